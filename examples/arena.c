@@ -0,0 +1,59 @@
+/**
+ * arena.c - an example usage of the
+ * arena allocator library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_arena.h>
+#include <_stdio.h>
+
+typedef struct {
+    int id;
+    const char *name;
+} item;
+
+int main() {
+    char stack[256];
+    _arena_t arena;
+
+    // the first allocations come from the stack buffer
+    _arena_init(&arena, stack, sizeof(stack));
+
+    for (int request = 1; request <= 3; request++) {
+        _arena_mark_t mark = _arena_checkpoint(&arena);
+
+        // many small objects which all die with the request,
+        // the arena continues in mapped chunks when needed
+        item *items = _arena_alloc(&arena, 1000 * sizeof(item), sizeof(void *));
+        for (int i = 0; i < 1000; i++) {
+            items[i].id = request * 1000 + i;
+            items[i].name = "item";
+        }
+
+        _printf("request %d: last item id %d\n", request, items[999].id);
+
+        // everything allocated for the request is freed at once
+        _arena_rewind(&arena, mark);
+    }
+
+    // nearly full: the padding of an aligned allocation does
+    // not fit in the buffer, so it comes from a new chunk
+    char small[60] __attribute__((aligned(16)));
+    _arena_t tight;
+
+    _arena_init(&tight, small, sizeof(small));
+    _arena_alloc(&tight, sizeof(small) - 3, 1);
+
+    char *aligned = _arena_alloc(&tight, 8, 16);
+    int past = aligned >= small + sizeof(small) && aligned < small + sizeof(small) + 16;
+
+    _printf("aligned allocation: %s\n", past ? "past the end of the buffer" : "from a new chunk");
+
+    _arena_free(&tight);
+
+    _arena_free(&arena);
+    return 0;
+}
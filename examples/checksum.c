@@ -0,0 +1,41 @@
+/**
+ * checksum.c - an example usage of the
+ * checksum library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_checksum.h>
+#include <_stdio.h>
+
+int main() {
+    const char *text = "123456789";
+
+    _printf("crc32c:  %x\n", _crc32c(0, text, 9));
+    _printf("crc32:   %x\n", _crc32(0, text, 9));
+    _printf("adler32: %x\n", _adler32(1, text, 9));
+
+    // checksum the blocks while they are written
+    char block[4096];
+    for (int i = 0; i < 4096; i++) block[i] = (char)i;
+
+    _FILE *file = _fopen("checksum.bin", "w+");
+    if (file == NULL) return 1;
+
+    _fchecksum(file, _crc32c, 0);
+    for (int i = 0; i < 16; i++) _fwrite(block, 1, sizeof(block), file);
+
+    unsigned int written = _fchecksum_value(file);
+
+    // and again while they are read back
+    _rewind(file);
+    _fchecksum(file, _crc32c, 0);
+    while (_fread(block, 1, sizeof(block), file) > 0);
+
+    _printf("written %x, read %x\n", written, _fchecksum_value(file));
+    _fclose(file);
+
+    return 0;
+}
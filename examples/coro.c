@@ -0,0 +1,83 @@
+/**
+ * coro.c - an example usage of the
+ * coroutines library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_coro.h>
+#include <_stdio.h>
+
+_evloop_t *loop;
+_FILE in;
+_FILE out;
+int finished = 0;
+
+void *numbers(void *arg) {
+    int count = (int)(long)arg;
+
+    for (int i = 1; i <= count; i++) _coro_yield((void *)(long)(i * i));
+
+    return NULL;
+}
+
+void *reader(void *arg) {
+    char line[64];
+
+    // suspends in _fgets until the writer sends more
+    while (_fgets(line, sizeof(line), &in) != NULL) _printf("read: %s", line);
+
+    if (++finished == 2) _evloop_stop(loop);
+    return NULL;
+}
+
+void *writer(void *arg) {
+    char line[] = "line X\n";
+
+    for (int i = 0; i < 3; i++) {
+        line[5] = '1' + i;
+        _fwrite(line, 1, sizeof(line) - 1, &out);
+    }
+
+    sys_close(out.fd);
+
+    if (++finished == 2) _evloop_stop(loop);
+    return NULL;
+}
+
+int main() {
+    // a generator, resumed by hand
+    _coro_t *squares = _coro_create(numbers, (void *)4L, 0);
+
+    for (;;) {
+        long value = (long)_coro_resume(squares, NULL);
+        if (_coro_done(squares)) break;
+
+        _printf("square: %d\n", (int)value);
+    }
+
+    _coro_destroy(squares);
+
+    // two coroutines talking through a nonblocking pipe
+    loop = _evloop_create();
+
+    int pipe[2];
+    sys_pipe2(pipe, _O_NONBLOCK);
+
+    in.fd = pipe[0];
+    in.offset = -1;
+    out.fd = pipe[1];
+    out.offset = -1;
+
+    _coro_spawn(loop, reader, NULL, 0);
+    _coro_spawn(loop, writer, NULL, 0);
+
+    _evloop_run(loop);
+
+    sys_close(pipe[0]);
+    _evloop_destroy(loop);
+
+    return 0;
+}
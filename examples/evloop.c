@@ -0,0 +1,75 @@
+/**
+ * evloop.c - an example usage of the
+ * event loop library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_evloop.h>
+#include <_thread.h>
+#include <_stdio.h>
+
+_evloop_t *loop;
+_thread_t *thread;
+
+void on_read(_evio_t *io, int events, void *arg) {
+    char buffer[64];
+    long long n;
+
+    // read until the pipe would block
+    while ((n = sys_read(io->fd, buffer, sizeof(buffer) - 1)) > 0) {
+        buffer[n] = '\0';
+        _printf("read: %s\n", buffer);
+    }
+
+    // the writing end was closed
+    if (n == 0) _evloop_del(io);
+}
+
+void on_tick(_evtimer_t *timer, void *arg) {
+    int *ticks = arg;
+
+    _printf("tick %d\n", ++*ticks);
+    if (*ticks == 3) _evloop_cancel(timer);
+}
+
+void on_done(void *arg) {
+    _printf("posted: %s\n", (char *)arg);
+    _evloop_stop(loop);
+}
+
+void *worker(void *arg) {
+    // other threads only post calls to the loop
+    _evloop_post(loop, on_done, "worker finished");
+
+    return NULL;
+}
+
+void on_timeout(_evtimer_t *timer, void *arg) {
+    thread = _thread_create(worker, NULL, 0);
+}
+
+int main() {
+    loop = _evloop_create();
+
+    int pipe[2];
+    sys_pipe2(pipe, _O_NONBLOCK);
+    _evloop_add(loop, pipe[0], EVLOOP_READ, on_read, NULL);
+    sys_write(pipe[1], "hello loop", 10);
+    sys_close(pipe[1]);
+
+    // every 10 ms, then once after 50 ms
+    int ticks = 0;
+    _evloop_timer(loop, 10000000ULL, 10000000ULL, on_tick, &ticks);
+    _evloop_timer(loop, 50000000ULL, 0, on_timeout, NULL);
+
+    _evloop_run(loop);
+    _thread_join(thread);
+
+    sys_close(pipe[0]);
+    _evloop_destroy(loop);
+
+    return 0;
+}
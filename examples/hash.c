@@ -0,0 +1,36 @@
+/**
+ * hash.c - an example usage of the
+ * hashing library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_hash.h>
+#include <_stdio.h>
+
+int main() {
+    const char *text = "The quick brown fox jumps over the lazy dog";
+
+    _printf("hash of text: %llx\n", _strhash(text, 0));
+    _printf("with a seed:  %llx\n", _strhash(text, 42));
+    _printf("avx2 long path: %s\n", _cpu_has(CPU_AVX2) ? "yes" : "no");
+
+    // hash a file in chunks, the same as hashing it at once
+    _FILE *file = _fopen("hash.c", "r");
+
+    if (file) {
+        _hash_state_t state;
+        char buffer[1000];
+        _size_t n;
+
+        _hash_init(&state, 0);
+        while ((n = _fread(buffer, 1, sizeof(buffer), file)) > 0) _hash_update(&state, buffer, n);
+
+        _printf("hash of hash.c: %llx\n", _hash_digest(&state));
+        _fclose(file);
+    }
+
+    return 0;
+}
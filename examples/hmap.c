@@ -0,0 +1,51 @@
+/**
+ * hmap.c - an example usage of the
+ * hash map library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_hmap.h>
+#include <_stdio.h>
+
+#define ID_HASH(k) _hmap_hash_u64(k)
+#define ID_EQUAL(a, b) ((a) == (b))
+
+RAWC_HMAP_DEFINE(scores, unsigned long long, unsigned int, ID_HASH, ID_EQUAL)
+
+int main() {
+    const char *words[] = { "apple", "pear", "apple", "plum", "pear", "apple" };
+
+    // count words in a map with string keys
+    _hmap_t *counts = _hmap_create(HMAP_STRING, sizeof(unsigned int));
+
+    for (int i = 0; i < 6; i++) {
+        unsigned int *count = _hmap_put(counts, words[i], NULL);
+        (*count)++;
+    }
+
+    _size_t iter = 0;
+    const void *word;
+    void *count;
+
+    while (_hmap_next(counts, &iter, &word, &count)) {
+        _printf("%s: %u\n", (const char *)word, *(unsigned int *)count);
+    }
+
+    _hmap_remove(counts, "plum");
+    _printf("plum %s\n", _hmap_get(counts, "plum") ? "found" : "removed");
+    _hmap_destroy(counts);
+
+    // a map made for its types
+    scores_t map;
+    scores_init(&map);
+
+    for (unsigned long long id = 1; id <= 1000; id++) scores_put(&map, id, (unsigned int)(id * 3));
+
+    _printf("score of 500: %u\n", *scores_get(&map, 500));
+    scores_free(&map);
+
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * io_uring.c - an example usage of the
+ * asynchronous I/O library.
+ *
+ * The example writes a few lines to a file with
+ * a single syscall, then reads them back.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_io_uring.h>
+
+int main() {
+    _uring ring;
+    char buffer[64];
+
+    if (_uring_init(&ring, 8, 0) != 0) {
+        _printf("io_uring is not available\n");
+        _exit(1);
+    }
+
+    _FILE* file = _fopen("io_uring.txt", "w+");
+
+    // queue four writes and a fsync, then submit them at once
+    for (int i = 0; i < 4; i++) {
+        _uring_fwrite(&ring, file, "Hello!\n", 7, i * 7, i);
+    }
+
+    // the fsync waits for the writes before it (IO_DRAIN)
+    _uring_sqe *sqe = _uring_get_sqe(&ring);
+    _uring_prep_fsync(sqe, file->fd, 0);
+    _uring_sqe_set_data(sqe, 4);
+    _uring_sqe_set_flags(sqe, _IOSQE_IO_DRAIN);
+    _uring_submit_and_wait(&ring, 5);
+
+    // reap all the completions in one batch
+    _uring_cqe *cqes[8];
+    unsigned count = _uring_peek_batch_cqe(&ring, cqes, 8);
+    _uring_cq_advance(&ring, count);
+
+    _printf("Completed requests: %d\n", count);
+
+    _uring_fread(&ring, file, buffer, 28, 0, 5);
+    _uring_submit_and_wait(&ring, 1);
+
+    _uring_cqe *cqe;
+    _uring_wait_cqe(&ring, &cqe);
+    _printf("Read %d bytes\n", cqe->res);
+    _uring_cqe_seen(&ring, cqe);
+
+    _fclose(file);
+    _uring_exit(&ring);
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * log.c - an example usage of the
+ * asynchronous logger.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_log.h>
+#include <_stdio.h>
+
+void *worker(void *arg) {
+    unsigned int id = (unsigned int)(unsigned long)arg;
+
+    for (unsigned int i = 0; i < 3; i++) {
+        _logf(LOG_INFO, "worker %u: step %u of %s\n", id, i, "3");
+    }
+
+    return NULL;
+}
+
+int main() {
+    // records go to the standard output, the threads wait when a ring is full
+    _log_start(1, LOG_BLOCK);
+
+    _logf(LOG_DEBUG, "starting %d workers\n", 2);
+
+    _thread_t *first = _thread_create(worker, (void *)1, 0);
+    _thread_t *second = _thread_create(worker, (void *)2, 0);
+    _thread_join(first);
+    _thread_join(second);
+
+    // debug records are skipped from now on
+    _log_level(LOG_INFO);
+    _logf(LOG_DEBUG, "not written\n");
+    _logf(LOG_WARN, "workers done at %p\n", (void *)main);
+
+    _log_stop();
+
+    _log_stats_t stats;
+    _log_stats(&stats);
+    _printf("written %llu, dropped %llu\n", stats.written, stats.dropped);
+
+    return 0;
+}
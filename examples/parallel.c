@@ -0,0 +1,36 @@
+/**
+ * parallel.c - an example usage of the
+ * parallel kernels library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_parallel.h>
+#include <_stdio.h>
+
+#define SIZE (64 * 1024 * 1024)
+
+int main() {
+    unsigned char *image = _malloc(SIZE);
+    unsigned char *copy = _malloc(SIZE);
+
+    // split buffers from 8 MiB on
+    _parallel_threshold(8 * 1024 * 1024);
+
+    _memset_mt(image, 0xAB, SIZE);
+    _memcpy_mt(copy, image, SIZE);
+
+    // the same values as the single-threaded functions
+    _printf("crc32c:   %x %x\n", _crc32c_mt(0, copy, SIZE), _crc32c(0, copy, SIZE));
+    _printf("crc32:    %x %x\n", _crc32_mt(0, copy, SIZE), _crc32(0, copy, SIZE));
+    _printf("adler32:  %x %x\n", _adler32_mt(1, copy, SIZE), _adler32(1, copy, SIZE));
+    _printf("tree hash: %llx\n", _memhash_mt(copy, SIZE, 0));
+
+    _free(copy);
+    _free(image);
+    _tpool_stop();
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+/**
+ * pool.c - an example usage of the
+ * object pool library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_pool.h>
+#include <_stdio.h>
+
+typedef struct node {
+    struct node *next;
+    int value;
+} node;
+
+int main() {
+    _pool_t *nodes = _pool_create(sizeof(node), POOL_CACHELINE);
+    node *list = NULL;
+
+    // build a list of nodes, every one on its own cache line
+    for (int i = 1; i <= 100; i++) {
+        node *n = _pool_get(nodes);
+
+        n->value = i;
+        n->next = list;
+        list = n;
+    }
+
+    int sum = 0;
+    while (list != NULL) {
+        node *next = list->next;
+
+        sum += list->value;
+        _pool_put(nodes, list);
+        list = next;
+    }
+
+    _pool_stats_t stats;
+    _pool_stats(nodes, &stats);
+
+    _printf("Sum of the nodes: %d\n", sum);
+    _printf("All nodes returned: %s\n", stats.live == 0 ? "yes" : "no");
+    _printf("High water: %d, slabs: %d\n", (int)stats.high_water, (int)stats.slabs);
+    _printf("Objects per slab: %d\n", (int)stats.per_slab);
+
+    _pool_destroy(nodes);
+    return 0;
+}
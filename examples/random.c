@@ -0,0 +1,37 @@
+/**
+ * random.c - an example usage of the
+ * random numbers library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_stdlib.h>
+#include <_stdio.h>
+
+int main() {
+    unsigned int counts[6] = { 0, 0, 0, 0, 0, 0 };
+    unsigned char payload[64];
+
+    // roll a die with the generator of the thread
+    _srand(42);
+    for (int i = 0; i < 6000; i++) counts[_rand_below(6)]++;
+
+    for (int i = 0; i < 6; i++) _printf("%u: %u\n", i + 1, counts[i]);
+
+    // a generator of its own, on stream 7
+    _pcg64_t gen;
+    _pcg64_seed(&gen, 42, 7);
+    _printf("pcg64: %llx\n", _pcg64_next(&gen));
+
+    // random bytes for a test payload
+    _rand_fill(payload, sizeof(payload));
+    _printf("payload starts with %x\n", payload[0]);
+
+    // a seed for something which must not be guessed
+    unsigned long long secret;
+    if (sys_getrandom(&secret, sizeof(secret), 0) == sizeof(secret)) _printf("secret: %llx\n", secret);
+
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * ring.c - an example usage of the
+ * ring buffers library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_ring.h>
+#include <_thread.h>
+#include <_stdio.h>
+
+#define RECORDS 1000
+
+typedef struct {
+    unsigned int id;
+    unsigned int value;
+} record;
+
+_ring_t *bytes;
+_mpsc_t *records;
+
+void *producer(void *arg) {
+    unsigned int id = (unsigned int)(unsigned long)arg;
+
+    for (unsigned int i = 0; i < RECORDS; i++) {
+        record r = { id, i };
+
+        // the consumer frees the slots as it goes
+        while (_mpsc_push(records, &r) != 0) ;
+    }
+
+    return NULL;
+}
+
+int main() {
+    // bytes: write in place, then commit
+    bytes = _ring_create(4096);
+
+    _size_t space;
+    char *dst = _ring_reserve(bytes, &space);
+    _memcpy(dst, "hello ", 6);
+    _memcpy(dst + 6, "ring", 4);
+    _ring_commit(bytes, 10);
+
+    char text[16] = { 0 };
+    _size_t ready;
+    const char *src = _ring_peek(bytes, &ready);
+    _memcpy(text, src, ready);
+    _ring_release(bytes, ready);
+    _printf("%u bytes: %s\n", (unsigned int)ready, text);
+    _ring_destroy(bytes);
+
+    // messages from two producer threads
+    records = _mpsc_create(64, sizeof(record));
+
+    _thread_t *first = _thread_create(producer, (void *)1, 0);
+    _thread_t *second = _thread_create(producer, (void *)2, 0);
+
+    unsigned int count = 0, sum = 0;
+    record r;
+
+    while (count < 2 * RECORDS) {
+        if (_mpsc_pop(records, &r) == 0) {
+            count++;
+            sum += r.value;
+        }
+    }
+
+    _thread_join(first);
+    _thread_join(second);
+    _printf("%u records, sum %u\n", count, sum);
+    _mpsc_destroy(records);
+
+    return 0;
+}
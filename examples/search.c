@@ -0,0 +1,57 @@
+/**
+ * search.c - an example usage of the
+ * searching library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_stdlib.h>
+#include <_stdio.h>
+
+typedef struct {
+    unsigned int code;
+    const char *name;
+} country;
+
+#define CODE_LESS(a, b) ((a) < (b))
+
+RAWC_SEARCH_DEFINE(search_codes, unsigned int, CODE_LESS)
+
+int compare_code(const void *key, const void *element) {
+    unsigned int code = *(const unsigned int *)key;
+    unsigned int other = ((const country *)element)->code;
+
+    return (code > other) - (code < other);
+}
+
+int main() {
+    country countries[] = {
+        { 33, "France" }, { 39, "Italy" }, { 44, "United Kingdom" },
+        { 48, "Poland" }, { 49, "Germany" }, { 81, "Japan" },
+    };
+    unsigned int codes[] = { 10, 20, 30, 40, 50, 60, 70 };
+    unsigned int eytz[8];
+    unsigned int key = 48;
+
+    // one search of a sorted array
+    country *found = _bsearch(&key, countries, 6, sizeof(country), compare_code);
+    _printf("%u: %s\n", key, found ? found->name : "not found");
+
+    // many searches, through an index in the B-tree layout
+    _search_index_t *index = _search_build(countries, 6, sizeof(country), compare_code, SEARCH_BTREE);
+
+    for (key = 30; key <= 90; key += 20) {
+        country *next = _search_lower_bound(index, &key);
+        _printf("first code from %u: %s\n", key, next ? next->name : "none");
+    }
+
+    _search_free(index);
+
+    // searches of a typed array in the Eytzinger layout
+    search_codes_eytzinger(codes, eytz, 7);
+    _printf("45 goes before %u\n", eytz[search_codes_eytzinger_search(eytz, 7, 45)]);
+
+    return 0;
+}
@@ -0,0 +1,55 @@
+/**
+ * sort.c - an example usage of the
+ * sorting library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_stdlib.h>
+#include <_stdio.h>
+
+typedef struct {
+    int key;
+    const char *name;
+} item;
+
+#define ITEM_LESS(a, b) ((a).key < (b).key)
+
+RAWC_SORT_DEFINE(sort_items, item, ITEM_LESS)
+
+int compare(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+
+    return (x > y) - (x < y);
+}
+
+int main() {
+    int numbers[] = { 42, 7, 19, 3, 88, 7, 51 };
+    item items[] = { { 3, "three" }, { 1, "one" }, { 2, "two" } };
+    unsigned int keys[1000];
+    float floats[] = { 2.5f, -1.0f, 0.5f, -3.5f };
+
+    // sort with a comparator
+    _qsort(numbers, 7, sizeof(int), compare);
+    for (int i = 0; i < 7; i++) _printf("%d ", numbers[i]);
+    _printf("\n");
+
+    // sort with a function made for the type
+    sort_items(items, 3);
+    for (int i = 0; i < 3; i++) _printf("%s ", items[i].name);
+    _printf("\n");
+
+    // radix sort of integer keys
+    for (unsigned int i = 0; i < 1000; i++) keys[i] = (i * 2654435761U) >> 8;
+    _radix_sort_u32(keys, 1000);
+    _printf("smallest %u, largest %u\n", keys[0], keys[999]);
+
+    // radix sort of floats, negative ones first
+    _radix_sort_f32(floats, 4);
+    _printf("%s\n", floats[0] < floats[1] && floats[1] < floats[2] && floats[2] < floats[3] ? "sorted" : "not sorted");
+
+    return 0;
+}
@@ -0,0 +1,38 @@
+/**
+ * stdlib.c - an example usage of the
+ * standard general utilities library remake.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_stdlib.h>
+#include <_stdio.h>
+
+int main() {
+    // small objects come from the size classes
+    int *numbers = _malloc(10 * sizeof(int));
+
+    for (int i = 0; i < 10; i++) numbers[i] = i * i;
+
+    // growing the array moves it to a bigger class
+    numbers = _realloc(numbers, 1000 * sizeof(int));
+    _printf("numbers[9] after realloc: %d\n", numbers[9]);
+
+    _free(numbers);
+
+    // a zeroed table of 100000 longs is a medium block
+    long *table = _calloc(100000, sizeof(long));
+    _printf("table is zeroed: %s\n", table[99999] == 0 ? "yes" : "no");
+    _free(table);
+
+    // 16 MB are mapped directly and remapped on growth
+    char *big = _malloc(16 << 20);
+    big[0] = 'R';
+    big = _realloc(big, 64 << 20);
+    _printf("big[0] after realloc: %c\n", big[0]);
+    _free(big);
+
+    return 0;
+}
@@ -0,0 +1,46 @@
+/**
+ * thread_sync.c - an example usage of the
+ * thread synchronization library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_thread_sync.h>
+#include <_stdio.h>
+
+_once_t setup_once = ONCE_INIT;
+_mutex_t lock = MUTEX_INIT;
+_cond_t ready = COND_INIT;
+_rwlock_t table_lock = RWLOCK_INIT;
+
+unsigned int setups = 0;
+
+void setup(void) {
+    setups++;
+}
+
+int main() {
+    // the second call does nothing
+    _once(&setup_once, setup);
+    _once(&setup_once, setup);
+    _printf("setup ran %u time(s)\n", setups);
+
+    // nobody signals, so the wait runs out after 10 ms
+    _mutex_lock(&lock);
+    int ret = _cond_timedwait(&ready, &lock, 10000000);
+    _mutex_unlock(&lock);
+    _printf("wait %s\n", ret == 0 ? "signalled" : "timed out");
+
+    // readers share the lock, a writer has it alone
+    _rwlock_rdlock(&table_lock);
+    _rwlock_rdlock(&table_lock);
+    _printf("writer while read: %s\n", _rwlock_trywrlock(&table_lock) ? "locked" : "busy");
+    _rwlock_unlock(&table_lock);
+    _rwlock_unlock(&table_lock);
+    _printf("writer when free: %s\n", _rwlock_trywrlock(&table_lock) ? "locked" : "busy");
+    _rwlock_unlock(&table_lock);
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * threads.c - an example usage of the
+ * threads library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_thread.h>
+#include <_stdio.h>
+
+#define THREADS 4
+#define NUMBERS 1000000
+
+// every thread has its own copy
+__thread unsigned int calls = 0;
+
+void *sum_part(void *arg) {
+    unsigned int part = (unsigned int)(unsigned long)arg;
+    unsigned long long sum = 0;
+
+    calls++;
+
+    for (unsigned int i = part; i < NUMBERS; i += THREADS) sum += i;
+
+    unsigned long long *result = _malloc(sizeof(unsigned long long));
+    *result = sum + calls - 1;
+
+    return result;
+}
+
+int main() {
+    _thread_t *threads[THREADS];
+
+    for (unsigned int i = 0; i < THREADS; i++) {
+        threads[i] = _thread_create(sum_part, (void *)(unsigned long)i, 0);
+    }
+
+    unsigned long long total = 0;
+
+    for (unsigned int i = 0; i < THREADS; i++) {
+        unsigned long long *result = _thread_join(threads[i]);
+
+        _printf("thread %u: %llu\n", i, *result);
+        total += *result;
+        _free(result);
+    }
+
+    _printf("total: %llu\n", total);
+
+    return 0;
+}
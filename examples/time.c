@@ -0,0 +1,32 @@
+/**
+ * time.c - an example usage of the
+ * time library remake.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_time.h>
+#include <_stdio.h>
+
+int main() {
+    _timespec ts;
+    unsigned cpu = 0;
+
+    _clock_gettime(_CLOCK_REALTIME, &ts);
+    _printf("Seconds since the Epoch: %d\n", (int)ts.tv_sec);
+    _printf("time(): %d\n", (int)_time(NULL));
+
+    // measure how long a loop of timestamps takes
+    unsigned long long start = _monotonic_ns();
+    for (int i = 0; i < 1000; i++) _monotonic_ns();
+    unsigned long long elapsed = _monotonic_ns() - start;
+
+    _printf("1000 timestamps took %d ns\n", (int)elapsed);
+
+    _getcpu(&cpu, NULL);
+    _printf("Running on CPU: %d\n", cpu);
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * tpool.c - an example usage of the
+ * thread pool library.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#include <_tpool.h>
+#include <_stdio.h>
+
+#define COUNT (1 << 20)
+
+unsigned int squares[COUNT];
+unsigned int done = 0;
+
+void square_range(_size_t begin, _size_t end, void *arg) {
+    for (_size_t i = begin; i < end; i++) squares[i] = (unsigned int)(i * i);
+}
+
+void count_task(void *arg) {
+    __atomic_add_fetch(&done, 1, __ATOMIC_RELAXED);
+}
+
+int main() {
+    _printf("workers: %u\n", (unsigned int)_tpool_start(0));
+
+    // the range is split into parts of at most 4096 numbers
+    _parallel_for(0, COUNT, 4096, square_range, NULL);
+    _printf("square of 1000: %u\n", squares[1000]);
+
+    for (int i = 0; i < 100; i++) _tpool_submit(count_task, NULL);
+    _tpool_wait();
+    _printf("tasks done: %u\n", done);
+
+    _tpool_stop();
+
+    return 0;
+}
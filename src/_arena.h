@@ -0,0 +1,366 @@
+/**
+ * _arena.h - Arena (bump) allocator.
+ *
+ * An arena hands out memory by moving a pointer
+ * forward, objects are never freed one by one. All
+ * of them are freed at once by resetting the arena,
+ * or by rewinding it to a checkpoint. This fits work
+ * which allocates many small objects dying together,
+ * like the handling of one request.
+ *
+ * The arena can start in a buffer supplied by the
+ * caller (e.g. on the stack), it grows in chunks
+ * mapped with mmap when the buffer is full. Arenas
+ * holding big tables can ask for chunks backed by
+ * transparent huge pages, and prefaulted ones (see
+ * _arena_set_flags).
+ *
+ * Example usage:
+ *  char stack[1024];
+ *  _arena_t arena;
+ *  _arena_init(&arena, stack, sizeof(stack));
+ *
+ *  _arena_mark_t mark = _arena_checkpoint(&arena);
+ *  int *numbers = _arena_alloc(&arena, 100 * sizeof(int), sizeof(int));
+ *  ...
+ *  _arena_rewind(&arena, mark);
+ *  ...
+ *  _arena_free(&arena);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <_syscalls.h>
+
+/**
+ * _size_t - type representing the size of
+ *           the memory block or the length of string.
+*/
+typedef unsigned long long int _size_t;
+
+/**
+ * NULL - Null pointer.
+*/
+#define NULL ((void *)0)
+
+/**
+ * ARENA_CHUNK - Size of the first chunk mapped by an arena.
+ *               Every next chunk is twice as big, up to
+ *               ARENA_CHUNK_MAX.
+*/
+#define ARENA_CHUNK      (64UL << 10)
+#define ARENA_CHUNK_MAX  (4UL << 20)
+
+/**
+ * ARENA_ALIGN - Alignment used when 0 is passed to _arena_alloc,
+ *               enough for any standard type.
+*/
+#define ARENA_ALIGN 16
+
+/**
+ * Flags of an arena, set with _arena_set_flags.
+ *
+ * - ARENA_HUGEPAGE - map chunks of whole huge pages, aligned
+ *                    to ARENA_HUGE, backed by transparent
+ *                    huge pages
+ * - ARENA_PREFAULT - fault the pages of a chunk in when it
+ *                    is mapped, not on the first access
+*/
+#define ARENA_HUGEPAGE  1
+#define ARENA_PREFAULT  2
+
+#define ARENA_HUGE      (2UL << 20)
+
+/**
+ * __arena_chunk - header of a chunk mapped by an arena.
+ *
+ * The chunks of an arena form a list from the newest
+ * one to the oldest one.
+ *
+ * @param prev the chunk mapped before this one
+ * @param size size of the chunk, with the header
+*/
+typedef struct __arena_chunk {
+    struct __arena_chunk *prev;
+    _size_t size;
+} __arena_chunk;
+
+/**
+ * _arena_t - an arena.
+ *
+ * @param ptr first free byte
+ * @param end end of the free space
+ * @param chunk the chunk in use (NULL while in the buffer)
+ * @param spare a free chunk kept for reuse
+ * @param buffer the buffer supplied by the caller
+ * @param buffer_size size of the buffer
+ * @param next_size size of the next chunk
+ * @param flags flags of the arena (ARENA_*)
+*/
+typedef struct {
+    char *ptr;
+    char *end;
+    __arena_chunk *chunk;
+    __arena_chunk *spare;
+    char *buffer;
+    _size_t buffer_size;
+    _size_t next_size;
+    int flags;
+} _arena_t;
+
+/**
+ * _arena_mark_t - a checkpoint of an arena.
+ *
+ * @param ptr first free byte at the checkpoint
+ * @param end end of the free space at the checkpoint
+ * @param chunk the chunk in use at the checkpoint
+*/
+typedef struct {
+    char *ptr;
+    char *end;
+    __arena_chunk *chunk;
+} _arena_mark_t;
+
+/**
+ * Library functions:
+ *  @fn _arena_init Initialize an arena.
+ *  @fn _arena_set_flags Set how an arena maps its chunks.
+ *  @fn _arena_alloc Allocate memory from an arena.
+ *  @fn _arena_checkpoint Remember the state of an arena.
+ *  @fn _arena_rewind Free everything allocated after a checkpoint.
+ *  @fn _arena_reset Free everything allocated from an arena.
+ *  @fn _arena_free Free everything and give the memory back.
+*/
+
+/**
+ * Initialize an arena.
+ *
+ * @param arena arena to initialize
+ * @param buffer memory to allocate from first (can be NULL),
+ *               it has to outlive the arena
+ * @param size size of the buffer
+*/
+void _arena_init(_arena_t *arena, void *buffer, _size_t size) {
+    arena->buffer = (char *)buffer;
+    arena->buffer_size = buffer ? size : 0;
+    arena->ptr = arena->buffer;
+    arena->end = arena->buffer + arena->buffer_size;
+    arena->chunk = NULL;
+    arena->spare = NULL;
+    arena->next_size = ARENA_CHUNK;
+    arena->flags = 0;
+}
+
+/**
+ * Set how an arena maps its chunks.
+ *
+ * The flags apply to the chunks mapped after the call.
+ *
+ * Example usage:
+ *  _arena_init(&arena, NULL, 0);
+ *  _arena_set_flags(&arena, ARENA_HUGEPAGE | ARENA_PREFAULT);
+ *
+ * @param arena the arena
+ * @param flags ARENA_HUGEPAGE, ARENA_PREFAULT, or 0
+*/
+void _arena_set_flags(_arena_t *arena, int flags) {
+    arena->flags = flags;
+}
+
+/**
+ * Map a chunk for an arena.
+ *
+ * Huge page chunks are aligned by mapping more than
+ * needed and unmapping the parts around the aligned
+ * area, the huge pages are asked for before the pages
+ * are prefaulted.
+ *
+ * @param size size of the chunk
+ * @param flags flags of the arena
+ * @return the chunk, or NULL on failure
+*/
+void* __arena_map(_size_t size, int flags) {
+    _size_t span = size;
+    int map = _MAP_PRIVATE | _MAP_ANONYMOUS;
+
+    if (flags & ARENA_HUGEPAGE) span += ARENA_HUGE;
+    else if (flags & ARENA_PREFAULT) map |= _MAP_POPULATE;
+
+    long long addr = sys_mmap(NULL, span, _PROT_READ | _PROT_WRITE, map, -1, 0);
+    if (addr < 0) return NULL;
+
+    char *chunk = (char *)(unsigned long)addr;
+    if (!(flags & ARENA_HUGEPAGE)) return chunk;
+
+    char *aligned = (char *)(((unsigned long)chunk + ARENA_HUGE - 1) & ~(ARENA_HUGE - 1));
+
+    if (aligned > chunk) sys_munmap(chunk, aligned - chunk);
+    if (chunk + span > aligned + size) sys_munmap(aligned + size, chunk + span - aligned - size);
+
+    sys_madvise(aligned, size, _MADV_HUGEPAGE);
+
+    // kernels before 5.14 do not know MADV_POPULATE_WRITE
+    if ((flags & ARENA_PREFAULT) && sys_madvise(aligned, size, _MADV_POPULATE_WRITE) != 0) {
+        for (_size_t i = 0; i < size; i += 4096) ((volatile char *)aligned)[i] = 0;
+    }
+
+    return aligned;
+}
+
+/**
+ * Give up a chunk which is no longer in use.
+ *
+ * The biggest free chunk is kept, so an arena which
+ * is reset in a loop does not map and unmap a chunk
+ * every time.
+ *
+ * @param arena arena of the chunk
+ * @param chunk the chunk
+*/
+void __arena_release(_arena_t *arena, __arena_chunk *chunk) {
+    if (arena->spare == NULL || arena->spare->size < chunk->size) {
+        __arena_chunk *old = arena->spare;
+
+        arena->spare = chunk;
+        chunk = old;
+    }
+
+    if (chunk != NULL) sys_munmap(chunk, chunk->size);
+}
+
+/**
+ * Continue the arena in a new chunk.
+ *
+ * @param arena arena to grow
+ * @param size size of the allocation which did not fit
+ * @param align its alignment
+ * @return 0 on success, -1 if the memory can not be mapped
+*/
+int __arena_grow(_arena_t *arena, _size_t size, _size_t align) {
+    _size_t need = sizeof(__arena_chunk) + size + align;
+    __arena_chunk *chunk = arena->spare;
+
+    if (need < size) return -1;
+
+    if (chunk != NULL && chunk->size >= need) arena->spare = NULL;
+    else {
+        _size_t chunk_size = arena->next_size;
+
+        while (chunk_size < need) chunk_size *= 2;
+
+        if (arena->flags & ARENA_HUGEPAGE) {
+            chunk_size = (chunk_size + ARENA_HUGE - 1) & ~(ARENA_HUGE - 1);
+            if (chunk_size < need) return -1;
+        }
+
+        chunk = (__arena_chunk *)__arena_map(chunk_size, arena->flags);
+        if (chunk == NULL) return -1;
+
+        chunk->size = chunk_size;
+
+        if (arena->next_size < ARENA_CHUNK_MAX) arena->next_size *= 2;
+    }
+
+    chunk->prev = arena->chunk;
+    arena->chunk = chunk;
+    arena->ptr = (char *)(chunk + 1);
+    arena->end = (char *)chunk + chunk->size;
+
+    return 0;
+}
+
+/**
+ * Allocate memory from an arena.
+ *
+ * The memory lives until the arena is reset, or
+ * rewound to a checkpoint taken before the call.
+ *
+ * @param arena arena to allocate from
+ * @param size size of the memory
+ * @param align alignment, a power of two (0 means ARENA_ALIGN)
+ * @return the memory, or NULL on failure
+*/
+void* _arena_alloc(_arena_t *arena, _size_t size, _size_t align) {
+    if (align == 0) align = ARENA_ALIGN;
+
+    unsigned long ptr = ((unsigned long)arena->ptr + align - 1) & ~(unsigned long)(align - 1);
+
+    // an arena without a buffer has no space before the first chunk,
+    // the padding may already take ptr past the end
+    if (arena->ptr == NULL || ptr < (unsigned long)arena->ptr || ptr > (unsigned long)arena->end ||
+        size > (unsigned long)arena->end - ptr) {
+        if (__arena_grow(arena, size, align) != 0) return NULL;
+
+        ptr = ((unsigned long)arena->ptr + align - 1) & ~(unsigned long)(align - 1);
+    }
+
+    arena->ptr = (char *)ptr + size;
+    return (void *)ptr;
+}
+
+/**
+ * Remember the state of an arena.
+ *
+ * @param arena the arena
+ * @return the checkpoint
+*/
+_arena_mark_t _arena_checkpoint(_arena_t *arena) {
+    _arena_mark_t mark = { arena->ptr, arena->end, arena->chunk };
+
+    return mark;
+}
+
+/**
+ * Free everything allocated after a checkpoint.
+ *
+ * Chunks mapped after the checkpoint are given up,
+ * checkpoints taken after this one become invalid.
+ *
+ * @param arena the arena
+ * @param mark checkpoint taken from the arena
+*/
+void _arena_rewind(_arena_t *arena, _arena_mark_t mark) {
+    while (arena->chunk != mark.chunk) {
+        __arena_chunk *chunk = arena->chunk;
+
+        arena->chunk = chunk->prev;
+        __arena_release(arena, chunk);
+    }
+
+    arena->ptr = mark.ptr;
+    arena->end = mark.end;
+}
+
+/**
+ * Free everything allocated from an arena.
+ *
+ * The arena starts again in the buffer of the
+ * caller, one chunk is kept for reuse.
+ *
+ * @param arena the arena
+*/
+void _arena_reset(_arena_t *arena) {
+    _arena_mark_t start = { arena->buffer, arena->buffer + arena->buffer_size, NULL };
+
+    _arena_rewind(arena, start);
+}
+
+/**
+ * Free everything allocated from an arena and
+ * give all of its chunks back to the kernel.
+ *
+ * @param arena the arena
+*/
+void _arena_free(_arena_t *arena) {
+    _arena_reset(arena);
+
+    if (arena->spare != NULL) sys_munmap(arena->spare, arena->spare->size);
+    arena->spare = NULL;
+}
+
+#endif // __ARENA_H__
@@ -0,0 +1,639 @@
+/**
+ * _checksum.h - Checksums for data integrity.
+ *
+ * The library provides three checksums, all of them
+ * compatible with the usual implementations:
+ *
+ * - CRC-32C (Castagnoli) - with the crc32 instruction of
+ *                          SSE4.2 on x86_64, three streams
+ *                          at once to hide its latency
+ * - CRC-32 (zlib, gzip, PNG...) - folded 64 bytes at a time
+ *                          with carry-less multiplication
+ *                          (PCLMULQDQ) on x86
+ * - Adler-32 (zlib)      - 32 bytes at a time with SSE2
+ *
+ * Without the instructions (i386, ARM, older CPUs) the
+ * CRCs are computed 8 bytes at a time from tables
+ * (slicing-by-8). The tables are made on the first call.
+ *
+ * Every function takes the checksum of the data before,
+ * so data can be checksummed in chunks. The checksum of
+ * no data is 0 for the CRCs and 1 for Adler-32. The
+ * checksums of chunks made separately (e.g. in parallel)
+ * are joined with the _combine functions.
+ *
+ * A stream can checksum everything read from or written
+ * to it, see _fchecksum in _stdio.h.
+ *
+ * Example usage:
+ *  unsigned int crc = _crc32c(0, block, size);
+ *  crc = _crc32c(crc, next_block, next_size);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __CHECKSUM_H__
+#define __CHECKSUM_H__
+
+#include <_string.h>
+#include <_cpu.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * Polynomials of the CRCs (reflected).
+*/
+#define __CRC32C_POLY 0x82F63B78U
+#define __CRC32_POLY  0xEDB88320U
+
+/**
+ * Bytes of every stream of the three-stream CRC-32C,
+ * for long data and for the rest of it.
+*/
+#define __CRC32C_LONG  8192
+#define __CRC32C_SHORT 256
+
+/**
+ * __ADLER_BASE - Modulus of Adler-32.
+ *
+ * __ADLER_NMAX - Most bytes summed before the sums
+ *                have to be reduced (no overflow).
+*/
+#define __ADLER_BASE 65521U
+#define __ADLER_NMAX 5552
+
+/**
+ * __checksum_tables - tables of the software CRCs.
+ *
+ * @param crc32c slicing-by-8 tables of CRC-32C
+ * @param crc32 slicing-by-8 tables of CRC-32
+ * @param crc32c_long appends __CRC32C_LONG zeros to a CRC-32C
+ * @param crc32c_short appends __CRC32C_SHORT zeros to a CRC-32C
+ * @param ready set once the tables are made
+*/
+struct {
+    unsigned int crc32c[8][256];
+    unsigned int crc32[8][256];
+    unsigned int crc32c_long[4][256];
+    unsigned int crc32c_short[4][256];
+    int ready;
+} __checksum_tables;
+
+/**
+ * Library functions:
+ *  @fn _crc32c Compute the CRC-32C of data.
+ *  @fn _crc32 Compute the CRC-32 of data.
+ *  @fn _adler32 Compute the Adler-32 of data.
+ *  @fn _crc32c_combine Join the CRC-32C of two chunks.
+ *  @fn _crc32_combine Join the CRC-32 of two chunks.
+ *  @fn _adler32_combine Join the Adler-32 of two chunks.
+*/
+
+typedef unsigned long long __attribute__((aligned(1), may_alias)) __checksum_u64_u;
+
+/**
+ * Multiply a vector by a matrix over GF(2).
+ *
+ * @param mat the matrix, a column per bit
+ * @param vec the vector
+ * @return the product
+*/
+unsigned int __gf2_times(const unsigned int *mat, unsigned int vec) {
+    unsigned int sum = 0;
+
+    for (; vec; vec >>= 1, mat++) {
+        if (vec & 1) sum ^= *mat;
+    }
+
+    return sum;
+}
+
+/**
+ * Square a matrix over GF(2).
+ *
+ * @param square where to store the square
+ * @param mat the matrix
+*/
+void __gf2_square(unsigned int *square, const unsigned int *mat) {
+    for (int n = 0; n < 32; n++) square[n] = __gf2_times(mat, mat[n]);
+}
+
+/**
+ * Make the table appending zeros to a CRC-32C.
+ *
+ * The operator appending one zero bit is squared
+ * until it appends len bytes.
+ *
+ * @param zeros where to store the table
+ * @param len number of zero bytes, a power of two
+*/
+void __crc32c_zeros(unsigned int zeros[4][256], _size_t len) {
+    unsigned int even[32], odd[32];
+    unsigned int *op = odd;
+
+    odd[0] = __CRC32C_POLY;
+    for (int n = 1; n < 32; n++) odd[n] = 1U << (n - 1);
+
+    __gf2_square(even, odd);        // 2 zero bits
+    __gf2_square(odd, even);        // 4 zero bits
+
+    // every square doubles the zeros, from a byte on
+    for (;;) {
+        __gf2_square(even, odd);
+        op = even;
+        if ((len >>= 1) == 0) break;
+
+        __gf2_square(odd, even);
+        op = odd;
+        if ((len >>= 1) == 0) break;
+    }
+
+    for (unsigned int n = 0; n < 256; n++) {
+        zeros[0][n] = __gf2_times(op, n);
+        zeros[1][n] = __gf2_times(op, n << 8);
+        zeros[2][n] = __gf2_times(op, n << 16);
+        zeros[3][n] = __gf2_times(op, n << 24);
+    }
+}
+
+/**
+ * Append zeros to a CRC-32C with a table.
+ *
+ * @param zeros the table (see __crc32c_zeros)
+ * @param crc the CRC
+ * @return the CRC followed by the zeros
+*/
+unsigned int __crc32c_shift(unsigned int zeros[4][256], unsigned int crc) {
+    return zeros[0][crc & 0xFF] ^ zeros[1][(crc >> 8) & 0xFF]
+         ^ zeros[2][(crc >> 16) & 0xFF] ^ zeros[3][crc >> 24];
+}
+
+/**
+ * Multiply two polynomials modulo a CRC polynomial.
+ *
+ * The polynomials are reflected, x^0 is the top bit.
+ *
+ * @param a the first polynomial
+ * @param b the second polynomial
+ * @param poly the CRC polynomial (reflected)
+ * @return the product modulo the CRC polynomial
+*/
+unsigned int __crc_multmod(unsigned int a, unsigned int b, unsigned int poly) {
+    unsigned int product = 0;
+
+    for (unsigned int m = 1U << 31; a != 0; m >>= 1) {
+        if (a & m) {
+            product ^= b;
+            a ^= m;
+        }
+
+        b = (b & 1) ? (b >> 1) ^ poly : b >> 1;
+    }
+
+    return product;
+}
+
+/**
+ * Get the operator appending zero bytes to a CRC.
+ *
+ * It is x^(8 * len) modulo the CRC polynomial, made
+ * from the squares x^8, x^16, x^32... in log(len) steps.
+ *
+ * @param len number of zero bytes
+ * @param poly the CRC polynomial (reflected)
+ * @return x^(8 * len) modulo the CRC polynomial
+*/
+unsigned int __crc_zeros(_size_t len, unsigned int poly) {
+    unsigned int op = 1U << 31;         // x^0
+    unsigned int square = 1U << 23;     // x^8
+
+    for (; len > 0; len >>= 1) {
+        if (len & 1) op = __crc_multmod(square, op, poly);
+        square = __crc_multmod(square, square, poly);
+    }
+
+    return op;
+}
+
+/**
+ * Make the slicing-by-8 tables of a CRC.
+ *
+ * @param table where to store the tables
+ * @param poly the polynomial (reflected)
+*/
+void __crc_table(unsigned int table[8][256], unsigned int poly) {
+    for (unsigned int n = 0; n < 256; n++) {
+        unsigned int crc = n;
+
+        for (int k = 0; k < 8; k++) crc = (crc >> 1) ^ (poly & -(crc & 1));
+        table[0][n] = crc;
+    }
+
+    for (unsigned int n = 0; n < 256; n++) {
+        for (int k = 1; k < 8; k++) table[k][n] = (table[k - 1][n] >> 8) ^ table[0][table[k - 1][n] & 0xFF];
+    }
+}
+
+/**
+ * Make the tables of the software CRCs,
+ * once, on the first call.
+*/
+void __checksum_init(void) {
+    if (__atomic_load_n(&__checksum_tables.ready, __ATOMIC_ACQUIRE)) return;
+
+    // the tables come out the same in every thread, a race only repeats the work
+    __crc_table(__checksum_tables.crc32c, __CRC32C_POLY);
+    __crc_table(__checksum_tables.crc32, __CRC32_POLY);
+    __crc32c_zeros(__checksum_tables.crc32c_long, __CRC32C_LONG);
+    __crc32c_zeros(__checksum_tables.crc32c_short, __CRC32C_SHORT);
+
+    __atomic_store_n(&__checksum_tables.ready, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Compute a CRC 8 bytes at a time (slicing-by-8).
+ *
+ * @param table the slicing-by-8 tables of the CRC
+ * @param crc the CRC before the data, not inverted
+ * @param p the data
+ * @param len size of the data
+ * @return the CRC, not inverted
+*/
+unsigned int __crc_slice8(unsigned int table[8][256], unsigned int crc, const unsigned char *p, _size_t len) {
+    while (len > 0 && ((unsigned long)p & 7)) {
+        crc = table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+        len--;
+    }
+
+    for (; len >= 8; len -= 8, p += 8) {
+        unsigned long long word = *(const __checksum_u64_u *)p ^ crc;
+
+        crc = table[7][word & 0xFF] ^ table[6][(word >> 8) & 0xFF]
+            ^ table[5][(word >> 16) & 0xFF] ^ table[4][(word >> 24) & 0xFF]
+            ^ table[3][(word >> 32) & 0xFF] ^ table[2][(word >> 40) & 0xFF]
+            ^ table[1][(word >> 48) & 0xFF] ^ table[0][word >> 56];
+    }
+
+    while (len-- > 0) crc = table[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+#ifdef __x86_64__
+
+/**
+ * Compute a CRC-32C with the crc32 instruction.
+ *
+ * The instruction takes 3 cycles and can start every
+ * cycle, so long data is split into three streams,
+ * each with its own CRC, joined at the end of every
+ * block by appending zeros to the CRC before.
+ *
+ * @param crc the CRC before the data, not inverted
+ * @param p the data
+ * @param len size of the data
+ * @return the CRC, not inverted
+*/
+__attribute__((target("sse4.2")))
+unsigned int __crc32c_sse42(unsigned int crc, const unsigned char *p, _size_t len) {
+    unsigned long long crc0 = crc;
+
+    while (len > 0 && ((unsigned long)p & 7)) {
+        crc0 = _mm_crc32_u8((unsigned int)crc0, *p++);
+        len--;
+    }
+
+    for (; len >= 3 * __CRC32C_LONG; len -= 3 * __CRC32C_LONG) {
+        unsigned long long crc1 = 0, crc2 = 0;
+        const unsigned char *end = p + __CRC32C_LONG;
+
+        for (; p < end; p += 8) {
+            crc0 = _mm_crc32_u64(crc0, *(const unsigned long long *)p);
+            crc1 = _mm_crc32_u64(crc1, *(const unsigned long long *)(p + __CRC32C_LONG));
+            crc2 = _mm_crc32_u64(crc2, *(const unsigned long long *)(p + 2 * __CRC32C_LONG));
+        }
+
+        crc0 = __crc32c_shift(__checksum_tables.crc32c_long, (unsigned int)crc0) ^ crc1;
+        crc0 = __crc32c_shift(__checksum_tables.crc32c_long, (unsigned int)crc0) ^ crc2;
+        p += 2 * __CRC32C_LONG;
+    }
+
+    for (; len >= 3 * __CRC32C_SHORT; len -= 3 * __CRC32C_SHORT) {
+        unsigned long long crc1 = 0, crc2 = 0;
+        const unsigned char *end = p + __CRC32C_SHORT;
+
+        for (; p < end; p += 8) {
+            crc0 = _mm_crc32_u64(crc0, *(const unsigned long long *)p);
+            crc1 = _mm_crc32_u64(crc1, *(const unsigned long long *)(p + __CRC32C_SHORT));
+            crc2 = _mm_crc32_u64(crc2, *(const unsigned long long *)(p + 2 * __CRC32C_SHORT));
+        }
+
+        crc0 = __crc32c_shift(__checksum_tables.crc32c_short, (unsigned int)crc0) ^ crc1;
+        crc0 = __crc32c_shift(__checksum_tables.crc32c_short, (unsigned int)crc0) ^ crc2;
+        p += 2 * __CRC32C_SHORT;
+    }
+
+    for (; len >= 8; len -= 8, p += 8) crc0 = _mm_crc32_u64(crc0, *(const unsigned long long *)p);
+    while (len-- > 0) crc0 = _mm_crc32_u8((unsigned int)crc0, *p++);
+
+    return (unsigned int)crc0;
+}
+
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * Compute a CRC-32 by folding with carry-less
+ * multiplication (Intel, "Fast CRC Computation for
+ * Generic Polynomials Using PCLMULQDQ Instruction").
+ *
+ * Four 128-bit registers are folded over the data,
+ * 64 bytes at a time, then into one register, which
+ * is reduced to 32 bits (Barrett reduction).
+ *
+ * @param crc the CRC before the data, not inverted
+ * @param p the data
+ * @param len size of the data, at least 64 bytes
+ *            and a multiple of 16
+ * @return the CRC, not inverted
+*/
+__attribute__((target("sse4.1,pclmul")))
+unsigned int __crc32_pclmul(unsigned int crc, const unsigned char *p, _size_t len) {
+    const __m128i mask = _mm_setr_epi32(-1, 0, -1, 0);
+    __m128i k, t1, t2, t3, t4;
+
+    __m128i x1 = _mm_loadu_si128((const __m128i *)p);
+    __m128i x2 = _mm_loadu_si128((const __m128i *)(p + 16));
+    __m128i x3 = _mm_loadu_si128((const __m128i *)(p + 32));
+    __m128i x4 = _mm_loadu_si128((const __m128i *)(p + 48));
+
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    k = _mm_set_epi64x(0x01C6E41596LL, 0x0154442BD4LL);
+    p += 64;
+    len -= 64;
+
+    // fold 64 bytes into the four registers
+    for (; len >= 64; len -= 64, p += 64) {
+        t1 = _mm_clmulepi64_si128(x1, k, 0x00);
+        t2 = _mm_clmulepi64_si128(x2, k, 0x00);
+        t3 = _mm_clmulepi64_si128(x3, k, 0x00);
+        t4 = _mm_clmulepi64_si128(x4, k, 0x00);
+
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, k, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, k, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, k, 0x11);
+
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, t1), _mm_loadu_si128((const __m128i *)p));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, t2), _mm_loadu_si128((const __m128i *)(p + 16)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, t3), _mm_loadu_si128((const __m128i *)(p + 32)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, t4), _mm_loadu_si128((const __m128i *)(p + 48)));
+    }
+
+    // fold the four registers into one
+    k = _mm_set_epi64x(0x00CCAA009ELL, 0x01751997D0LL);
+
+    t1 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), t1);
+
+    t1 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), t1);
+
+    t1 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), t1);
+
+    // fold the rest, 16 bytes at a time
+    for (; len >= 16; len -= 16, p += 16) {
+        t1 = _mm_clmulepi64_si128(x1, k, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, k, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i *)p)), t1);
+    }
+
+    // fold 128 bits into 64
+    t2 = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), t2);
+
+    k = _mm_set_epi64x(0, 0x0163CD6124LL);
+    t2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, mask);
+    x1 = _mm_clmulepi64_si128(x1, k, 0x00);
+    x1 = _mm_xor_si128(x1, t2);
+
+    // Barrett reduction to 32 bits
+    k = _mm_set_epi64x(0x01F7011641LL, 0x01DB710641LL);
+    t2 = _mm_and_si128(x1, mask);
+    t2 = _mm_clmulepi64_si128(t2, k, 0x10);
+    t2 = _mm_and_si128(t2, mask);
+    t2 = _mm_clmulepi64_si128(t2, k, 0x00);
+    x1 = _mm_xor_si128(x1, t2);
+
+    return (unsigned int)_mm_extract_epi32(x1, 1);
+}
+
+#endif
+
+/**
+ * Compute the CRC-32C of data.
+ *
+ * The CRC of iSCSI, ext4, Btrfs and SSE4.2.
+ *
+ * Example usage:
+ *  unsigned int crc = _crc32c(0, "123456789", 9);   // 0xE3069283
+ *
+ * @param crc the CRC of the data before, 0 for none
+ * @param data the data
+ * @param len size of the data
+ * @return the CRC of the data before and this data
+*/
+unsigned int _crc32c(unsigned int crc, const void *data, _size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+
+    __checksum_init();
+
+#ifdef __x86_64__
+    if (_cpu_has(CPU_SSE42)) return ~__crc32c_sse42(~crc, p, len);
+#endif
+
+    return ~__crc_slice8(__checksum_tables.crc32c, ~crc, p, len);
+}
+
+/**
+ * Compute the CRC-32 of data.
+ *
+ * The CRC of zlib, gzip, PNG and Ethernet.
+ *
+ * Example usage:
+ *  unsigned int crc = _crc32(0, "123456789", 9);    // 0xCBF43926
+ *
+ * @param crc the CRC of the data before, 0 for none
+ * @param data the data
+ * @param len size of the data
+ * @return the CRC of the data before and this data
+*/
+unsigned int _crc32(unsigned int crc, const void *data, _size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+
+    __checksum_init();
+    crc = ~crc;
+
+#if defined(__x86_64__) || defined(__i386__)
+    if (len >= 64 && _cpu_has(CPU_SSE42 | CPU_PCLMUL)) {
+        _size_t folded = len & ~(_size_t)15;
+
+        crc = __crc32_pclmul(crc, p, folded);
+        p += folded;
+        len -= folded;
+    }
+#endif
+
+    return ~__crc_slice8(__checksum_tables.crc32, crc, p, len);
+}
+
+/**
+ * Compute the Adler-32 of data.
+ *
+ * The checksum of the zlib format: two 16-bit sums
+ * modulo 65521, of the bytes and of the first sum
+ * after every byte.
+ *
+ * @param adler the Adler-32 of the data before, 1 for none
+ * @param data the data
+ * @param len size of the data
+ * @return the Adler-32 of the data before and this data
+*/
+unsigned int _adler32(unsigned int adler, const void *data, _size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    unsigned int s1 = adler & 0xFFFF;
+    unsigned int s2 = adler >> 16;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights_hi = _mm_setr_epi16(32, 31, 30, 29, 28, 27, 26, 25);
+    const __m128i weights_lo = _mm_setr_epi16(24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i weights_hi2 = _mm_setr_epi16(16, 15, 14, 13, 12, 11, 10, 9);
+    const __m128i weights_lo2 = _mm_setr_epi16(8, 7, 6, 5, 4, 3, 2, 1);
+    _size_t blocks = len / 32;
+
+    len -= blocks * 32;
+
+    while (blocks > 0) {
+        _size_t n = blocks < __ADLER_NMAX / 32 ? blocks : __ADLER_NMAX / 32;
+
+        blocks -= n;
+
+        // s2 gains s1 for every byte of the blocks
+        __m128i v_ps = _mm_setr_epi32(0, 0, 0, (int)(s1 * n));
+        __m128i v_s1 = zero;
+        __m128i v_s2 = _mm_setr_epi32(0, 0, 0, (int)s2);
+
+        do {
+            __m128i b1 = _mm_loadu_si128((const __m128i *)p);
+            __m128i b2 = _mm_loadu_si128((const __m128i *)(p + 16));
+
+            // the sum of the blocks before, once per byte
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+
+            v_s1 = _mm_add_epi32(v_s1, _mm_add_epi32(_mm_sad_epu8(b1, zero), _mm_sad_epu8(b2, zero)));
+
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_unpacklo_epi8(b1, zero), weights_hi));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_unpackhi_epi8(b1, zero), weights_lo));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_unpacklo_epi8(b2, zero), weights_hi2));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_unpackhi_epi8(b2, zero), weights_lo2));
+
+            p += 32;
+        } while (--n > 0);
+
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        // add up the lanes
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0x4E));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, 0xB1));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0x4E));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, 0xB1));
+
+        s1 = (s1 + (unsigned int)_mm_cvtsi128_si32(v_s1)) % __ADLER_BASE;
+        s2 = (unsigned int)_mm_cvtsi128_si32(v_s2) % __ADLER_BASE;
+    }
+#endif
+
+    while (len > 0) {
+        _size_t n = len < __ADLER_NMAX ? len : __ADLER_NMAX;
+
+        len -= n;
+
+        for (; n > 0; n--) {
+            s1 += *p++;
+            s2 += s1;
+        }
+
+        s1 %= __ADLER_BASE;
+        s2 %= __ADLER_BASE;
+    }
+
+    return (s2 << 16) | s1;
+}
+
+/**
+ * Join the CRC-32C of two chunks.
+ *
+ * Example usage:
+ *  unsigned int crc = _crc32c_combine(_crc32c(0, a, a_len), _crc32c(0, b, b_len), b_len);
+ *
+ * @param crc1 the CRC of the first chunk
+ * @param crc2 the CRC of the second chunk
+ * @param len2 size of the second chunk
+ * @return the CRC of the first chunk followed by the second
+*/
+unsigned int _crc32c_combine(unsigned int crc1, unsigned int crc2, _size_t len2) {
+    return __crc_multmod(__crc_zeros(len2, __CRC32C_POLY), crc1, __CRC32C_POLY) ^ crc2;
+}
+
+/**
+ * Join the CRC-32 of two chunks.
+ *
+ * @param crc1 the CRC of the first chunk
+ * @param crc2 the CRC of the second chunk
+ * @param len2 size of the second chunk
+ * @return the CRC of the first chunk followed by the second
+*/
+unsigned int _crc32_combine(unsigned int crc1, unsigned int crc2, _size_t len2) {
+    return __crc_multmod(__crc_zeros(len2, __CRC32_POLY), crc1, __CRC32_POLY) ^ crc2;
+}
+
+/**
+ * Join the Adler-32 of two chunks.
+ *
+ * The second sum of the second chunk misses the first
+ * sum of the first chunk once for every byte of it.
+ *
+ * @param adler1 the Adler-32 of the first chunk
+ * @param adler2 the Adler-32 of the second chunk
+ * @param len2 size of the second chunk
+ * @return the Adler-32 of the first chunk followed by the second
+*/
+unsigned int _adler32_combine(unsigned int adler1, unsigned int adler2, _size_t len2) {
+    unsigned int rem = (unsigned int)(len2 % __ADLER_BASE);
+    unsigned int s1 = adler1 & 0xFFFF;
+    unsigned int s2 = (unsigned int)((unsigned long long)rem * s1 % __ADLER_BASE);
+
+    // the 1 both chunks start their first sum with is counted once
+    s1 += (adler2 & 0xFFFF) + __ADLER_BASE - 1;
+    s2 += (adler1 >> 16) + (adler2 >> 16) + __ADLER_BASE - rem;
+
+    if (s1 >= __ADLER_BASE) s1 -= __ADLER_BASE;
+    if (s1 >= __ADLER_BASE) s1 -= __ADLER_BASE;
+    if (s2 >= 2 * __ADLER_BASE) s2 -= 2 * __ADLER_BASE;
+    if (s2 >= __ADLER_BASE) s2 -= __ADLER_BASE;
+
+    return (s2 << 16) | s1;
+}
+
+#endif // __CHECKSUM_H__
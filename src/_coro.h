@@ -0,0 +1,422 @@
+/**
+ * _coro.h - Stackful coroutines.
+ *
+ * A coroutine is a function running on its own stack,
+ * which can stop in the middle (_coro_yield) and go on
+ * later from there (_coro_resume). Switching saves only
+ * the callee-saved registers on the stack being left
+ * and loads the stack pointer of the other side (see
+ * __coro_switch in the syscall header of the
+ * architecture), so it costs a few nanoseconds and no
+ * syscall.
+ *
+ * The stacks are mapped with a guard page under them,
+ * so an overflow faults instead of writing over other
+ * memory. Stacks of the default size are kept in a
+ * pool of the thread when their coroutine ends, the
+ * pool is unmapped when a thread of _thread.h exits.
+ *
+ * Coroutines started with _coro_spawn run in an event
+ * loop (_evloop.h): a read or a write of a nonblocking
+ * stream which would block (EAGAIN) suspends the
+ * coroutine, and the loop resumes it when the descriptor
+ * is ready. The code of the coroutine stays straight:
+ *
+ *  void *echo(void *arg) {
+ *      _FILE *in = arg;
+ *      char line[256];
+ *
+ *      while (_fgets(line, sizeof(line), in) != NULL) _printf("%s", line);
+ *      return NULL;
+ *  }
+ *
+ *  _evloop_nonblock(in->fd);
+ *  _coro_spawn(loop, echo, in, 0);
+ *  _evloop_run(loop);
+ *
+ * A coroutine belongs to the thread which created it.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __CORO_H__
+#define __CORO_H__
+
+#include <_evloop.h>
+
+/**
+ * CORO_STACK - Default stack size of a coroutine.
+ *
+ * CORO_POOL - Stacks of the default size kept by a
+ *             thread for the next coroutines.
+*/
+#define CORO_STACK (128 * 1024)
+#define CORO_POOL  64
+
+/**
+ * States of a coroutine.
+ *
+ * - CORO_SUSPENDED - created or yielded, waits for _coro_resume
+ * - CORO_RUNNING   - running, or resuming another coroutine
+ * - CORO_DONE      - its function returned
+*/
+#define CORO_SUSPENDED 0
+#define CORO_RUNNING   1
+#define CORO_DONE      2
+
+/**
+ * _coro_t - a coroutine.
+ *
+ * The structure is at the top of the mapping of the
+ * stack, so it comes and goes with the stack.
+ *
+ * @param sp saved stack pointer of the coroutine
+ * @param caller saved stack pointer of the resumer
+ * @param fn function of the coroutine
+ * @param arg argument of fn
+ * @param value value passed by _coro_resume and _coro_yield,
+ *              the result of fn at the end
+ * @param state CORO_SUSPENDED, CORO_RUNNING or CORO_DONE
+ * @param prev the coroutine running before, NULL for the thread
+ * @param loop event loop of a spawned coroutine, or NULL
+ * @param map the mapping, guard page and stack
+ * @param map_size size of the mapping
+ * @param next next stack in the pool
+*/
+typedef struct _coro_t {
+    void *sp;
+    void *caller;
+    void *(*fn)(void *arg);
+    void *arg;
+    void *value;
+    int state;
+    struct _coro_t *prev;
+    _evloop_t *loop;
+    void *map;
+    _size_t map_size;
+    struct _coro_t *next;
+} _coro_t;
+
+/**
+ * __coro_current - the coroutine running in the thread.
+ *
+ * __coro_pool - stacks of the thread, free to use.
+ *
+ * __coro_pooled - number of stacks in the pool.
+*/
+__thread _coro_t *__coro_current = NULL;
+__thread _coro_t *__coro_pool = NULL;
+__thread int __coro_pooled = 0;
+
+/**
+ * Library functions:
+ *  @fn _coro_create Create a coroutine.
+ *  @fn _coro_resume Run a coroutine until it yields or returns.
+ *  @fn _coro_yield Suspend the running coroutine.
+ *  @fn _coro_self Get the running coroutine.
+ *  @fn _coro_done Tell whether a coroutine returned.
+ *  @fn _coro_destroy Free a coroutine which is not running.
+ *  @fn _coro_pool_release Unmap the stacks pooled by the thread.
+ *  @fn _coro_spawn Run a coroutine in an event loop.
+ *  @fn _coro_wait Suspend the running coroutine until a descriptor is ready.
+*/
+
+/**
+ * Size of the mapping of a stack: the guard page,
+ * the stack and the _coro_t.
+ *
+ * @param stack_size size of the stack
+ * @param page size of a page
+ * @return size of the mapping
+*/
+_size_t __coro_map_size(_size_t stack_size, _size_t page) {
+    return (page + stack_size + sizeof(_coro_t) + 15 + page - 1) & ~(page - 1);
+}
+
+/**
+ * Entry of a new coroutine, on its own stack.
+ *
+ * @param arg the coroutine
+*/
+void __coro_main(void *arg) {
+    _coro_t *coro = arg;
+
+    coro->value = coro->fn(coro->arg);
+    coro->state = CORO_DONE;
+
+    // back to the resumer for good
+    __coro_switch(&coro->sp, coro->caller);
+}
+
+/**
+ * Create a coroutine.
+ *
+ * The coroutine does not run until _coro_resume.
+ *
+ * Example usage:
+ *  _coro_t *gen = _coro_create(numbers, NULL, 0);
+ *
+ * @param fn function of the coroutine, its result
+ *           is returned by the last _coro_resume
+ * @param arg argument of fn
+ * @param stack_size size of the stack, 0 for CORO_STACK
+ * @return the coroutine, or NULL on failure
+*/
+_coro_t *_coro_create(void *(*fn)(void *arg), void *arg, _size_t stack_size) {
+    _size_t page = _getauxval(_AT_PAGESZ);
+    _coro_t *coro;
+
+    if (page == 0) page = 4096;
+    if (stack_size == 0) stack_size = CORO_STACK;
+
+    if (stack_size == CORO_STACK && __coro_pool != NULL) {
+        coro = __coro_pool;
+        __coro_pool = coro->next;
+        __coro_pooled--;
+    }
+    else {
+        // guard page | stack | _coro_t
+        _size_t size = __coro_map_size(stack_size, page);
+
+        long long addr = sys_mmap(NULL, size, _PROT_READ | _PROT_WRITE,
+                                  _MAP_PRIVATE | _MAP_ANONYMOUS | _MAP_NORESERVE, -1, 0);
+        if (addr < 0 && addr > -4096) return NULL;
+
+        char *map = (char *)(unsigned long)addr;
+
+        if (sys_mprotect(map, page, _PROT_NONE) != 0) {
+            sys_munmap(map, size);
+            return NULL;
+        }
+
+        coro = (_coro_t *)((unsigned long)(map + size - sizeof(_coro_t)) & ~15UL);
+        coro->map = map;
+        coro->map_size = size;
+    }
+
+    coro->fn = fn;
+    coro->arg = arg;
+    coro->value = NULL;
+    coro->state = CORO_SUSPENDED;
+    coro->prev = NULL;
+    coro->loop = NULL;
+    coro->next = NULL;
+    coro->sp = __coro_frame(coro, __coro_main, coro);
+
+    return coro;
+}
+
+/**
+ * Run a coroutine until it yields or returns.
+ *
+ * Coroutines may resume other coroutines, a yield
+ * goes back to the resumer.
+ *
+ * Example usage:
+ *  while (!_coro_done(gen)) _printf("%d\n", (int)(long)_coro_resume(gen, NULL));
+ *
+ * @param coro a suspended coroutine
+ * @param value returned by the _coro_yield the coroutine
+ *              stopped in (ignored by the first resume)
+ * @return the value passed to _coro_yield, or the result
+ *         of the function when it returned
+*/
+void *_coro_resume(_coro_t *coro, void *value) {
+    if (coro->state != CORO_SUSPENDED) return NULL;
+
+    coro->value = value;
+    coro->state = CORO_RUNNING;
+    coro->prev = __coro_current;
+    __coro_current = coro;
+
+    __coro_switch(&coro->caller, coro->sp);
+
+    __coro_current = coro->prev;
+
+    return coro->value;
+}
+
+/**
+ * Suspend the running coroutine, _coro_resume
+ * returns in its resumer.
+ *
+ * Example usage:
+ *  for (int i = 0; i < 10; i++) _coro_yield((void *)(long)i);
+ *
+ * @param value returned by _coro_resume
+ * @return the value passed to the next _coro_resume,
+ *         or NULL outside of a coroutine
+*/
+void *_coro_yield(void *value) {
+    _coro_t *coro = __coro_current;
+    if (coro == NULL) return NULL;
+
+    coro->value = value;
+    coro->state = CORO_SUSPENDED;
+
+    __coro_switch(&coro->sp, coro->caller);
+
+    return coro->value;
+}
+
+/**
+ * Get the running coroutine.
+ *
+ * @return the coroutine, or NULL outside of coroutines
+*/
+_coro_t *_coro_self(void) {
+    return __coro_current;
+}
+
+/**
+ * Tell whether the function of a coroutine returned.
+ *
+ * @param coro the coroutine
+ * @return 1 if it returned, 0 otherwise
+*/
+int _coro_done(_coro_t *coro) {
+    return coro->state == CORO_DONE;
+}
+
+/**
+ * Unmap the stacks pooled by the calling thread.
+ *
+ * _thread_exit calls it, a thread which is not made
+ * by _thread_create may call it when it is done with
+ * coroutines.
+*/
+void _coro_pool_release(void) {
+    while (__coro_pool != NULL) {
+        _coro_t *coro = __coro_pool;
+
+        __coro_pool = coro->next;
+        sys_munmap(coro->map, coro->map_size);
+    }
+
+    __coro_pooled = 0;
+}
+
+/**
+ * Free a coroutine which is not running.
+ *
+ * A suspended coroutine is dropped where it stopped.
+ * Its stack goes to the pool of the thread, or back
+ * to the system when the pool is full.
+ *
+ * @param coro the coroutine
+*/
+void _coro_destroy(_coro_t *coro) {
+    if (coro->state == CORO_RUNNING) return;
+
+    _size_t page = _getauxval(_AT_PAGESZ);
+    if (page == 0) page = 4096;
+
+    if (coro->map_size == __coro_map_size(CORO_STACK, page) && __coro_pooled < CORO_POOL) {
+        coro->next = __coro_pool;
+        __coro_pool = coro;
+        __coro_pooled++;
+
+        // the pool goes away with the thread
+        if (__coro_pooled == 1) __thread_release_add(_coro_pool_release);
+        return;
+    }
+
+    sys_munmap(coro->map, coro->map_size);
+}
+
+/**
+ * Resume a spawned coroutine from the loop, and
+ * free it when it returned.
+ *
+ * @param coro the coroutine
+*/
+void __coro_step(_coro_t *coro) {
+    _coro_resume(coro, NULL);
+
+    if (_coro_done(coro)) _coro_destroy(coro);
+}
+
+/**
+ * First resume of a spawned coroutine, posted to
+ * its loop.
+ *
+ * @param arg the coroutine
+*/
+void __coro_start(void *arg) {
+    __coro_step(arg);
+}
+
+/**
+ * Resume a coroutine whose descriptor is ready.
+ *
+ * @param io registration of the descriptor
+ * @param events the ready events
+ * @param arg the coroutine
+*/
+void __coro_ready(_evio_t *io, int events, void *arg) {
+    _evloop_del(io);
+    __coro_step(arg);
+}
+
+/**
+ * Suspend the running coroutine until a descriptor
+ * is ready.
+ *
+ * The loop of the coroutine resumes it. Used by the
+ * streams (__fwait) when a nonblocking descriptor
+ * would block.
+ *
+ * Example usage:
+ *  while ((n = sys_read(fd, buffer, size)) == -11) _coro_wait(fd, EVLOOP_READ);
+ *
+ * @param fd the descriptor
+ * @param events EVLOOP_READ or EVLOOP_WRITE
+ * @return 0 when ready, -1 outside of a spawned coroutine
+*/
+int _coro_wait(int fd, int events) {
+    _coro_t *coro = __coro_current;
+
+    if (coro == NULL || coro->loop == NULL) return -1;
+    if (_evloop_add(coro->loop, fd, events, __coro_ready, coro) == NULL) return -1;
+
+    _coro_yield(NULL);
+
+    return 0;
+}
+
+/**
+ * Run a coroutine in an event loop.
+ *
+ * The coroutine starts in the next batch of the loop,
+ * it is resumed by the loop whenever a descriptor it
+ * waits for is ready, and freed when it returns.
+ *
+ * Example usage:
+ *  _coro_spawn(loop, serve, client, 0);
+ *
+ * @param loop the event loop
+ * @param fn function of the coroutine
+ * @param arg argument of fn
+ * @param stack_size size of the stack, 0 for CORO_STACK
+ * @return the coroutine, or NULL on failure
+*/
+_coro_t *_coro_spawn(_evloop_t *loop, void *(*fn)(void *arg), void *arg, _size_t stack_size) {
+    _coro_t *coro = _coro_create(fn, arg, stack_size);
+    if (coro == NULL) return NULL;
+
+    coro->loop = loop;
+
+    // streams of the coroutines wait in the loop
+    __fwait = _coro_wait;
+
+    if (_evloop_post(loop, __coro_start, coro) != 0) {
+        _coro_destroy(coro);
+        return NULL;
+    }
+
+    return coro;
+}
+
+#endif // __CORO_H__
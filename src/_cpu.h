@@ -0,0 +1,181 @@
+/**
+ * _cpu.h - CPU feature detection.
+ *
+ * Libraries with code for newer instruction sets
+ * (AVX2, SSE4.2, PCLMULQDQ...) are compiled for the
+ * baseline of the architecture, and pick the faster
+ * code at runtime. The features are read once:
+ *
+ * - x86 and x86_64 - with the cpuid instruction, the
+ *                    AVX registers are checked to be
+ *                    enabled by the kernel (xgetbv)
+ * - ARM            - from the hardware capabilities
+ *                    passed by the kernel (AT_HWCAP)
+ *
+ * Example usage:
+ *  if (_cpu_has(CPU_AVX2)) hash_avx2(data, len);
+ *  else hash_scalar(data, len);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __CPU_H__
+#define __CPU_H__
+
+#include <_vdso.h>
+
+/**
+ * CPU features.
+ *
+ * - CPU_SSE2    - SSE2 (always there on x86_64)
+ * - CPU_SSE42   - SSE4.2, with the crc32 instruction
+ * - CPU_PCLMUL  - carry-less multiplication (PCLMULQDQ)
+ * - CPU_AVX     - AVX, enabled by the kernel
+ * - CPU_AVX2    - AVX2, enabled by the kernel
+ * - CPU_BMI2    - BMI2
+ * - CPU_AVX512  - AVX-512 F and BW, enabled by the kernel
+ * - CPU_NEON    - NEON (ARM)
+ * - CPU_CRC32   - the crc32 instructions (ARM)
+ * - CPU_PMULL   - 64-bit polynomial multiplication (ARM)
+*/
+#define CPU_SSE2     0x0001
+#define CPU_SSE42    0x0002
+#define CPU_PCLMUL   0x0004
+#define CPU_AVX      0x0008
+#define CPU_AVX2     0x0010
+#define CPU_BMI2     0x0020
+#define CPU_AVX512   0x0040
+#define CPU_NEON     0x0100
+#define CPU_CRC32    0x0200
+#define CPU_PMULL    0x0400
+
+/**
+ * Hardware capabilities of ARM (AT_HWCAP and AT_HWCAP2).
+*/
+#define __HWCAP_NEON     (1 << 12)
+#define __HWCAP2_PMULL   (1 << 1)
+#define __HWCAP2_CRC32   (1 << 4)
+
+/**
+ * __cpu_features - the detected features, with
+ *                  __CPU_READ set once they are read.
+*/
+#define __CPU_READ 0x80000000U
+
+unsigned int __cpu_features = 0;
+
+/**
+ * Library functions:
+ *  @fn _cpu_features Get all detected CPU features.
+ *  @fn _cpu_has Check for a CPU feature.
+*/
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * Run the cpuid instruction.
+ *
+ * @param leaf the leaf (eax)
+ * @param subleaf the subleaf (ecx)
+ * @param regs where to store eax, ebx, ecx and edx
+*/
+void __cpuid(unsigned int leaf, unsigned int subleaf, unsigned int regs[4]) {
+    asm volatile
+    (
+        "cpuid"
+        : "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+        : "0" (leaf), "2" (subleaf)
+    );
+}
+
+/**
+ * Read the state components enabled by the kernel.
+ *
+ * @return the low half of XCR0
+*/
+unsigned int __xgetbv(void) {
+    unsigned int eax, edx;
+
+    asm volatile ("xgetbv" : "=a" (eax), "=d" (edx) : "c" (0));
+    return eax;
+}
+
+#endif
+
+/**
+ * Detect the features of the CPU.
+ *
+ * @return the features (CPU_*)
+*/
+unsigned int __cpu_detect(void) {
+    unsigned int features = 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int regs[4];
+
+    __cpuid(0, 0, regs);
+    unsigned int max_leaf = regs[0];
+
+    __cpuid(1, 0, regs);
+
+    if (regs[3] & (1U << 26)) features |= CPU_SSE2;
+    if (regs[2] & (1U << 20)) features |= CPU_SSE42;
+    if (regs[2] & (1U << 1))  features |= CPU_PCLMUL;
+
+    // the kernel has to save the vector registers (OSXSAVE, XCR0)
+    unsigned int xcr0 = (regs[2] & (1U << 27)) ? __xgetbv() : 0;
+    int avx_os = (xcr0 & 0x06) == 0x06;
+    int avx512_os = (xcr0 & 0xE6) == 0xE6;
+
+    if (avx_os && (regs[2] & (1U << 28))) features |= CPU_AVX;
+
+    if (max_leaf >= 7) {
+        __cpuid(7, 0, regs);
+
+        if (avx_os && (regs[1] & (1U << 5))) features |= CPU_AVX2;
+        if (regs[1] & (1U << 8)) features |= CPU_BMI2;
+        if (avx512_os && (regs[1] & (1U << 16)) && (regs[1] & (1U << 30))) features |= CPU_AVX512;
+    }
+#elif defined(__arm__)
+    unsigned long hwcap = _getauxval(_AT_HWCAP);
+    unsigned long hwcap2 = _getauxval(_AT_HWCAP2);
+
+    if (hwcap & __HWCAP_NEON) features |= CPU_NEON;
+    if (hwcap2 & __HWCAP2_CRC32) features |= CPU_CRC32;
+    if (hwcap2 & __HWCAP2_PMULL) features |= CPU_PMULL;
+#endif
+
+    return features;
+}
+
+/**
+ * Get all detected CPU features.
+ *
+ * @return the features (CPU_*)
+*/
+unsigned int _cpu_features(void) {
+    unsigned int features = __atomic_load_n(&__cpu_features, __ATOMIC_RELAXED);
+
+    // detection gives the same result in every thread, a race only repeats it
+    if (!(features & __CPU_READ)) {
+        features = __cpu_detect() | __CPU_READ;
+        __atomic_store_n(&__cpu_features, features, __ATOMIC_RELAXED);
+    }
+
+    return features & ~__CPU_READ;
+}
+
+/**
+ * Check for a CPU feature.
+ *
+ * @param feature the feature (CPU_*), or several
+ *                of them, all have to be present
+ * @return 1 if the CPU has the feature, 0 if not
+*/
+int _cpu_has(unsigned int feature) {
+    return (_cpu_features() & feature) == feature;
+}
+
+#endif // __CPU_H__
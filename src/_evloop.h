@@ -0,0 +1,914 @@
+/**
+ * _evloop.h - Event loop.
+ *
+ * Waits for many file descriptors at once with epoll
+ * and calls a function for every descriptor ready for
+ * reading or writing. One epoll_wait returns up to
+ * EVLOOP_BATCH events, their callbacks run one after
+ * another before the loop waits again.
+ *
+ * Besides the descriptors the loop has:
+ *
+ * - timers, kept in a hierarchical timer wheel: four
+ *   levels of 64 slots, the first one of EVLOOP_TICK_NS
+ *   ticks, every next one 64 times coarser. Adding and
+ *   cancelling a timer is O(1), a timer moves to a finer
+ *   level when its time comes closer. A timerfd wakes
+ *   up the loop for the next tick with a timer.
+ *
+ * - posted calls, the only part of a loop other threads
+ *   may use: _evloop_post queues a function and wakes
+ *   up the loop through an eventfd.
+ *
+ * Streams (_FILE) can be waited for too. A stream with
+ * data left in its buffer is ready for reading without
+ * asking the kernel, and regular files, which epoll does
+ * not accept, are always ready.
+ *
+ * Example usage:
+ *  _evloop_t *loop = _evloop_create();
+ *
+ *  _evloop_nonblock(fd);
+ *  _evloop_add(loop, fd, EVLOOP_READ, on_read, NULL);
+ *  _evloop_timer(loop, 5000000000ULL, 0, on_timeout, NULL);
+ *
+ *  _evloop_run(loop);     // until _evloop_stop
+ *  _evloop_destroy(loop);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __EVLOOP_H__
+#define __EVLOOP_H__
+
+#include <_stdlib.h>
+#include <_thread_sync.h>
+#include <_time.h>
+
+/**
+ * Events of a file descriptor.
+ *
+ * - EVLOOP_READ  - ready for reading
+ * - EVLOOP_WRITE - ready for writing
+ * - EVLOOP_ERROR - error or hang up, reported with the
+ *                  events waited for
+*/
+#define EVLOOP_READ  0x1
+#define EVLOOP_WRITE 0x2
+#define EVLOOP_ERROR 0x4
+
+/**
+ * EVLOOP_BATCH - Events taken by one epoll_wait.
+ *
+ * EVLOOP_TICK_NS - Resolution of the timers.
+*/
+#define EVLOOP_BATCH   64
+#define EVLOOP_TICK_NS 1000000ULL
+
+/**
+ * Shape of the timer wheel, __EVLOOP_LEVELS levels
+ * of 2^__EVLOOP_BITS slots.
+*/
+#define __EVLOOP_LEVELS 4
+#define __EVLOOP_BITS   6
+#define __EVLOOP_SLOTS  (1 << __EVLOOP_BITS)
+
+/* epoll data of the timerfd and of the eventfd */
+#define __EVLOOP_TIMERFD 1
+#define __EVLOOP_EVENTFD 2
+
+typedef struct _evloop_t _evloop_t;
+
+/**
+ * _evio_t - a file descriptor waited for.
+ *
+ * @param loop the loop
+ * @param fd the file descriptor
+ * @param file the stream of the descriptor, or NULL
+ * @param events events waited for (EVLOOP_READ, EVLOOP_WRITE)
+ * @param fn function called with the ready events
+ * @param arg argument of fn
+ * @param always 1 if epoll does not accept the descriptor
+ *               (a regular file), it is always ready
+ * @param dead 1 after _evloop_del, freed after the batch
+ * @param batch last batch the descriptor was dispatched in
+ * @param next next descriptor of the loop
+*/
+typedef struct _evio_t {
+    _evloop_t *loop;
+    int fd;
+    _FILE *file;
+    int events;
+    void (*fn)(struct _evio_t *io, int events, void *arg);
+    void *arg;
+    int always;
+    int dead;
+    unsigned long long batch;
+    struct _evio_t *next;
+} _evio_t;
+
+/**
+ * _evtimer_t - a timer.
+ *
+ * @param loop the loop
+ * @param expires tick of the expiration
+ * @param period ticks between the expirations, 0 for
+ *               a one-shot timer
+ * @param fn function called when the timer expires
+ * @param arg argument of fn
+ * @param next next timer of the slot
+ * @param pprev pointer to this timer in the slot
+*/
+typedef struct _evtimer_t {
+    _evloop_t *loop;
+    unsigned long long expires;
+    unsigned long long period;
+    void (*fn)(struct _evtimer_t *timer, void *arg);
+    void *arg;
+    struct _evtimer_t *next;
+    struct _evtimer_t **pprev;
+} _evtimer_t;
+
+/**
+ * __evloop_post - a call posted by _evloop_post.
+*/
+typedef struct __evloop_post {
+    void (*fn)(void *arg);
+    void *arg;
+    struct __evloop_post *next;
+} __evloop_post;
+
+/**
+ * _evloop_t - an event loop.
+ *
+ * @param epfd the epoll instance
+ * @param tfd the timerfd
+ * @param efd the eventfd of the posted calls
+ * @param stop set by _evloop_stop
+ * @param ios the file descriptors
+ * @param scan descriptors checked without epoll
+ *             (streams and regular files)
+ * @param dead descriptors to free after the batch
+ * @param batch number of the current batch
+ * @param wheel the timer wheel
+ * @param timers number of timers in the wheel
+ * @param start monotonic time of tick 0
+ * @param now last tick handled
+ * @param armed tick the timerfd is armed for, 0 if disarmed
+ * @param running the timer whose function runs
+ * @param cancelled 1 if the running timer was cancelled
+ * @param lock lock of the posted calls
+ * @param posts the posted calls
+ * @param last last posted call
+ * @param signalled 1 if the eventfd was written
+ * @param events the events of the batch
+*/
+struct _evloop_t {
+    int epfd;
+    int tfd;
+    int efd;
+    int stop;
+    _evio_t *ios;
+    int scan;
+    int dead;
+    unsigned long long batch;
+    _evtimer_t *wheel[__EVLOOP_LEVELS][__EVLOOP_SLOTS];
+    int timers;
+    unsigned long long start;
+    unsigned long long now;
+    unsigned long long armed;
+    _evtimer_t *running;
+    int cancelled;
+    _mutex_t lock;
+    __evloop_post *posts;
+    __evloop_post *last;
+    unsigned int signalled;
+    _epoll_event_t events[EVLOOP_BATCH];
+};
+
+/**
+ * Library functions:
+ *  @fn _evloop_create Create an event loop.
+ *  @fn _evloop_destroy Close the loop and free its descriptors and timers.
+ *  @fn _evloop_nonblock Make reads and writes of a file descriptor nonblocking.
+ *  @fn _evloop_add Wait for events of a file descriptor.
+ *  @fn _evloop_file Wait for events of a stream.
+ *  @fn _evloop_mod Change the events waited for.
+ *  @fn _evloop_del Stop waiting for a file descriptor.
+ *  @fn _evloop_timer Start a timer.
+ *  @fn _evloop_cancel Cancel a timer.
+ *  @fn _evloop_post Call a function in the loop, from any thread.
+ *  @fn _evloop_once Wait for one batch of events and dispatch it.
+ *  @fn _evloop_run Dispatch events until _evloop_stop.
+ *  @fn _evloop_stop Make _evloop_run return, from any thread.
+*/
+
+/**
+ * Create an event loop.
+ *
+ * @return the loop, or NULL on failure
+*/
+_evloop_t *_evloop_create(void) {
+    _evloop_t *loop = _malloc(sizeof(_evloop_t));
+    if (loop == NULL) return NULL;
+
+    _memset(loop, 0, sizeof(_evloop_t));
+
+    loop->epfd = sys_epoll_create1(_EPOLL_CLOEXEC);
+    loop->tfd = sys_timerfd_create(_CLOCK_MONOTONIC, _TFD_NONBLOCK | _TFD_CLOEXEC);
+    loop->efd = sys_eventfd2(0, _EFD_NONBLOCK | _EFD_CLOEXEC);
+
+    _epoll_event_t timer = { _EPOLLIN, __EVLOOP_TIMERFD };
+    _epoll_event_t event = { _EPOLLIN, __EVLOOP_EVENTFD };
+
+    if (loop->epfd < 0 || loop->tfd < 0 || loop->efd < 0
+        || sys_epoll_ctl(loop->epfd, _EPOLL_CTL_ADD, loop->tfd, &timer) < 0
+        || sys_epoll_ctl(loop->epfd, _EPOLL_CTL_ADD, loop->efd, &event) < 0) {
+        if (loop->epfd >= 0) sys_close(loop->epfd);
+        if (loop->tfd >= 0) sys_close(loop->tfd);
+        if (loop->efd >= 0) sys_close(loop->efd);
+
+        _free(loop);
+        return NULL;
+    }
+
+    loop->start = _monotonic_ns();
+
+    return loop;
+}
+
+/**
+ * Make reads and writes of a file descriptor
+ * nonblocking, they fail with EAGAIN instead
+ * of waiting.
+ *
+ * @param fd the file descriptor
+ * @return 0 on success, or an error code
+*/
+int _evloop_nonblock(int fd) {
+    int flags = sys_fcntl(fd, _F_GETFL, 0);
+    if (flags < 0) return flags;
+
+    if (flags & _O_NONBLOCK) return 0;
+
+    return sys_fcntl(fd, _F_SETFL, flags | _O_NONBLOCK);
+}
+
+/**
+ * Translate EVLOOP_* events to epoll events.
+ *
+ * @param events the events
+ * @return the epoll events
+*/
+unsigned int __evloop_epoll(int events) {
+    unsigned int epoll = 0;
+
+    if (events & EVLOOP_READ) epoll |= _EPOLLIN | _EPOLLRDHUP;
+    if (events & EVLOOP_WRITE) epoll |= _EPOLLOUT;
+
+    return epoll;
+}
+
+/**
+ * Register a file descriptor with the loop.
+ *
+ * @param loop the loop
+ * @param fd the file descriptor
+ * @param file the stream of the descriptor, or NULL
+ * @param events the events
+ * @param fn the function
+ * @param arg argument of fn
+ * @return the registration, or NULL on failure
+*/
+_evio_t *__evloop_add(_evloop_t *loop, int fd, _FILE *file, int events,
+                      void (*fn)(_evio_t *io, int events, void *arg), void *arg) {
+    _evio_t *io = _malloc(sizeof(_evio_t));
+    if (io == NULL) return NULL;
+
+    io->loop = loop;
+    io->fd = fd;
+    io->file = file;
+    io->events = events;
+    io->fn = fn;
+    io->arg = arg;
+    io->always = 0;
+    io->dead = 0;
+    io->batch = 0;
+
+    _epoll_event_t event = { __evloop_epoll(events), (unsigned long)io };
+    int ret = sys_epoll_ctl(loop->epfd, _EPOLL_CTL_ADD, fd, &event);
+
+    // regular files never block, so epoll does not take them
+    if (ret == -1) io->always = 1;
+    else if (ret < 0) {
+        _free(io);
+        return NULL;
+    }
+
+    if (io->always || file != NULL) loop->scan++;
+
+    io->next = loop->ios;
+    loop->ios = io;
+
+    return io;
+}
+
+/**
+ * Wait for events of a file descriptor.
+ *
+ * The function is called in the loop whenever the
+ * descriptor is ready (level-triggered), with the
+ * events ready. It should read or write until the
+ * descriptor would block, or the loop calls it again
+ * right away.
+ *
+ * Example usage:
+ *  _evloop_add(loop, pipe[0], EVLOOP_READ, on_read, &state);
+ *
+ * @param loop the loop
+ * @param fd the file descriptor
+ * @param events EVLOOP_READ, EVLOOP_WRITE or both
+ * @param fn the function
+ * @param arg argument of fn
+ * @return the registration, or NULL on failure
+*/
+_evio_t *_evloop_add(_evloop_t *loop, int fd, int events,
+                     void (*fn)(_evio_t *io, int events, void *arg), void *arg) {
+    return __evloop_add(loop, fd, NULL, events, fn, arg);
+}
+
+/**
+ * Wait for events of a stream.
+ *
+ * Like _evloop_add with the descriptor of the stream,
+ * but a stream with data in its buffer is ready for
+ * reading.
+ *
+ * @param loop the loop
+ * @param file the stream
+ * @param events EVLOOP_READ, EVLOOP_WRITE or both
+ * @param fn the function
+ * @param arg argument of fn
+ * @return the registration, or NULL on failure
+*/
+_evio_t *_evloop_file(_evloop_t *loop, _FILE *file, int events,
+                      void (*fn)(_evio_t *io, int events, void *arg), void *arg) {
+    return __evloop_add(loop, file->fd, file, events, fn, arg);
+}
+
+/**
+ * Change the events waited for.
+ *
+ * @param io the registration
+ * @param events EVLOOP_READ, EVLOOP_WRITE, both or 0
+ * @return 0 on success, or an error code
+*/
+int _evloop_mod(_evio_t *io, int events) {
+    io->events = events;
+
+    if (io->always) return 0;
+
+    _epoll_event_t event = { __evloop_epoll(events), (unsigned long)io };
+
+    return sys_epoll_ctl(io->loop->epfd, _EPOLL_CTL_MOD, io->fd, &event);
+}
+
+/**
+ * Stop waiting for a file descriptor.
+ *
+ * The descriptor is not closed. The registration is
+ * freed after the current batch, so the function may
+ * be called from any callback.
+ *
+ * @param io the registration
+*/
+void _evloop_del(_evio_t *io) {
+    if (io->dead) return;
+
+    if (!io->always) sys_epoll_ctl(io->loop->epfd, _EPOLL_CTL_DEL, io->fd, NULL);
+
+    io->dead = 1;
+    io->loop->dead++;
+}
+
+/**
+ * Put a timer into the slot of its expiration.
+ *
+ * @param loop the loop
+ * @param timer the timer
+*/
+void __evloop_insert(_evloop_t *loop, _evtimer_t *timer) {
+    unsigned long long expires = timer->expires;
+    unsigned long long delta = expires - loop->now;
+    int level = 0;
+
+    // expired timers go to the next tick
+    if ((long long)delta <= 0) {
+        expires = loop->now + 1;
+        delta = 1;
+    }
+
+    while (level < __EVLOOP_LEVELS - 1 && delta >> (__EVLOOP_BITS * (level + 1))) level++;
+
+    // beyond the wheel, moved down again when the last level turns
+    if (delta >> (__EVLOOP_BITS * __EVLOOP_LEVELS)) {
+        expires = loop->now + (1ULL << (__EVLOOP_BITS * __EVLOOP_LEVELS)) - 1;
+    }
+
+    _evtimer_t **slot = &loop->wheel[level][(expires >> (__EVLOOP_BITS * level)) & (__EVLOOP_SLOTS - 1)];
+
+    timer->next = *slot;
+    timer->pprev = slot;
+    if (*slot != NULL) (*slot)->pprev = &timer->next;
+    *slot = timer;
+}
+
+/**
+ * Take a timer out of its slot.
+ *
+ * @param timer the timer
+*/
+void __evloop_unlink(_evtimer_t *timer) {
+    *timer->pprev = timer->next;
+    if (timer->next != NULL) timer->next->pprev = timer->pprev;
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+}
+
+/**
+ * Arm the timerfd for the next tick with a timer,
+ * or disarm it.
+ *
+ * The next tick is the first timer of the first level,
+ * or the first turn of a higher level which moves down
+ * a slot with timers, whichever comes first. Empty
+ * slots do not wake up the loop, so a long timer costs
+ * one wakeup per level instead of one per turn.
+ *
+ * @param loop the loop
+*/
+void __evloop_arm(_evloop_t *loop) {
+    unsigned long long next = 0;
+
+    if (loop->timers > 0) {
+        for (unsigned long long tick = loop->now + 1; tick <= loop->now + __EVLOOP_SLOTS; tick++) {
+            if (loop->wheel[0][tick & (__EVLOOP_SLOTS - 1)] != NULL) {
+                next = tick;
+                break;
+            }
+        }
+
+        for (int level = 1; level < __EVLOOP_LEVELS; level++) {
+            int shift = __EVLOOP_BITS * level;
+
+            // the turns of the level after now, one per slot
+            for (unsigned long long turn = (loop->now >> shift) + 1; turn <= (loop->now >> shift) + __EVLOOP_SLOTS; turn++) {
+                unsigned long long tick = turn << shift;
+
+                if (next != 0 && tick >= next) break;
+                if (loop->wheel[level][turn & (__EVLOOP_SLOTS - 1)] == NULL) continue;
+
+                next = tick;
+                break;
+            }
+        }
+    }
+
+    if (next == loop->armed) return;
+    loop->armed = next;
+
+    // interval and expiration, zero disarms
+    _timespec spec[2] = { { 0, 0 }, { 0, 0 } };
+
+    if (next != 0) {
+        unsigned long long time = loop->start + next * EVLOOP_TICK_NS;
+
+        spec[1].tv_sec = (_time_t)(time / 1000000000ULL);
+        spec[1].tv_nsec = (long)(time % 1000000000ULL);
+    }
+
+    sys_timerfd_settime(loop->tfd, _TFD_TIMER_ABSTIME, spec, NULL);
+}
+
+/**
+ * Start a timer.
+ *
+ * The function is called in the loop after the delay,
+ * rounded up to EVLOOP_TICK_NS, and then every period
+ * if it is not 0.
+ *
+ * A one-shot timer is freed after its function
+ * returns, a periodic timer by _evloop_cancel.
+ *
+ * Example usage:
+ *  _evtimer_t *tick = _evloop_timer(loop, 0, 100000000ULL, on_tick, NULL);
+ *
+ * @param loop the loop
+ * @param delay_ns delay of the first call in nanoseconds
+ * @param period_ns period of the calls in nanoseconds, 0 for one call
+ * @param fn the function
+ * @param arg argument of fn
+ * @return the timer, or NULL on failure
+*/
+_evtimer_t *_evloop_timer(_evloop_t *loop, unsigned long long delay_ns, unsigned long long period_ns,
+                          void (*fn)(_evtimer_t *timer, void *arg), void *arg) {
+    _evtimer_t *timer = _malloc(sizeof(_evtimer_t));
+    if (timer == NULL) return NULL;
+
+    unsigned long long time = _monotonic_ns() - loop->start;
+    unsigned long long tick = time / EVLOOP_TICK_NS;
+
+    // an empty wheel can skip the ticks nobody waited for
+    if (loop->timers == 0 && loop->running == NULL) loop->now = tick;
+
+    // the first tick at or after the delay
+    timer->loop = loop;
+    timer->expires = (time + delay_ns + EVLOOP_TICK_NS - 1) / EVLOOP_TICK_NS;
+    timer->period = (period_ns + EVLOOP_TICK_NS - 1) / EVLOOP_TICK_NS;
+    timer->fn = fn;
+    timer->arg = arg;
+
+    if (timer->expires <= tick) timer->expires = tick + 1;
+    if (period_ns != 0 && timer->period == 0) timer->period = 1;
+
+    __evloop_insert(loop, timer);
+    loop->timers++;
+
+    if (loop->running == NULL) __evloop_arm(loop);
+
+    return timer;
+}
+
+/**
+ * Cancel a timer.
+ *
+ * A periodic timer may cancel itself from its function.
+ *
+ * @param timer a pending timer
+*/
+void _evloop_cancel(_evtimer_t *timer) {
+    _evloop_t *loop = timer->loop;
+
+    if (timer == loop->running) {
+        loop->cancelled = 1;
+        return;
+    }
+
+    __evloop_unlink(timer);
+    loop->timers--;
+    _free(timer);
+}
+
+/**
+ * Advance the timer wheel to the current time,
+ * calling the functions of the expired timers.
+ *
+ * @param loop the loop
+*/
+void __evloop_expire(_evloop_t *loop) {
+    unsigned long long tick = (_monotonic_ns() - loop->start) / EVLOOP_TICK_NS;
+
+    while (loop->now < tick && loop->timers > 0) {
+        loop->now++;
+
+        // a level turned: move down the timers of the next level
+        for (int level = 1; level < __EVLOOP_LEVELS; level++) {
+            if (loop->now & ((1ULL << (__EVLOOP_BITS * level)) - 1)) break;
+
+            _evtimer_t **slot = &loop->wheel[level][(loop->now >> (__EVLOOP_BITS * level)) & (__EVLOOP_SLOTS - 1)];
+            _evtimer_t *timer = *slot;
+
+            *slot = NULL;
+
+            while (timer != NULL) {
+                _evtimer_t *next = timer->next;
+
+                __evloop_insert(loop, timer);
+                timer = next;
+            }
+        }
+
+        // detach the slot, the functions may cancel the timers in it
+        _evtimer_t *due = loop->wheel[0][loop->now & (__EVLOOP_SLOTS - 1)];
+
+        loop->wheel[0][loop->now & (__EVLOOP_SLOTS - 1)] = NULL;
+        if (due != NULL) due->pprev = &due;
+
+        while (due != NULL) {
+            _evtimer_t *timer = due;
+
+            __evloop_unlink(timer);
+
+            // clamped to the end of the wheel, not due yet
+            if (timer->expires > loop->now) {
+                __evloop_insert(loop, timer);
+                continue;
+            }
+
+            loop->running = timer;
+            loop->cancelled = 0;
+
+            timer->fn(timer, timer->arg);
+
+            loop->running = NULL;
+
+            if (timer->period != 0 && !loop->cancelled) {
+                timer->expires += timer->period;
+                __evloop_insert(loop, timer);
+            }
+            else {
+                loop->timers--;
+                _free(timer);
+            }
+        }
+    }
+
+    if (loop->timers == 0) loop->now = tick;
+
+    __evloop_arm(loop);
+}
+
+/**
+ * Call a function in the loop.
+ *
+ * The only function of a loop which other threads
+ * may call. The calls run in the order they were
+ * posted, after the events of the next batch.
+ *
+ * Example usage:
+ *  _evloop_post(loop, on_result, result);
+ *
+ * @param loop the loop
+ * @param fn the function, NULL only wakes up the loop
+ * @param arg argument of fn
+ * @return 0 on success, -1 on failure
+*/
+int _evloop_post(_evloop_t *loop, void (*fn)(void *arg), void *arg) {
+    if (fn != NULL) {
+        __evloop_post *post = _malloc(sizeof(__evloop_post));
+        if (post == NULL) return -1;
+
+        post->fn = fn;
+        post->arg = arg;
+        post->next = NULL;
+
+        _mutex_lock(&loop->lock);
+
+        if (loop->last != NULL) loop->last->next = post;
+        else loop->posts = post;
+        loop->last = post;
+
+        _mutex_unlock(&loop->lock);
+    }
+
+    // one write wakes up the loop however many calls were posted
+    if (__atomic_exchange_n(&loop->signalled, 1, __ATOMIC_ACQ_REL) == 0) {
+        unsigned long long one = 1;
+
+        sys_write(loop->efd, (const char *)&one, sizeof(one));
+    }
+
+    return 0;
+}
+
+/**
+ * Run the posted calls.
+ *
+ * @param loop the loop
+*/
+void __evloop_posts(_evloop_t *loop) {
+    unsigned long long count;
+
+    sys_read(loop->efd, (char *)&count, sizeof(count));
+    __atomic_store_n(&loop->signalled, 0, __ATOMIC_RELEASE);
+
+    _mutex_lock(&loop->lock);
+
+    __evloop_post *post = loop->posts;
+
+    loop->posts = NULL;
+    loop->last = NULL;
+
+    _mutex_unlock(&loop->lock);
+
+    while (post != NULL) {
+        __evloop_post *next = post->next;
+
+        post->fn(post->arg);
+        _free(post);
+        post = next;
+    }
+}
+
+/**
+ * Call the function of a file descriptor.
+ *
+ * @param io the registration
+ * @param events the ready events
+*/
+void __evloop_dispatch(_evio_t *io, int events) {
+    if (io->dead || io->batch == io->loop->batch) return;
+
+    events &= io->events | EVLOOP_ERROR;
+    if (events == 0) return;
+
+    io->batch = io->loop->batch;
+    io->fn(io, events, io->arg);
+}
+
+/**
+ * Tell whether a file descriptor is ready without
+ * asking epoll: a regular file, or a stream with
+ * data in its buffer.
+ *
+ * @param io the registration
+ * @return the ready events
+*/
+int __evloop_ready(_evio_t *io) {
+    if (io->dead) return 0;
+    if (io->always) return io->events;
+
+    _FILE *file = io->file;
+
+    if (file != NULL && file->buffer_pos < file->buffer_len) return io->events & EVLOOP_READ;
+
+    return 0;
+}
+
+/**
+ * Wait for one batch of events and dispatch it.
+ *
+ * Calls the functions of the ready descriptors, then
+ * of the expired timers, then the posted calls.
+ *
+ * @param loop the loop
+ * @param timeout_ns longest wait in nanoseconds, -1 to
+ *                   wait until something happens
+ * @return number of ready descriptors, or an error code
+*/
+int _evloop_once(_evloop_t *loop, long long timeout_ns) {
+    int timeout = timeout_ns < 0 ? -1 : (int)((timeout_ns + 999999) / 1000000);
+    int ready = 0;
+
+    // descriptors ready without epoll do not let it sleep
+    if (loop->scan > 0) {
+        for (_evio_t *io = loop->ios; io != NULL; io = io->next) {
+            if (__evloop_ready(io)) {
+                timeout = 0;
+                break;
+            }
+        }
+    }
+
+    int count = sys_epoll_wait(loop->epfd, loop->events, EVLOOP_BATCH, timeout);
+
+    if (count < 0 && count != -4) return count;   // EINTR
+    if (count < 0) count = 0;
+
+    int posted = 0;
+
+    loop->batch++;
+
+    for (int i = 0; i < count; i++) {
+        unsigned long long data = loop->events[i].data;
+        unsigned int epoll = loop->events[i].events;
+
+        if (data == __EVLOOP_TIMERFD) {
+            unsigned long long expirations;
+
+            sys_read(loop->tfd, (char *)&expirations, sizeof(expirations));
+            continue;
+        }
+
+        if (data == __EVLOOP_EVENTFD) {
+            posted = 1;
+            continue;
+        }
+
+        int events = 0;
+
+        if (epoll & (_EPOLLIN | _EPOLLRDHUP)) events |= EVLOOP_READ;
+        if (epoll & _EPOLLOUT) events |= EVLOOP_WRITE;
+
+        // errors wake up the reader and the writer, they see them in their next call
+        if (epoll & (_EPOLLERR | _EPOLLHUP)) events |= EVLOOP_ERROR | EVLOOP_READ | EVLOOP_WRITE;
+
+        __evloop_dispatch((_evio_t *)(unsigned long)data, events);
+        ready++;
+    }
+
+    if (loop->scan > 0) {
+        for (_evio_t *io = loop->ios; io != NULL; io = io->next) {
+            int events = __evloop_ready(io);
+
+            if (events && io->batch != loop->batch) {
+                __evloop_dispatch(io, events);
+                ready++;
+            }
+        }
+    }
+
+    __evloop_expire(loop);
+
+    if (posted) __evloop_posts(loop);
+
+    // free the descriptors deleted in the batch
+    if (loop->dead > 0) {
+        _evio_t **link = &loop->ios;
+
+        while (*link != NULL) {
+            _evio_t *io = *link;
+
+            if (!io->dead) {
+                link = &io->next;
+                continue;
+            }
+
+            if (io->always || io->file != NULL) loop->scan--;
+
+            *link = io->next;
+            _free(io);
+        }
+
+        loop->dead = 0;
+    }
+
+    return ready;
+}
+
+/**
+ * Dispatch events until _evloop_stop.
+ *
+ * @param loop the loop
+ * @return 0 when stopped, or an error code of epoll_wait
+*/
+int _evloop_run(_evloop_t *loop) {
+    while (!__atomic_load_n(&loop->stop, __ATOMIC_ACQUIRE)) {
+        int ret = _evloop_once(loop, -1);
+
+        if (ret < 0) return ret;
+    }
+
+    __atomic_store_n(&loop->stop, 0, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+/**
+ * Make _evloop_run return after the current batch.
+ *
+ * May be called from any thread.
+ *
+ * @param loop the loop
+*/
+void _evloop_stop(_evloop_t *loop) {
+    __atomic_store_n(&loop->stop, 1, __ATOMIC_RELEASE);
+
+    _evloop_post(loop, NULL, NULL);
+}
+
+/**
+ * Close the loop and free its descriptors, timers
+ * and posted calls.
+ *
+ * The file descriptors waited for are not closed.
+ *
+ * @param loop the loop
+*/
+void _evloop_destroy(_evloop_t *loop) {
+    for (_evio_t *io = loop->ios; io != NULL; ) {
+        _evio_t *next = io->next;
+
+        _free(io);
+        io = next;
+    }
+
+    for (int level = 0; level < __EVLOOP_LEVELS; level++) {
+        for (int slot = 0; slot < __EVLOOP_SLOTS; slot++) {
+            for (_evtimer_t *timer = loop->wheel[level][slot]; timer != NULL; ) {
+                _evtimer_t *next = timer->next;
+
+                _free(timer);
+                timer = next;
+            }
+        }
+    }
+
+    for (__evloop_post *post = loop->posts; post != NULL; ) {
+        __evloop_post *next = post->next;
+
+        _free(post);
+        post = next;
+    }
+
+    sys_close(loop->epfd);
+    sys_close(loop->tfd);
+    sys_close(loop->efd);
+
+    _free(loop);
+}
+
+#endif // __EVLOOP_H__
@@ -0,0 +1,545 @@
+/**
+ * _hash.h - Fast non-cryptographic hashing.
+ *
+ * The hashes are built on 64-bit multiplications
+ * whose 128-bit product is folded into 64 bits:
+ *
+ * - short inputs (up to HASH_SHORT bytes) - 16 bytes per
+ *   multiplication in three independent lanes (wyhash),
+ *   inputs under 16 bytes are read with two overlapping
+ *   loads, never byte by byte
+ * - long inputs - 64-byte stripes added into eight 64-bit
+ *   accumulators with 32x32-bit multiplications, which
+ *   map to SIMD lanes (XXH3): an AVX2 loop runs where
+ *   the CPU has it, a scalar loop elsewhere
+ *
+ * Both loops compute the same value, a hash depends only
+ * on the data, the seed and the byte order, never on the
+ * CPU it was computed on. The hashes are not fit for
+ * cryptography, or for tables whose keys come from an
+ * attacker who knows the seed.
+ *
+ * Data arriving in chunks (e.g. from _fread) is hashed
+ * with a _hash_state_t, giving the same value as hashing
+ * all of it at once.
+ *
+ * Example usage:
+ *  unsigned long long h = _memhash(block, size, 0);
+ *
+ *  _hash_state_t state;
+ *  _hash_init(&state, 0);
+ *  while ((n = _fread(buffer, 1, sizeof(buffer), file)) > 0) _hash_update(&state, buffer, n);
+ *  h = _hash_digest(&state);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __HASH_H__
+#define __HASH_H__
+
+#include <_string.h>
+#include <_cpu.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/**
+ * HASH_SHORT - Longest input hashed with the short hash.
+ *
+ * HASH_STRIPE - Bytes added to the accumulators in one step.
+ *
+ * HASH_BLOCK - Stripes between two scrambles of the accumulators.
+*/
+#define HASH_SHORT   256
+#define HASH_STRIPE  64
+#define HASH_BLOCK   16
+
+/**
+ * Primes of the accumulators (the primes of xxHash).
+*/
+#define __HASH_P32_1 0x9E3779B1U
+#define __HASH_P32_2 0x85EBCA77U
+#define __HASH_P32_3 0xC2B2AE3DU
+#define __HASH_P64_1 0x9E3779B185EBCA87ULL
+#define __HASH_P64_2 0xC2B2AE3D27D4EB4FULL
+#define __HASH_P64_3 0x165667B19E3779F9ULL
+#define __HASH_P64_4 0x85EBCA77C2B2AE63ULL
+#define __HASH_P64_5 0x27D4EB2F165667C5ULL
+
+/**
+ * __HASH_KEYS - Number of key words of the long hash.
+ *
+ * Stripe i of a block takes words i to i + 7, the
+ * scramble words 16 to 23.
+*/
+#define __HASH_KEYS 24
+
+const unsigned long long __hash_secret[__HASH_KEYS] = {
+    0x2CB0F69F4ABEA221ULL, 0x9417034723148989ULL, 0xDD555950609DFE03ULL,
+    0xDBAFB150DEB12800ULL, 0x7E789B2E6C442CB6ULL, 0xF41E5636C7E4F8C4ULL,
+    0x0959D150F8FBA7E4ULL, 0xA97316F13CDB9EEAULL, 0x74CD8258F9520068ULL,
+    0x55C74A62E116868BULL, 0xD2F4C799A2023CBDULL, 0xDF98CB79A37B51B9ULL,
+    0x396F5885524F3905ULL, 0xAF1D56386CA3B276ULL, 0xA9FFBE6B5104E85AULL,
+    0x6BD0C51B9FD533B3ULL, 0x980CE91C50AB4B56ULL, 0x28AC395780FE62C5ULL,
+    0x768912E3A6BCEDC7ULL, 0x50B3E8C9332C7C88ULL, 0xCE3BBFE520BD47DAULL,
+    0xCBA6C8E8E0BB7C4FULL, 0xBF194DB8434A346DULL, 0x7D8F2A7B60416D7FULL,
+};
+
+/**
+ * _hash_state_t - state of a hash of data arriving in chunks.
+ *
+ * @param acc the accumulators
+ * @param key the key words, made from the seed
+ * @param buffer data not added yet
+ * @param last the last stripe added, for the final stripe
+ * @param seed the seed
+ * @param total number of bytes hashed
+ * @param buffered number of bytes in the buffer
+ * @param stripe stripe of the block added next
+*/
+typedef struct {
+    unsigned long long acc[8];
+    unsigned long long key[__HASH_KEYS];
+    unsigned char buffer[HASH_SHORT];
+    unsigned char last[HASH_STRIPE];
+    unsigned long long seed;
+    _size_t total;
+    unsigned int buffered;
+    unsigned int stripe;
+} _hash_state_t;
+
+/**
+ * Library functions:
+ *  @fn _memhash Hash a block of memory.
+ *  @fn _strhash Hash a string.
+ *  @fn _hash_u64 Hash a 64-bit integer.
+ *  @fn _hash_init Start a hash of data arriving in chunks.
+ *  @fn _hash_update Hash a chunk of data.
+ *  @fn _hash_digest Get the hash of the chunks.
+*/
+
+/**
+ * __hash_u64_u - 8 bytes at any address.
+*/
+typedef unsigned long long __attribute__((aligned(1), may_alias)) __hash_u64_u;
+typedef unsigned int __attribute__((aligned(1), may_alias)) __hash_u32_u;
+
+#define __HASH_READ64(p) (*(const __hash_u64_u *)(p))
+#define __HASH_READ32(p) (*(const __hash_u32_u *)(p))
+
+/**
+ * Multiply two 64-bit numbers into 128 bits.
+ *
+ * @param a first number, replaced by the low half
+ * @param b second number, replaced by the high half
+*/
+void __hash_mum(unsigned long long *a, unsigned long long *b) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)*a * *b;
+
+    *a = (unsigned long long)r;
+    *b = (unsigned long long)(r >> 64);
+#else
+    unsigned long long a_lo = *a & 0xFFFFFFFF, a_hi = *a >> 32;
+    unsigned long long b_lo = *b & 0xFFFFFFFF, b_hi = *b >> 32;
+    unsigned long long lo_lo = a_lo * b_lo;
+    unsigned long long hi_lo = a_hi * b_lo;
+    unsigned long long cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + a_lo * b_hi;
+
+    *b = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    *a = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+}
+
+/**
+ * Multiply two 64-bit numbers and fold the
+ * halves of the product into one.
+ *
+ * @param a first number
+ * @param b second number
+ * @return low half xor high half of the product
+*/
+unsigned long long __hash_mix(unsigned long long a, unsigned long long b) {
+    __hash_mum(&a, &b);
+    return a ^ b;
+}
+
+/**
+ * Hash a short block of memory (wyhash).
+ *
+ * @param p the memory
+ * @param len size of the memory
+ * @param seed the seed
+ * @return the hash
+*/
+unsigned long long __hash_short(const unsigned char *p, _size_t len, unsigned long long seed) {
+    const unsigned long long *s = __hash_secret;
+    unsigned long long a, b;
+
+    seed ^= __hash_mix(seed ^ s[0], s[1]);
+
+    if (len <= 16) {
+        if (len >= 4) {
+            _size_t mid = (len >> 3) << 2;
+
+            a = ((unsigned long long)__HASH_READ32(p) << 32) | __HASH_READ32(p + mid);
+            b = ((unsigned long long)__HASH_READ32(p + len - 4) << 32) | __HASH_READ32(p + len - 4 - mid);
+        } else if (len > 0) {
+            a = ((unsigned long long)p[0] << 16) | ((unsigned long long)p[len >> 1] << 8) | p[len - 1];
+            b = 0;
+        } else a = b = 0;
+    } else {
+        _size_t left = len;
+
+        if (left > 48) {
+            unsigned long long see1 = seed, see2 = seed;
+
+            do {
+                seed = __hash_mix(__HASH_READ64(p) ^ s[1], __HASH_READ64(p + 8) ^ seed);
+                see1 = __hash_mix(__HASH_READ64(p + 16) ^ s[2], __HASH_READ64(p + 24) ^ see1);
+                see2 = __hash_mix(__HASH_READ64(p + 32) ^ s[3], __HASH_READ64(p + 40) ^ see2);
+                p += 48;
+                left -= 48;
+            } while (left > 48);
+
+            seed ^= see1 ^ see2;
+        }
+
+        while (left > 16) {
+            seed = __hash_mix(__HASH_READ64(p) ^ s[1], __HASH_READ64(p + 8) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+
+        a = __HASH_READ64(p + left - 16);
+        b = __HASH_READ64(p + left - 8);
+    }
+
+    a ^= s[1];
+    b ^= seed;
+    __hash_mum(&a, &b);
+
+    return __hash_mix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+/**
+ * Make the key words of the long hash from a seed.
+ *
+ * @param key where to store the words
+ * @param seed the seed
+*/
+void __hash_key(unsigned long long key[__HASH_KEYS], unsigned long long seed) {
+    for (int i = 0; i < __HASH_KEYS; i += 2) {
+        key[i] = __hash_secret[i] + seed;
+        key[i + 1] = __hash_secret[i + 1] - seed;
+    }
+}
+
+/**
+ * Set the accumulators to their starting values.
+ *
+ * @param acc the accumulators
+*/
+void __hash_acc_init(unsigned long long acc[8]) {
+    acc[0] = __HASH_P32_3;
+    acc[1] = __HASH_P64_1;
+    acc[2] = __HASH_P64_2;
+    acc[3] = __HASH_P64_3;
+    acc[4] = __HASH_P64_4;
+    acc[5] = __HASH_P32_2;
+    acc[6] = __HASH_P64_5;
+    acc[7] = __HASH_P32_1;
+}
+
+/**
+ * Add a stripe to the accumulators.
+ *
+ * Every word is added to the neighbouring accumulator,
+ * and the product of its halves, mixed with the key,
+ * to its own.
+ *
+ * @param acc the accumulators
+ * @param p the stripe
+ * @param key the key words of the stripe
+*/
+void __hash_stripe(unsigned long long acc[8], const unsigned char *p, const unsigned long long *key) {
+    for (int i = 0; i < 8; i++) {
+        unsigned long long data = __HASH_READ64(p + 8 * i);
+        unsigned long long mixed = data ^ key[i];
+
+        acc[i ^ 1] += data;
+        acc[i] += (mixed & 0xFFFFFFFF) * (mixed >> 32);
+    }
+}
+
+/**
+ * Scramble the accumulators at the end of a block.
+ *
+ * @param acc the accumulators
+ * @param key the key words of the scramble
+*/
+void __hash_scramble(unsigned long long acc[8], const unsigned long long *key) {
+    for (int i = 0; i < 8; i++) {
+        unsigned long long a = acc[i];
+
+        a ^= a >> 47;
+        a ^= key[i];
+        acc[i] = a * __HASH_P32_1;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+
+/**
+ * Add stripes to the accumulators, with AVX2.
+ *
+ * The same steps as __hash_stripe and __hash_scramble,
+ * four accumulators in a register.
+*/
+__attribute__((target("avx2")))
+void __hash_consume_avx2(unsigned long long acc[8], const unsigned char *p, _size_t stripes,
+                         unsigned int *stripe, const unsigned long long *key) {
+    __m256i acc0 = _mm256_loadu_si256((const __m256i *)acc);
+    __m256i acc1 = _mm256_loadu_si256((const __m256i *)(acc + 4));
+    __m256i prime = _mm256_set1_epi32((int)__HASH_P32_1);
+    unsigned int s = *stripe;
+
+    for (; stripes > 0; stripes--, p += HASH_STRIPE) {
+        __m256i data0 = _mm256_loadu_si256((const __m256i *)p);
+        __m256i data1 = _mm256_loadu_si256((const __m256i *)(p + 32));
+        __m256i mixed0 = _mm256_xor_si256(data0, _mm256_loadu_si256((const __m256i *)(key + s)));
+        __m256i mixed1 = _mm256_xor_si256(data1, _mm256_loadu_si256((const __m256i *)(key + s + 4)));
+
+        // the words swapped in pairs, for the neighbouring accumulators
+        acc0 = _mm256_add_epi64(acc0, _mm256_shuffle_epi32(data0, 0x4E));
+        acc1 = _mm256_add_epi64(acc1, _mm256_shuffle_epi32(data1, 0x4E));
+        acc0 = _mm256_add_epi64(acc0, _mm256_mul_epu32(mixed0, _mm256_srli_epi64(mixed0, 32)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_mul_epu32(mixed1, _mm256_srli_epi64(mixed1, 32)));
+
+        if (++s == HASH_BLOCK) {
+            __m256i a0 = _mm256_xor_si256(acc0, _mm256_srli_epi64(acc0, 47));
+            __m256i a1 = _mm256_xor_si256(acc1, _mm256_srli_epi64(acc1, 47));
+
+            a0 = _mm256_xor_si256(a0, _mm256_loadu_si256((const __m256i *)(key + 16)));
+            a1 = _mm256_xor_si256(a1, _mm256_loadu_si256((const __m256i *)(key + 20)));
+
+            // 64x32-bit products, from the two halves
+            acc0 = _mm256_add_epi64(_mm256_mul_epu32(a0, prime),
+                                    _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a0, 32), prime), 32));
+            acc1 = _mm256_add_epi64(_mm256_mul_epu32(a1, prime),
+                                    _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a1, 32), prime), 32));
+            s = 0;
+        }
+    }
+
+    _mm256_storeu_si256((__m256i *)acc, acc0);
+    _mm256_storeu_si256((__m256i *)(acc + 4), acc1);
+    *stripe = s;
+}
+
+#endif
+
+/**
+ * Add stripes to the accumulators.
+ *
+ * @param acc the accumulators
+ * @param p the stripes
+ * @param stripes number of stripes
+ * @param stripe stripe of the block added next, updated
+ * @param key the key words
+*/
+void __hash_consume(unsigned long long acc[8], const unsigned char *p, _size_t stripes,
+                    unsigned int *stripe, const unsigned long long *key) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (_cpu_has(CPU_AVX2)) {
+        __hash_consume_avx2(acc, p, stripes, stripe, key);
+        return;
+    }
+#endif
+
+    for (; stripes > 0; stripes--, p += HASH_STRIPE) {
+        __hash_stripe(acc, p, key + *stripe);
+
+        if (++*stripe == HASH_BLOCK) {
+            __hash_scramble(acc, key + 16);
+            *stripe = 0;
+        }
+    }
+}
+
+/**
+ * Merge the accumulators into the hash.
+ *
+ * @param acc the accumulators
+ * @param last the last 64 bytes of the data
+ * @param len size of the data
+ * @param key the key words
+ * @return the hash
+*/
+unsigned long long __hash_merge(unsigned long long acc[8], const unsigned char *last, _size_t len,
+                                const unsigned long long *key) {
+    unsigned long long h = len * __HASH_P64_1;
+
+    __hash_stripe(acc, last, key + 9);
+
+    for (int i = 0; i < 4; i++) h += __hash_mix(acc[2 * i] ^ key[2 * i + 3], acc[2 * i + 1] ^ key[2 * i + 4]);
+
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ULL;
+    return h ^ (h >> 32);
+}
+
+/**
+ * Hash a block of memory.
+ *
+ * Example usage:
+ *  unsigned long long h = _memhash(&point, sizeof(point), 0);
+ *
+ * @param data the memory
+ * @param len size of the memory
+ * @param seed the seed, different seeds give unrelated hashes
+ * @return the hash
+*/
+unsigned long long _memhash(const void *data, _size_t len, unsigned long long seed) {
+    const unsigned char *p = (const unsigned char *)data;
+
+    if (len <= HASH_SHORT) return __hash_short(p, len, seed);
+
+    unsigned long long acc[8];
+    unsigned long long key[__HASH_KEYS];
+    unsigned int stripe = 0;
+
+    __hash_key(key, seed);
+    __hash_acc_init(acc);
+
+    // the stripe with the last byte is left for __hash_merge
+    __hash_consume(acc, p, (len - 1) / HASH_STRIPE, &stripe, key);
+
+    return __hash_merge(acc, p + len - HASH_STRIPE, len, key);
+}
+
+/**
+ * Hash a string.
+ *
+ * @param str the string
+ * @param seed the seed
+ * @return the hash, the same as _memhash of the
+ *         characters without the terminator
+*/
+unsigned long long _strhash(const char *str, unsigned long long seed) {
+    return _memhash(str, _strlen(str), seed);
+}
+
+/**
+ * Hash a 64-bit integer.
+ *
+ * Cheaper than _memhash of the 8 bytes, for hash
+ * tables with integer keys.
+ *
+ * @param x the integer
+ * @param seed the seed
+ * @return the hash
+*/
+unsigned long long _hash_u64(unsigned long long x, unsigned long long seed) {
+    return __hash_mix(x ^ __hash_secret[0] ^ seed, __hash_secret[1]);
+}
+
+/**
+ * Start a hash of data arriving in chunks.
+ *
+ * @param state the state
+ * @param seed the seed
+*/
+void _hash_init(_hash_state_t *state, unsigned long long seed) {
+    __hash_key(state->key, seed);
+    __hash_acc_init(state->acc);
+
+    state->seed = seed;
+    state->total = 0;
+    state->buffered = 0;
+    state->stripe = 0;
+}
+
+/**
+ * Hash a chunk of data.
+ *
+ * Stripes are added only once more data is known
+ * to follow them, the data is copied only while
+ * the chunks are shorter than the buffer.
+ *
+ * @param state the state
+ * @param data the chunk
+ * @param len size of the chunk
+*/
+void _hash_update(_hash_state_t *state, const void *data, _size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+
+    state->total += len;
+
+    if (state->buffered + len <= HASH_SHORT) {
+        _memcpy(state->buffer + state->buffered, p, len);
+        state->buffered += len;
+        return;
+    }
+
+    if (state->buffered > 0) {
+        _size_t fill = HASH_SHORT - state->buffered;
+
+        _memcpy(state->buffer + state->buffered, p, fill);
+        p += fill;
+        len -= fill;
+
+        __hash_consume(state->acc, state->buffer, HASH_SHORT / HASH_STRIPE, &state->stripe, state->key);
+        _memcpy(state->last, state->buffer + HASH_SHORT - HASH_STRIPE, HASH_STRIPE);
+        state->buffered = 0;
+    }
+
+    if (len > HASH_SHORT) {
+        _size_t stripes = (len - 1) / HASH_SHORT * (HASH_SHORT / HASH_STRIPE);
+
+        __hash_consume(state->acc, p, stripes, &state->stripe, state->key);
+        p += stripes * HASH_STRIPE;
+        len -= stripes * HASH_STRIPE;
+
+        _memcpy(state->last, p - HASH_STRIPE, HASH_STRIPE);
+    }
+
+    _memcpy(state->buffer, p, len);
+    state->buffered = len;
+}
+
+/**
+ * Get the hash of the chunks.
+ *
+ * The state is not changed, more chunks can follow.
+ *
+ * @param state the state
+ * @return the hash of all chunks so far, the same as
+ *         _memhash of them joined together
+*/
+unsigned long long _hash_digest(const _hash_state_t *state) {
+    if (state->total <= HASH_SHORT) return __hash_short(state->buffer, state->total, state->seed);
+
+    unsigned long long acc[8];
+    unsigned char last[HASH_STRIPE];
+    unsigned int stripe = state->stripe;
+
+    _memcpy(acc, state->acc, sizeof(acc));
+    __hash_consume(acc, state->buffer, (state->buffered - 1) / HASH_STRIPE, &stripe, state->key);
+
+    if (state->buffered >= HASH_STRIPE)
+        return __hash_merge(acc, state->buffer + state->buffered - HASH_STRIPE, state->total, state->key);
+
+    // the last 64 bytes start in the stripe added before the buffer
+    _size_t before = HASH_STRIPE - state->buffered;
+
+    _memcpy(last, state->last + state->buffered, before);
+    _memcpy(last + before, state->buffer, state->buffered);
+
+    return __hash_merge(acc, last, state->total, state->key);
+}
+
+#endif // __HASH_H__
@@ -0,0 +1,727 @@
+/**
+ * _hmap.h - Open-addressing hash map.
+ *
+ * Every slot of the table has a control byte: the
+ * high bit is set while the slot is empty, a full
+ * slot keeps 7 bits of the hash of its key. A lookup
+ * takes 16 control bytes at once (one SSE2 compare
+ * and movemask, or two 8-byte words where SSE2 is
+ * missing) and compares keys only in the slots whose
+ * 7 bits match, about one slot in 128 of the others.
+ *
+ * The table is probed linearly, 16 slots at a time,
+ * from the slot picked by the hash, and a lookup stops
+ * at the first group with an empty slot. Removed
+ * entries leave no tombstones: the entries after
+ * them are shifted back (Knuth's Algorithm R), so the
+ * table never has to be cleaned up.
+ *
+ * The library provides a generic map, holding keys and
+ * values of sizes given at runtime (or strings as keys),
+ * and a macro generating a map for given types, with
+ * the hash and the comparison inlined.
+ *
+ * Example usage:
+ *  _hmap_t *ages = _hmap_create(HMAP_STRING, sizeof(int));
+ *  int age = 42;
+ *  _hmap_put(ages, "alice", &age);
+ *  int *found = _hmap_get(ages, "alice");
+ *  ...
+ *  _hmap_destroy(ages);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __HMAP_H__
+#define __HMAP_H__
+
+#include <_stdlib.h>
+#include <_string.h>
+#include <_hash.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * HMAP_STRING - Key size of a map with string keys.
+ *
+ * The map keeps the pointers to the strings, they
+ * have to live as long as their entries.
+*/
+#define HMAP_STRING 0
+
+/**
+ * HMAP_GROUP - Number of slots probed at once.
+*/
+#define HMAP_GROUP 16
+
+/**
+ * Control bytes of the slots, and the smallest table.
+ *
+ * - __HMAP_EMPTY - the slot is empty (high bit set)
+ * - a full slot  - 7 bits of the hash of the key
+*/
+#define __HMAP_EMPTY    ((signed char)0x80)
+#define __HMAP_MIN      HMAP_GROUP
+
+/**
+ * _hmap_t - a generic hash map.
+ *
+ * @param ctrl control bytes, the first HMAP_GROUP are
+ *             repeated after the last one, so a group
+ *             can be read at any slot
+ * @param slots the entries, a key followed by a value
+ * @param capacity number of slots, a power of two
+ * @param size number of entries
+ * @param key_size size of a key (HMAP_STRING for strings)
+ * @param value_size size of a value
+ * @param value_offset offset of the value in an entry
+ * @param stride size of an entry
+*/
+typedef struct {
+    signed char *ctrl;
+    char *slots;
+    _size_t capacity;
+    _size_t size;
+    _size_t key_size;
+    _size_t value_size;
+    _size_t value_offset;
+    _size_t stride;
+} _hmap_t;
+
+/**
+ * Library functions:
+ *  @fn _hmap_hash Hash a block of memory.
+ *  @fn _hmap_strhash Hash a string.
+ *  @fn _hmap_hash_u64 Hash a 64-bit integer.
+ *  @fn _hmap_create Create a hash map.
+ *  @fn _hmap_get Find the value of a key.
+ *  @fn _hmap_put Set the value of a key.
+ *  @fn _hmap_remove Remove a key.
+ *  @fn _hmap_size Get the number of entries.
+ *  @fn _hmap_next Walk the entries.
+ *  @fn _hmap_clear Remove all entries.
+ *  @fn _hmap_destroy Free a hash map.
+ *  @fn RAWC_HMAP_DEFINE Define a hash map for given types.
+*/
+
+/**
+ * __hmap_u64_u - 8 bytes at any address.
+*/
+typedef unsigned long long __attribute__((aligned(1), may_alias)) __hmap_u64_u;
+
+/**
+ * Hash a block of memory.
+ *
+ * @param data the memory
+ * @param len size of the memory
+ * @return the hash, _memhash with seed 0
+*/
+unsigned long long _hmap_hash(const void *data, _size_t len) {
+    return _memhash(data, len, 0);
+}
+
+/**
+ * Hash a string.
+ *
+ * @param str the string
+ * @return the hash
+*/
+unsigned long long _hmap_strhash(const char *str) {
+    return _strhash(str, 0);
+}
+
+/**
+ * Hash a 64-bit integer.
+ *
+ * @param x the integer
+ * @return the hash
+*/
+unsigned long long _hmap_hash_u64(unsigned long long x) {
+    return _hash_u64(x, 0);
+}
+
+/**
+ * Find the slots of a group with a given control byte.
+ *
+ * @param ctrl the first control byte of the group
+ * @param c the control byte
+ * @return bit i set if slot i of the group has it
+*/
+unsigned __hmap_match(const signed char *ctrl, signed char c) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+
+    return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+    const unsigned long long lsb = 0x0101010101010101ULL, low7 = 0x7F7F7F7F7F7F7F7FULL;
+    unsigned mask = 0;
+
+    for (int half = 0; half < 2; half++) {
+        unsigned long long x = *(const __hmap_u64_u *)(ctrl + 8 * half) ^ (lsb * (unsigned char)c);
+
+        // 0x80 in every zero byte, exactly
+        x = ~(((x & low7) + low7) | x | low7);
+        mask |= (unsigned)((((x >> 7) * 0x0102040810204080ULL) >> 56) << (8 * half));
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ * Find the empty slots of a group.
+ *
+ * @param ctrl the first control byte of the group
+ * @return bit i set if slot i of the group is empty
+*/
+unsigned __hmap_match_empty(const signed char *ctrl) {
+#ifdef __SSE2__
+    return (unsigned)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+    unsigned mask = 0;
+
+    for (int half = 0; half < 2; half++) {
+        unsigned long long x = *(const __hmap_u64_u *)(ctrl + 8 * half) & 0x8080808080808080ULL;
+
+        mask |= (unsigned)((((x >> 7) * 0x0102040810204080ULL) >> 56) << (8 * half));
+    }
+
+    return mask;
+#endif
+}
+
+/**
+ * Set the control byte of a slot, and its copy.
+ *
+ * @param ctrl control bytes of the table
+ * @param capacity number of slots
+ * @param i the slot
+ * @param c the control byte
+*/
+void __hmap_set_ctrl(signed char *ctrl, _size_t capacity, _size_t i, signed char c) {
+    ctrl[i] = c;
+    if (i < HMAP_GROUP) ctrl[capacity + i] = c;
+}
+
+/**
+ * Allocate the control bytes of a table, all empty.
+ *
+ * @param capacity number of slots
+ * @return the control bytes, or NULL on failure
+*/
+signed char* __hmap_alloc_ctrl(_size_t capacity) {
+    signed char *ctrl = _malloc(capacity + HMAP_GROUP);
+
+    if (ctrl != NULL) _memset(ctrl, __HMAP_EMPTY, capacity + HMAP_GROUP);
+    return ctrl;
+}
+
+/**
+ * Get the first slot to probe for a hash.
+*/
+#define __HMAP_H1(hash, capacity) (((hash) >> 7) & ((capacity) - 1))
+
+/**
+ * Get the control byte of a hash.
+*/
+#define __HMAP_H2(hash) ((signed char)((hash) & 0x7F))
+
+/**
+ * Find the first empty slot from a hash.
+ *
+ * The load factor keeps an empty slot in the table,
+ * so the loop ends.
+ *
+ * @param ctrl control bytes of the table
+ * @param capacity number of slots
+ * @param hash the hash
+ * @return the slot
+*/
+_size_t __hmap_find_empty(const signed char *ctrl, _size_t capacity, unsigned long long hash) {
+    _size_t pos = __HMAP_H1(hash, capacity);
+
+    for (;;) {
+        unsigned empty = __hmap_match_empty(ctrl + pos);
+
+        if (empty) return (pos + __builtin_ctz(empty)) & (capacity - 1);
+        pos = (pos + HMAP_GROUP) & (capacity - 1);
+    }
+}
+
+/**
+ * Check whether an entry may move back into a slot.
+ *
+ * An entry found from slot home may be anywhere from
+ * home to the first empty slot after it. Moving the
+ * entry at j to the hole keeps it reachable when the
+ * hole lies from home to j.
+ *
+ * @param home first slot probed for the entry
+ * @param hole the empty slot
+ * @param j slot of the entry
+ * @param capacity number of slots
+ * @return 1 if the entry can move to the hole
+*/
+int __hmap_can_shift(_size_t home, _size_t hole, _size_t j, _size_t capacity) {
+    return ((j - home) & (capacity - 1)) >= ((j - hole) & (capacity - 1));
+}
+
+/**
+ * Hash a key of a generic map.
+*/
+unsigned long long __hmap_key_hash(const _hmap_t *map, const void *key) {
+    if (map->key_size == HMAP_STRING) return _hmap_strhash((const char *)key);
+    return _hmap_hash(key, map->key_size);
+}
+
+/**
+ * Compare a key with the key of an entry of a generic map.
+*/
+int __hmap_key_equal(const _hmap_t *map, const void *key, const char *entry) {
+    if (map->key_size == HMAP_STRING) return _strcmp((const char *)key, *(const char **)entry) == 0;
+    return _memcmp(key, entry, map->key_size) == 0;
+}
+
+/**
+ * Get the key of an entry of a generic map, as
+ * passed to the functions.
+*/
+const void* __hmap_entry_key(const _hmap_t *map, const char *entry) {
+    if (map->key_size == HMAP_STRING) return *(const char **)entry;
+    return entry;
+}
+
+/**
+ * Create a hash map.
+ *
+ * Keys and values are copied into the map. A map with
+ * string keys (HMAP_STRING) keeps only the pointers.
+ *
+ * Example usage:
+ *  _hmap_t *counts = _hmap_create(sizeof(unsigned int), sizeof(long));
+ *
+ * @param key_size size of a key, or HMAP_STRING
+ * @param value_size size of a value (can be 0, for a set)
+ * @return the map, or NULL on failure
+*/
+_hmap_t* _hmap_create(_size_t key_size, _size_t value_size) {
+    _hmap_t *map = _malloc(sizeof(_hmap_t));
+    if (map == NULL) return NULL;
+
+    _size_t key_bytes = key_size == HMAP_STRING ? sizeof(char *) : key_size;
+    _size_t align = sizeof(void *);
+
+    map->ctrl = NULL;
+    map->slots = NULL;
+    map->capacity = 0;
+    map->size = 0;
+    map->key_size = key_size;
+    map->value_size = value_size;
+    map->value_offset = (key_bytes + align - 1) & ~(align - 1);
+    map->stride = (map->value_offset + value_size + align - 1) & ~(align - 1);
+
+    return map;
+}
+
+/**
+ * Find the entry of a key in a generic map.
+ *
+ * @param map the map
+ * @param key the key
+ * @param hash hash of the key
+ * @return the slot of the entry, or capacity if missing
+*/
+_size_t __hmap_find(const _hmap_t *map, const void *key, unsigned long long hash) {
+    _size_t mask = map->capacity - 1;
+    _size_t pos = __HMAP_H1(hash, map->capacity);
+    signed char h2 = __HMAP_H2(hash);
+
+    for (;;) {
+        const signed char *group = map->ctrl + pos;
+
+        for (unsigned match = __hmap_match(group, h2); match; match &= match - 1) {
+            _size_t i = (pos + __builtin_ctz(match)) & mask;
+
+            if (__hmap_key_equal(map, key, map->slots + i * map->stride)) return i;
+        }
+
+        if (__hmap_match_empty(group)) return map->capacity;
+        pos = (pos + HMAP_GROUP) & mask;
+    }
+}
+
+/**
+ * Move the entries of a generic map to a bigger table.
+ *
+ * @param map the map
+ * @param capacity the new number of slots
+ * @return 0 on success, -1 on failure
+*/
+int __hmap_resize(_hmap_t *map, _size_t capacity) {
+    if (capacity > (_size_t)-1 / map->stride) return -1;
+
+    signed char *ctrl = __hmap_alloc_ctrl(capacity);
+    char *slots = _malloc(capacity * map->stride);
+
+    if (ctrl == NULL || slots == NULL) {
+        _free(ctrl);
+        _free(slots);
+        return -1;
+    }
+
+    for (_size_t i = 0; i < map->capacity; i++) {
+        if (map->ctrl[i] < 0) continue;
+
+        char *entry = map->slots + i * map->stride;
+        unsigned long long hash = __hmap_key_hash(map, __hmap_entry_key(map, entry));
+        _size_t j = __hmap_find_empty(ctrl, capacity, hash);
+
+        __hmap_set_ctrl(ctrl, capacity, j, __HMAP_H2(hash));
+        _memcpy(slots + j * map->stride, entry, map->stride);
+    }
+
+    _free(map->ctrl);
+    _free(map->slots);
+
+    map->ctrl = ctrl;
+    map->slots = slots;
+    map->capacity = capacity;
+
+    return 0;
+}
+
+/**
+ * Find the value of a key.
+ *
+ * @param map the map
+ * @param key the key (the string itself for HMAP_STRING)
+ * @return the value in the map, or NULL if the key is missing
+*/
+void* _hmap_get(const _hmap_t *map, const void *key) {
+    if (map->size == 0) return NULL;
+
+    _size_t i = __hmap_find(map, key, __hmap_key_hash(map, key));
+
+    if (i == map->capacity) return NULL;
+    return map->slots + i * map->stride + map->value_offset;
+}
+
+/**
+ * Set the value of a key.
+ *
+ * The table grows when it is 7/8 full, values got
+ * from the map before may move.
+ *
+ * @param map the map
+ * @param key the key (the string itself for HMAP_STRING)
+ * @param value the value to copy (NULL leaves a new
+ *              value zeroed and an old one as it is)
+ * @return the value in the map, or NULL on failure
+*/
+void* _hmap_put(_hmap_t *map, const void *key, const void *value) {
+    unsigned long long hash = __hmap_key_hash(map, key);
+    _size_t i = map->size > 0 ? __hmap_find(map, key, hash) : map->capacity;
+
+    if (i == map->capacity) {
+        if ((map->size + 1) * 8 > map->capacity * 7) {
+            _size_t capacity = map->capacity ? map->capacity * 2 : __HMAP_MIN;
+
+            if (capacity < map->capacity || __hmap_resize(map, capacity) != 0) return NULL;
+        }
+
+        i = __hmap_find_empty(map->ctrl, map->capacity, hash);
+        __hmap_set_ctrl(map->ctrl, map->capacity, i, __HMAP_H2(hash));
+        map->size++;
+
+        char *entry = map->slots + i * map->stride;
+
+        if (map->key_size == HMAP_STRING) *(const char **)entry = (const char *)key;
+        else _memcpy(entry, key, map->key_size);
+
+        if (value == NULL) _memset(entry + map->value_offset, 0, map->value_size);
+    }
+
+    char *slot_value = map->slots + i * map->stride + map->value_offset;
+
+    if (value != NULL) _memcpy(slot_value, value, map->value_size);
+    return slot_value;
+}
+
+/**
+ * Remove a key.
+ *
+ * @param map the map
+ * @param key the key (the string itself for HMAP_STRING)
+ * @return 1 if the key was removed, 0 if it was missing
+*/
+int _hmap_remove(_hmap_t *map, const void *key) {
+    if (map->size == 0) return 0;
+
+    _size_t hole = __hmap_find(map, key, __hmap_key_hash(map, key));
+    _size_t mask = map->capacity - 1;
+
+    if (hole == map->capacity) return 0;
+
+    // shift back the entries which were probed past the hole
+    for (_size_t j = (hole + 1) & mask; map->ctrl[j] >= 0; j = (j + 1) & mask) {
+        char *entry = map->slots + j * map->stride;
+        unsigned long long hash = __hmap_key_hash(map, __hmap_entry_key(map, entry));
+
+        if (__hmap_can_shift(__HMAP_H1(hash, map->capacity), hole, j, map->capacity)) {
+            __hmap_set_ctrl(map->ctrl, map->capacity, hole, map->ctrl[j]);
+            _memcpy(map->slots + hole * map->stride, entry, map->stride);
+            hole = j;
+        }
+    }
+
+    __hmap_set_ctrl(map->ctrl, map->capacity, hole, __HMAP_EMPTY);
+    map->size--;
+
+    return 1;
+}
+
+/**
+ * Get the number of entries of a map.
+ *
+ * @param map the map
+ * @return the number of entries
+*/
+_size_t _hmap_size(const _hmap_t *map) {
+    return map->size;
+}
+
+/**
+ * Walk the entries of a map.
+ *
+ * The order is the order of the table. The map must
+ * not change during the walk.
+ *
+ * Example usage:
+ *  _size_t iter = 0;
+ *  const void *key;
+ *  void *value;
+ *
+ *  while (_hmap_next(map, &iter, &key, &value)) {
+ *      ...
+ *  }
+ *
+ * @param map the map
+ * @param iter position of the walk, 0 at the start
+ * @param key where to store the key (the string for HMAP_STRING)
+ * @param value where to store the value in the map
+ * @return 1 if an entry was stored, 0 at the end
+*/
+int _hmap_next(const _hmap_t *map, _size_t *iter, const void **key, void **value) {
+    while (*iter < map->capacity) {
+        _size_t i = (*iter)++;
+
+        if (map->ctrl[i] >= 0) {
+            char *entry = map->slots + i * map->stride;
+
+            if (key != NULL) *key = __hmap_entry_key(map, entry);
+            if (value != NULL) *value = entry + map->value_offset;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Remove all entries of a map, the table is kept.
+ *
+ * @param map the map
+*/
+void _hmap_clear(_hmap_t *map) {
+    if (map->ctrl != NULL) _memset(map->ctrl, __HMAP_EMPTY, map->capacity + HMAP_GROUP);
+    map->size = 0;
+}
+
+/**
+ * Free a hash map.
+ *
+ * @param map the map
+*/
+void _hmap_destroy(_hmap_t *map) {
+    _free(map->ctrl);
+    _free(map->slots);
+    _free(map);
+}
+
+/**
+ * Define a hash map for given types.
+ *
+ * The macro defines the types `name##_t` (the map) and
+ * `name##_entry` (a key with its value), and the functions:
+ *
+ * - `void name##_init(name##_t *map)` - initialize an empty map
+ * - `value_type* name##_get(name##_t *map, key_type key)` -
+ *   the value of a key, or NULL
+ * - `value_type* name##_put(name##_t *map, key_type key, value_type value)` -
+ *   set the value of a key, returns it in the map, or NULL on failure
+ * - `int name##_remove(name##_t *map, key_type key)` - remove a key,
+ *   1 if it was there
+ * - `name##_entry* name##_next(name##_t *map, _size_t *iter)` -
+ *   walk the entries, iter starts at 0, NULL at the end
+ * - `void name##_free(name##_t *map)` - free the table
+ *
+ * Example usage:
+ *  #define ID_HASH(k) _hmap_hash_u64(k)
+ *  #define ID_EQUAL(a, b) ((a) == (b))
+ *  RAWC_HMAP_DEFINE(users, unsigned long long, user *, ID_HASH, ID_EQUAL)
+ *
+ *  users_t map;
+ *  users_init(&map);
+ *  users_put(&map, id, u);
+ *
+ * @param name name of the map
+ * @param key_type type of the keys
+ * @param value_type type of the values
+ * @param hash macro or function `hash(key)`, a 64-bit hash
+ * @param equal macro or function `equal(a, b)`, true for equal keys
+*/
+#define RAWC_HMAP_DEFINE(name, key_type, value_type, hash, equal)                           \
+                                                                                            \
+typedef struct {                                                                            \
+    key_type key;                                                                           \
+    value_type value;                                                                       \
+} name##_entry;                                                                             \
+                                                                                            \
+typedef struct {                                                                            \
+    signed char *ctrl;                                                                      \
+    name##_entry *slots;                                                                    \
+    _size_t capacity;                                                                       \
+    _size_t size;                                                                           \
+} name##_t;                                                                                 \
+                                                                                            \
+void name##_init(name##_t *map) {                                                           \
+    map->ctrl = NULL;                                                                       \
+    map->slots = NULL;                                                                      \
+    map->capacity = 0;                                                                      \
+    map->size = 0;                                                                          \
+}                                                                                           \
+                                                                                            \
+_size_t name##_find(name##_t *map, key_type key, unsigned long long h) {                    \
+    _size_t mask = map->capacity - 1;                                                       \
+    _size_t pos = __HMAP_H1(h, map->capacity);                                              \
+                                                                                            \
+    for (;;) {                                                                              \
+        const signed char *group = map->ctrl + pos;                                         \
+                                                                                            \
+        for (unsigned match = __hmap_match(group, __HMAP_H2(h)); match; match &= match - 1) { \
+            _size_t i = (pos + __builtin_ctz(match)) & mask;                                \
+                                                                                            \
+            if (equal(map->slots[i].key, key)) return i;                                    \
+        }                                                                                   \
+                                                                                            \
+        if (__hmap_match_empty(group)) return map->capacity;                                \
+        pos = (pos + HMAP_GROUP) & mask;                                                    \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+value_type* name##_get(name##_t *map, key_type key) {                                       \
+    if (map->size == 0) return NULL;                                                        \
+                                                                                            \
+    _size_t i = name##_find(map, key, hash(key));                                           \
+                                                                                            \
+    return i == map->capacity ? NULL : &map->slots[i].value;                                \
+}                                                                                           \
+                                                                                            \
+int name##_resize(name##_t *map, _size_t capacity) {                                        \
+    if (capacity > (_size_t)-1 / sizeof(name##_entry)) return -1;                           \
+                                                                                            \
+    signed char *ctrl = __hmap_alloc_ctrl(capacity);                                        \
+    name##_entry *slots = _malloc(capacity * sizeof(name##_entry));                         \
+                                                                                            \
+    if (ctrl == NULL || slots == NULL) {                                                    \
+        _free(ctrl);                                                                        \
+        _free(slots);                                                                       \
+        return -1;                                                                          \
+    }                                                                                       \
+                                                                                            \
+    for (_size_t i = 0; i < map->capacity; i++) {                                           \
+        if (map->ctrl[i] < 0) continue;                                                     \
+                                                                                            \
+        unsigned long long h = hash(map->slots[i].key);                                     \
+        _size_t j = __hmap_find_empty(ctrl, capacity, h);                                   \
+                                                                                            \
+        __hmap_set_ctrl(ctrl, capacity, j, __HMAP_H2(h));                                   \
+        slots[j] = map->slots[i];                                                           \
+    }                                                                                       \
+                                                                                            \
+    _free(map->ctrl);                                                                       \
+    _free(map->slots);                                                                      \
+                                                                                            \
+    map->ctrl = ctrl;                                                                       \
+    map->slots = slots;                                                                     \
+    map->capacity = capacity;                                                               \
+                                                                                            \
+    return 0;                                                                               \
+}                                                                                           \
+                                                                                            \
+value_type* name##_put(name##_t *map, key_type key, value_type value) {                     \
+    unsigned long long h = hash(key);                                                       \
+    _size_t i = map->size > 0 ? name##_find(map, key, h) : map->capacity;                   \
+                                                                                            \
+    if (i == map->capacity) {                                                               \
+        if ((map->size + 1) * 8 > map->capacity * 7) {                                      \
+            _size_t capacity = map->capacity ? map->capacity * 2 : __HMAP_MIN;              \
+                                                                                            \
+            if (capacity < map->capacity || name##_resize(map, capacity) != 0) return NULL; \
+        }                                                                                   \
+                                                                                            \
+        i = __hmap_find_empty(map->ctrl, map->capacity, h);                                 \
+        __hmap_set_ctrl(map->ctrl, map->capacity, i, __HMAP_H2(h));                         \
+        map->slots[i].key = key;                                                            \
+        map->size++;                                                                        \
+    }                                                                                       \
+                                                                                            \
+    map->slots[i].value = value;                                                            \
+    return &map->slots[i].value;                                                            \
+}                                                                                           \
+                                                                                            \
+int name##_remove(name##_t *map, key_type key) {                                            \
+    if (map->size == 0) return 0;                                                           \
+                                                                                            \
+    _size_t hole = name##_find(map, key, hash(key));                                        \
+    _size_t mask = map->capacity - 1;                                                       \
+                                                                                            \
+    if (hole == map->capacity) return 0;                                                    \
+                                                                                            \
+    for (_size_t j = (hole + 1) & mask; map->ctrl[j] >= 0; j = (j + 1) & mask) {            \
+        _size_t home = __HMAP_H1(hash(map->slots[j].key), map->capacity);                   \
+                                                                                            \
+        if (__hmap_can_shift(home, hole, j, map->capacity)) {                               \
+            __hmap_set_ctrl(map->ctrl, map->capacity, hole, map->ctrl[j]);                  \
+            map->slots[hole] = map->slots[j];                                               \
+            hole = j;                                                                       \
+        }                                                                                   \
+    }                                                                                       \
+                                                                                            \
+    __hmap_set_ctrl(map->ctrl, map->capacity, hole, __HMAP_EMPTY);                          \
+    map->size--;                                                                            \
+                                                                                            \
+    return 1;                                                                               \
+}                                                                                           \
+                                                                                            \
+name##_entry* name##_next(name##_t *map, _size_t *iter) {                                   \
+    while (*iter < map->capacity) {                                                         \
+        _size_t i = (*iter)++;                                                              \
+                                                                                            \
+        if (map->ctrl[i] >= 0) return &map->slots[i];                                       \
+    }                                                                                       \
+                                                                                            \
+    return NULL;                                                                            \
+}                                                                                           \
+                                                                                            \
+void name##_free(name##_t *map) {                                                           \
+    _free(map->ctrl);                                                                       \
+    _free(map->slots);                                                                      \
+    name##_init(map);                                                                       \
+}
+
+#endif // __HMAP_H__
@@ -0,0 +1,764 @@
+/**
+ * _io_uring.h - Asynchronous I/O through io_uring.
+ *
+ * io_uring is a pair of ring buffers shared with
+ * the kernel. Requests are written to the submission
+ * queue (SQ) and results are read from the completion
+ * queue (CQ), so many reads and writes can be in flight
+ * and a whole batch costs a single syscall.
+ *
+ * Example usage:
+ *  _uring ring;
+ *  _uring_init(&ring, 64, 0);
+ *
+ *  _uring_fread(&ring, file, buffer, 4096, 0, 1);
+ *  _uring_submit_and_wait(&ring, 1);
+ *
+ *  _uring_cqe *cqe;
+ *  _uring_wait_cqe(&ring, &cqe);
+ *  // cqe->res is the number of bytes read
+ *  _uring_cqe_seen(&ring, cqe);
+ *
+ *  _uring_exit(&ring);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __IO_URING_H__
+#define __IO_URING_H__
+
+#include <_stdio.h>
+
+/**
+ * Setup flags.
+ *
+ * - IORING_SETUP_IOPOLL - busy-poll for completions
+ * - IORING_SETUP_SQPOLL - a kernel thread polls the submission queue
+ * - IORING_SETUP_SQ_AFF - pin the polling thread to sq_thread_cpu
+ * - IORING_SETUP_CQSIZE - use cq_entries as the completion queue size
+*/
+#define _IORING_SETUP_IOPOLL  (1U << 0)
+#define _IORING_SETUP_SQPOLL  (1U << 1)
+#define _IORING_SETUP_SQ_AFF  (1U << 2)
+#define _IORING_SETUP_CQSIZE  (1U << 3)
+
+/**
+ * Request opcodes used by RawC.
+*/
+#define _IORING_OP_NOP          0
+#define _IORING_OP_FSYNC        3
+#define _IORING_OP_READ_FIXED   4
+#define _IORING_OP_WRITE_FIXED  5
+#define _IORING_OP_OPENAT       18
+#define _IORING_OP_CLOSE        19
+#define _IORING_OP_READ         22
+#define _IORING_OP_WRITE        23
+
+/**
+ * Request flags.
+ *
+ * - IOSQE_FIXED_FILE - fd is an index into the registered files
+ * - IOSQE_IO_DRAIN   - start after all previous requests completed
+ * - IOSQE_IO_LINK    - the next request starts after this one
+*/
+#define _IOSQE_FIXED_FILE  (1U << 0)
+#define _IOSQE_IO_DRAIN    (1U << 1)
+#define _IOSQE_IO_LINK     (1U << 2)
+
+#define _IORING_FSYNC_DATASYNC  (1U << 0)
+
+#define _IORING_ENTER_GETEVENTS  (1U << 0)
+#define _IORING_ENTER_SQ_WAKEUP  (1U << 1)
+
+#define _IORING_SQ_NEED_WAKEUP   (1U << 0)
+
+#define _IORING_FEAT_SINGLE_MMAP (1U << 0)
+
+#define _IORING_REGISTER_BUFFERS    0
+#define _IORING_UNREGISTER_BUFFERS  1
+#define _IORING_REGISTER_FILES      2
+#define _IORING_UNREGISTER_FILES    3
+
+#define _IORING_OFF_SQ_RING  0ULL
+#define _IORING_OFF_CQ_RING  0x8000000ULL
+#define _IORING_OFF_SQES     0x10000000ULL
+
+/* AT_FDCWD - open relative to the current working directory. */
+#define _AT_FDCWD  -100
+
+/**
+ * _uring_sqe - submission queue entry (kernel ABI, 64 bytes).
+ *
+ * @param opcode type of the request (_IORING_OP_*)
+ * @param flags request flags (_IOSQE_*)
+ * @param fd file descriptor, or index of a registered file
+ * @param off offset in the file
+ * @param addr buffer or path address
+ * @param len buffer length, or mode for openat
+ * @param op_flags opcode specific flags (fsync, open flags)
+ * @param user_data value copied to the completion
+ * @param buf_index index of a registered buffer
+*/
+typedef struct {
+    unsigned char  opcode;
+    unsigned char  flags;
+    unsigned short ioprio;
+    int            fd;
+    unsigned long long off;
+    unsigned long long addr;
+    unsigned int   len;
+    unsigned int   op_flags;
+    unsigned long long user_data;
+    unsigned short buf_index;
+    unsigned short personality;
+    int            splice_fd_in;
+    unsigned long long __pad[2];
+} _uring_sqe;
+
+/**
+ * _uring_cqe - completion queue entry (kernel ABI).
+ *
+ * @param user_data value of the submitted request
+ * @param res result, as returned by the equivalent syscall
+ * @param flags completion flags
+*/
+typedef struct {
+    unsigned long long user_data;
+    int res;
+    unsigned int flags;
+} _uring_cqe;
+
+/**
+ * Ring offsets and setup parameters (kernel ABI).
+*/
+typedef struct {
+    unsigned int head, tail, ring_mask, ring_entries;
+    unsigned int flags, dropped, array, resv1;
+    unsigned long long user_addr;
+} _uring_sq_offsets;
+
+typedef struct {
+    unsigned int head, tail, ring_mask, ring_entries;
+    unsigned int overflow, cqes, flags, resv1;
+    unsigned long long user_addr;
+} _uring_cq_offsets;
+
+typedef struct {
+    unsigned int sq_entries;
+    unsigned int cq_entries;
+    unsigned int flags;
+    unsigned int sq_thread_cpu;
+    unsigned int sq_thread_idle;
+    unsigned int features;
+    unsigned int wq_fd;
+    unsigned int resv[3];
+    _uring_sq_offsets sq_off;
+    _uring_cq_offsets cq_off;
+} _uring_params;
+
+/**
+ * _uring - an io_uring instance.
+ *
+ * The k* pointers point into the memory shared
+ * with the kernel. sqe_head and sqe_tail track the
+ * entries handed out by _uring_get_sqe but not yet
+ * published to the kernel.
+*/
+typedef struct {
+    int fd;
+    unsigned flags;
+    unsigned features;
+
+    // submission queue
+    unsigned *khead;
+    unsigned *ktail;
+    unsigned *kflags;
+    unsigned *array;
+    unsigned sq_mask;
+    unsigned sq_entries;
+    _uring_sqe *sqes;
+    unsigned sqe_head;
+    unsigned sqe_tail;
+
+    // completion queue
+    unsigned *cq_khead;
+    unsigned *cq_ktail;
+    unsigned cq_mask;
+    unsigned cq_entries;
+    _uring_cqe *cqes;
+
+    // mappings
+    void *sq_ring;
+    _size_t sq_ring_size;
+    void *cq_ring;
+    _size_t cq_ring_size;
+    _size_t sqes_size;
+} _uring;
+
+/**
+ * Library functions:
+ *  > ring setup:
+ *   @fn _uring_init Create and map an io_uring.
+ *   @fn _uring_exit Unmap and close an io_uring.
+ *   @fn _uring_register_buffers Register fixed buffers.
+ *   @fn _uring_unregister_buffers Unregister fixed buffers.
+ *   @fn _uring_register_files Register fixed files.
+ *   @fn _uring_unregister_files Unregister fixed files.
+ *
+ *  > submission:
+ *   @fn _uring_get_sqe Get a free submission queue entry.
+ *   @fn _uring_prep_read Prepare a read request.
+ *   @fn _uring_prep_write Prepare a write request.
+ *   @fn _uring_prep_read_fixed Prepare a read into a registered buffer.
+ *   @fn _uring_prep_write_fixed Prepare a write from a registered buffer.
+ *   @fn _uring_prep_fsync Prepare a fsync request.
+ *   @fn _uring_prep_openat Prepare an open request.
+ *   @fn _uring_prep_close Prepare a close request.
+ *   @fn _uring_submit Submit the prepared requests.
+ *   @fn _uring_submit_and_wait Submit and wait for completions.
+ *
+ *  > completion:
+ *   @fn _uring_peek_cqe Get a completion if there is one.
+ *   @fn _uring_wait_cqe Wait for a completion.
+ *   @fn _uring_peek_batch_cqe Get up to n completions.
+ *   @fn _uring_cq_advance Mark n completions as consumed.
+ *   @fn _uring_cqe_seen Mark a completion as consumed.
+ *
+ *  > _FILE helpers:
+ *   @fn _uring_fread Queue a read from a stream.
+ *   @fn _uring_fwrite Queue a write to a stream.
+ *   @fn _uring_fsync Queue a fsync of a stream.
+ *   @fn _uring_fopen Queue an open of a file.
+*/
+
+/**
+ * Create and map an io_uring.
+ *
+ * The SQ ring, the CQ ring and the SQE array are
+ * mapped from the ring file descriptor. On kernels
+ * with IORING_FEAT_SINGLE_MMAP both rings share one
+ * mapping.
+ *
+ * @param ring ring to initialize
+ * @param entries number of submission queue entries (power of 2)
+ * @param flags setup flags (_IORING_SETUP_*)
+ * @return 0 on success, or an error code
+*/
+int _uring_init(_uring *ring, unsigned entries, unsigned flags) {
+    _uring_params p;
+    char *c = (char *)&p;
+
+    for (_size_t i = 0; i < sizeof(p); i++) c[i] = 0;
+    for (_size_t i = 0; i < sizeof(*ring); i++) ((char *)ring)[i] = 0;
+
+    p.flags = flags;
+
+    int fd = sys_io_uring_setup(entries, &p);
+    if (fd < 0) return fd;
+
+    ring->fd = fd;
+    ring->flags = p.flags;
+    ring->features = p.features;
+
+    ring->sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(_uring_cqe);
+
+    if (ring->features & _IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    long long sq = sys_mmap(NULL, ring->sq_ring_size, _PROT_READ | _PROT_WRITE,
+                            _MAP_SHARED | _MAP_POPULATE, fd, _IORING_OFF_SQ_RING);
+    if (sq < 0) {
+        sys_close(fd);
+        return (int)sq;
+    }
+    ring->sq_ring = (void *)(unsigned long)sq;
+
+    if (ring->features & _IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    }
+    else {
+        long long cq = sys_mmap(NULL, ring->cq_ring_size, _PROT_READ | _PROT_WRITE,
+                                _MAP_SHARED | _MAP_POPULATE, fd, _IORING_OFF_CQ_RING);
+        if (cq < 0) {
+            sys_munmap(ring->sq_ring, ring->sq_ring_size);
+            sys_close(fd);
+            return (int)cq;
+        }
+        ring->cq_ring = (void *)(unsigned long)cq;
+    }
+
+    ring->sqes_size = p.sq_entries * sizeof(_uring_sqe);
+    long long sqes = sys_mmap(NULL, ring->sqes_size, _PROT_READ | _PROT_WRITE,
+                              _MAP_SHARED | _MAP_POPULATE, fd, _IORING_OFF_SQES);
+    if (sqes < 0) {
+        if (ring->cq_ring != ring->sq_ring) sys_munmap(ring->cq_ring, ring->cq_ring_size);
+        sys_munmap(ring->sq_ring, ring->sq_ring_size);
+        sys_close(fd);
+        return (int)sqes;
+    }
+    ring->sqes = (_uring_sqe *)(unsigned long)sqes;
+
+    char *sq_ptr = (char *)ring->sq_ring;
+    ring->khead      = (unsigned *)(sq_ptr + p.sq_off.head);
+    ring->ktail      = (unsigned *)(sq_ptr + p.sq_off.tail);
+    ring->kflags     = (unsigned *)(sq_ptr + p.sq_off.flags);
+    ring->array      = (unsigned *)(sq_ptr + p.sq_off.array);
+    ring->sq_mask    = *(unsigned *)(sq_ptr + p.sq_off.ring_mask);
+    ring->sq_entries = *(unsigned *)(sq_ptr + p.sq_off.ring_entries);
+
+    char *cq_ptr = (char *)ring->cq_ring;
+    ring->cq_khead   = (unsigned *)(cq_ptr + p.cq_off.head);
+    ring->cq_ktail   = (unsigned *)(cq_ptr + p.cq_off.tail);
+    ring->cq_mask    = *(unsigned *)(cq_ptr + p.cq_off.ring_mask);
+    ring->cq_entries = *(unsigned *)(cq_ptr + p.cq_off.ring_entries);
+    ring->cqes       = (_uring_cqe *)(cq_ptr + p.cq_off.cqes);
+
+    // the index array never changes, slot i of the
+    // ring always points to the SQE number i
+    for (unsigned i = 0; i < ring->sq_entries; i++) ring->array[i] = i;
+
+    ring->sqe_head = ring->sqe_tail = *ring->ktail;
+
+    return 0;
+}
+
+/**
+ * Unmap and close an io_uring.
+ *
+ * @param ring ring to destroy
+*/
+void _uring_exit(_uring *ring) {
+    sys_munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) sys_munmap(ring->cq_ring, ring->cq_ring_size);
+    sys_munmap(ring->sq_ring, ring->sq_ring_size);
+    sys_close(ring->fd);
+}
+
+/**
+ * Get a free submission queue entry.
+ *
+ * The entry is cleared, so only the fields needed
+ * by the request have to be set.
+ *
+ * @param ring ring to get the entry from
+ * @return the entry, or NULL if the submission queue is full
+*/
+_uring_sqe *_uring_get_sqe(_uring *ring) {
+    // the kernel moves the head as it consumes entries
+    unsigned head = __atomic_load_n(ring->khead, __ATOMIC_ACQUIRE);
+
+    if (ring->sqe_tail - head >= ring->sq_entries) return NULL;
+
+    _uring_sqe *sqe = &ring->sqes[ring->sqe_tail & ring->sq_mask];
+    ring->sqe_tail++;
+
+    unsigned long long *words = (unsigned long long *)sqe;
+    for (int i = 0; i < 8; i++) words[i] = 0;
+
+    return sqe;
+}
+
+/**
+ * Fill the common fields of a read or write request.
+*/
+void __uring_prep_rw(int op, _uring_sqe *sqe, int fd, const void *addr, unsigned len, unsigned long long off) {
+    sqe->opcode = op;
+    sqe->fd = fd;
+    sqe->off = off;
+    sqe->addr = (unsigned long)addr;
+    sqe->len = len;
+}
+
+/**
+ * Prepare a read request.
+ *
+ * @param sqe entry to prepare
+ * @param fd file descriptor to read from
+ * @param buf buffer to read into
+ * @param len number of bytes to read
+ * @param off offset in the file, or -1 for the file position
+*/
+void _uring_prep_read(_uring_sqe *sqe, int fd, void *buf, unsigned len, unsigned long long off) {
+    __uring_prep_rw(_IORING_OP_READ, sqe, fd, buf, len, off);
+}
+
+/**
+ * Prepare a write request.
+ *
+ * @param sqe entry to prepare
+ * @param fd file descriptor to write to
+ * @param buf buffer to write from
+ * @param len number of bytes to write
+ * @param off offset in the file, or -1 for the file position
+*/
+void _uring_prep_write(_uring_sqe *sqe, int fd, const void *buf, unsigned len, unsigned long long off) {
+    __uring_prep_rw(_IORING_OP_WRITE, sqe, fd, buf, len, off);
+}
+
+/**
+ * Prepare a read into a registered buffer.
+ *
+ * @param sqe entry to prepare
+ * @param fd file descriptor to read from
+ * @param buf address inside the registered buffer
+ * @param len number of bytes to read
+ * @param off offset in the file
+ * @param buf_index index of the registered buffer
+*/
+void _uring_prep_read_fixed(_uring_sqe *sqe, int fd, void *buf, unsigned len, unsigned long long off, int buf_index) {
+    __uring_prep_rw(_IORING_OP_READ_FIXED, sqe, fd, buf, len, off);
+    sqe->buf_index = buf_index;
+}
+
+/**
+ * Prepare a write from a registered buffer.
+ *
+ * @param sqe entry to prepare
+ * @param fd file descriptor to write to
+ * @param buf address inside the registered buffer
+ * @param len number of bytes to write
+ * @param off offset in the file
+ * @param buf_index index of the registered buffer
+*/
+void _uring_prep_write_fixed(_uring_sqe *sqe, int fd, const void *buf, unsigned len, unsigned long long off, int buf_index) {
+    __uring_prep_rw(_IORING_OP_WRITE_FIXED, sqe, fd, buf, len, off);
+    sqe->buf_index = buf_index;
+}
+
+/**
+ * Prepare a fsync request.
+ *
+ * @param sqe entry to prepare
+ * @param fd file descriptor to sync
+ * @param flags 0, or _IORING_FSYNC_DATASYNC for fdatasync
+*/
+void _uring_prep_fsync(_uring_sqe *sqe, int fd, unsigned flags) {
+    __uring_prep_rw(_IORING_OP_FSYNC, sqe, fd, NULL, 0, 0);
+    sqe->op_flags = flags;
+}
+
+/**
+ * Prepare an open request.
+ *
+ * The result of the completion is the new
+ * file descriptor, or an error code.
+ *
+ * @param sqe entry to prepare
+ * @param dirfd directory the path is relative to, or _AT_FDCWD
+ * @param path path of the file (must stay valid until submitted)
+ * @param flags open flags (_O_*)
+ * @param mode file permissions
+*/
+void _uring_prep_openat(_uring_sqe *sqe, int dirfd, const char *path, int flags, int mode) {
+    __uring_prep_rw(_IORING_OP_OPENAT, sqe, dirfd, path, mode, 0);
+    sqe->op_flags = flags;
+}
+
+/**
+ * Prepare a close request.
+ *
+ * @param sqe entry to prepare
+ * @param fd file descriptor to close
+*/
+void _uring_prep_close(_uring_sqe *sqe, int fd) {
+    __uring_prep_rw(_IORING_OP_CLOSE, sqe, fd, NULL, 0, 0);
+}
+
+/**
+ * Set the value returned with the completion of the request.
+*/
+void _uring_sqe_set_data(_uring_sqe *sqe, unsigned long long data) {
+    sqe->user_data = data;
+}
+
+/**
+ * Set the request flags (_IOSQE_*).
+*/
+void _uring_sqe_set_flags(_uring_sqe *sqe, unsigned flags) {
+    sqe->flags = flags;
+}
+
+/**
+ * Publish the prepared entries to the kernel.
+ *
+ * The release store of the tail makes the entries
+ * visible to the kernel before the new tail is.
+ *
+ * @return number of entries published
+*/
+unsigned __uring_flush(_uring *ring) {
+    unsigned submitted = ring->sqe_tail - ring->sqe_head;
+
+    if (submitted) {
+        ring->sqe_head = ring->sqe_tail;
+        __atomic_store_n(ring->ktail, ring->sqe_tail, __ATOMIC_RELEASE);
+    }
+
+    // entries published earlier but not consumed yet
+    return ring->sqe_tail - __atomic_load_n(ring->khead, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Submit the prepared requests and wait for completions.
+ *
+ * With a SQPOLL ring the kernel thread picks up the
+ * requests by itself and the syscall is only needed
+ * to wake it up or to wait.
+ *
+ * @param ring ring to submit
+ * @param wait_nr number of completions to wait for
+ * @return number of submitted requests, or an error code
+*/
+int _uring_submit_and_wait(_uring *ring, unsigned wait_nr) {
+    unsigned pending = __uring_flush(ring);
+    unsigned flags = 0;
+
+    if (ring->flags & _IORING_SETUP_SQPOLL) {
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        if (__atomic_load_n(ring->kflags, __ATOMIC_RELAXED) & _IORING_SQ_NEED_WAKEUP)
+            flags |= _IORING_ENTER_SQ_WAKEUP;
+        else if (!wait_nr)
+            return pending;
+    }
+
+    if (wait_nr) flags |= _IORING_ENTER_GETEVENTS;
+
+    int ret;
+    do {
+        ret = sys_io_uring_enter(ring->fd, pending, wait_nr, flags, NULL, 0);
+    } while (ret == -4);    // EINTR
+
+    return ret;
+}
+
+/**
+ * Submit the prepared requests.
+ *
+ * @param ring ring to submit
+ * @return number of submitted requests, or an error code
+*/
+int _uring_submit(_uring *ring) {
+    return _uring_submit_and_wait(ring, 0);
+}
+
+/**
+ * Get a completion if there is one.
+ *
+ * @param ring ring to check
+ * @param cqe_ptr where to store the completion
+ * @return 0 if a completion was found, -11 (EAGAIN) otherwise
+*/
+int _uring_peek_cqe(_uring *ring, _uring_cqe **cqe_ptr) {
+    unsigned head = *ring->cq_khead;
+
+    // the acquire load of the tail makes the
+    // completion contents visible as well
+    if (head == __atomic_load_n(ring->cq_ktail, __ATOMIC_ACQUIRE)) {
+        *cqe_ptr = NULL;
+        return -11;
+    }
+
+    *cqe_ptr = &ring->cqes[head & ring->cq_mask];
+    return 0;
+}
+
+/**
+ * Wait for a completion.
+ *
+ * @param ring ring to wait on
+ * @param cqe_ptr where to store the completion
+ * @return 0 on success, or an error code
+*/
+int _uring_wait_cqe(_uring *ring, _uring_cqe **cqe_ptr) {
+    while (_uring_peek_cqe(ring, cqe_ptr) != 0) {
+        int ret = sys_io_uring_enter(ring->fd, 0, 1, _IORING_ENTER_GETEVENTS, NULL, 0);
+
+        if (ret < 0 && ret != -4) return ret;
+    }
+
+    return 0;
+}
+
+/**
+ * Get up to count completions.
+ *
+ * The completions stay in the ring until they are
+ * consumed with _uring_cq_advance.
+ *
+ * @param ring ring to check
+ * @param cqes where to store the completions
+ * @param count maximum number of completions
+ * @return number of completions stored
+*/
+unsigned _uring_peek_batch_cqe(_uring *ring, _uring_cqe **cqes, unsigned count) {
+    unsigned head = *ring->cq_khead;
+    unsigned ready = __atomic_load_n(ring->cq_ktail, __ATOMIC_ACQUIRE) - head;
+
+    if (ready > count) ready = count;
+
+    for (unsigned i = 0; i < ready; i++) {
+        cqes[i] = &ring->cqes[(head + i) & ring->cq_mask];
+    }
+
+    return ready;
+}
+
+/**
+ * Mark n completions as consumed.
+ *
+ * The release store tells the kernel the entries
+ * were read and can be reused.
+*/
+void _uring_cq_advance(_uring *ring, unsigned n) {
+    if (n) __atomic_store_n(ring->cq_khead, *ring->cq_khead + n, __ATOMIC_RELEASE);
+}
+
+/**
+ * Mark a completion as consumed.
+*/
+void _uring_cqe_seen(_uring *ring, _uring_cqe *cqe) {
+    if (cqe) _uring_cq_advance(ring, 1);
+}
+
+/**
+ * Register fixed buffers.
+ *
+ * The kernel pins the pages once, so the reads and
+ * writes using them (_uring_prep_*_fixed) do not
+ * have to map them for every request.
+ *
+ * @param ring ring to register with
+ * @param iovecs buffers to register
+ * @param n number of buffers
+ * @return 0 on success, or an error code
+*/
+int _uring_register_buffers(_uring *ring, const _iovec *iovecs, unsigned n) {
+    return sys_io_uring_register(ring->fd, _IORING_REGISTER_BUFFERS, (void *)iovecs, n);
+}
+
+/**
+ * Unregister the fixed buffers.
+*/
+int _uring_unregister_buffers(_uring *ring) {
+    return sys_io_uring_register(ring->fd, _IORING_UNREGISTER_BUFFERS, NULL, 0);
+}
+
+/**
+ * Register fixed files.
+ *
+ * Requests with _IOSQE_FIXED_FILE use an index into
+ * this table instead of a file descriptor, which saves
+ * the file reference counting on every request.
+ *
+ * @param ring ring to register with
+ * @param fds file descriptors to register
+ * @param n number of file descriptors
+ * @return 0 on success, or an error code
+*/
+int _uring_register_files(_uring *ring, const int *fds, unsigned n) {
+    return sys_io_uring_register(ring->fd, _IORING_REGISTER_FILES, (void *)fds, n);
+}
+
+/**
+ * Unregister the fixed files.
+*/
+int _uring_unregister_files(_uring *ring) {
+    return sys_io_uring_register(ring->fd, _IORING_UNREGISTER_FILES, NULL, 0);
+}
+
+/**
+ * Queue a read from a stream.
+ *
+ * @param ring ring to queue on
+ * @param stream stream to read from
+ * @param buf buffer to read into
+ * @param len number of bytes to read
+ * @param off offset in the file
+ * @param data value returned with the completion
+ * @return 0 on success, -16 (EBUSY) if the submission queue is full
+*/
+int _uring_fread(_uring *ring, _FILE *stream, void *buf, unsigned len, unsigned long long off, unsigned long long data) {
+    _uring_sqe *sqe = _uring_get_sqe(ring);
+    if (sqe == NULL) return -16;
+
+    _uring_prep_read(sqe, stream->fd, buf, len, off);
+    sqe->user_data = data;
+    return 0;
+}
+
+/**
+ * Queue a write to a stream.
+ *
+ * @param ring ring to queue on
+ * @param stream stream to write to
+ * @param buf buffer to write from
+ * @param len number of bytes to write
+ * @param off offset in the file
+ * @param data value returned with the completion
+ * @return 0 on success, -16 (EBUSY) if the submission queue is full
+*/
+int _uring_fwrite(_uring *ring, _FILE *stream, const void *buf, unsigned len, unsigned long long off, unsigned long long data) {
+    _uring_sqe *sqe = _uring_get_sqe(ring);
+    if (sqe == NULL) return -16;
+
+    _uring_prep_write(sqe, stream->fd, buf, len, off);
+    sqe->user_data = data;
+    return 0;
+}
+
+/**
+ * Queue a fsync of a stream.
+ *
+ * The kernel may run the fsync before or alongside
+ * the requests queued ahead of it, so it does not
+ * wait for their writes. To sync what they wrote,
+ * prepare the fsync with _IOSQE_IO_DRAIN:
+ *
+ *  _uring_sqe *sqe = _uring_get_sqe(ring);
+ *  _uring_prep_fsync(sqe, stream->fd, 0);
+ *  _uring_sqe_set_flags(sqe, _IOSQE_IO_DRAIN);
+ *
+ * or chain the writes to it with _IOSQE_IO_LINK.
+ *
+ * @param ring ring to queue on
+ * @param stream stream to sync
+ * @param data value returned with the completion
+ * @return 0 on success, -16 (EBUSY) if the submission queue is full
+*/
+int _uring_fsync(_uring *ring, _FILE *stream, unsigned long long data) {
+    _uring_sqe *sqe = _uring_get_sqe(ring);
+    if (sqe == NULL) return -16;
+
+    _uring_prep_fsync(sqe, stream->fd, 0);
+    sqe->user_data = data;
+    return 0;
+}
+
+/**
+ * Queue an open of a file.
+ *
+ * The mode string is the same as for _fopen, the
+ * result of the completion is the file descriptor.
+ *
+ * @param ring ring to queue on
+ * @param filename name of the file (must stay valid until submitted)
+ * @param mode mode of the file
+ * @param data value returned with the completion
+ * @return 0 on success, -16 (EBUSY) if the submission queue is full
+*/
+int _uring_fopen(_uring *ring, const char *filename, const char *mode, unsigned long long data) {
+    _uring_sqe *sqe = _uring_get_sqe(ring);
+    if (sqe == NULL) return -16;
+
+    _uring_prep_openat(sqe, _AT_FDCWD, filename, (int)__fopen_flags(mode), 0666);
+    sqe->user_data = data;
+    return 0;
+}
+
+#endif // __IO_URING_H__
@@ -0,0 +1,832 @@
+/**
+ * _log.h - Asynchronous logger.
+ *
+ * _logf does not format and does not enter the kernel.
+ * It copies the format pointer, the arguments and a
+ * monotonic timestamp into a ring of the calling thread
+ * (_ring.h), and returns. A writer thread drains the
+ * rings, formats the records and writes them with
+ * writev, many records per syscall:
+ *
+ *  [   12.345678] INFO  accepted 3 connections
+ *
+ * The literal text of the formats and the strings of
+ * the arguments are written from where they are, only
+ * the numbers are formatted into a buffer.
+ *
+ * The records of a thread are written in order, the
+ * records of different threads are not sorted by time.
+ *
+ * The format specifiers are the ones of _printf
+ * (%d, %u, %x with l and ll, %s, %c, %p, %%). Strings
+ * are copied when logging, but the format itself is
+ * kept by its address: it has to be a string literal
+ * (or live until the record is written).
+ *
+ * When the ring of a thread is full, the record is
+ * dropped (LOG_DROP) or the thread waits for the writer
+ * (LOG_BLOCK, the default). Both are counted, see
+ * _log_stats.
+ *
+ * The logger starts by itself on the standard error
+ * with the first record. When a thread of _thread.h
+ * exits, its ring is written out and then given to the
+ * next thread which logs, so threads coming and going
+ * do not add rings. The rings of other threads stay
+ * for the rest of the process. Records in the rings are
+ * kept when the logger stops, until it is restarted.
+ *
+ * Example usage:
+ *  _log_start(1, LOG_DROP);
+ *  _logf(LOG_INFO, "accepted %u connections\n", count);
+ *  _log_stop();
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __LOG_H__
+#define __LOG_H__
+
+#include <_ring.h>
+#include <_thread.h>
+#include <_thread_sync.h>
+#include <_time.h>
+
+/**
+ * Levels of the records.
+*/
+#define LOG_DEBUG 0
+#define LOG_INFO  1
+#define LOG_WARN  2
+#define LOG_ERROR 3
+
+/**
+ * What _logf does when the ring of the thread is full.
+ *
+ * - LOG_BLOCK - wait for the writer to make room
+ * - LOG_DROP  - drop the record
+*/
+#define LOG_BLOCK 0
+#define LOG_DROP  1
+
+/**
+ * LOG_RING - Size of the ring of a thread.
+ *
+ * LOG_RECORD - Largest record, longer strings are cut.
+ *
+ * LOG_FLUSH_NS - Longest time a record waits for the
+ *                writer when nobody wakes it up.
+*/
+#define LOG_RING     (64 * 1024)
+#define LOG_RECORD   1024
+#define LOG_FLUSH_NS 1000000
+
+/**
+ * __LOG_IOV - Buffers written by one writev.
+ *
+ * __LOG_SCRATCH - Size of the buffer of the formatted
+ *                 numbers and timestamps.
+*/
+#define __LOG_IOV     256
+#define __LOG_SCRATCH 8192
+
+/* Level of the records filling the end of a ring. */
+#define __LOG_PAD 0xFFFFFFFFU
+
+/**
+ * _log_stats_t - counters of the logger.
+ *
+ * @param written records written
+ * @param dropped records dropped, the ring was full (LOG_DROP)
+ * @param blocked records which waited for room in the ring (LOG_BLOCK)
+*/
+typedef struct {
+    unsigned long long written;
+    unsigned long long dropped;
+    unsigned long long blocked;
+} _log_stats_t;
+
+/**
+ * __log_record - header of a record in a ring.
+ *
+ * It is followed by the arguments, 8 bytes each.
+ * A string is its length and its characters, padded
+ * to 8 bytes.
+ *
+ * @param size size of the record with its arguments,
+ *             a multiple of 8
+ * @param level level of the record, __LOG_PAD for the
+ *              records filling the end of the ring
+ * @param time monotonic time of the record in nanoseconds
+ * @param format the format
+*/
+typedef struct {
+    unsigned int size;
+    unsigned int level;
+    unsigned long long time;
+    const char *format;
+} __log_record;
+
+#define __LOG_HEADER ((sizeof(__log_record) + 7) & ~(_size_t)7)
+
+/**
+ * __log_thread - a thread which logs.
+ *
+ * @param ring the ring of the thread
+ * @param next the thread registered before
+ * @param free 1 once the thread exited, the ring goes
+ *             to the next thread when it is empty
+*/
+typedef struct __log_thread {
+    _ring_t *ring;
+    struct __log_thread *next;
+    int free;
+} __log_thread;
+
+/**
+ * __log - the logger.
+ *
+ * @param threads the threads which log
+ * @param writer the writer thread, NULL when stopped
+ * @param lock lock of starting and stopping
+ * @param fd file descriptor of the output
+ * @param policy LOG_BLOCK or LOG_DROP
+ * @param level lowest level logged
+ * @param stop set to stop the writer
+ * @param wake futex word of the writer
+ * @param sleeping 1 while the writer sleeps
+ * @param drained futex word of the threads waiting for
+ *                the writer, changed after every pass
+ * @param stats the counters
+*/
+struct {
+    __log_thread *threads;
+    _thread_t *writer;
+    _mutex_t lock;
+    int fd;
+    int policy;
+    int level;
+    int stop;
+    unsigned int wake;
+    unsigned int sleeping;
+    unsigned int drained;
+    _log_stats_t stats;
+} __log;
+
+__thread __log_thread *__log_self = NULL;
+
+const char *__log_levels[] = { "DEBUG ", "INFO  ", "WARN  ", "ERROR " };
+
+/**
+ * __log_out - output of the writer.
+ *
+ * @param iov the buffers of the next writev
+ * @param count number of buffers
+ * @param scratch the formatted numbers
+ * @param used bytes of the scratch in use
+ * @param rings rings to release after the writev
+ * @param lens bytes to release in the rings
+ * @param releases number of rings to release
+ * @param records records in the buffers
+*/
+typedef struct {
+    _iovec iov[__LOG_IOV];
+    int count;
+    char scratch[__LOG_SCRATCH];
+    _size_t used;
+    _ring_t *rings[__LOG_IOV];
+    _size_t lens[__LOG_IOV];
+    int releases;
+    unsigned long long records;
+} __log_out;
+
+/**
+ * Library functions:
+ *  @fn _log_start Start the logger.
+ *  @fn _log_stop Write the records and stop the logger.
+ *  @fn _log_flush Wait until the records logged so far are written.
+ *  @fn _log_level Set the lowest level logged.
+ *  @fn _log_stats Get the counters of the logger.
+ *  @fn _logf Log a formatted record.
+*/
+
+/**
+ * Write the buffers of the output, then give the
+ * ring space they came from back to the threads.
+ *
+ * @param out the output
+*/
+void __log_flush(__log_out *out) {
+    _iovec *iov = out->iov;
+    int count = out->count;
+
+    while (count > 0) {
+        long long written = sys_writev(__log.fd, iov, count);
+
+        if (written == -4) continue;    // EINTR
+        if (written <= 0) break;        // the records are lost
+
+        // skip what was written, a partial write continues in a buffer
+        while (count > 0 && (unsigned long long)written >= iov->len) {
+            written -= iov->len;
+            iov++;
+            count--;
+        }
+
+        if (count > 0) {
+            iov->base = (char *)iov->base + written;
+            iov->len -= written;
+        }
+    }
+
+    for (int i = 0; i < out->releases; i++) _ring_release(out->rings[i], out->lens[i]);
+
+    __atomic_add_fetch(&__log.stats.written, out->records, __ATOMIC_RELAXED);
+
+    out->count = 0;
+    out->used = 0;
+    out->releases = 0;
+    out->records = 0;
+}
+
+/**
+ * Add a buffer to the output.
+ *
+ * A buffer right after the last one extends it.
+ *
+ * @param out the output
+ * @param base the buffer
+ * @param len length of the buffer
+*/
+void __log_add(__log_out *out, const void *base, _size_t len) {
+    if (len == 0) return;
+
+    if (out->count > 0) {
+        _iovec *last = &out->iov[out->count - 1];
+
+        if ((const char *)last->base + last->len == (const char *)base) {
+            last->len += len;
+            return;
+        }
+    }
+
+    if (out->count == __LOG_IOV) __log_flush(out);
+
+    out->iov[out->count].base = (void *)base;
+    out->iov[out->count].len = len;
+    out->count++;
+}
+
+/**
+ * Get room for formatted text in the scratch buffer.
+ *
+ * Writes the output first when the scratch or the
+ * buffers are full, the text is then added without
+ * writing the scratch under it.
+ *
+ * @param out the output
+ * @param len bytes needed, at most 64
+ * @return the room
+*/
+char *__log_scratch(__log_out *out, _size_t len) {
+    if (out->used + len > __LOG_SCRATCH || out->count == __LOG_IOV) __log_flush(out);
+
+    return out->scratch + out->used;
+}
+
+/**
+ * Add a formatted number to the output.
+ *
+ * @param out the output
+ * @param num the number
+ * @param base 10 or 16
+ * @param negative 1 to print a minus sign
+ * @param width least number of digits, padded with zeros
+*/
+void __log_number(__log_out *out, unsigned long long num, unsigned base, int negative, int width) {
+    char digits[MAX_DIGITS_64];
+    char *text = __log_scratch(out, MAX_DIGITS_64 + 8);
+    _size_t len = 0;
+
+    __ull_to_buf(digits, num, base);
+
+    if (negative) text[len++] = '-';
+    for (int pad = width - (int)_strlen(digits); pad > 0; pad--) text[len++] = '0';
+    for (char *d = digits; *d != '\0'; d++) text[len++] = *d;
+
+    out->used += len;
+    __log_add(out, text, len);
+}
+
+/**
+ * Add a record to the output.
+ *
+ * Walks the format like _vdprintf, taking the arguments
+ * from the record. A record cut for being too long
+ * ends at its last whole argument.
+ *
+ * @param out the output
+ * @param record the record
+*/
+void __log_format(__log_out *out, const __log_record *record) {
+    const unsigned char *arg = (const unsigned char *)record + __LOG_HEADER;
+    const unsigned char *end = (const unsigned char *)record + record->size;
+    const char *format = record->format;
+    const char *text = format;
+
+    // the timestamp, seconds and microseconds
+    __log_add(out, "[", 1);
+    __log_number(out, record->time / 1000000000ULL, 10, 0, 5);
+    __log_add(out, ".", 1);
+    __log_number(out, record->time / 1000ULL % 1000000ULL, 10, 0, 6);
+    __log_add(out, "] ", 2);
+    __log_add(out, __log_levels[record->level & 3], 6);
+
+    while (*format != '\0') {
+        if (*format != '%') {
+            format++;
+            continue;
+        }
+
+        // the text before the specifier is written from the format
+        __log_add(out, text, format - text);
+        format++;
+
+        int longs = 0;
+        while (*format == 'l' && longs < 2) {
+            longs++;
+            format++;
+        }
+
+        char spec = *format;
+        if (spec == '\0') {
+            text = format;
+            break;
+        }
+
+        format++;
+        text = format;
+
+        if (spec == '%') {
+            __log_add(out, "%", 1);
+            continue;
+        }
+
+        if (spec != 'd' && spec != 'u' && spec != 'x' && spec != 'c' && spec != 'p' && spec != 's') continue;
+        if (arg + 8 > end) continue;
+
+        unsigned long long value = *(const unsigned long long *)arg;
+        arg += 8;
+
+        switch (spec) {
+            case 'd':
+                if ((long long)value < 0) __log_number(out, -value, 10, 1, 1);
+                else __log_number(out, value, 10, 0, 1);
+                break;
+            case 'u':
+            case 'x':
+                __log_number(out, value, spec == 'x' ? 16 : 10, 0, 1);
+                break;
+            case 'c': {
+                char *c = __log_scratch(out, 1);
+
+                *c = (char)value;
+                out->used++;
+                __log_add(out, c, 1);
+                break;
+            }
+            case 'p':
+                __log_add(out, "0x", 2);
+                __log_number(out, value, 16, 0, 1);
+                break;
+            case 's':
+                // the characters are written from the ring
+                __log_add(out, arg, value);
+                arg += (value + 7) & ~7ULL;
+                break;
+        }
+    }
+
+    __log_add(out, text, format - text);
+    out->records++;
+}
+
+/**
+ * Add the records of a ring to the output.
+ *
+ * The ring is released when the output is written.
+ *
+ * @param out the output
+ * @param ring the ring
+ * @return 1 if the ring had records, 0 otherwise
+*/
+int __log_drain(__log_out *out, _ring_t *ring) {
+    _size_t len;
+    const unsigned char *data = _ring_peek(ring, &len);
+
+    if (len == 0) return 0;
+
+    for (_size_t used = 0; used < len; ) {
+        const __log_record *record = (const __log_record *)(data + used);
+
+        if (record->level != __LOG_PAD) __log_format(out, record);
+        used += record->size;
+
+        if (used == len || out->releases == __LOG_IOV) {
+            if (out->releases == __LOG_IOV) __log_flush(out);
+
+            out->rings[out->releases] = ring;
+            out->lens[out->releases] = used;
+            out->releases++;
+
+            // the rest of the records, the bytes before are released with the output
+            data += used;
+            len -= used;
+            used = 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * Main loop of the writer thread.
+ *
+ * Sleeps when the rings are empty, for LOG_FLUSH_NS
+ * at most, or until a thread with a filling ring
+ * wakes it up.
+ *
+ * @param arg unused
+ * @return NULL
+*/
+void *__log_writer(void *arg) {
+    __log_out *out = _malloc(sizeof(__log_out));
+
+    if (out == NULL) return NULL;
+
+    out->count = 0;
+    out->used = 0;
+    out->releases = 0;
+    out->records = 0;
+
+    for (;;) {
+        unsigned int wake = __atomic_load_n(&__log.wake, __ATOMIC_ACQUIRE);
+        int stop = __atomic_load_n(&__log.stop, __ATOMIC_ACQUIRE);
+        int busy = 0;
+
+        __log_thread *thread = __atomic_load_n(&__log.threads, __ATOMIC_ACQUIRE);
+
+        for (; thread != NULL; thread = thread->next) busy |= __log_drain(out, thread->ring);
+
+        __log_flush(out);
+
+        // threads waiting for room or in _log_flush look again
+        __atomic_add_fetch(&__log.drained, 1, __ATOMIC_RELEASE);
+        __futex_wake(&__log.drained, 0x7FFFFFFF);
+
+        if (busy) continue;
+        if (stop) break;
+
+        __atomic_store_n(&__log.sleeping, 1, __ATOMIC_SEQ_CST);
+        __futex_wait(&__log.wake, wake, LOG_FLUSH_NS);
+        __atomic_store_n(&__log.sleeping, 0, __ATOMIC_RELAXED);
+    }
+
+    _free(out);
+
+    return NULL;
+}
+
+/**
+ * Wake up the writer if it sleeps.
+*/
+void __log_wake(void) {
+    __atomic_add_fetch(&__log.wake, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&__log.sleeping, __ATOMIC_SEQ_CST)) __futex_wake(&__log.wake, 1);
+}
+
+/**
+ * Start the logger.
+ *
+ * Called again while the logger runs, it changes
+ * the output and the policy.
+ *
+ * Example usage:
+ *  _log_start(log_fd, LOG_DROP);
+ *
+ * @param fd file descriptor of the output
+ * @param policy LOG_BLOCK or LOG_DROP
+ * @return 0 on success, -1 if the writer can not be started
+*/
+int _log_start(int fd, int policy) {
+    _mutex_lock(&__log.lock);
+
+    __log.fd = fd;
+    __atomic_store_n(&__log.policy, policy, __ATOMIC_RELAXED);
+
+    if (__log.writer == NULL) {
+        __atomic_store_n(&__log.stop, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&__log.writer, _thread_create(__log_writer, NULL, 0), __ATOMIC_RELEASE);
+    }
+
+    int ret = __log.writer != NULL ? 0 : -1;
+
+    _mutex_unlock(&__log.lock);
+
+    return ret;
+}
+
+/**
+ * Free the ring of the calling thread when it exits
+ * (see __thread_release).
+ *
+ * The writer still writes the records in the ring,
+ * __log_register hands it out again once it is empty.
+*/
+void __log_release(void) {
+    __log_thread *self = __log_self;
+    if (self == NULL) return;
+
+    __log_self = NULL;
+    __atomic_store_n(&self->free, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Take the ring of a thread which exited.
+ *
+ * Only a ring the writer emptied is taken, its records
+ * are all written and the writer does not touch it
+ * until the new thread logs.
+ *
+ * @return the thread, or NULL if no ring is free
+*/
+__log_thread *__log_reuse(void) {
+    __log_thread *thread = __atomic_load_n(&__log.threads, __ATOMIC_ACQUIRE);
+
+    for (; thread != NULL; thread = thread->next) {
+        int free = 1;
+
+        if (!__atomic_load_n(&thread->free, __ATOMIC_ACQUIRE)) continue;
+        if (_ring_used(thread->ring) != 0) continue;
+
+        if (__atomic_compare_exchange_n(&thread->free, &free, 0, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) return thread;
+    }
+
+    return NULL;
+}
+
+/**
+ * Give the calling thread a ring.
+ *
+ * The ring of a thread which exited is taken first,
+ * a new one is made otherwise. Starts the logger on
+ * the standard error if it was never started.
+ *
+ * @return the thread, or NULL on failure
+*/
+__log_thread *__log_register(void) {
+    __log_thread *self = __log_reuse();
+
+    if (self == NULL) {
+        self = _malloc(sizeof(__log_thread));
+        if (self == NULL) return NULL;
+
+        self->ring = _ring_create(LOG_RING);
+        if (self->ring == NULL) {
+            _free(self);
+            return NULL;
+        }
+
+        self->free = 0;
+        self->next = __atomic_load_n(&__log.threads, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&__log.threads, &self->next, self, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) ;
+    }
+
+    // the ring goes to the next thread when this one exits
+    __thread_release_add(__log_release);
+
+    if (__atomic_load_n(&__log.writer, __ATOMIC_ACQUIRE) == NULL && __log.fd == 0) _log_start(2, __log.policy);
+
+    __log_self = self;
+
+    return self;
+}
+
+/**
+ * Put a record into the ring of the calling thread.
+ *
+ * A record which does not fit before the end of the
+ * buffer goes to its start, the end is filled with
+ * a padding record.
+ *
+ * @param self the thread
+ * @param record the record
+ * @param size size of the record
+*/
+void __log_put(__log_thread *self, const void *record, _size_t size) {
+    _ring_t *ring = self->ring;
+    int blocked = 0;
+
+    for (;;) {
+        _size_t space;
+        unsigned char *dst = _ring_reserve(ring, &space);
+
+        if (space >= size) {
+            _memcpy(dst, record, size);
+            _ring_commit(ring, size);
+
+            // wake the writer before the ring fills up
+            if (ring->head - ring->tail_cache > ring->size / 2 && __atomic_load_n(&__log.sleeping, __ATOMIC_RELAXED)) {
+                __log_wake();
+            }
+            return;
+        }
+
+        if (space > 0 && space == ring->size - (ring->head & (ring->size - 1))) {
+            __log_record *pad = (__log_record *)dst;
+
+            pad->size = (unsigned int)space;
+            pad->level = __LOG_PAD;
+            _ring_commit(ring, space);
+            continue;
+        }
+
+        // the ring is full
+        if (__atomic_load_n(&__log.policy, __ATOMIC_RELAXED) == LOG_DROP
+            || __atomic_load_n(&__log.writer, __ATOMIC_ACQUIRE) == NULL) {
+            __atomic_add_fetch(&__log.stats.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+
+        if (!blocked) {
+            __atomic_add_fetch(&__log.stats.blocked, 1, __ATOMIC_RELAXED);
+            blocked = 1;
+        }
+
+        unsigned int drained = __atomic_load_n(&__log.drained, __ATOMIC_ACQUIRE);
+
+        __log_wake();
+        __futex_wait(&__log.drained, drained, LOG_FLUSH_NS);
+    }
+}
+
+/**
+ * Log a formatted record.
+ *
+ * The arguments are copied into the ring of the calling
+ * thread, the writer thread formats and writes them.
+ *
+ * Example usage:
+ *  _logf(LOG_WARN, "slow request %s: %llu ns\n", path, elapsed);
+ *
+ * @param level level of the record (LOG_*)
+ * @param format the format, a string literal
+ * @param ... the arguments
+*/
+void _logf(int level, const char *format, ...) {
+    if (level < __atomic_load_n(&__log.level, __ATOMIC_RELAXED)) return;
+
+    __log_thread *self = __log_self;
+    if (self == NULL && (self = __log_register()) == NULL) return;
+
+    unsigned long long buffer[LOG_RECORD / 8];
+    __log_record *record = (__log_record *)buffer;
+    unsigned char *arg = (unsigned char *)buffer + __LOG_HEADER;
+    unsigned char *end = (unsigned char *)buffer + LOG_RECORD;
+
+    record->level = (unsigned int)level;
+    record->time = _monotonic_ns();
+    record->format = format;
+
+    va_list args;
+    va_start(args, format);
+
+    // the same walk as __log_format, keeping the arguments
+    for (const char *f = format; *f != '\0' && arg + 8 <= end; f++) {
+        if (*f != '%') continue;
+        f++;
+
+        int longs = 0;
+        while (*f == 'l' && longs < 2) {
+            longs++;
+            f++;
+        }
+
+        unsigned long long value;
+
+        switch (*f) {
+            case 'd':
+                if (longs == 0) value = (unsigned long long)(long long)va_arg(args, int);
+                else if (longs == 1) value = (unsigned long long)(long long)va_arg(args, long);
+                else value = (unsigned long long)va_arg(args, long long);
+                break;
+            case 'u':
+            case 'x':
+                if (longs == 0) value = va_arg(args, unsigned int);
+                else if (longs == 1) value = va_arg(args, unsigned long);
+                else value = va_arg(args, unsigned long long);
+                break;
+            case 'c':
+                value = (unsigned long long)va_arg(args, int);
+                break;
+            case 'p':
+                value = (unsigned long)va_arg(args, void *);
+                break;
+            case 's': {
+                const char *str = va_arg(args, const char *);
+                _size_t room = end - arg - 8;
+
+                if (str == NULL) str = "(null)";
+
+                // a string too long for the record is cut
+                for (value = 0; value < room && str[value] != '\0'; value++) arg[8 + value] = str[value];
+
+                *(unsigned long long *)arg = value;
+                arg += 8 + ((value + 7) & ~7ULL);
+                continue;
+            }
+            case '\0':
+                f--;
+                continue;
+            default:
+                continue;
+        }
+
+        *(unsigned long long *)arg = value;
+        arg += 8;
+    }
+
+    va_end(args);
+
+    record->size = (unsigned int)(arg - (unsigned char *)buffer);
+
+    __log_put(self, buffer, record->size);
+}
+
+/**
+ * Wait until the records logged so far are written.
+*/
+void _log_flush(void) {
+    __log_thread *thread = __atomic_load_n(&__log.threads, __ATOMIC_ACQUIRE);
+
+    for (; thread != NULL; thread = thread->next) {
+        _size_t head = __atomic_load_n(&thread->ring->head, __ATOMIC_ACQUIRE);
+
+        // the writer releases the ring after the records are written
+        while ((long)(head - __atomic_load_n(&thread->ring->tail, __ATOMIC_ACQUIRE)) > 0) {
+            if (__atomic_load_n(&__log.writer, __ATOMIC_ACQUIRE) == NULL) return;
+
+            unsigned int drained = __atomic_load_n(&__log.drained, __ATOMIC_ACQUIRE);
+
+            __log_wake();
+            __futex_wait(&__log.drained, drained, LOG_FLUSH_NS);
+        }
+    }
+}
+
+/**
+ * Write the records and stop the logger.
+ *
+ * Records logged after it stays in the rings (or are
+ * dropped when a ring is full) until the next _log_start.
+*/
+void _log_stop(void) {
+    _mutex_lock(&__log.lock);
+
+    _thread_t *writer = __log.writer;
+
+    if (writer != NULL) {
+        __atomic_store_n(&__log.stop, 1, __ATOMIC_RELEASE);
+        __log_wake();
+        _thread_join(writer);
+
+        __atomic_store_n(&__log.writer, NULL, __ATOMIC_RELEASE);
+    }
+
+    _mutex_unlock(&__log.lock);
+}
+
+/**
+ * Set the lowest level logged.
+ *
+ * @param level the level (LOG_*), lower records are skipped
+*/
+void _log_level(int level) {
+    __atomic_store_n(&__log.level, level, __ATOMIC_RELAXED);
+}
+
+/**
+ * Get the counters of the logger.
+ *
+ * @param stats where to store the counters
+*/
+void _log_stats(_log_stats_t *stats) {
+    stats->written = __atomic_load_n(&__log.stats.written, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&__log.stats.dropped, __ATOMIC_RELAXED);
+    stats->blocked = __atomic_load_n(&__log.stats.blocked, __ATOMIC_RELAXED);
+}
+
+#endif // __LOG_H__
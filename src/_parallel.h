@@ -0,0 +1,444 @@
+/**
+ * _parallel.h - Parallel kernels for large buffers.
+ *
+ * One core can not use all the memory bandwidth of a
+ * big machine. The functions here split a large buffer
+ * into parts and run them on the thread pool (_tpool.h),
+ * small buffers are handled in the calling thread:
+ *
+ * - _memcpy_mt, _memset_mt - the parts start at page
+ *   boundaries of the destination, no two threads write
+ *   to the same page
+ * - _crc32c_mt, _crc32_mt, _adler32_mt - the checksums of
+ *   the parts are joined (_checksum.h), the result is the
+ *   same as of the single-threaded function
+ * - _memhash_mt - a tree hash: the chunks are hashed with
+ *   _memhash, then the list of their hashes. It does not
+ *   depend on the number of threads, but differs from
+ *   _memhash for data longer than one chunk
+ *
+ * Buffers shorter than the threshold (PARALLEL_THRESHOLD,
+ * changed with _parallel_threshold) are not split.
+ *
+ * Example usage:
+ *  _memcpy_mt(copy, image, image_size);
+ *  unsigned int crc = _crc32c_mt(0, image, image_size);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+#include <_tpool.h>
+#include <_checksum.h>
+#include <_hash.h>
+
+/**
+ * PARALLEL_THRESHOLD - Default size from which buffers
+ *                      are split between threads.
+*/
+#define PARALLEL_THRESHOLD (16 * 1024 * 1024)
+
+/**
+ * __PARALLEL_PARTS - Most parts a buffer is split into.
+ *
+ * A few threads are enough to reach the bandwidth of
+ * the memory, more only compete for it.
+ *
+ * __PARALLEL_PART - Smallest part.
+ *
+ * __PARALLEL_PAGE - Alignment of the parts.
+*/
+#define __PARALLEL_PARTS 16
+#define __PARALLEL_PART  (1024 * 1024)
+#define __PARALLEL_PAGE  4096
+
+/**
+ * PARALLEL_HASH_CHUNK - Size of the chunks of _memhash_mt.
+ *
+ * Part of the hash value, changing it changes the hashes.
+*/
+#define PARALLEL_HASH_CHUNK (1024 * 1024)
+
+/**
+ * __PARALLEL_BATCH - Chunks hashed between two updates
+ *                    of the list hash.
+*/
+#define __PARALLEL_BATCH 64
+
+_size_t __parallel_threshold = PARALLEL_THRESHOLD;
+
+/**
+ * __parallel_job - a buffer split into parts.
+ *
+ * @param dst destination (or the data of a checksum)
+ * @param src source of a copy
+ * @param value byte of a fill, or checksum of the data before
+ * @param len size of the buffer
+ * @param parts number of parts
+ * @param sums checksums of the parts
+ * @param hashes hashes of a batch of chunks
+ * @param first index of the first chunk of the batch
+ * @param seed seed of the hashes
+*/
+typedef struct {
+    unsigned char *dst;
+    const unsigned char *src;
+    unsigned int value;
+    _size_t len;
+    _size_t parts;
+    unsigned int sums[__PARALLEL_PARTS];
+    unsigned long long *hashes;
+    _size_t first;
+    unsigned long long seed;
+} __parallel_job;
+
+/**
+ * Library functions:
+ *  @fn _parallel_threshold Set the size from which buffers are split.
+ *  @fn _memcpy_mt Copy a large memory block on several threads.
+ *  @fn _memset_mt Fill a large memory block on several threads.
+ *  @fn _crc32c_mt Compute the CRC-32C of large data on several threads.
+ *  @fn _crc32_mt Compute the CRC-32 of large data on several threads.
+ *  @fn _adler32_mt Compute the Adler-32 of large data on several threads.
+ *  @fn _memhash_mt Hash large data on several threads.
+*/
+
+/**
+ * Set the size from which buffers are split between threads.
+ *
+ * Example usage:
+ *  _parallel_threshold(256 * 1024 * 1024);
+ *
+ * @param bytes the new threshold, 0 to keep the current one
+ * @return the threshold before
+*/
+_size_t _parallel_threshold(_size_t bytes) {
+    _size_t old = __atomic_load_n(&__parallel_threshold, __ATOMIC_RELAXED);
+
+    if (bytes != 0) __atomic_store_n(&__parallel_threshold, bytes, __ATOMIC_RELAXED);
+
+    return old;
+}
+
+/**
+ * Decide into how many parts a buffer is split.
+ *
+ * Starts the thread pool if the buffer is split.
+ *
+ * @param len size of the buffer
+ * @return number of parts, 1 for no split
+*/
+_size_t __parallel_parts(_size_t len) {
+    if (len < __atomic_load_n(&__parallel_threshold, __ATOMIC_RELAXED) || len < 2 * __PARALLEL_PART) return 1;
+
+    int threads = _tpool_threads();
+    if (threads == 0) threads = _tpool_start(0);
+
+    // the calling thread works on a part too
+    _size_t parts = (_size_t)threads + 1;
+
+    if (parts > __PARALLEL_PARTS) parts = __PARALLEL_PARTS;
+    if (parts > len / __PARALLEL_PART) parts = len / __PARALLEL_PART;
+
+    return threads > 0 ? parts : 1;
+}
+
+/**
+ * Get the offset of a part of a buffer.
+ *
+ * The parts are about the same size and start at
+ * page boundaries of the buffer.
+ *
+ * @param job the buffer
+ * @param part index of the part, job->parts for the end
+ * @return offset of the part
+*/
+_size_t __parallel_offset(const __parallel_job *job, _size_t part) {
+    if (part >= job->parts) return job->len;
+    if (part == 0) return 0;
+
+    unsigned long addr = (unsigned long)job->dst + (job->len / job->parts) * part;
+    addr = (addr + __PARALLEL_PAGE - 1) & ~(unsigned long)(__PARALLEL_PAGE - 1);
+
+    _size_t offset = addr - (unsigned long)job->dst;
+    return offset < job->len ? offset : job->len;
+}
+
+/**
+ * Copy parts of a buffer (_parallel_for range).
+*/
+void __parallel_copy(_size_t begin, _size_t end, void *arg) {
+    __parallel_job *job = arg;
+
+    for (_size_t part = begin; part < end; part++) {
+        _size_t offset = __parallel_offset(job, part);
+
+        _memcpy(job->dst + offset, job->src + offset, __parallel_offset(job, part + 1) - offset);
+    }
+}
+
+/**
+ * Fill parts of a buffer (_parallel_for range).
+*/
+void __parallel_fill(_size_t begin, _size_t end, void *arg) {
+    __parallel_job *job = arg;
+
+    for (_size_t part = begin; part < end; part++) {
+        _size_t offset = __parallel_offset(job, part);
+
+        _memset(job->dst + offset, (int)job->value, __parallel_offset(job, part + 1) - offset);
+    }
+}
+
+/**
+ * Copy a large memory block on several threads.
+ *
+ * The blocks must not overlap.
+ *
+ * Example usage:
+ *  _memcpy_mt(copy, image, image_size);
+ *
+ * @param dest destination
+ * @param src source
+ * @param n number of bytes
+ * @return the destination
+*/
+void *_memcpy_mt(void *dest, const void *src, _size_t n) {
+    __parallel_job job;
+
+    job.parts = __parallel_parts(n);
+    if (job.parts == 1) return _memcpy(dest, src, n);
+
+    job.dst = dest;
+    job.src = src;
+    job.len = n;
+
+    _parallel_for(0, job.parts, 1, __parallel_copy, &job);
+
+    return dest;
+}
+
+/**
+ * Fill a large memory block on several threads.
+ *
+ * Example usage:
+ *  _memset_mt(frame, 0, frame_size);
+ *
+ * @param dest destination
+ * @param ch the byte
+ * @param n number of bytes
+ * @return the destination
+*/
+void *_memset_mt(void *dest, int ch, _size_t n) {
+    __parallel_job job;
+
+    job.parts = __parallel_parts(n);
+    if (job.parts == 1) return _memset(dest, ch, n);
+
+    job.dst = dest;
+    job.value = (unsigned char)ch;
+    job.len = n;
+
+    _parallel_for(0, job.parts, 1, __parallel_fill, &job);
+
+    return dest;
+}
+
+/**
+ * Checksum parts of a buffer (_parallel_for ranges).
+ *
+ * The first part continues the checksum of the data
+ * before, the others start from the empty checksum.
+*/
+void __parallel_crc32c(_size_t begin, _size_t end, void *arg) {
+    __parallel_job *job = arg;
+
+    for (_size_t part = begin; part < end; part++) {
+        _size_t offset = __parallel_offset(job, part);
+
+        job->sums[part] = _crc32c(part == 0 ? job->value : 0, job->dst + offset,
+                                  __parallel_offset(job, part + 1) - offset);
+    }
+}
+
+void __parallel_crc32(_size_t begin, _size_t end, void *arg) {
+    __parallel_job *job = arg;
+
+    for (_size_t part = begin; part < end; part++) {
+        _size_t offset = __parallel_offset(job, part);
+
+        job->sums[part] = _crc32(part == 0 ? job->value : 0, job->dst + offset,
+                                 __parallel_offset(job, part + 1) - offset);
+    }
+}
+
+void __parallel_adler32(_size_t begin, _size_t end, void *arg) {
+    __parallel_job *job = arg;
+
+    for (_size_t part = begin; part < end; part++) {
+        _size_t offset = __parallel_offset(job, part);
+
+        job->sums[part] = _adler32(part == 0 ? job->value : 1, job->dst + offset,
+                                   __parallel_offset(job, part + 1) - offset);
+    }
+}
+
+/**
+ * Checksum a buffer in parts and join the checksums.
+ *
+ * @param job the buffer, with the checksum of the data before
+ * @param range checksums a range of parts
+ * @param combine joins two checksums
+ * @return the checksum of the data before and the buffer
+*/
+unsigned int __parallel_checksum(__parallel_job *job, void (*range)(_size_t, _size_t, void *),
+                                 unsigned int (*combine)(unsigned int, unsigned int, _size_t)) {
+    _parallel_for(0, job->parts, 1, range, job);
+
+    unsigned int sum = job->sums[0];
+
+    for (_size_t part = 1; part < job->parts; part++) {
+        _size_t offset = __parallel_offset(job, part);
+
+        sum = combine(sum, job->sums[part], __parallel_offset(job, part + 1) - offset);
+    }
+
+    return sum;
+}
+
+/**
+ * Compute the CRC-32C of large data on several threads.
+ *
+ * Gives the same value as _crc32c.
+ *
+ * @param crc the CRC of the data before, 0 for none
+ * @param data the data
+ * @param len size of the data
+ * @return the CRC of the data before and this data
+*/
+unsigned int _crc32c_mt(unsigned int crc, const void *data, _size_t len) {
+    __parallel_job job;
+
+    job.parts = __parallel_parts(len);
+    if (job.parts == 1) return _crc32c(crc, data, len);
+
+    job.dst = (unsigned char *)data;
+    job.value = crc;
+    job.len = len;
+
+    return __parallel_checksum(&job, __parallel_crc32c, _crc32c_combine);
+}
+
+/**
+ * Compute the CRC-32 of large data on several threads.
+ *
+ * Gives the same value as _crc32.
+ *
+ * @param crc the CRC of the data before, 0 for none
+ * @param data the data
+ * @param len size of the data
+ * @return the CRC of the data before and this data
+*/
+unsigned int _crc32_mt(unsigned int crc, const void *data, _size_t len) {
+    __parallel_job job;
+
+    job.parts = __parallel_parts(len);
+    if (job.parts == 1) return _crc32(crc, data, len);
+
+    job.dst = (unsigned char *)data;
+    job.value = crc;
+    job.len = len;
+
+    return __parallel_checksum(&job, __parallel_crc32, _crc32_combine);
+}
+
+/**
+ * Compute the Adler-32 of large data on several threads.
+ *
+ * Gives the same value as _adler32.
+ *
+ * @param adler the Adler-32 of the data before, 1 for none
+ * @param data the data
+ * @param len size of the data
+ * @return the Adler-32 of the data before and this data
+*/
+unsigned int _adler32_mt(unsigned int adler, const void *data, _size_t len) {
+    __parallel_job job;
+
+    job.parts = __parallel_parts(len);
+    if (job.parts == 1) return _adler32(adler, data, len);
+
+    job.dst = (unsigned char *)data;
+    job.value = adler;
+    job.len = len;
+
+    return __parallel_checksum(&job, __parallel_adler32, _adler32_combine);
+}
+
+/**
+ * Hash chunks of data (_parallel_for range).
+ *
+ * The ranges index the batch of chunks from job->first.
+*/
+void __parallel_hash(_size_t begin, _size_t end, void *arg) {
+    __parallel_job *job = arg;
+
+    for (_size_t i = begin; i < end; i++) {
+        _size_t offset = (job->first + i) * PARALLEL_HASH_CHUNK;
+        _size_t size = job->len - offset < PARALLEL_HASH_CHUNK ? job->len - offset : PARALLEL_HASH_CHUNK;
+
+        job->hashes[i] = _memhash(job->dst + offset, size, job->seed);
+    }
+}
+
+/**
+ * Hash large data on several threads.
+ *
+ * Data up to PARALLEL_HASH_CHUNK bytes hashes as with
+ * _memhash. Longer data is hashed in chunks of that
+ * size, and the hash is the _memhash of their hashes,
+ * seeded with the seed and the length.
+ *
+ * Example usage:
+ *  unsigned long long hash = _memhash_mt(image, image_size, 0);
+ *
+ * @param data the data
+ * @param len size of the data
+ * @param seed seed of the hash
+ * @return 64-bit hash
+*/
+unsigned long long _memhash_mt(const void *data, _size_t len, unsigned long long seed) {
+    if (len <= PARALLEL_HASH_CHUNK) return _memhash(data, len, seed);
+
+    __parallel_job job;
+    unsigned long long hashes[__PARALLEL_BATCH];
+    _hash_state_t state;
+
+    _size_t chunks = (len + PARALLEL_HASH_CHUNK - 1) / PARALLEL_HASH_CHUNK;
+    _size_t parts = __parallel_parts(len);
+
+    job.dst = (unsigned char *)data;
+    job.len = len;
+    job.seed = seed;
+    job.hashes = hashes;
+
+    // the list of hashes is hashed as it is made, a batch at a time
+    _hash_init(&state, seed ^ len);
+
+    for (job.first = 0; job.first < chunks; job.first += __PARALLEL_BATCH) {
+        _size_t count = chunks - job.first < __PARALLEL_BATCH ? chunks - job.first : __PARALLEL_BATCH;
+
+        if (parts == 1) __parallel_hash(0, count, &job);
+        else _parallel_for(0, count, 1, __parallel_hash, &job);
+
+        _hash_update(&state, hashes, count * sizeof(unsigned long long));
+    }
+
+    return _hash_digest(&state);
+}
+
+#endif // __PARALLEL_H__
@@ -0,0 +1,246 @@
+/**
+ * _pool.h - Fixed-size object pool.
+ *
+ * A pool hands out objects of one size from slabs of
+ * whole pages. Free objects are linked through their
+ * first word, so getting and putting an object is a
+ * constant-time list operation, and objects allocated
+ * together stay close to each other in memory.
+ *
+ * Objects can be aligned to the cache line size
+ * (POOL_CACHELINE), so two objects used by different
+ * threads never share a cache line.
+ *
+ * A pool is not thread-safe, every thread should use
+ * its own pool, or lock around the calls.
+ *
+ * Example usage:
+ *  _pool_t *nodes = _pool_create(sizeof(node), POOL_CACHELINE);
+ *  node *n = _pool_get(nodes);
+ *  ...
+ *  _pool_put(nodes, n);
+ *  _pool_destroy(nodes);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __POOL_H__
+#define __POOL_H__
+
+#include <_stdlib.h>
+
+/**
+ * POOL_CACHELINE - Size of a cache line, pass it as the
+ *                  alignment to keep objects on their
+ *                  own cache lines.
+*/
+#define POOL_CACHELINE 64
+
+/**
+ * POOL_SLAB - Size of a slab. Pools of objects bigger than
+ *             an eighth of it use slabs of several pages.
+*/
+#define POOL_SLAB 4096UL
+
+/**
+ * __pool_slab - header at the start of every slab.
+ *
+ * @param next the slab allocated before this one
+*/
+typedef struct __pool_slab {
+    struct __pool_slab *next;
+} __pool_slab;
+
+/**
+ * _pool_t - a pool of objects of one size.
+ *
+ * @param obj_size distance between the objects
+ * @param align alignment of the objects
+ * @param slab_size size of a slab
+ * @param first offset of the first object in a slab
+ * @param free free objects (linked through their first word)
+ * @param bump next object of the newest slab never handed out
+ * @param bump_end end of the newest slab
+ * @param slabs slabs of the pool
+ * @param live number of objects handed out
+ * @param high_water the highest number of live objects
+ * @param slab_count number of slabs
+*/
+typedef struct {
+    _size_t obj_size;
+    _size_t align;
+    _size_t slab_size;
+    _size_t first;
+    void *free;
+    char *bump;
+    char *bump_end;
+    __pool_slab *slabs;
+    _size_t live;
+    _size_t high_water;
+    _size_t slab_count;
+} _pool_t;
+
+/**
+ * _pool_stats_t - statistics of a pool.
+ *
+ * @param live number of objects handed out
+ * @param high_water the highest number of live objects
+ * @param slabs number of slabs
+ * @param obj_size distance between the objects
+ * @param per_slab number of objects in a slab
+ * @param bytes memory taken by the slabs
+*/
+typedef struct {
+    _size_t live;
+    _size_t high_water;
+    _size_t slabs;
+    _size_t obj_size;
+    _size_t per_slab;
+    _size_t bytes;
+} _pool_stats_t;
+
+/**
+ * Library functions:
+ *  @fn _pool_create Create a pool of objects of one size.
+ *  @fn _pool_get Get an object from a pool.
+ *  @fn _pool_put Give an object back to its pool.
+ *  @fn _pool_stats Get the statistics of a pool.
+ *  @fn _pool_destroy Free a pool with all of its objects.
+*/
+
+/**
+ * Create a pool of objects of one size.
+ *
+ * @param obj_size size of the objects
+ * @param align alignment of the objects, a power of two up
+ *              to the page size (0 means pointer alignment)
+ * @return the pool, or NULL on failure
+*/
+_pool_t* _pool_create(_size_t obj_size, _size_t align) {
+    if (align < sizeof(void *)) align = sizeof(void *);
+    if (align > POOL_SLAB || (align & (align - 1)) != 0) return NULL;
+
+    // the free list link is stored in the object
+    if (obj_size < sizeof(void *)) obj_size = sizeof(void *);
+
+    _size_t stride = (obj_size + align - 1) & ~(align - 1);
+    _size_t first = (sizeof(__pool_slab) + align - 1) & ~(align - 1);
+    _size_t slab_size = POOL_SLAB;
+
+    while (slab_size < first + stride * 8) slab_size *= 2;
+
+    _pool_t *pool = _malloc(sizeof(_pool_t));
+    if (pool == NULL) return NULL;
+
+    pool->obj_size = stride;
+    pool->align = align;
+    pool->slab_size = slab_size;
+    pool->first = first;
+    pool->free = NULL;
+    pool->bump = NULL;
+    pool->bump_end = NULL;
+    pool->slabs = NULL;
+    pool->live = 0;
+    pool->high_water = 0;
+    pool->slab_count = 0;
+
+    return pool;
+}
+
+/**
+ * Add a slab to a pool.
+ *
+ * The objects of the slab are handed out from its
+ * start, so the pages are touched only when needed.
+ *
+ * @param pool the pool
+ * @return 0 on success, -1 on failure
+*/
+int __pool_grow(_pool_t *pool) {
+    __pool_slab *slab = _aligned_alloc(POOL_SLAB, pool->slab_size);
+    if (slab == NULL) return -1;
+
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    pool->slab_count++;
+
+    pool->bump = (char *)slab + pool->first;
+    pool->bump_end = (char *)slab + pool->slab_size;
+
+    return 0;
+}
+
+/**
+ * Get an object from a pool.
+ *
+ * @param pool the pool
+ * @return the object (not zeroed), or NULL on failure
+*/
+void* _pool_get(_pool_t *pool) {
+    void *obj = pool->free;
+
+    if (obj != NULL) pool->free = *(void **)obj;
+    else {
+        if ((_size_t)(pool->bump_end - pool->bump) < pool->obj_size) {
+            if (__pool_grow(pool) != 0) return NULL;
+        }
+
+        obj = pool->bump;
+        pool->bump += pool->obj_size;
+    }
+
+    if (++pool->live > pool->high_water) pool->high_water = pool->live;
+
+    return obj;
+}
+
+/**
+ * Give an object back to its pool.
+ *
+ * @param pool the pool
+ * @param obj object got from the pool (NULL does nothing)
+*/
+void _pool_put(_pool_t *pool, void *obj) {
+    if (obj == NULL) return;
+
+    *(void **)obj = pool->free;
+    pool->free = obj;
+    pool->live--;
+}
+
+/**
+ * Get the statistics of a pool.
+ *
+ * @param pool the pool
+ * @param stats where to store the statistics
+*/
+void _pool_stats(const _pool_t *pool, _pool_stats_t *stats) {
+    stats->live = pool->live;
+    stats->high_water = pool->high_water;
+    stats->slabs = pool->slab_count;
+    stats->obj_size = pool->obj_size;
+    stats->per_slab = (pool->slab_size - pool->first) / pool->obj_size;
+    stats->bytes = pool->slab_count * pool->slab_size;
+}
+
+/**
+ * Free a pool with all of its objects.
+ *
+ * @param pool the pool
+*/
+void _pool_destroy(_pool_t *pool) {
+    __pool_slab *slab = pool->slabs;
+
+    while (slab != NULL) {
+        __pool_slab *next = slab->next;
+
+        _free(slab);
+        slab = next;
+    }
+
+    _free(pool);
+}
+
+#endif // __POOL_H__
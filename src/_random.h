@@ -0,0 +1,555 @@
+/**
+ * _random.h - Pseudo-random numbers.
+ *
+ * The library provides two generators:
+ *
+ * - xoshiro256** (Blackman, Vigna) - 256 bits of state, fast,
+ *                                    with jumps for parallel streams
+ * - PCG64 (O'Neill)                - the XSL-RR output of a 128-bit
+ *                                    LCG, with selectable streams
+ *
+ * Neither is fit for cryptography, use sys_getrandom
+ * for keys and tokens.
+ *
+ * Every thread has its own xoshiro256** generator used
+ * by _rand and the other functions without a generator
+ * argument, so threads never share or lock the state.
+ * A thread which did not call _srand is seeded from the
+ * kernel (getrandom) on its first use.
+ *
+ * The header is included by _stdlib.h.
+ *
+ * Example usage:
+ *  _srand(42);
+ *  int roll = _rand_below(6) + 1;
+ *  double p = _rand_double();
+ *
+ *  _pcg64_t gen;
+ *  _pcg64_seed(&gen, 42, 1);
+ *  unsigned long long x = _pcg64_next(&gen);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __RANDOM_H__
+#define __RANDOM_H__
+
+#include <_stdlib.h>
+
+/**
+ * RAND_MAX - The largest number returned by _rand.
+*/
+#define RAND_MAX 2147483647
+
+/**
+ * _xoshiro256_t - state of a xoshiro256** generator.
+ *
+ * @param s the state, never all zero
+*/
+typedef struct {
+    unsigned long long s[4];
+} _xoshiro256_t;
+
+/**
+ * _pcg64_t - state of a PCG64 generator.
+ *
+ * The 128-bit numbers are kept in halves, so the
+ * generator works on 32-bit targets too.
+ *
+ * @param lo low half of the state
+ * @param hi high half of the state
+ * @param inc_lo low half of the increment (odd, selects the stream)
+ * @param inc_hi high half of the increment
+*/
+typedef struct {
+    unsigned long long lo;
+    unsigned long long hi;
+    unsigned long long inc_lo;
+    unsigned long long inc_hi;
+} _pcg64_t;
+
+/**
+ * __rand_lanes - four xoshiro256** generators stepped
+ *                together by _rand_fill.
+ *
+ * Word i of every generator is kept in vector s[i],
+ * so one step of the four generators is a few vector
+ * instructions (GCC vector extensions, the compiler
+ * splits them where the vectors are narrower).
+*/
+typedef unsigned long long __rand_v4 __attribute__((vector_size(32)));
+typedef unsigned long long __rand_v4_u __attribute__((vector_size(32), aligned(1), may_alias));
+
+typedef struct {
+    __rand_v4 s[4];
+} __rand_lanes;
+
+/**
+ * __rand_state - random state of a thread.
+ *
+ * @param gen the generator of _rand
+ * @param lanes the generators of _rand_fill
+ * @param seeded gen is seeded
+ * @param lanes_seeded lanes are seeded
+*/
+typedef struct {
+    _xoshiro256_t gen;
+    __rand_lanes lanes;
+    int seeded;
+    int lanes_seeded;
+} __rand_state;
+
+__thread __rand_state __rand_thread;
+
+/**
+ * Library functions:
+ *  @fn _rand Get a random number from 0 to RAND_MAX.
+ *  @fn _srand Seed the generator of the thread.
+ *  @fn _rand_u64 Get 64 random bits.
+ *  @fn _rand_below Get a random number from 0 to a bound.
+ *  @fn _rand_double Get a random number from 0 to 1.
+ *  @fn _rand_fill Fill a buffer with random bytes.
+ *  @fn _xoshiro256_seed Seed a xoshiro256** generator.
+ *  @fn _xoshiro256_next Get 64 bits from a xoshiro256** generator.
+ *  @fn _xoshiro256_jump Move a xoshiro256** generator 2^128 steps ahead.
+ *  @fn _xoshiro256_below Get a number below a bound from a xoshiro256** generator.
+ *  @fn _xoshiro256_double Get a double from a xoshiro256** generator.
+ *  @fn _pcg64_seed Seed a PCG64 generator.
+ *  @fn _pcg64_next Get 64 bits from a PCG64 generator.
+ *  @fn _pcg64_below Get a number below a bound from a PCG64 generator.
+ *  @fn _pcg64_double Get a double from a PCG64 generator.
+*/
+
+/**
+ * Get the next number of a splitmix64 sequence.
+ *
+ * Used to expand a 64-bit seed into a whole state,
+ * close seeds give unrelated states.
+ *
+ * @param x the sequence
+ * @return the number
+*/
+unsigned long long __splitmix64(unsigned long long *x) {
+    unsigned long long z = (*x += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Multiply two 64-bit numbers into 128 bits.
+ *
+ * @param a first number
+ * @param b second number
+ * @param hi where to store the high half
+ * @return the low half
+*/
+unsigned long long __rand_mul128(unsigned long long a, unsigned long long b, unsigned long long *hi) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 r = (unsigned __int128)a * b;
+
+    *hi = (unsigned long long)(r >> 64);
+    return (unsigned long long)r;
+#else
+    unsigned long long a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+    unsigned long long b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+    unsigned long long lo_lo = a_lo * b_lo;
+    unsigned long long hi_lo = a_hi * b_lo;
+    unsigned long long lo_hi = a_lo * b_hi;
+    unsigned long long cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+
+    *hi = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+    return (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+}
+
+/**
+ * Reduce random bits to a number below a bound.
+ *
+ * Lemire's method: the bits are multiplied by the bound
+ * and the high half is taken. Products landing in the
+ * few low values which would make some results more
+ * likely are rejected, so the result is unbiased, and
+ * a division is needed only when that can happen.
+ *
+ * @param x the random bits
+ * @param bound the bound
+ * @param low where to store the low half of the product
+ * @return the number, valid if the low half is at least
+ *         the threshold (see __rand_below)
+*/
+unsigned long long __rand_reduce(unsigned long long x, unsigned long long bound, unsigned long long *low) {
+    unsigned long long hi;
+
+    *low = __rand_mul128(x, bound, &hi);
+    return hi;
+}
+
+/**
+ * Get a number below a bound from a generator.
+ *
+ * @param next function stepping the generator
+ * @param gen the generator
+ * @param bound the bound (0 gives 0)
+ * @return a uniform number from 0 to bound - 1
+*/
+unsigned long long __rand_below(unsigned long long (*next)(void *), void *gen, unsigned long long bound) {
+    unsigned long long low;
+    unsigned long long r = __rand_reduce(next(gen), bound, &low);
+
+    if (low < bound) {
+        unsigned long long threshold = -bound % bound;
+
+        while (low < threshold) r = __rand_reduce(next(gen), bound, &low);
+    }
+
+    return r;
+}
+
+/**
+ * Seed a xoshiro256** generator.
+ *
+ * @param gen the generator
+ * @param seed the seed, any value
+*/
+void _xoshiro256_seed(_xoshiro256_t *gen, unsigned long long seed) {
+    for (int i = 0; i < 4; i++) gen->s[i] = __splitmix64(&seed);
+}
+
+/**
+ * Get 64 random bits from a xoshiro256** generator.
+ *
+ * @param gen the generator
+ * @return the bits
+*/
+unsigned long long _xoshiro256_next(_xoshiro256_t *gen) {
+    unsigned long long *s = gen->s;
+    unsigned long long x = s[1] * 5;
+    unsigned long long result = ((x << 7) | (x >> 57)) * 9;
+    unsigned long long t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+
+    return result;
+}
+
+/**
+ * Move a xoshiro256** generator 2^128 steps ahead.
+ *
+ * Generators copied from one and jumped 1, 2, 3...
+ * times give sequences which never overlap, for
+ * parallel work which has to be reproducible.
+ *
+ * @param gen the generator
+*/
+void _xoshiro256_jump(_xoshiro256_t *gen) {
+    static const unsigned long long jump[4] = {
+        0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL,
+        0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+    };
+    unsigned long long s[4] = { 0, 0, 0, 0 };
+
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & (1ULL << b)) {
+                for (int j = 0; j < 4; j++) s[j] ^= gen->s[j];
+            }
+
+            _xoshiro256_next(gen);
+        }
+    }
+
+    for (int j = 0; j < 4; j++) gen->s[j] = s[j];
+}
+
+/**
+ * Step a xoshiro256** generator, for __rand_below.
+*/
+unsigned long long __xoshiro256_step(void *gen) {
+    return _xoshiro256_next((_xoshiro256_t *)gen);
+}
+
+/**
+ * Get a random number below a bound from
+ * a xoshiro256** generator, without bias.
+ *
+ * @param gen the generator
+ * @param bound the bound (0 gives 0)
+ * @return a number from 0 to bound - 1
+*/
+unsigned long long _xoshiro256_below(_xoshiro256_t *gen, unsigned long long bound) {
+    return __rand_below(__xoshiro256_step, gen, bound);
+}
+
+/**
+ * Get a random double from a xoshiro256** generator.
+ *
+ * @param gen the generator
+ * @return a uniform number from 0 (included) to 1
+ *         (excluded), a multiple of 2^-53
+*/
+double _xoshiro256_double(_xoshiro256_t *gen) {
+    return (_xoshiro256_next(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Step the state of a PCG64 generator.
+ *
+ * state = state * multiplier + increment, in 128 bits.
+ *
+ * @param gen the generator
+*/
+void __pcg64_step(_pcg64_t *gen) {
+    const unsigned long long mul_lo = 0x4385DF649FCCF645ULL;
+    const unsigned long long mul_hi = 0x2360ED051FC65DA4ULL;
+    unsigned long long hi;
+    unsigned long long lo = __rand_mul128(gen->lo, mul_lo, &hi);
+
+    hi += gen->lo * mul_hi + gen->hi * mul_lo;
+
+    gen->lo = lo + gen->inc_lo;
+    gen->hi = hi + gen->inc_hi + (gen->lo < lo);
+}
+
+/**
+ * Seed a PCG64 generator.
+ *
+ * Generators with the same seed and different
+ * streams give unrelated sequences.
+ *
+ * @param gen the generator
+ * @param seed the seed, any value
+ * @param stream the stream, any value
+*/
+void _pcg64_seed(_pcg64_t *gen, unsigned long long seed, unsigned long long stream) {
+    unsigned long long s_lo = __splitmix64(&seed);
+    unsigned long long s_hi = __splitmix64(&seed);
+
+    gen->inc_lo = (stream << 1) | 1;
+    gen->inc_hi = stream >> 63;
+    gen->lo = 0;
+    gen->hi = 0;
+
+    __pcg64_step(gen);
+
+    unsigned long long lo = gen->lo + s_lo;
+
+    gen->hi += s_hi + (lo < s_lo);
+    gen->lo = lo;
+
+    __pcg64_step(gen);
+}
+
+/**
+ * Get 64 random bits from a PCG64 generator.
+ *
+ * @param gen the generator
+ * @return the bits
+*/
+unsigned long long _pcg64_next(_pcg64_t *gen) {
+    __pcg64_step(gen);
+
+    unsigned long long x = gen->hi ^ gen->lo;
+    unsigned rot = gen->hi >> 58;
+
+    return (x >> rot) | (x << ((64 - rot) & 63));
+}
+
+/**
+ * Step a PCG64 generator, for __rand_below.
+*/
+unsigned long long __pcg64_next_step(void *gen) {
+    return _pcg64_next((_pcg64_t *)gen);
+}
+
+/**
+ * Get a random number below a bound from
+ * a PCG64 generator, without bias.
+ *
+ * @param gen the generator
+ * @param bound the bound (0 gives 0)
+ * @return a number from 0 to bound - 1
+*/
+unsigned long long _pcg64_below(_pcg64_t *gen, unsigned long long bound) {
+    return __rand_below(__pcg64_next_step, gen, bound);
+}
+
+/**
+ * Get a random double from a PCG64 generator.
+ *
+ * @param gen the generator
+ * @return a uniform number from 0 (included) to 1
+ *         (excluded), a multiple of 2^-53
+*/
+double _pcg64_double(_pcg64_t *gen) {
+    return (_pcg64_next(gen) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Get a seed from the kernel.
+ *
+ * Kernels before 3.17 have no getrandom, the seed is
+ * then made from addresses of the stack and of the
+ * thread (which differ between runs with ASLR).
+ *
+ * @return the seed
+*/
+unsigned long long __rand_entropy(void) {
+    unsigned long long seed;
+
+    if (sys_getrandom(&seed, sizeof(seed), _GRND_NONBLOCK) == sizeof(seed)) return seed;
+
+    seed = (unsigned long long)(unsigned long)&seed;
+    seed ^= __splitmix64(&seed) + (unsigned long long)(unsigned long)&__rand_thread;
+    return __splitmix64(&seed);
+}
+
+/**
+ * Get the generator of the thread, seeded.
+ *
+ * @return the generator
+*/
+_xoshiro256_t* __rand_gen(void) {
+    if (!__rand_thread.seeded) {
+        _xoshiro256_seed(&__rand_thread.gen, __rand_entropy());
+        __rand_thread.seeded = 1;
+    }
+
+    return &__rand_thread.gen;
+}
+
+/**
+ * Seed the generator of the thread.
+ *
+ * The same seed gives the same numbers from _rand,
+ * _rand_u64, _rand_below, _rand_double and _rand_fill
+ * of the thread.
+ *
+ * @param seed the seed
+*/
+void _srand(unsigned int seed) {
+    _xoshiro256_seed(&__rand_thread.gen, seed);
+    __rand_thread.seeded = 1;
+    __rand_thread.lanes_seeded = 0;
+}
+
+/**
+ * Get 64 random bits from the generator of the thread.
+ *
+ * @return the bits
+*/
+unsigned long long _rand_u64(void) {
+    return _xoshiro256_next(__rand_gen());
+}
+
+/**
+ * Get a random number from 0 to RAND_MAX.
+ *
+ * @return the number
+*/
+int _rand(void) {
+    return (int)(_rand_u64() >> 33);
+}
+
+/**
+ * Get a random number below a bound, without bias,
+ * from the generator of the thread.
+ *
+ * @param bound the bound (0 gives 0)
+ * @return a number from 0 to bound - 1
+*/
+unsigned long long _rand_below(unsigned long long bound) {
+    return _xoshiro256_below(__rand_gen(), bound);
+}
+
+/**
+ * Get a random double from the generator of the thread.
+ *
+ * @return a uniform number from 0 (included) to 1
+ *         (excluded), a multiple of 2^-53
+*/
+double _rand_double(void) {
+    return _xoshiro256_double(__rand_gen());
+}
+
+/**
+ * Step the four generators of _rand_fill.
+ *
+ * The multiplications of xoshiro256** are by 5 and 9,
+ * done with shifts and adds, as 64-bit vector
+ * multiplication is missing below AVX-512.
+ *
+ * @param lanes the generators
+ * @param out where to store 32 random bytes
+*/
+void __rand_lanes_next(__rand_lanes *lanes, __rand_v4 *out) {
+    __rand_v4 *s = lanes->s;
+    __rand_v4 x = s[1] + (s[1] << 2);
+    __rand_v4 r = (x << 7) | (x >> 57);
+    __rand_v4 t = s[1] << 17;
+
+    *out = r + (r << 3);
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+}
+
+/**
+ * Fill a buffer with random bytes.
+ *
+ * The bytes come from four generators of the thread
+ * stepped together in vectors, 32 bytes per step,
+ * seeded from the generator of the thread.
+ *
+ * Example usage:
+ *  char payload[4096];
+ *  _rand_fill(payload, sizeof(payload));
+ *
+ * @param buf the buffer
+ * @param len size of the buffer
+*/
+void _rand_fill(void *buf, _size_t len) {
+    unsigned char *out = (unsigned char *)buf;
+    __rand_lanes lanes;
+    __rand_v4 v;
+
+    if (!__rand_thread.lanes_seeded) {
+        _xoshiro256_t *gen = __rand_gen();
+
+        for (int i = 0; i < 4; i++) {
+            for (int lane = 0; lane < 4; lane++) __rand_thread.lanes.s[i][lane] = _xoshiro256_next(gen);
+        }
+
+        __rand_thread.lanes_seeded = 1;
+    }
+
+    // a local copy stays in registers, the stores to the buffer could alias the thread state
+    lanes = __rand_thread.lanes;
+
+    for (; len >= sizeof(v); len -= sizeof(v), out += sizeof(v)) {
+        __rand_lanes_next(&lanes, &v);
+        *(__rand_v4_u *)out = v;
+    }
+
+    if (len > 0) {
+        __rand_lanes_next(&lanes, &v);
+
+        for (_size_t i = 0; i < len; i++) out[i] = ((unsigned char *)&v)[i];
+    }
+
+    __rand_thread.lanes = lanes;
+}
+
+#endif // __RANDOM_H__
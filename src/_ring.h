@@ -0,0 +1,500 @@
+/**
+ * _ring.h - Lock-free ring buffers between threads.
+ *
+ * Two bounded rings, both without locks or syscalls:
+ *
+ * - _ring_t - bytes from one producer thread to one
+ *   consumer thread (SPSC). Both sides work in place:
+ *   the producer reserves space, writes into it and
+ *   commits it, the consumer peeks at the data and
+ *   releases it. Several records can be committed at
+ *   once, so the consumer sees them together.
+ *
+ * - _mpsc_t - fixed-size messages from any number of
+ *   producer threads to one consumer thread (MPSC).
+ *   Every slot has a sequence number telling whether
+ *   it is free, being written or ready, so producers
+ *   only race for the head with a compare-and-swap.
+ *
+ * The positions written by the producers and by the
+ * consumer are on their own cache lines, and every side
+ * keeps a copy of the position of the other side, read
+ * again only when the ring looks full (or empty).
+ *
+ * Example usage:
+ *  _ring_t *ring = _ring_create(1 << 16);
+ *
+ *  // producer
+ *  _size_t space;
+ *  char *dst = _ring_reserve(ring, &space);
+ *  if (space >= len) {
+ *      _memcpy(dst, record, len);
+ *      _ring_commit(ring, len);
+ *  }
+ *
+ *  // consumer
+ *  _size_t ready;
+ *  const char *src = _ring_peek(ring, &ready);
+ *  handle(src, ready);
+ *  _ring_release(ring, ready);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __RING_H__
+#define __RING_H__
+
+#include <_stdlib.h>
+
+/**
+ * RING_CACHELINE - Size of a cache line, the positions
+ *                  of both sides are this far apart.
+*/
+#define RING_CACHELINE 64
+
+/**
+ * _ring_t - a single-producer single-consumer byte ring.
+ *
+ * The positions count the bytes written and read since
+ * the creation, the offset in the buffer is the position
+ * masked with the size.
+ *
+ * @param head bytes committed by the producer
+ * @param tail_cache the tail last seen by the producer
+ * @param tail bytes released by the consumer
+ * @param head_cache the head last seen by the consumer
+ * @param data the buffer
+ * @param size size of the buffer, a power of two
+*/
+typedef struct {
+    _size_t head __attribute__((aligned(RING_CACHELINE)));
+    _size_t tail_cache;
+    _size_t tail __attribute__((aligned(RING_CACHELINE)));
+    _size_t head_cache;
+    unsigned char *data __attribute__((aligned(RING_CACHELINE)));
+    _size_t size;
+} _ring_t;
+
+/**
+ * _mpsc_t - a multi-producer single-consumer message ring.
+ *
+ * A slot is a sequence number followed by a message.
+ * The slot of position pos is free while its sequence
+ * number is pos, and holds a message when it is pos + 1.
+ *
+ * @param head next position claimed by a producer
+ * @param tail next position read by the consumer
+ * @param data the slots
+ * @param mask number of slots minus one
+ * @param stride size of a slot
+ * @param msg_size size of a message
+*/
+typedef struct {
+    _size_t head __attribute__((aligned(RING_CACHELINE)));
+    _size_t tail __attribute__((aligned(RING_CACHELINE)));
+    unsigned char *data __attribute__((aligned(RING_CACHELINE)));
+    _size_t mask;
+    _size_t stride;
+    _size_t msg_size;
+} _mpsc_t;
+
+/**
+ * __mpsc_slot - header of a slot.
+ *
+ * @param seq sequence number of the slot
+*/
+typedef struct {
+    _size_t seq;
+} __mpsc_slot;
+
+/**
+ * Library functions:
+ *  @fn _ring_create Create a byte ring.
+ *  @fn _ring_reserve Get the free space of a byte ring.
+ *  @fn _ring_commit Hand written bytes to the consumer.
+ *  @fn _ring_write Copy bytes into a byte ring.
+ *  @fn _ring_peek Get the committed bytes of a byte ring.
+ *  @fn _ring_release Give read bytes back to the producer.
+ *  @fn _ring_read Copy bytes out of a byte ring.
+ *  @fn _ring_used Get the number of committed bytes.
+ *  @fn _ring_destroy Free a byte ring.
+ *  @fn _mpsc_create Create a message ring.
+ *  @fn _mpsc_claim Get a free slot of a message ring.
+ *  @fn _mpsc_publish Hand a claimed slot to the consumer.
+ *  @fn _mpsc_push Copy a message into a message ring.
+ *  @fn _mpsc_peek Get the next message of a message ring.
+ *  @fn _mpsc_release Give the slot of a read message back.
+ *  @fn _mpsc_pop Copy the next message out of a message ring.
+ *  @fn _mpsc_destroy Free a message ring.
+*/
+
+/**
+ * Round a size up to a power of two.
+ *
+ * @param size the size
+ * @return the power of two, 0 if it does not fit
+*/
+_size_t __ring_pow2(_size_t size) {
+    _size_t pow2 = 1;
+
+    while (pow2 < size && pow2 != 0) pow2 <<= 1;
+
+    return pow2;
+}
+
+/**
+ * Create a byte ring.
+ *
+ * Example usage:
+ *  _ring_t *ring = _ring_create(1 << 16);
+ *
+ * @param size size of the buffer, rounded up to a power of two
+ * @return the ring, or NULL on failure
+*/
+_ring_t *_ring_create(_size_t size) {
+    size = __ring_pow2(size < RING_CACHELINE ? RING_CACHELINE : size);
+    if (size == 0) return NULL;
+
+    _ring_t *ring = _aligned_alloc(RING_CACHELINE, sizeof(_ring_t));
+    if (ring == NULL) return NULL;
+
+    ring->data = _aligned_alloc(RING_CACHELINE, size);
+    if (ring->data == NULL) {
+        _free(ring);
+        return NULL;
+    }
+
+    ring->head = 0;
+    ring->tail_cache = 0;
+    ring->tail = 0;
+    ring->head_cache = 0;
+    ring->size = size;
+
+    return ring;
+}
+
+/**
+ * Get the free space of a byte ring (producer).
+ *
+ * The space is contiguous: at the end of the buffer it
+ * stops there, and the rest is at the start once this
+ * part is committed. Nothing is reserved until it is
+ * committed, calling it again returns the same space.
+ *
+ * @param ring the ring
+ * @param len where to store the size of the space
+ * @return start of the space
+*/
+void *_ring_reserve(_ring_t *ring, _size_t *len) {
+    _size_t head = ring->head;
+    _size_t offset = head & (ring->size - 1);
+    _size_t contiguous = ring->size - offset;
+    _size_t free = ring->size - (head - ring->tail_cache);
+
+    // the cached tail may be old, look at the one of the consumer
+    if (free < contiguous) {
+        ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        free = ring->size - (head - ring->tail_cache);
+    }
+
+    *len = free < contiguous ? free : contiguous;
+
+    return ring->data + offset;
+}
+
+/**
+ * Hand written bytes to the consumer (producer).
+ *
+ * The bytes have to be in the space of _ring_reserve.
+ * The release store orders them before the new head.
+ *
+ * @param ring the ring
+ * @param len number of bytes
+*/
+void _ring_commit(_ring_t *ring, _size_t len) {
+    __atomic_store_n(&ring->head, ring->head + len, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copy bytes into a byte ring (producer).
+ *
+ * Example usage:
+ *  if (_ring_write(ring, record, len) < len) ...   // full
+ *
+ * @param ring the ring
+ * @param data the bytes
+ * @param len number of bytes
+ * @return number of bytes written, less than len if
+ *         the ring is full
+*/
+_size_t _ring_write(_ring_t *ring, const void *data, _size_t len) {
+    const unsigned char *src = (const unsigned char *)data;
+    _size_t head = ring->head;
+    _size_t free = ring->size - (head - ring->tail_cache);
+
+    if (free < len) {
+        ring->tail_cache = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        free = ring->size - (head - ring->tail_cache);
+    }
+
+    if (len > free) len = free;
+
+    // up to the end of the buffer, then from its start
+    _size_t offset = head & (ring->size - 1);
+    _size_t first = ring->size - offset < len ? ring->size - offset : len;
+
+    _memcpy(ring->data + offset, src, first);
+    _memcpy(ring->data, src + first, len - first);
+
+    __atomic_store_n(&ring->head, head + len, __ATOMIC_RELEASE);
+
+    return len;
+}
+
+/**
+ * Get the committed bytes of a byte ring (consumer).
+ *
+ * Like _ring_reserve, the bytes are contiguous and stop
+ * at the end of the buffer.
+ *
+ * @param ring the ring
+ * @param len where to store the number of bytes
+ * @return start of the bytes
+*/
+const void *_ring_peek(_ring_t *ring, _size_t *len) {
+    _size_t tail = ring->tail;
+    _size_t offset = tail & (ring->size - 1);
+    _size_t contiguous = ring->size - offset;
+    _size_t used = ring->head_cache - tail;
+
+    if (used < contiguous) {
+        ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        used = ring->head_cache - tail;
+    }
+
+    *len = used < contiguous ? used : contiguous;
+
+    return ring->data + offset;
+}
+
+/**
+ * Give read bytes back to the producer (consumer).
+ *
+ * @param ring the ring
+ * @param len number of bytes, at most the ones of _ring_peek
+*/
+void _ring_release(_ring_t *ring, _size_t len) {
+    __atomic_store_n(&ring->tail, ring->tail + len, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copy bytes out of a byte ring (consumer).
+ *
+ * @param ring the ring
+ * @param buffer where to copy the bytes
+ * @param len size of the buffer
+ * @return number of bytes copied, 0 if the ring is empty
+*/
+_size_t _ring_read(_ring_t *ring, void *buffer, _size_t len) {
+    unsigned char *dst = (unsigned char *)buffer;
+    _size_t tail = ring->tail;
+    _size_t used = ring->head_cache - tail;
+
+    if (used < len) {
+        ring->head_cache = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        used = ring->head_cache - tail;
+    }
+
+    if (len > used) len = used;
+
+    _size_t offset = tail & (ring->size - 1);
+    _size_t first = ring->size - offset < len ? ring->size - offset : len;
+
+    _memcpy(dst, ring->data + offset, first);
+    _memcpy(dst + first, ring->data, len - first);
+
+    __atomic_store_n(&ring->tail, tail + len, __ATOMIC_RELEASE);
+
+    return len;
+}
+
+/**
+ * Get the number of committed bytes of a byte ring.
+ *
+ * Exact only when called by one of the two sides
+ * while the other one does not touch the ring.
+ *
+ * @param ring the ring
+ * @return number of bytes committed and not released
+*/
+_size_t _ring_used(const _ring_t *ring) {
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * Free a byte ring.
+ *
+ * @param ring the ring
+*/
+void _ring_destroy(_ring_t *ring) {
+    _free(ring->data);
+    _free(ring);
+}
+
+/**
+ * Create a message ring.
+ *
+ * Example usage:
+ *  _mpsc_t *events = _mpsc_create(1024, sizeof(event));
+ *
+ * @param slots number of messages it holds, rounded up to a power of two
+ * @param msg_size size of a message
+ * @return the ring, or NULL on failure
+*/
+_mpsc_t *_mpsc_create(_size_t slots, _size_t msg_size) {
+    slots = __ring_pow2(slots < 2 ? 2 : slots);
+    if (slots == 0) return NULL;
+
+    _mpsc_t *ring = _aligned_alloc(RING_CACHELINE, sizeof(_mpsc_t));
+    if (ring == NULL) return NULL;
+
+    // the messages keep the alignment of the sequence numbers
+    ring->stride = (sizeof(__mpsc_slot) + msg_size + sizeof(_size_t) - 1) & ~(sizeof(_size_t) - 1);
+    ring->data = _aligned_alloc(RING_CACHELINE, slots * ring->stride);
+
+    if (ring->data == NULL) {
+        _free(ring);
+        return NULL;
+    }
+
+    for (_size_t i = 0; i < slots; i++) {
+        ((__mpsc_slot *)(ring->data + i * ring->stride))->seq = i;
+    }
+
+    ring->head = 0;
+    ring->tail = 0;
+    ring->mask = slots - 1;
+    ring->msg_size = msg_size;
+
+    return ring;
+}
+
+/**
+ * Get a free slot of a message ring (producer).
+ *
+ * The producer which moves the head past the slot owns
+ * it until it publishes the message. The consumer waits
+ * for the message of a claimed slot, so publish soon.
+ *
+ * @param ring the ring
+ * @return where to write the message, or NULL if the ring is full
+*/
+void *_mpsc_claim(_mpsc_t *ring) {
+    _size_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+    for (;;) {
+        __mpsc_slot *slot = (__mpsc_slot *)(ring->data + (pos & ring->mask) * ring->stride);
+        long diff = (long)(__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 1, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return slot + 1;
+            }
+        }
+        // the consumer has not released the message of the previous lap
+        else if (diff < 0) return NULL;
+        else pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * Hand a claimed slot to the consumer (producer).
+ *
+ * @param ring the ring
+ * @param msg the message, as returned by _mpsc_claim
+*/
+void _mpsc_publish(_mpsc_t *ring, void *msg) {
+    __mpsc_slot *slot = (__mpsc_slot *)msg - 1;
+
+    __atomic_store_n(&slot->seq, slot->seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Copy a message into a message ring (producer).
+ *
+ * Example usage:
+ *  while (_mpsc_push(events, &ev) != 0) ...   // full
+ *
+ * @param ring the ring
+ * @param msg the message, msg_size bytes
+ * @return 0 on success, -1 if the ring is full
+*/
+int _mpsc_push(_mpsc_t *ring, const void *msg) {
+    void *slot = _mpsc_claim(ring);
+    if (slot == NULL) return -1;
+
+    _memcpy(slot, msg, ring->msg_size);
+    _mpsc_publish(ring, slot);
+
+    return 0;
+}
+
+/**
+ * Get the next message of a message ring (consumer).
+ *
+ * @param ring the ring
+ * @return the message, or NULL if the ring is empty or
+ *         the next message is not published yet
+*/
+void *_mpsc_peek(_mpsc_t *ring) {
+    __mpsc_slot *slot = (__mpsc_slot *)(ring->data + (ring->tail & ring->mask) * ring->stride);
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != ring->tail + 1) return NULL;
+
+    return slot + 1;
+}
+
+/**
+ * Give the slot of the message of _mpsc_peek back (consumer).
+ *
+ * The slot is free again for the position one lap ahead.
+ *
+ * @param ring the ring
+*/
+void _mpsc_release(_mpsc_t *ring) {
+    __mpsc_slot *slot = (__mpsc_slot *)(ring->data + (ring->tail & ring->mask) * ring->stride);
+
+    __atomic_store_n(&slot->seq, ring->tail + ring->mask + 1, __ATOMIC_RELEASE);
+    ring->tail++;
+}
+
+/**
+ * Copy the next message out of a message ring (consumer).
+ *
+ * @param ring the ring
+ * @param msg where to copy the message, msg_size bytes
+ * @return 0 on success, -1 if there is no message
+*/
+int _mpsc_pop(_mpsc_t *ring, void *msg) {
+    void *slot = _mpsc_peek(ring);
+    if (slot == NULL) return -1;
+
+    _memcpy(msg, slot, ring->msg_size);
+    _mpsc_release(ring);
+
+    return 0;
+}
+
+/**
+ * Free a message ring.
+ *
+ * @param ring the ring
+*/
+void _mpsc_destroy(_mpsc_t *ring) {
+    _free(ring->data);
+    _free(ring);
+}
+
+#endif // __RING_H__
@@ -0,0 +1,418 @@
+/**
+ * _search.h - Searching in sorted arrays.
+ *
+ * A binary search jumps across the whole array, every
+ * step of a big search is a cache miss which can not
+ * start before the comparison of the step before it
+ * is done. The library makes the misses cheaper in
+ * two ways:
+ *
+ * - the searches are branchless, the next position
+ *   is computed without a jump, so there are no
+ *   mispredictions, and the elements of the step
+ *   after the next one are prefetched
+ * - arrays searched many times can be copied into an
+ *   index ordered for searching (see _search_build):
+ *   the Eytzinger layout (the order of a breadth-first
+ *   walk of the search tree), where all elements of the
+ *   next four steps share a cache line and are
+ *   prefetched at once, or the static B-tree layout,
+ *   where every step takes a node of one cache line
+ *
+ * The header is included by _stdlib.h.
+ *
+ * Example usage:
+ *  _search_index_t *index = _search_build(table, count, sizeof(entry), compare, SEARCH_EYTZINGER);
+ *  const entry *found = _search_find(index, &key);
+ *  ...
+ *  _search_free(index);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __SEARCH_H__
+#define __SEARCH_H__
+
+#include <_stdlib.h>
+
+/**
+ * Layouts of a search index.
+ *
+ * - SEARCH_EYTZINGER - the breadth-first order of the search tree
+ * - SEARCH_BTREE     - a static B-tree with nodes of one cache line
+*/
+#define SEARCH_EYTZINGER 0
+#define SEARCH_BTREE     1
+
+/**
+ * SEARCH_CACHELINE - Size of a cache line, the unit of the layouts.
+*/
+#define SEARCH_CACHELINE 64
+
+/**
+ * _search_index_t - a sorted array copied in a search layout.
+ *
+ * @param data the elements (the Eytzinger layout leaves slot 0 empty)
+ * @param n number of elements
+ * @param size size of an element
+ * @param layout SEARCH_EYTZINGER or SEARCH_BTREE
+ * @param node keys in a B-tree node
+ * @param nodes number of B-tree nodes
+ * @param ahead the Eytzinger descendant prefetched, as a multiple of the position
+ * @param compar the comparator
+*/
+typedef struct {
+    char *data;
+    _size_t n;
+    _size_t size;
+    int layout;
+    _size_t node;
+    _size_t nodes;
+    _size_t ahead;
+    int (*compar)(const void *, const void *);
+} _search_index_t;
+
+/**
+ * Library functions:
+ *  @fn _bsearch Find an element of a sorted array.
+ *  @fn _lower_bound Find the first element of a sorted array not less than a key.
+ *  @fn RAWC_SEARCH_DEFINE Define the searches for one type.
+ *  @fn _search_build Copy a sorted array into a search index.
+ *  @fn _search_lower_bound Find the first element of an index not less than a key.
+ *  @fn _search_find Find an element of an index.
+ *  @fn _search_free Free a search index.
+*/
+
+/**
+ * Get how far ahead the Eytzinger search prefetches.
+ *
+ * The descendants of position k four levels down are
+ * 16k to 16k + 15, for elements of 4 bytes they fill
+ * one cache line. Bigger elements prefetch fewer levels
+ * ahead, at least the children.
+ *
+ * @param size size of an element
+ * @return the multiple of the position to prefetch
+*/
+_size_t __search_ahead(_size_t size) {
+    _size_t ahead = 2;
+
+    while (ahead * 2 * size <= SEARCH_CACHELINE) ahead *= 2;
+    return ahead;
+}
+
+/**
+ * Find the first element of a sorted array
+ * not less than a key.
+ *
+ * The range is halved without a branch, both
+ * halves which the next step can take are
+ * prefetched while the comparison runs.
+ *
+ * @param key the key
+ * @param base the array
+ * @param nmemb number of elements
+ * @param size size of an element
+ * @param compar the comparator, called with the key
+ *               and an element, as for _bsearch
+ * @return position of the element, nmemb if all
+ *         elements are less than the key
+*/
+_size_t _lower_bound(const void *key, const void *base, _size_t nmemb, _size_t size,
+                     int (*compar)(const void *, const void *)) {
+    const char *first = (const char *)base;
+    _size_t len = nmemb;
+
+    if (len == 0) return 0;
+
+    while (len > 1) {
+        _size_t half = len / 2;
+
+        __builtin_prefetch(first + half / 2 * size);
+        __builtin_prefetch(first + (half + half / 2) * size);
+
+        first += (compar(key, first + (half - 1) * size) > 0) * half * size;
+        len -= half;
+    }
+
+    return (first - (const char *)base) / size + (compar(key, first) > 0);
+}
+
+/**
+ * Find an element of a sorted array.
+ *
+ * Example usage:
+ *  int compare(const void *key, const void *element) {
+ *      return *(const int *)key - *(const int *)element;
+ *  }
+ *  ...
+ *  int *found = _bsearch(&key, numbers, count, sizeof(int), compare);
+ *
+ * @param key the key
+ * @param base the array, sorted by the comparator
+ * @param nmemb number of elements
+ * @param size size of an element
+ * @param compar the comparator, returns a negative number,
+ *               zero or a positive number if the key goes
+ *               before, with, or after the element
+ * @return an element equal to the key, or NULL
+*/
+void* _bsearch(const void *key, const void *base, _size_t nmemb, _size_t size,
+               int (*compar)(const void *, const void *)) {
+    _size_t pos = _lower_bound(key, base, nmemb, size, compar);
+    const char *element = (const char *)base + pos * size;
+
+    if (pos == nmemb || compar(key, element) != 0) return NULL;
+    return (void *)element;
+}
+
+/**
+ * Define the searches for one type.
+ *
+ * The macro defines:
+ *
+ * - `_size_t name(const type *base, _size_t n, type key)` -
+ *   position of the first element of a sorted array not
+ *   less than the key (n if none)
+ * - `void name##_eytzinger(const type *sorted, type *eytz, _size_t n)` -
+ *   copy a sorted array in the Eytzinger layout, eytz holds
+ *   n + 1 elements (slot 0 stays empty) and should be aligned
+ *   to SEARCH_CACHELINE
+ * - `_size_t name##_eytzinger_search(const type *eytz, _size_t n, type key)` -
+ *   position in eytz of the first element not less than
+ *   the key (0 if none)
+ *
+ * The comparison is a macro or a function `less(a, b)`
+ * taking two values of the type, true if a goes before b.
+ *
+ * Example usage:
+ *  #define U32_LESS(a, b) ((a) < (b))
+ *  RAWC_SEARCH_DEFINE(search_u32, unsigned int, U32_LESS)
+ *
+ * @param name name of the functions
+ * @param type type of the elements
+ * @param less the comparison
+*/
+#define RAWC_SEARCH_DEFINE(name, type, less)                                                \
+                                                                                            \
+_size_t name(const type *base, _size_t n, type key) {                                       \
+    const type *first = base;                                                               \
+    _size_t len = n;                                                                        \
+                                                                                            \
+    if (len == 0) return 0;                                                                 \
+                                                                                            \
+    while (len > 1) {                                                                       \
+        _size_t half = len / 2;                                                             \
+                                                                                            \
+        __builtin_prefetch(first + half / 2);                                               \
+        __builtin_prefetch(first + half + half / 2);                                        \
+                                                                                            \
+        first += less(first[half - 1], key) ? half : 0;                                     \
+        len -= half;                                                                        \
+    }                                                                                       \
+                                                                                            \
+    return (first - base) + less(*first, key);                                              \
+}                                                                                           \
+                                                                                            \
+_size_t name##_eytzinger_fill(const type *sorted, type *eytz, _size_t n, _size_t i, _size_t k) { \
+    if (k <= n) {                                                                           \
+        i = name##_eytzinger_fill(sorted, eytz, n, i, 2 * k);                               \
+        eytz[k] = sorted[i++];                                                              \
+        i = name##_eytzinger_fill(sorted, eytz, n, i, 2 * k + 1);                           \
+    }                                                                                       \
+                                                                                            \
+    return i;                                                                               \
+}                                                                                           \
+                                                                                            \
+void name##_eytzinger(const type *sorted, type *eytz, _size_t n) {                          \
+    name##_eytzinger_fill(sorted, eytz, n, 0, 1);                                           \
+}                                                                                           \
+                                                                                            \
+_size_t name##_eytzinger_search(const type *eytz, _size_t n, type key) {                    \
+    _size_t ahead = __search_ahead(sizeof(type));                                           \
+    _size_t k = 1;                                                                          \
+                                                                                            \
+    while (k <= n) {                                                                        \
+        __builtin_prefetch((const char *)eytz + k * ahead * sizeof(type));                  \
+        k = 2 * k + less(eytz[k], key);                                                     \
+    }                                                                                       \
+                                                                                            \
+    /* drop the right turns taken after the last left one */                                \
+    return k >> (__builtin_ctzll(~(unsigned long long)k) + 1);                              \
+}
+
+/**
+ * Copy an element into a search index.
+ *
+ * @param dst slot of the index
+ * @param src the element
+ * @param size size of an element
+*/
+void __search_copy(char *dst, const char *src, _size_t size) {
+    for (_size_t i = 0; i < size; i++) dst[i] = src[i];
+}
+
+/**
+ * Fill a search index in the Eytzinger layout, in
+ * the order of an in-order walk of the tree.
+ *
+ * @param index the index
+ * @param sorted the sorted array
+ * @param i next element of the sorted array
+ * @param k position in the index
+ * @return next element of the sorted array after the subtree
+*/
+_size_t __search_fill_eytzinger(_search_index_t *index, const char *sorted, _size_t i, _size_t k) {
+    if (k <= index->n) {
+        i = __search_fill_eytzinger(index, sorted, i, 2 * k);
+        __search_copy(index->data + k * index->size, sorted + i * index->size, index->size);
+        i = __search_fill_eytzinger(index, sorted, i + 1, 2 * k + 1);
+    }
+
+    return i;
+}
+
+/**
+ * Fill a search index in the B-tree layout.
+ *
+ * The children of node k are nodes k * (node + 1) + 1
+ * to k * (node + 1) + node + 1, the slots left after
+ * the last element get copies of it, so they keep
+ * the order and are never the first one not less
+ * than a key before a real element.
+ *
+ * @param index the index
+ * @param sorted the sorted array
+ * @param i next element of the sorted array
+ * @param k the node
+ * @return next element of the sorted array after the subtree
+*/
+_size_t __search_fill_btree(_search_index_t *index, const char *sorted, _size_t i, _size_t k) {
+    _size_t size = index->size;
+    _size_t last = index->n - 1;
+
+    if (k >= index->nodes) return i;
+
+    for (_size_t j = 0; j < index->node; j++) {
+        i = __search_fill_btree(index, sorted, i, k * (index->node + 1) + j + 1);
+
+        __search_copy(index->data + (k * index->node + j) * size, sorted + (i < last ? i : last) * size, size);
+        i++;
+    }
+
+    return __search_fill_btree(index, sorted, i, k * (index->node + 1) + index->node + 1);
+}
+
+/**
+ * Copy a sorted array into a search index.
+ *
+ * The index is a copy, the array can be freed after
+ * the call. Building takes O(n) time, so an index pays
+ * off for arrays searched many times.
+ *
+ * Example usage:
+ *  _search_index_t *index = _search_build(numbers, count, sizeof(int), compare, SEARCH_BTREE);
+ *
+ * @param base the array, sorted by the comparator
+ * @param nmemb number of elements
+ * @param size size of an element
+ * @param compar the comparator, called with the key
+ *               and an element, as for _bsearch
+ * @param layout SEARCH_EYTZINGER or SEARCH_BTREE
+ * @return the index, or NULL on failure
+*/
+_search_index_t* _search_build(const void *base, _size_t nmemb, _size_t size,
+                               int (*compar)(const void *, const void *), int layout) {
+    if (size == 0 || (layout != SEARCH_EYTZINGER && layout != SEARCH_BTREE)) return NULL;
+
+    _search_index_t *index = _malloc(sizeof(_search_index_t));
+    if (index == NULL) return NULL;
+
+    index->n = nmemb;
+    index->size = size;
+    index->layout = layout;
+    index->compar = compar;
+    index->ahead = __search_ahead(size);
+    index->node = SEARCH_CACHELINE / size < 2 ? 2 : SEARCH_CACHELINE / size;
+    index->nodes = (nmemb + index->node - 1) / index->node;
+
+    _size_t slots = layout == SEARCH_EYTZINGER ? nmemb + 1 : index->nodes * index->node;
+
+    if (slots > (_size_t)-1 / size
+        || (index->data = _aligned_alloc(SEARCH_CACHELINE, slots * size)) == NULL) {
+        _free(index);
+        return NULL;
+    }
+
+    if (layout == SEARCH_EYTZINGER) __search_fill_eytzinger(index, (const char *)base, 0, 1);
+    else if (nmemb > 0) __search_fill_btree(index, (const char *)base, 0, 0);
+
+    return index;
+}
+
+/**
+ * Find the first element of a search index
+ * not less than a key.
+ *
+ * @param index the index
+ * @param key the key
+ * @return the element (in the index), or NULL if
+ *         all elements are less than the key
+*/
+void* _search_lower_bound(const _search_index_t *index, const void *key) {
+    _size_t size = index->size;
+
+    if (index->layout == SEARCH_EYTZINGER) {
+        _size_t k = 1;
+
+        while (k <= index->n) {
+            __builtin_prefetch(index->data + k * index->ahead * size);
+            k = 2 * k + (index->compar(key, index->data + k * size) > 0);
+        }
+
+        // drop the right turns taken after the last left one
+        k >>= __builtin_ctzll(~(unsigned long long)k) + 1;
+
+        return k == 0 ? NULL : index->data + k * size;
+    }
+
+    char *found = NULL;
+
+    for (_size_t k = 0; k < index->nodes;) {
+        char *node = index->data + k * index->node * size;
+        _size_t i = _lower_bound(key, node, index->node, size, index->compar);
+
+        if (i < index->node) found = node + i * size;
+        k = k * (index->node + 1) + i + 1;
+    }
+
+    return found;
+}
+
+/**
+ * Find an element of a search index.
+ *
+ * @param index the index
+ * @param key the key
+ * @return an element equal to the key (in the index), or NULL
+*/
+void* _search_find(const _search_index_t *index, const void *key) {
+    void *element = _search_lower_bound(index, key);
+
+    if (element == NULL || index->compar(key, element) != 0) return NULL;
+    return element;
+}
+
+/**
+ * Free a search index.
+ *
+ * @param index the index
+*/
+void _search_free(_search_index_t *index) {
+    _free(index->data);
+    _free(index);
+}
+
+#endif // __SEARCH_H__
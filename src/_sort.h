@@ -0,0 +1,786 @@
+/**
+ * _sort.h - Sorting.
+ *
+ * The library provides three ways of sorting:
+ *
+ * - _qsort            - the standard interface, a comparator
+ *                       called through a pointer and elements
+ *                       of any size
+ * - RAWC_SORT_DEFINE  - a sort function generated for one type,
+ *                       the comparison is inlined and elements
+ *                       are moved as values
+ * - _radix_sort_*     - LSD radix sorts of integer and float keys,
+ *                       they do not compare at all
+ *
+ * The comparison sorts are pattern-defeating quicksorts
+ * (pdqsort, Orson Peters): a quicksort with insertion sort
+ * for short ranges, which detects already sorted input,
+ * breaks up patterns giving bad pivots and falls back to
+ * heapsort, so the worst case stays O(n log n).
+ *
+ * The header is included by _stdlib.h.
+ *
+ * Example usage:
+ *  #define LESS(a, b) ((a).key < (b).key)
+ *  RAWC_SORT_DEFINE(sort_items, item, LESS)
+ *  ...
+ *  sort_items(items, count);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __SORT_H__
+#define __SORT_H__
+
+#include <_stdlib.h>
+
+/**
+ * Library functions:
+ *  @fn _qsort Sort an array with a comparator function.
+ *  @fn RAWC_SORT_DEFINE Define a sort function for one type.
+ *  @fn _radix_sort_u32 Sort an array of 32-bit unsigned integers.
+ *  @fn _radix_sort_u64 Sort an array of 64-bit unsigned integers.
+ *  @fn _radix_sort_f32 Sort an array of floats.
+*/
+
+/**
+ * Tuning of the sorts.
+ *
+ * - INSERTION      - ranges shorter than this are insertion sorted
+ * - NINTHER        - ranges longer than this take the pseudomedian
+ *                    of 9 elements as the pivot, not the median of 3
+ * - PARTIAL_LIMIT  - number of moves after which the insertion sort
+ *                    of an already partitioned range gives up
+ * - BLOCK          - number of elements looked at in one block of
+ *                    the branchless partition
+ * - RADIX_MIN      - arrays shorter than this are not radix sorted
+*/
+#define __SORT_INSERTION      24
+#define __SORT_NINTHER        128
+#define __SORT_PARTIAL_LIMIT  8
+#define __SORT_BLOCK          64
+#define __SORT_RADIX_MIN      256
+
+/**
+ * Get the number of bad partitions allowed
+ * before switching to heapsort.
+ *
+ * @param n number of elements
+ * @return floor(log2(n))
+*/
+int __sort_log2(_size_t n) {
+    int log = 0;
+
+    while (n >>= 1) log++;
+    return log;
+}
+
+/**
+ * Define a sort function for one type.
+ *
+ * The macro defines `void name(type *base, _size_t n)`,
+ * sorting the array in ascending order, and its helpers
+ * (prefixed with `name`). The comparison is a macro or a
+ * function `less(a, b)` taking two values of the type,
+ * true if a goes before b. It is inlined into the sort,
+ * so no call is made per comparison.
+ *
+ * The partitions are branchless (BlockQuicksort, Edelkamp
+ * and Weiss): elements on the wrong side are collected in
+ * blocks of offsets and swapped afterwards, so the result
+ * of a comparison never decides a jump.
+ *
+ * Example usage:
+ *  #define INT_LESS(a, b) ((a) < (b))
+ *  RAWC_SORT_DEFINE(sort_ints, int, INT_LESS)
+ *
+ * @param name name of the function
+ * @param type type of the elements
+ * @param less the comparison
+*/
+#define RAWC_SORT_DEFINE(name, type, less)                                                  \
+                                                                                            \
+void name##_swap(type *a, type *b) {                                                        \
+    type tmp = *a;                                                                          \
+    *a = *b;                                                                                \
+    *b = tmp;                                                                               \
+}                                                                                           \
+                                                                                            \
+void name##_sort2(type *a, type *b) {                                                       \
+    if (less(*b, *a)) name##_swap(a, b);                                                    \
+}                                                                                           \
+                                                                                            \
+void name##_sort3(type *a, type *b, type *c) {                                              \
+    name##_sort2(a, b);                                                                     \
+    name##_sort2(b, c);                                                                     \
+    name##_sort2(a, b);                                                                     \
+}                                                                                           \
+                                                                                            \
+/* guarded - the range is the start of the array */                                         \
+void name##_insertion(type *begin, type *end, int guarded) {                                \
+    if (begin == end) return;                                                               \
+                                                                                            \
+    for (type *cur = begin + 1; cur != end; cur++) {                                        \
+        type *sift = cur;                                                                   \
+        type *sift_1 = cur - 1;                                                             \
+                                                                                            \
+        if (less(*sift, *sift_1)) {                                                         \
+            type tmp = *sift;                                                               \
+                                                                                            \
+            do *sift-- = *sift_1;                                                           \
+            while ((!guarded || sift != begin) && less(tmp, *--sift_1));                    \
+                                                                                            \
+            *sift = tmp;                                                                    \
+        }                                                                                   \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+int name##_partial_insertion(type *begin, type *end) {                                      \
+    _size_t limit = 0;                                                                      \
+                                                                                            \
+    if (begin == end) return 1;                                                             \
+                                                                                            \
+    for (type *cur = begin + 1; cur != end; cur++) {                                        \
+        type *sift = cur;                                                                   \
+        type *sift_1 = cur - 1;                                                             \
+                                                                                            \
+        if (less(*sift, *sift_1)) {                                                         \
+            type tmp = *sift;                                                               \
+                                                                                            \
+            do *sift-- = *sift_1;                                                           \
+            while (sift != begin && less(tmp, *--sift_1));                                  \
+                                                                                            \
+            *sift = tmp;                                                                    \
+            limit += cur - sift;                                                            \
+        }                                                                                   \
+                                                                                            \
+        if (limit > __SORT_PARTIAL_LIMIT) return 0;                                         \
+    }                                                                                       \
+                                                                                            \
+    return 1;                                                                               \
+}                                                                                           \
+                                                                                            \
+void name##_sift_down(type *base, _size_t n, _size_t root) {                                \
+    type tmp = base[root];                                                                  \
+                                                                                            \
+    while (2 * root + 1 < n) {                                                              \
+        _size_t child = 2 * root + 1;                                                       \
+                                                                                            \
+        if (child + 1 < n && less(base[child], base[child + 1])) child++;                   \
+        if (!less(tmp, base[child])) break;                                                 \
+                                                                                            \
+        base[root] = base[child];                                                           \
+        root = child;                                                                       \
+    }                                                                                       \
+                                                                                            \
+    base[root] = tmp;                                                                       \
+}                                                                                           \
+                                                                                            \
+void name##_heapsort(type *begin, type *end) {                                              \
+    _size_t n = end - begin;                                                                \
+                                                                                            \
+    for (_size_t i = n / 2; i > 0; i--) name##_sift_down(begin, n, i - 1);                  \
+                                                                                            \
+    for (_size_t i = n - 1; i > 0; i--) {                                                   \
+        name##_swap(begin, begin + i);                                                      \
+        name##_sift_down(begin, i, 0);                                                      \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+/* equal elements go to the left, for ranges full of the pivot */                          \
+type* name##_partition_left(type *begin, type *end) {                                       \
+    type pivot = *begin;                                                                    \
+    type *first = begin;                                                                    \
+    type *last = end;                                                                       \
+                                                                                            \
+    while (less(pivot, *--last));                                                           \
+                                                                                            \
+    if (last + 1 == end) while (first < last && !less(pivot, *++first));                    \
+    else while (!less(pivot, *++first));                                                    \
+                                                                                            \
+    while (first < last) {                                                                  \
+        name##_swap(first, last);                                                           \
+        while (less(pivot, *--last));                                                       \
+        while (!less(pivot, *++first));                                                     \
+    }                                                                                       \
+                                                                                            \
+    *begin = *last;                                                                         \
+    *last = pivot;                                                                          \
+    return last;                                                                            \
+}                                                                                           \
+                                                                                            \
+void name##_swap_offsets(type *first, type *last, unsigned char *offsets_l,                 \
+                         unsigned char *offsets_r, _size_t num, int use_swaps) {            \
+    if (use_swaps) {                                                                        \
+        /* descending input needs real swaps to stay O(n) */                                \
+        for (_size_t i = 0; i < num; i++) name##_swap(first + offsets_l[i], last - offsets_r[i]); \
+    } else if (num > 0) {                                                                   \
+        type *l = first + offsets_l[0];                                                     \
+        type *r = last - offsets_r[0];                                                      \
+        type tmp = *l;                                                                      \
+                                                                                            \
+        *l = *r;                                                                            \
+        for (_size_t i = 1; i < num; i++) {                                                 \
+            l = first + offsets_l[i];                                                       \
+            *r = *l;                                                                        \
+            r = last - offsets_r[i];                                                        \
+            *l = *r;                                                                        \
+        }                                                                                   \
+        *r = tmp;                                                                           \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+/* elements less than the pivot go to the left, returns the pivot position */              \
+type* name##_partition_right(type *begin, type *end, int *already_partitioned) {            \
+    type pivot = *begin;                                                                    \
+    type *first = begin;                                                                    \
+    type *last = end;                                                                       \
+                                                                                            \
+    /* the median of 3 guarantees an element not less than the pivot */                    \
+    while (less(*++first, pivot));                                                          \
+                                                                                            \
+    if (first - 1 == begin) while (first < last && !less(*--last, pivot));                  \
+    else while (!less(*--last, pivot));                                                     \
+                                                                                            \
+    *already_partitioned = first >= last;                                                   \
+                                                                                            \
+    if (!*already_partitioned) {                                                            \
+        unsigned char offsets_l[__SORT_BLOCK], offsets_r[__SORT_BLOCK];                     \
+        _size_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;                             \
+                                                                                            \
+        name##_swap(first, last);                                                           \
+        first++;                                                                            \
+                                                                                            \
+        type *base_l = first;                                                               \
+        type *base_r = last;                                                                \
+                                                                                            \
+        while (first < last) {                                                              \
+            _size_t unknown = last - first;                                                 \
+            _size_t split_l = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;        \
+            _size_t split_r = num_r == 0 ? unknown - split_l : 0;                           \
+                                                                                            \
+            if (split_l > __SORT_BLOCK) split_l = __SORT_BLOCK;                             \
+            if (split_r > __SORT_BLOCK) split_r = __SORT_BLOCK;                             \
+                                                                                            \
+            for (_size_t i = 0; i < split_l; i++) {                                         \
+                offsets_l[num_l] = i;                                                       \
+                num_l += !less(*first, pivot);                                              \
+                first++;                                                                    \
+            }                                                                               \
+                                                                                            \
+            for (_size_t i = 0; i < split_r; i++) {                                         \
+                offsets_r[num_r] = i + 1;                                                   \
+                num_r += less(*--last, pivot);                                              \
+            }                                                                               \
+                                                                                            \
+            _size_t num = num_l < num_r ? num_l : num_r;                                    \
+                                                                                            \
+            name##_swap_offsets(base_l, base_r, offsets_l + start_l, offsets_r + start_r,   \
+                                num, num_l == num_r);                                       \
+                                                                                            \
+            num_l -= num;                                                                   \
+            num_r -= num;                                                                   \
+            start_l += num;                                                                 \
+            start_r += num;                                                                 \
+                                                                                            \
+            if (num_l == 0) {                                                               \
+                start_l = 0;                                                                \
+                base_l = first;                                                             \
+            }                                                                               \
+            if (num_r == 0) {                                                               \
+                start_r = 0;                                                                \
+                base_r = last;                                                              \
+            }                                                                               \
+        }                                                                                   \
+                                                                                            \
+        /* move the elements left in one of the blocks */                                   \
+        if (num_l) {                                                                        \
+            while (num_l--) name##_swap(base_l + offsets_l[start_l + num_l], --last);       \
+            first = last;                                                                   \
+        }                                                                                   \
+        if (num_r) {                                                                        \
+            while (num_r--) name##_swap(base_r - offsets_r[start_r + num_r], first++);      \
+        }                                                                                   \
+    }                                                                                       \
+                                                                                            \
+    type *pivot_pos = first - 1;                                                            \
+                                                                                            \
+    *begin = *pivot_pos;                                                                    \
+    *pivot_pos = pivot;                                                                     \
+    return pivot_pos;                                                                       \
+}                                                                                           \
+                                                                                            \
+void name##_loop(type *begin, type *end, int bad_allowed, int leftmost) {                   \
+    for (;;) {                                                                              \
+        _size_t size = end - begin;                                                         \
+        _size_t s2 = size / 2;                                                              \
+                                                                                            \
+        if (size < __SORT_INSERTION) {                                                      \
+            name##_insertion(begin, end, leftmost);                                         \
+            return;                                                                         \
+        }                                                                                   \
+                                                                                            \
+        /* the pivot goes to the start of the range */                                      \
+        if (size > __SORT_NINTHER) {                                                        \
+            name##_sort3(begin, begin + s2, end - 1);                                       \
+            name##_sort3(begin + 1, begin + (s2 - 1), end - 2);                             \
+            name##_sort3(begin + 2, begin + (s2 + 1), end - 3);                             \
+            name##_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1));                   \
+            name##_swap(begin, begin + s2);                                                 \
+        } else name##_sort3(begin + s2, begin, end - 1);                                    \
+                                                                                            \
+        /* the pivot equals the element before the range, which is not */                   \
+        /* greater than any element of it: all equal ones go left, done */                  \
+        if (!leftmost && !less(*(begin - 1), *begin)) {                                     \
+            begin = name##_partition_left(begin, end) + 1;                                  \
+            continue;                                                                       \
+        }                                                                                   \
+                                                                                            \
+        int already_partitioned;                                                            \
+        type *pivot_pos = name##_partition_right(begin, end, &already_partitioned);         \
+        _size_t l_size = pivot_pos - begin;                                                 \
+        _size_t r_size = end - (pivot_pos + 1);                                             \
+                                                                                            \
+        if (l_size < size / 8 || r_size < size / 8) {                                       \
+            if (--bad_allowed == 0) {                                                       \
+                name##_heapsort(begin, end);                                                \
+                return;                                                                     \
+            }                                                                               \
+                                                                                            \
+            /* shuffle some elements to break the pattern */                                \
+            if (l_size >= __SORT_INSERTION) {                                               \
+                name##_swap(begin, begin + l_size / 4);                                     \
+                name##_swap(pivot_pos - 1, pivot_pos - l_size / 4);                         \
+                                                                                            \
+                if (l_size > __SORT_NINTHER) {                                              \
+                    name##_swap(begin + 1, begin + (l_size / 4 + 1));                       \
+                    name##_swap(begin + 2, begin + (l_size / 4 + 2));                       \
+                    name##_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));               \
+                    name##_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));               \
+                }                                                                           \
+            }                                                                               \
+                                                                                            \
+            if (r_size >= __SORT_INSERTION) {                                               \
+                name##_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));                   \
+                name##_swap(end - 1, end - r_size / 4);                                     \
+                                                                                            \
+                if (r_size > __SORT_NINTHER) {                                              \
+                    name##_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));               \
+                    name##_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));               \
+                    name##_swap(end - 2, end - (1 + r_size / 4));                           \
+                    name##_swap(end - 3, end - (2 + r_size / 4));                           \
+                }                                                                           \
+            }                                                                               \
+        } else if (already_partitioned && name##_partial_insertion(begin, pivot_pos)        \
+                                       && name##_partial_insertion(pivot_pos + 1, end)) {   \
+            return;                                                                         \
+        }                                                                                   \
+                                                                                            \
+        name##_loop(begin, pivot_pos, bad_allowed, leftmost);                               \
+        begin = pivot_pos + 1;                                                              \
+        leftmost = 0;                                                                       \
+    }                                                                                       \
+}                                                                                           \
+                                                                                            \
+void name(type *base, _size_t n) {                                                          \
+    if (n > 1) name##_loop(base, base + n, __sort_log2(n), 1);                              \
+}
+
+/**
+ * Swap two elements of a _qsort array.
+ *
+ * @param a first element
+ * @param b second element
+ * @param size size of an element
+*/
+void __qsort_swap(char *a, char *b, _size_t size) {
+    // the common sizes are swapped as one value
+    if (size == sizeof(int) && ((unsigned long)a | (unsigned long)b) % sizeof(int) == 0) {
+        int tmp = *(int *)a;
+
+        *(int *)a = *(int *)b;
+        *(int *)b = tmp;
+        return;
+    }
+
+    // whole words when the elements are made of them
+    if (size % sizeof(long) == 0 && ((unsigned long)a | (unsigned long)b) % sizeof(long) == 0) {
+        for (_size_t i = 0; i < size; i += sizeof(long)) {
+            long tmp = *(long *)(a + i);
+
+            *(long *)(a + i) = *(long *)(b + i);
+            *(long *)(b + i) = tmp;
+        }
+        return;
+    }
+
+    for (_size_t i = 0; i < size; i++) {
+        char tmp = a[i];
+
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
+
+/**
+ * __qsort_ctx - the element size and the comparator of a _qsort call.
+ *
+ * @param size size of an element
+ * @param compar the comparator
+*/
+typedef struct {
+    _size_t size;
+    int (*compar)(const void *, const void *);
+} __qsort_ctx;
+
+#define __QSORT_LESS(ctx, a, b) ((ctx)->compar((a), (b)) < 0)
+
+/**
+ * Sort three elements of a _qsort array.
+*/
+void __qsort_sort3(__qsort_ctx *ctx, char *a, char *b, char *c) {
+    if (__QSORT_LESS(ctx, b, a)) __qsort_swap(a, b, ctx->size);
+    if (__QSORT_LESS(ctx, c, b)) __qsort_swap(b, c, ctx->size);
+    if (__QSORT_LESS(ctx, b, a)) __qsort_swap(a, b, ctx->size);
+}
+
+/**
+ * Insertion sort a range of a _qsort array.
+ *
+ * Elements are moved by swapping them with their
+ * neighbour, no buffer of an element is needed.
+ *
+ * @param ctx the sort
+ * @param begin first element
+ * @param end end of the range
+ * @param limit number of moves after which to give up (0 - no limit)
+ * @return 1 if the range is sorted, 0 if the limit was hit
+*/
+int __qsort_insertion(__qsort_ctx *ctx, char *begin, char *end, _size_t limit) {
+    _size_t size = ctx->size;
+    _size_t moves = 0;
+
+    for (char *cur = begin + size; cur < end; cur += size) {
+        for (char *sift = cur; sift > begin && __QSORT_LESS(ctx, sift, sift - size); sift -= size) {
+            __qsort_swap(sift, sift - size, size);
+            moves++;
+        }
+
+        if (limit != 0 && moves > limit) return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * Move an element of a _qsort heap down to its place.
+ *
+ * @param ctx the sort
+ * @param base the heap
+ * @param n number of elements in the heap
+ * @param root index of the element
+*/
+void __qsort_sift_down(__qsort_ctx *ctx, char *base, _size_t n, _size_t root) {
+    _size_t size = ctx->size;
+
+    while (2 * root + 1 < n) {
+        _size_t child = 2 * root + 1;
+
+        if (child + 1 < n && __QSORT_LESS(ctx, base + child * size, base + (child + 1) * size)) child++;
+        if (!__QSORT_LESS(ctx, base + root * size, base + child * size)) break;
+
+        __qsort_swap(base + root * size, base + child * size, size);
+        root = child;
+    }
+}
+
+/**
+ * Heapsort a range of a _qsort array.
+*/
+void __qsort_heapsort(__qsort_ctx *ctx, char *begin, char *end) {
+    _size_t size = ctx->size;
+    _size_t n = (end - begin) / size;
+
+    for (_size_t i = n / 2; i > 0; i--) __qsort_sift_down(ctx, begin, n, i - 1);
+
+    for (_size_t i = n - 1; i > 0; i--) {
+        __qsort_swap(begin, begin + i * size, size);
+        __qsort_sift_down(ctx, begin, i, 0);
+    }
+}
+
+/**
+ * Partition a range of a _qsort array around its first
+ * element, elements equal to it go to the left.
+ *
+ * @return the position of the pivot
+*/
+char* __qsort_partition_left(__qsort_ctx *ctx, char *begin, char *end) {
+    _size_t size = ctx->size;
+    char *first = begin;
+    char *last = end;
+
+    // the pivot stays at begin until the end
+    while (__QSORT_LESS(ctx, begin, last -= size));
+
+    if (last + size == end) while (first < last && !__QSORT_LESS(ctx, begin, first += size));
+    else while (!__QSORT_LESS(ctx, begin, first += size));
+
+    while (first < last) {
+        __qsort_swap(first, last, size);
+        while (__QSORT_LESS(ctx, begin, last -= size));
+        while (!__QSORT_LESS(ctx, begin, first += size));
+    }
+
+    __qsort_swap(begin, last, size);
+    return last;
+}
+
+/**
+ * Partition a range of a _qsort array around its first
+ * element, elements less than it go to the left.
+ *
+ * @param already_partitioned set if no element was moved
+ * @return the position of the pivot
+*/
+char* __qsort_partition_right(__qsort_ctx *ctx, char *begin, char *end, int *already_partitioned) {
+    _size_t size = ctx->size;
+    char *first = begin;
+    char *last = end;
+
+    // the median of 3 guarantees an element not less than the pivot
+    while (__QSORT_LESS(ctx, first += size, begin));
+
+    if (first - size == begin) while (first < last && !__QSORT_LESS(ctx, last -= size, begin));
+    else while (!__QSORT_LESS(ctx, last -= size, begin));
+
+    *already_partitioned = first >= last;
+
+    while (first < last) {
+        __qsort_swap(first, last, size);
+        while (__QSORT_LESS(ctx, first += size, begin));
+        while (!__QSORT_LESS(ctx, last -= size, begin));
+    }
+
+    __qsort_swap(begin, first - size, size);
+    return first - size;
+}
+
+/**
+ * Sort a range of a _qsort array (see RAWC_SORT_DEFINE
+ * for the steps, this is the same loop on raw bytes).
+*/
+void __qsort_loop(__qsort_ctx *ctx, char *begin, char *end, int bad_allowed, int leftmost) {
+    _size_t size = ctx->size;
+
+    for (;;) {
+        _size_t n = (end - begin) / size;
+        char *mid = begin + n / 2 * size;
+
+        if (n < __SORT_INSERTION) {
+            __qsort_insertion(ctx, begin, end, 0);
+            return;
+        }
+
+        if (n > __SORT_NINTHER) {
+            __qsort_sort3(ctx, begin, mid, end - size);
+            __qsort_sort3(ctx, begin + size, mid - size, end - 2 * size);
+            __qsort_sort3(ctx, begin + 2 * size, mid + size, end - 3 * size);
+            __qsort_sort3(ctx, mid - size, mid, mid + size);
+            __qsort_swap(begin, mid, size);
+        } else __qsort_sort3(ctx, mid, begin, end - size);
+
+        if (!leftmost && !__QSORT_LESS(ctx, begin - size, begin)) {
+            begin = __qsort_partition_left(ctx, begin, end) + size;
+            continue;
+        }
+
+        int already_partitioned;
+        char *pivot = __qsort_partition_right(ctx, begin, end, &already_partitioned);
+        _size_t l_size = (pivot - begin) / size;
+        _size_t r_size = (end - pivot) / size - 1;
+
+        if (l_size < n / 8 || r_size < n / 8) {
+            if (--bad_allowed == 0) {
+                __qsort_heapsort(ctx, begin, end);
+                return;
+            }
+
+            // shuffle some elements to break the pattern
+            if (l_size >= __SORT_INSERTION) {
+                __qsort_swap(begin, begin + l_size / 4 * size, size);
+                __qsort_swap(pivot - size, pivot - l_size / 4 * size, size);
+            }
+
+            if (r_size >= __SORT_INSERTION) {
+                __qsort_swap(pivot + size, pivot + (1 + r_size / 4) * size, size);
+                __qsort_swap(end - size, end - r_size / 4 * size, size);
+            }
+        } else if (already_partitioned && __qsort_insertion(ctx, begin, pivot, __SORT_PARTIAL_LIMIT)
+                                       && __qsort_insertion(ctx, pivot + size, end, __SORT_PARTIAL_LIMIT)) {
+            return;
+        }
+
+        __qsort_loop(ctx, begin, pivot, bad_allowed, leftmost);
+        begin = pivot + size;
+        leftmost = 0;
+    }
+}
+
+/**
+ * Sort an array with a comparator function.
+ *
+ * The sort is not stable. For arrays of one known
+ * type, a sort from RAWC_SORT_DEFINE is several
+ * times faster, it does not call a function for
+ * every comparison.
+ *
+ * Example usage:
+ *  int compare(const void *a, const void *b) {
+ *      return *(const int *)a - *(const int *)b;
+ *  }
+ *  ...
+ *  _qsort(numbers, count, sizeof(int), compare);
+ *
+ * @param base the array
+ * @param nmemb number of elements
+ * @param size size of an element
+ * @param compar the comparator, returns a negative number,
+ *               zero or a positive number if the first
+ *               element goes before, with, or after the second
+*/
+void _qsort(void *base, _size_t nmemb, _size_t size, int (*compar)(const void *, const void *)) {
+    __qsort_ctx ctx = { size, compar };
+
+    if (nmemb < 2 || size == 0) return;
+
+    __qsort_loop(&ctx, (char *)base, (char *)base + nmemb * size, __sort_log2(nmemb), 1);
+}
+
+/**
+ * Sorts of the radix sort keys, for the short arrays.
+*/
+#define __SORT_KEY_LESS(a, b) ((a) < (b))
+
+RAWC_SORT_DEFINE(__sort_u32, unsigned int, __SORT_KEY_LESS)
+RAWC_SORT_DEFINE(__sort_u64, unsigned long long, __SORT_KEY_LESS)
+
+/**
+ * Define an LSD radix sort of unsigned keys.
+ *
+ * The keys are sorted one byte at a time, from the
+ * lowest one, moving them between the array and a
+ * buffer. The counts of all bytes are taken in one
+ * pass first, bytes which are the same in all keys
+ * are skipped.
+ *
+ * @param name name of the function
+ * @param type type of the keys
+ * @param fallback comparison sort for short arrays
+*/
+#define __RADIX_DEFINE(name, type, fallback)                                                \
+void name(type *keys, _size_t n) {                                                          \
+    _size_t counts[sizeof(type)][256];                                                      \
+    type *buffer;                                                                           \
+                                                                                            \
+    if (n < __SORT_RADIX_MIN || n > (_size_t)-1 / sizeof(type)                              \
+        || (buffer = (type *)_malloc(n * sizeof(type))) == NULL) {                          \
+        fallback(keys, n);                                                                  \
+        return;                                                                             \
+    }                                                                                       \
+                                                                                            \
+    for (unsigned b = 0; b < sizeof(type); b++)                                             \
+        for (unsigned d = 0; d < 256; d++) counts[b][d] = 0;                                \
+                                                                                            \
+    for (_size_t i = 0; i < n; i++) {                                                       \
+        type key = keys[i];                                                                 \
+                                                                                            \
+        for (unsigned b = 0; b < sizeof(type); b++) counts[b][(key >> (8 * b)) & 255]++;    \
+    }                                                                                       \
+                                                                                            \
+    type *src = keys;                                                                       \
+    type *dst = buffer;                                                                     \
+                                                                                            \
+    for (unsigned b = 0; b < sizeof(type); b++) {                                           \
+        _size_t *count = counts[b];                                                         \
+        _size_t offset = 0;                                                                 \
+                                                                                            \
+        if (count[(keys[0] >> (8 * b)) & 255] == n) continue;                               \
+                                                                                            \
+        for (unsigned d = 0; d < 256; d++) {                                                \
+            _size_t c = count[d];                                                           \
+                                                                                            \
+            count[d] = offset;                                                              \
+            offset += c;                                                                    \
+        }                                                                                   \
+                                                                                            \
+        for (_size_t i = 0; i < n; i++) {                                                   \
+            type key = src[i];                                                              \
+                                                                                            \
+            dst[count[(key >> (8 * b)) & 255]++] = key;                                     \
+        }                                                                                   \
+                                                                                            \
+        type *tmp = src;                                                                    \
+        src = dst;                                                                          \
+        dst = tmp;                                                                          \
+    }                                                                                       \
+                                                                                            \
+    if (src != keys) for (_size_t i = 0; i < n; i++) keys[i] = src[i];                      \
+                                                                                            \
+    _free(buffer);                                                                          \
+}
+
+/**
+ * Sort an array of 32-bit unsigned integers.
+ *
+ * The sort takes a buffer as big as the array, if it
+ * can not be allocated, the keys are sorted in place
+ * with a comparison sort.
+ *
+ * @param keys the array
+ * @param n number of keys
+*/
+__RADIX_DEFINE(_radix_sort_u32, unsigned int, __sort_u32)
+
+/**
+ * Sort an array of 64-bit unsigned integers.
+ *
+ * The sort takes a buffer as big as the array, if it
+ * can not be allocated, the keys are sorted in place
+ * with a comparison sort.
+ *
+ * @param keys the array
+ * @param n number of keys
+*/
+__RADIX_DEFINE(_radix_sort_u64, unsigned long long, __sort_u64)
+
+/**
+ * __f32_bits - a float seen as its bits.
+*/
+typedef unsigned int __attribute__((may_alias)) __f32_bits;
+
+/**
+ * Sort an array of floats.
+ *
+ * The bits of the floats are turned into keys which
+ * sort as unsigned integers in the order of the floats
+ * (the sign bit is flipped, negative floats get all
+ * bits flipped) and back after the sort. -0 goes before
+ * 0, NaNs go to the ends by their sign.
+ *
+ * @param keys the array
+ * @param n number of keys
+*/
+void _radix_sort_f32(float *keys, _size_t n) {
+    __f32_bits *bits = (__f32_bits *)keys;
+
+    for (_size_t i = 0; i < n; i++) bits[i] ^= (unsigned)((int)bits[i] >> 31) | 0x80000000U;
+
+    _radix_sort_u32((unsigned int *)bits, n);
+
+    for (_size_t i = 0; i < n; i++) bits[i] ^= ((bits[i] >> 31) - 1) | 0x80000000U;
+}
+
+#endif // __SORT_H__
@@ -10,28 +10,9 @@
 #define __STDIO_H__
 
 #include <stdarg.h>
-
-/**
- * Determine the architecture and include the
- * proper syscalls header file.
- *
- * Available architectures:
- * - x86_64
- * - i386
- * ! more architectures will be added in the future
- * 
- * If the architecture is not supported, the error
- * "Architecture not supported" will be thrown.
-*/
-#ifdef __x86_64__
-    #include <x86_64/syscalls.h>
-#elif defined(__i386__) || defined(__i686__)
-    #include <x86/syscalls.h>
-#elif defined(__arm__)
-    #include <arm/syscalls.h>
-#else
-    #error "Architecture not supported"
-#endif
+#include <_syscalls.h>
+#include <_string.h>
+#include <_thread_sync.h>
 
 /**
  * _mode_t - type representing the file mode.
@@ -54,22 +35,73 @@ typedef unsigned long long int _size_t;
  * be used to perform file in/out operations.
  * 
  * 
+ * Reads go through the buffer, which holds a window
+ * of the file ending at the descriptor position. The
+ * stream position is offset - buffer_len + buffer_pos,
+ * so seeking inside the window only moves buffer_pos.
+ * 
  * @param fd file descriptor
  * @param buffer buffer for the file I/O
  * @param buffer_size size of the buffer
  * @param buffer_pos current position in the buffer
+ * @param buffer_len number of valid bytes in the buffer
+ * @param offset position of the descriptor (the end of
+ *               the buffered data), -1 if not known
  * @param error error indicator
  * @param eof end-of-file indicator
+ * @param flags stream state flags (_F_*)
+ * @param checksum function checksumming the data read
+ *                 and written, NULL for none (see _fchecksum)
+ * @param sum checksum of the data so far
+ * @param lock lock of a stream shared between threads
+ *             (see _flockfile)
 */
 typedef struct {
     int fd;               
     char *buffer;         
     _size_t buffer_size;  
     _size_t buffer_pos;  
+    _size_t buffer_len;
+    long long offset;
     int error;            
     int eof;              
+    int flags;
+    unsigned int (*checksum)(unsigned int sum, const void *data, _size_t len);
+    unsigned int sum;
+    _mutex_t lock;
 } _FILE;
 
+/**
+ * Stream state flags.
+ * 
+ * - F_USED   - the stream slot is taken by an open file
+ * - F_MAPPED - the whole file is mapped into memory, buffer points
+ *              to the mapping, buffer_size is the size of the file
+ *              and buffer_pos is the read position
+ * - F_APPEND - the file is opened in the append mode, writes move
+ *              the descriptor to the end of the file
+ * - F_BUFFER - the buffer was allocated by the stream
+*/
+#define _F_USED    0x0001
+#define _F_MAPPED  0x0002
+#define _F_APPEND  0x0004
+#define _F_BUFFER  0x0008
+
+/**
+ * BUFSIZ - Size of the read buffer of a stream.
+ *          The buffer is allocated on the first read,
+ *          so streams which are only written to do
+ *          not use any memory for it.
+*/
+#define BUFSIZ 8192
+
+/**
+ * FOPEN_MAX - Maximum number of streams open at once.
+ *             The streams are kept in a static table,
+ *             so they stay valid after _fopen returns.
+*/
+#define FOPEN_MAX 64
+
 /**
  * MAX_DIGITS - Maximum number of digits in an integer.
  *              Setting this value to 12 will allow to store an integer
@@ -78,6 +110,12 @@ typedef struct {
 */
 #define MAX_DIGITS 12
 
+/**
+ * MAX_DIGITS_64 - Size of a string representation of a 64-bit integer,
+ *                 with the sign and the null terminator.
+*/
+#define MAX_DIGITS_64 22
+
 /**
  * MAX_BUFFER - Maximum size of a buffer.
  *              Setting this value to 255 will allow to store 255 characters
@@ -92,10 +130,14 @@ typedef struct {
 */
 #define NULL ((void *)0)
 
+#include <_arena.h>
+
 /**
  * Library functions:
  *  > in/out operations:
  *   @fn _printf Print a given string to the standard output.
+ *   @fn _dprintf Print a formatted string to the given file descriptor.
+ *   @fn _vdprintf Print a formatted string with a va_list to the given file descriptor.
  *   @fn _scanf Scan a text from the standard input using the given format.
  *   @fn _putchar  Put a character to the standard output.
  *   @fn _putc Put a character to the given output.
@@ -106,17 +148,35 @@ typedef struct {
  *   @fn _fopen Open the file.
  *   @fn _fclose Close the file.
  *   @fn _fwrite Write to the stream.
+ *   @fn _fread Read from the stream.
+ *   @fn _fgets Read a line from the stream.
+ *   @fn _freadptr Read from a mapped stream without copying.
+ *   @fn _fgetln Read a line from a mapped stream without copying.
+ *   @fn _mmap_file Map the whole file into memory.
+ *   @fn _munmap_file Unmap a file mapped by _mmap_file.
+ *   @fn _fseek Set the position of the stream.
+ *   @fn _ftell Get the position of the stream.
+ *   @fn _rewind Set the position of the stream to the start.
+ *   @fn _fpread Read from the given offset of the stream.
+ *   @fn _fpwrite Write to the given offset of the stream.
+ *   @fn _fadvise Announce the access pattern of the stream.
+ *   @fn _freadahead Read a range of the stream into the page cache.
+ *   @fn _fcopy Copy from one stream to another inside the kernel.
+ *   @fn _fchecksum Checksum the data read from and written to the stream.
+ *   @fn _fchecksum_value Get the checksum of the stream.
+ *   @fn _flockfile Lock the stream for this thread.
+ *   @fn _ftrylockfile Lock the stream if no other thread holds it.
+ *   @fn _funlockfile Unlock the stream.
  * 
  *  > other operations:
  *   @fn _exit Exit the program with a given exit code.
  * 
  * Helper functions:
  *  > string operations:
- *  @fn _strlen Get a lenght of an given string.
+ *  @fn _strlen Get a lenght of an given string (from _string.h).
  *  @fn _atoi Convert a string to an integer.
  *  @fn _int_to_str Convert an integer to a string.
  *  @fn copy_string Copy a string from the source to the destination.
- *  @fn _free Free a memory block.
  *  @fn _int_len Get a lenght of an given inteeger.
 */  
 
@@ -147,46 +207,22 @@ _size_t _int_len(int num) {
 }
 
 /**
- * Memory block structure
- * 
- * The structure is used to store the memory blocks
- * that are freed by the user. The structure is a singly
- * linked list, where each block contains the size of the
- * memory block and a pointer to the next memory block.
- * 
- * The structure is used to free the memory that is allocated
- * by the _int_to_str function.
- * 
- * @param size size of the memory block
- * @param next pointer to the next memory block
-*/
-typedef struct memory_block {
-    _size_t size;
-    struct memory_block *next;
-} memory_block;
-
-memory_block *memory_list = NULL;
-
-/**
- * Free a memory block.
- * 
- * The function is used to free the memory block
- * that is allocated by the _int_to_str function.
+ * Convert an integer to a string in the given buffer.
  * 
- * This function is not a part of the standard library,
- * but I had to implement it as a helper function for
- * in/out operations which require a dynamic memory
- * allocation.
- * 
- * @param ptr pointer to the memory block
+ * @param str buffer of at least MAX_DIGITS characters
+ * @param num integer to convert
+ * @return str
 */
-void _free(void *ptr) {
-    if (ptr == NULL) return; 
+char* __int_to_buf(char *str, int num) {
+    _size_t length = _int_len(num);
 
-    memory_block *block = (memory_block *)((char *)ptr - sizeof(_size_t));
+    for (int i = length - 1; i >= 0; i--) {
+        str[i] = num % 10 + '0'; 
+        num /= 10; 
+    }
 
-    block->next = memory_list;
-    memory_list = block;
+    str[length] = '\0';
+    return str;
 }
 
 /**
@@ -204,29 +240,8 @@ void _free(void *ptr) {
 */
 const char* _int_to_str(int num) {
     static char str[MAX_DIGITS]; 
-    _size_t length = _int_len(num);
-
-    for (int i = length - 1; i >= 0; i--) {
-        str[i] = num % 10 + '0'; 
-        num /= 10; 
-    }
-
-    str[length] = '\0';
-    return str;
-}
 
-/**
- * Get a lenght of an given string. 
- * If the string is empty, 
- * the function will return 0.
- * 
- * @param text string to get length
- * @return length of the string
-*/
-_size_t _strlen(const char* string) {
-    _size_t len = 0;
-    while (*string++) len++;
-    return len;
+    return __int_to_buf(str, num);
 }
 
 /**
@@ -312,6 +327,11 @@ void _scanf(const char *format, ...) {
     va_list args;
     va_start(args, format);
 
+    // the input buffers are taken from an arena on the stack
+    char scratch[MAX_BUFFER + MAX_DIGITS];
+    _arena_t arena;
+    _arena_init(&arena, scratch, sizeof(scratch));
+
     while (*format != '\0') {
         if (*format == '%') {
             // skip the '%' character
@@ -333,7 +353,9 @@ void _scanf(const char *format, ...) {
                 case 'd': {
                     int *arg = va_arg(args, int *);
 
-                    char buffer[MAX_DIGITS];
+                    _arena_mark_t mark = _arena_checkpoint(&arena);
+
+                    char *buffer = _arena_alloc(&arena, MAX_DIGITS, 1);
                     sys_read(1, buffer, MAX_DIGITS);
 
                     // make the last character a null terminator
@@ -342,18 +364,22 @@ void _scanf(const char *format, ...) {
                     int num = _atoi(buffer);
 
                     *arg = num; 
+                    _arena_rewind(&arena, mark);
                     break;
                 }
                 case 's': {
                     char *arg = va_arg(args, char *);
 
-                    char buffer[MAX_BUFFER];
+                    _arena_mark_t mark = _arena_checkpoint(&arena);
+
+                    char *buffer = _arena_alloc(&arena, MAX_BUFFER, 1);
                     sys_read(1, buffer, MAX_BUFFER); 
 
                     // make the last character a null terminator
                     buffer[_strlen(buffer) - 1] = '\0';
 
                     copy_string(arg, buffer);
+                    _arena_rewind(&arena, mark);
                     break;
                 }
                 case '\0': 
@@ -411,38 +437,119 @@ void _putc(char character, long fd) {
 }
 
 /**
- * Print a given string to the standard output.
- * 
- * The function is using the _putchar function
- * to print the characters of the string.
- * 
- * Example usage:
- * _printf("Hello, World!\n");
- * 
- * This will print the "Hello, World!" string
- * to the standard output.
- * 
- * @param string string to print
- * @param ... 
+ * __printf_out - output of _vdprintf.
+ *
+ * The characters are collected in the buffer and
+ * written with one syscall when it is full, not one
+ * syscall per character.
+ *
+ * @param fd file descriptor to write to
+ * @param len number of characters in the buffer
+ * @param buffer the characters
 */
-void _printf(const char* format, ...) {
-    // initialize the va_list
-    va_list args;
-    va_start(args, format);
+typedef struct {
+    int fd;
+    _size_t len;
+    char buffer[MAX_BUFFER + 1];
+} __printf_out;
+
+/**
+ * Write the collected characters.
+ *
+ * @param out the output
+*/
+void __printf_flush(__printf_out *out) {
+    if (out->len > 0) sys_write(out->fd, out->buffer, out->len);
+    out->len = 0;
+}
+
+/**
+ * Add a character to the output.
+ *
+ * @param out the output
+ * @param character character to add
+*/
+void __printf_putc(__printf_out *out, char character) {
+    if (out->len == sizeof(out->buffer)) __printf_flush(out);
+    out->buffer[out->len++] = character;
+}
+
+/**
+ * Add a string to the output.
+ *
+ * @param out the output
+ * @param str string to add
+*/
+void __printf_puts(__printf_out *out, const char *str) {
+    while (*str != '\0') __printf_putc(out, *str++);
+}
+
+/**
+ * Convert an unsigned 64-bit integer to a string
+ * in the given buffer.
+ *
+ * @param str buffer of at least MAX_DIGITS_64 characters
+ * @param num integer to convert
+ * @param base 10 or 16
+ * @return str
+*/
+char* __ull_to_buf(char *str, unsigned long long num, unsigned base) {
+    char digits[MAX_DIGITS_64];
+    _size_t len = 0;
+
+    do {
+        digits[len++] = "0123456789abcdef"[num % base];
+        num /= base;
+    } while (num);
+
+    for (_size_t i = 0; i < len; i++) str[i] = digits[len - 1 - i];
+
+    str[len] = '\0';
+    return str;
+}
+
+/**
+ * Print a formatted string to the given file descriptor.
+ *
+ * The format specifiers are the ones of _printf.
+ *
+ * @param fd file descriptor
+ * @param format the format
+ * @param args the arguments
+*/
+void _vdprintf(int fd, const char* format, va_list args) {
+    __printf_out out;
+    out.fd = fd;
+    out.len = 0;
+
+    // the numbers are converted in an arena on the stack
+    char scratch[MAX_DIGITS_64 * 2];
+    _arena_t arena;
+    _arena_init(&arena, scratch, sizeof(scratch));
 
     while (*format != '\0') {
         if (*format == '%') {
             // skip the '%' character
             format++; 
+
+            // count the length modifiers ('l' - long, 'll' - long long)
+            int longs = 0;
+            while (*format == 'l' && longs < 2) {
+                longs++;
+                format++;
+            }
+
             /**
              * Check the format specifier.
              * 
              * The format specifier can be one of the following:
-             * - %d - integer
+             * - %d - integer (%ld, %lld - long, long long)
+             * - %u - unsigned integer (%lu, %llu)
              * - %s - string
              * - %c - character
-             * - %x - hexadecimal
+             * - %x - hexadecimal (%lx, %llx)
              * - %p - pointer
+             * - %% - the '%' character
              * 
              * If the format specifier is not recognized,
              * the function will print the character without
@@ -450,70 +557,123 @@ void _printf(const char* format, ...) {
             */
             switch (*format) {
                 case 'd': {
-                    int num = va_arg(args, int);
+                    _arena_mark_t mark = _arena_checkpoint(&arena);
+                    char* num_str = _arena_alloc(&arena, MAX_DIGITS_64, 1);
 
-                    char* num_str = _int_to_str(num);
+                    long long num;
 
-                    for (int i = 0; num_str[i] != '\0'; i++) {
-                        _putchar(num_str[i]);
-                    }
+                    if (longs == 0) num = va_arg(args, int);
+                    else if (longs == 1) num = va_arg(args, long);
+                    else num = va_arg(args, long long);
 
-                    _free(num_str); 
+                    if (num < 0) __printf_putc(&out, '-');
+                    __ull_to_buf(num_str, num < 0 ? -(unsigned long long)num : (unsigned long long)num, 10);
+
+                    __printf_puts(&out, num_str);
+
+                    _arena_rewind(&arena, mark);
                     break;
                 }
-                case 's': {
-                    const char* text = va_arg(args, const char*);
+                case 'u':
+                case 'x': {
+                    unsigned long long num;
 
-                    while (*text != '\0') {
-                        _putchar(*text);
-                        text++;
-                    }
+                    if (longs == 0) num = va_arg(args, unsigned int);
+                    else if (longs == 1) num = va_arg(args, unsigned long);
+                    else num = va_arg(args, unsigned long long);
+
+                    _arena_mark_t mark = _arena_checkpoint(&arena);
+                    char* num_str = _arena_alloc(&arena, MAX_DIGITS_64, 1);
+
+                    __printf_puts(&out, __ull_to_buf(num_str, num, *format == 'x' ? 16 : 10));
 
+                    _arena_rewind(&arena, mark);
                     break;
                 }
-                case 'c': {
-                    char c = va_arg(args, int);
+                case 's': {
+                    const char* text = va_arg(args, const char*);
 
-                    _putchar(c);
+                    __printf_puts(&out, text);
                     break;
                 }
-                case 'x': {
-                    int num = va_arg(args, int);
-
-                    char* num_str = _int_to_str(num);
-
-                    for (int i = 0; num_str[i] != '\0'; i++) {
-                        _putchar(num_str[i]);
-                    }
-
-                    _free(num_str); 
+                case 'c': {
+                    char c = va_arg(args, int);
 
+                    __printf_putc(&out, c);
                     break;
                 }
                 case 'p': {
                     void* ptr = va_arg(args, void*);
 
                     // convert the pointer to a string
-                    char* ptr_str = _int_to_str((int)ptr);
+                    _arena_mark_t mark = _arena_checkpoint(&arena);
+                    char* ptr_str = __ull_to_buf(_arena_alloc(&arena, MAX_DIGITS_64, 1), (unsigned long)ptr, 16);
 
-                    for (int i = 0; ptr_str[i] != '\0'; i++) {
-                        _putchar(ptr_str[i]);
-                    }
+                    __printf_puts(&out, "0x");
+                    __printf_puts(&out, ptr_str);
 
-                    _free(ptr_str); 
+                    _arena_rewind(&arena, mark);
                     break;
                 }
+                case '%':
+                    __printf_putc(&out, '%');
+                    break;
                 // check if the format specifier is a null terminator
                 case '\0': 
+                    __printf_flush(&out);
                     return;
             }
         // if the character is not a format specifier ('%')
         // just print the character without any changes
         } 
-        else _putchar(*format);
+        else __printf_putc(&out, *format);
         format++;  
     }
 
+    __printf_flush(&out);
+}
+
+/**
+ * Print a formatted string to the given file descriptor.
+ *
+ * Example usage:
+ * _dprintf(2, "error: %s\n", message);
+ *
+ * @param fd file descriptor
+ * @param format the format
+ * @param ... 
+*/
+void _dprintf(int fd, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+
+    _vdprintf(fd, format, args);
+
+    va_end(args);
+}
+
+/**
+ * Print a given string to the standard output.
+ * 
+ * The output is collected in a buffer and written
+ * when the buffer is full, and at the end of the call.
+ * 
+ * Example usage:
+ * _printf("Hello, World!\n");
+ * 
+ * This will print the "Hello, World!" string
+ * to the standard output.
+ * 
+ * @param string string to print
+ * @param ... 
+*/
+void _printf(const char* format, ...) {
+    // initialize the va_list
+    va_list args;
+    va_start(args, format);
+
+    _vdprintf(1, format, args);
+
     va_end(args);
 }
 
@@ -530,57 +690,198 @@ void _rename(const char *old_name, const char *new_name) {
     sys_rename(old_name, new_name);
 }
 
+/* Table of the streams returned by _fopen. */
+_FILE __files[FOPEN_MAX];
+
+/**
+ * Translate the fopen mode string to the open flags.
+ * 
+ * The mode of the file is determined by the
+ * first character of the mode string and by the
+ * '+' character which can follow it. The mode
+ * can be one of the following:
+ * 
+ * - "r"  - read-only
+ * - "w"  - write-only, create, truncate
+ * - "a"  - write-only, create, append
+ * - "r+" - read-write
+ * - "w+" - read-write, create, truncate
+ * - "a+" - read-write, create, append
+ *  
+ * If the mode is not recognized, the default
+ * mode is read-only ("r") 
+ * 
+ * The 'm' character ("rm") asks _fopen to map
+ * a read-only file into memory, it does not
+ * change the flags.
+ * 
+ * @param mode mode of the file
+ * @return flags for the sys_open syscall
+*/
+long __fopen_flags(const char* mode) {
+    long flags;
+    int update = 0;
+
+    // look for the '+' after the mode character
+    for (const char *c = mode + 1; *c != '\0'; c++) {
+        if (*c == '+') update = 1;
+    }
+
+    switch (mode[0])
+    {
+    case 'w' : flags = _O_CREAT | _O_TRUNC; break;      // create, truncate
+    case 'a' : flags = _O_CREAT | _O_APPEND; break;     // create, append
+    default  : flags = 0; break;                        // DEFAULT: read
+    }
+
+    if (update) flags |= _O_RDWR;                       // read-write
+    else if (mode[0] == 'w' || mode[0] == 'a') flags |= _O_WRONLY;
+    else flags |= _O_RDONLY;
+
+    return flags;
+}
+
+/**
+ * Map an open file into memory.
+ * 
+ * The mapping is private and read-only. The kernel
+ * is told the file will be read from the start to the
+ * end, so it reads ahead aggressively and drops the
+ * pages behind the reader.
+ * 
+ * @param fd file descriptor
+ * @param len where to store the size of the file
+ * @return address of the mapping, or NULL on failure
+ *         (also for empty files, which can not be mapped)
+*/
+const char* __mmap_fd(int fd, _size_t *len) {
+    _stat_t st;
+
+    *len = 0;
+    if (sys_fstat(fd, &st) != 0 || st.st_size <= 0) return NULL;
+
+    // files bigger than the address space can not be mapped
+    if ((unsigned long long)st.st_size != (unsigned long)st.st_size) return NULL;
+
+    long long addr = sys_mmap(NULL, st.st_size, _PROT_READ, _MAP_PRIVATE, fd, 0);
+    if (addr < 0) return NULL;
+
+    sys_madvise((void *)(unsigned long)addr, st.st_size, _MADV_SEQUENTIAL);
+    sys_madvise((void *)(unsigned long)addr, st.st_size, _MADV_WILLNEED);
+
+    *len = st.st_size;
+    return (const char *)(unsigned long)addr;
+}
+
+/**
+ * Map the whole file into memory.
+ * 
+ * The contents of the file can be read directly from
+ * the page cache, without copying them through read.
+ * 
+ * Example usage:
+ *  _size_t len;
+ *  const char *data = _mmap_file("data.bin", &len);
+ *  ...
+ *  _munmap_file(data, len);
+ * 
+ * @param filename name of the file
+ * @param len where to store the size of the file
+ * @return address of the mapping, or NULL on failure
+*/
+const char* _mmap_file(const char* filename, _size_t *len) {
+    long long fd = sys_open(filename, _O_RDONLY, 0);
+
+    *len = 0;
+    if (fd < 0) return NULL;
+
+    // the mapping stays valid after the descriptor is closed
+    const char *addr = __mmap_fd((int)fd, len);
+    sys_close((int)fd);
+
+    return addr;
+}
+
+/**
+ * Unmap a file mapped by _mmap_file.
+ * 
+ * @param addr address of the mapping
+ * @param len size of the file
+*/
+void _munmap_file(const char* addr, _size_t len) {
+    if (addr != NULL) sys_munmap((void *)addr, len);
+}
+
 /**
  * Open the file.
  * 
  * The function is used to open the file
  * with the given name and mode.
  * 
+ * With the "rm" mode the whole file is mapped into
+ * memory, _fread copies from the mapping and _freadptr
+ * and _fgetln return pointers into it. If the file can
+ * not be mapped (e.g. it is empty or a pipe), the stream
+ * works as a regular one.
+ * 
  * @param filename name of the file
- * @param mode mode of the file
- * @return file descriptor
+ * @param mode mode of the file (see __fopen_flags)
+ * @return the stream, or NULL if the file can not be opened
 */
 _FILE* _fopen(const char* filename, const char* mode) {
-    long flags;
+    long flags = __fopen_flags(mode);
+    _FILE *file_ptr = NULL;
 
-    // create a new file
-    _FILE file;
-    _FILE *file_ptr = &file;
-
-    /**
-     * Check the file mode.
-     * 
-     * The mode of the file is determined by the
-     * first character of the mode string. The mode
-     * can be one of the following:
-     * 
-     * - "r"  - read-only
-     * - "w"  - write-only, create, truncate
-     * - "a"  - write-only, create, append
-     * - "r+" - read-write
-     * - "w+" - read-write, create, truncate
-     * - "a+" - read-write, create, append
-     *  
-     * If the mode is not recognized, the default
-     * mode is read-only ("r") 
-    */
-    switch (mode[0])
-    {
-    case 'r' : flags = _O_RDONLY; break;                            // read-only
-    case 'w' : flags = _O_WRONLY | _O_CREAT | _O_TRUNC; break;      // write-only, create, truncate
-    case 'a' : flags = _O_WRONLY | _O_CREAT | _O_APPEND; break;     // write-only, create, append
-    case 'r+': flags = _O_RDWR; break;                              // read-write
-    case 'w+': flags = _O_RDWR | _O_CREAT | _O_TRUNC; break;        // read-write, create, truncate
-    case 'a+': flags = _O_RDWR | _O_CREAT | _O_APPEND; break;       // read-write, create, append
-    default  : flags = _O_RDONLY; break;                            // DEFAULT: read-only
+    // claim a free slot of the stream table, other threads may race for it
+    for (int i = 0; i < FOPEN_MAX && file_ptr == NULL; i++) {
+        if (__files[i].flags & _F_USED) continue;
+        if (__atomic_fetch_or(&__files[i].flags, _F_USED, __ATOMIC_ACQUIRE) & _F_USED) continue;
+
+        file_ptr = &__files[i];
+    }
+
+    if (file_ptr == NULL) return NULL;
+
+    long long fd = sys_open(filename, flags, 0666);
+
+    if (fd < 0) {
+        __atomic_store_n(&file_ptr->flags, 0, __ATOMIC_RELEASE);
+        return NULL;
     }
 
-    file_ptr->fd = sys_open(filename, flags, 0666); 
+    file_ptr->fd = fd; 
     file_ptr->buffer = NULL;        
     file_ptr->buffer_size = 0;      
     file_ptr->buffer_pos = 0;       
+    file_ptr->buffer_len = 0;
+    file_ptr->offset = 0;
     file_ptr->error = 0;            
     file_ptr->eof = 0;              
+    file_ptr->flags = _F_USED;
+    file_ptr->checksum = NULL;
+    file_ptr->sum = 0;
+    _mutex_init(&file_ptr->lock);
+
+    if (flags & _O_APPEND) file_ptr->flags |= _F_APPEND;
+
+    // map read-only files opened with the 'm' mode
+    if ((flags & (_O_WRONLY | _O_RDWR)) == 0) {
+        for (const char *c = mode; *c != '\0'; c++) {
+            if (*c != 'm') continue;
+
+            _size_t len;
+            const char *addr = __mmap_fd(file_ptr->fd, &len);
+
+            if (addr != NULL) {
+                file_ptr->buffer = (char *)addr;
+                file_ptr->buffer_size = len;
+                file_ptr->buffer_len = len;
+                file_ptr->offset = len;
+                file_ptr->flags |= _F_MAPPED;
+            }
+            break;
+        }
+    }
 
     return file_ptr;
 }
@@ -594,39 +895,942 @@ _FILE* _fopen(const char* filename, const char* mode) {
  * @param file file to close
 */
 void _fclose(_FILE *file) {
+    if (file->flags & (_F_MAPPED | _F_BUFFER)) sys_munmap(file->buffer, file->buffer_size);
+
     sys_close(file->fd);
+
+    // the slot is free for the next _fopen
+    __atomic_store_n(&file->flags, 0, __ATOMIC_RELEASE);
 }
 
 /**
- * Write to the stream.
- * 
- * The function is used to write the data
- * to the stream.
- * 
- * @param ptr pointer to the data
- * @param size size of the data
- * @param nmemb number of members
- * @param stream stream to write
+ * Get the buffer of the stream, allocating it on first use.
  * 
- * @return number of bytes written
+ * @param stream stream to get the buffer of
+ * @return the buffer, or NULL if it can not be allocated
 */
-void _fwrite(char *str, _size_t size, _size_t nmemb, _FILE *stream) {
-    sys_write(stream->fd, str, size * nmemb);
+char* __fbuffer(_FILE *stream) {
+    if (stream->buffer == NULL) {
+        long long addr = sys_mmap(NULL, BUFSIZ, _PROT_READ | _PROT_WRITE,
+                                  _MAP_PRIVATE | _MAP_ANONYMOUS, -1, 0);
+        if (addr < 0) return NULL;
+
+        stream->buffer = (char *)(unsigned long)addr;
+        stream->buffer_size = BUFSIZ;
+        stream->flags |= _F_BUFFER;
+    }
+
+    return stream->buffer;
 }
 
 /**
- * Read from the stream.
+ * Get the position of the descriptor of the stream.
  * 
- * The function is used to read the data
- * from the stream.
+ * The position is tracked by the stream, the kernel
+ * is only asked when it is not known (after a write
+ * in the append mode).
  * 
- * @param ptr pointer to the data
- * @param size size of the data
- * @param nmemb number of members
- * @param stream stream to read
+ * @param stream stream to get the position of
+ * @return the position, or an error code
 */
-void _fread(char *str, _size_t size, _size_t nmemb, _FILE *stream) {
-    sys_read(stream->fd, str, size * nmemb);
+long long __foffset(_FILE *stream) {
+    if (stream->offset < 0) {
+        long long off = sys_lseek(stream->fd, 0, _SEEK_CUR);
+        if (off < 0) return off;
+
+        stream->offset = off;
+    }
+
+    return stream->offset;
+}
+
+/**
+ * Wait for a nonblocking descriptor.
+ * 
+ * Called when a read or a write of a stream fails
+ * with EAGAIN, with 1 to wait for reading or 2 for
+ * writing. Returning 0 retries the call, anything
+ * else fails it. _coro.h sets it to suspend the
+ * coroutine until the event loop sees the descriptor
+ * ready; without it EAGAIN is an error of the stream.
+*/
+int (*__fwait)(int fd, int events) = NULL;
+
+/**
+ * Read from the descriptor of a stream, waiting
+ * with __fwait while it would block.
+ * 
+ * @param stream stream to read
+ * @param buf buffer for the data
+ * @param count maximum number of bytes
+ * @return number of bytes read, or an error code
+*/
+long long __fread_fd(_FILE *stream, char *buf, _size_t count) {
+    long long n;
+
+    // EAGAIN
+    while ((n = sys_read(stream->fd, buf, count)) == -11) {
+        if (__fwait == NULL || __fwait(stream->fd, 1) != 0) break;
+    }
+
+    return n;
+}
+
+/**
+ * Fill the buffer with the data following the window.
+ * 
+ * @param stream stream to fill the buffer of
+ * @return number of bytes read, 0 at the end of
+ *         the file, or an error code
+*/
+long long __frefill(_FILE *stream) {
+    if (__fbuffer(stream) == NULL) return -12;
+
+    long long n = __fread_fd(stream, stream->buffer, stream->buffer_size);
+    if (n < 0) return n;
+
+    if (stream->offset >= 0) stream->offset += n;
+    stream->buffer_len = n;
+    stream->buffer_pos = 0;
+
+    return n;
+}
+
+/**
+ * Drop the buffered data which was not read yet.
+ * 
+ * The descriptor is moved back to the position of
+ * the stream, so the next write lands where the
+ * reader stopped.
+ * 
+ * @param stream stream to drop the buffered data of
+ * @return 0 on success, or an error code
+*/
+int __fdiscard(_FILE *stream) {
+    _size_t ahead = stream->buffer_len - stream->buffer_pos;
+
+    if (ahead > 0) {
+        long long off = sys_lseek(stream->fd, -(long long)ahead, _SEEK_CUR);
+        if (off < 0) return (int)off;
+
+        stream->offset = off;
+    }
+
+    stream->buffer_len = 0;
+    stream->buffer_pos = 0;
+    return 0;
+}
+
+/**
+ * Checksum the data read from and written to the stream.
+ * 
+ * Every byte going through the stream is added to the
+ * checksum while it is at hand (in the cache), right
+ * after it is copied out of the buffer or before it is
+ * written, so the data is never read a second time.
+ * Positional reads and writes (_fpread, _fpwrite) and
+ * kernel copies (_fcopy) are not checksummed.
+ * 
+ * Example usage:
+ *  _fchecksum(file, _crc32c, 0);      // _checksum.h
+ *  _fwrite(block, 1, size, file);
+ *  unsigned int crc = _fchecksum_value(file);
+ * 
+ * @param stream stream to checksum
+ * @param checksum function adding data to a checksum,
+ *                 NULL to stop checksumming
+ * @param init the checksum of no data (0 for CRCs)
+*/
+void _fchecksum(_FILE *stream, unsigned int (*checksum)(unsigned int, const void *, _size_t), unsigned int init) {
+    stream->checksum = checksum;
+    stream->sum = init;
+}
+
+/**
+ * Get the checksum of the stream.
+ * 
+ * @param stream stream checksummed with _fchecksum
+ * @return the checksum of the data read and written since
+*/
+unsigned int _fchecksum_value(_FILE *stream) {
+    return stream->sum;
+}
+
+/**
+ * Lock the stream for this thread.
+ * 
+ * The stream functions do not lock the stream on their
+ * own, so streams used by one thread pay nothing for it.
+ * Threads sharing a stream hold the lock around their
+ * calls, which also keeps the data of a sequence of
+ * calls together. A free lock costs one atomic
+ * instruction to take and one to release.
+ * 
+ * Example usage:
+ *  _flockfile(log);
+ *  _fwrite(header, 1, sizeof(header), log);
+ *  _fwrite(record, 1, size, log);
+ *  _funlockfile(log);
+ * 
+ * @param stream stream to lock
+*/
+void _flockfile(_FILE *stream) {
+    _mutex_lock(&stream->lock);
+}
+
+/**
+ * Lock the stream if no other thread holds it.
+ * 
+ * @param stream stream to lock
+ * @return 1 if the stream was locked, 0 if not
+*/
+int _ftrylockfile(_FILE *stream) {
+    return _mutex_trylock(&stream->lock);
+}
+
+/**
+ * Unlock the stream.
+ * 
+ * @param stream stream locked by this thread
+*/
+void _funlockfile(_FILE *stream) {
+    _mutex_unlock(&stream->lock);
+}
+
+/**
+ * Add data going through the stream to its checksum.
+ * 
+ * @param stream the stream
+ * @param data the data
+ * @param len size of the data
+*/
+void __fchecksum_add(_FILE *stream, const char *data, _size_t len) {
+    if (stream->checksum != NULL && len > 0) stream->sum = stream->checksum(stream->sum, data, len);
+}
+
+/**
+ * Write to the stream.
+ * 
+ * The function is used to write the data
+ * to the stream.
+ * 
+ * @param ptr pointer to the data
+ * @param size size of the data
+ * @param nmemb number of members
+ * @param stream stream to write
+ * 
+ * @return number of bytes written
+*/
+void _fwrite(char *str, _size_t size, _size_t nmemb, _FILE *stream) {
+    if (__fdiscard(stream) != 0) {
+        stream->error = 1;
+        return;
+    }
+
+    _size_t total = size * nmemb;
+    _size_t done = 0;
+
+    // a nonblocking descriptor takes the data in parts
+    while (done < total) {
+        long long n = sys_write(stream->fd, str + done, total - done);
+
+        if (n == -11 && __fwait != NULL && __fwait(stream->fd, 2) == 0) continue;   // EAGAIN
+        if (n <= 0) {
+            stream->error = 1;
+            break;
+        }
+
+        if (stream->offset >= 0) stream->offset += n;
+        __fchecksum_add(stream, str + done, n);
+        done += n;
+    }
+
+    // appending moved the descriptor to the end of the file
+    if (stream->flags & _F_APPEND) stream->offset = -1;
+}
+
+/**
+ * Read from a mapped stream without copying.
+ * 
+ * Returns a pointer into the mapping (the page cache)
+ * and moves the read position past the returned data.
+ * The data is valid until the stream is closed.
+ * 
+ * @param stream stream opened with the "rm" mode
+ * @param size number of bytes wanted
+ * @param len where to store the number of bytes available
+ * @return pointer to the data, or NULL at the end of
+ *         the file or if the stream is not mapped
+*/
+const char* _freadptr(_FILE *stream, _size_t size, _size_t *len) {
+    *len = 0;
+
+    if (!(stream->flags & _F_MAPPED)) return NULL;
+
+    // the position can be past the end after _fseek
+    if (stream->buffer_pos >= stream->buffer_size) {
+        stream->eof = 1;
+        return NULL;
+    }
+
+    _size_t left = stream->buffer_size - stream->buffer_pos;
+    if (size > left) size = left;
+
+    const char *data = stream->buffer + stream->buffer_pos;
+    stream->buffer_pos += size;
+    __fchecksum_add(stream, data, size);
+
+    *len = size;
+    return data;
+}
+
+/**
+ * Read a line from a mapped stream without copying.
+ * 
+ * The returned line is not null terminated, it ends
+ * with the newline character (except for the last
+ * line of the file if it has no newline).
+ * 
+ * Example usage:
+ *  _size_t len;
+ *  const char *line;
+ *  while ((line = _fgetln(file, &len)) != NULL) { ... }
+ * 
+ * @param stream stream opened with the "rm" mode
+ * @param len where to store the length of the line
+ * @return pointer to the line, or NULL at the end of
+ *         the file or if the stream is not mapped
+*/
+const char* _fgetln(_FILE *stream, _size_t *len) {
+    *len = 0;
+
+    if (!(stream->flags & _F_MAPPED)) return NULL;
+
+    if (stream->buffer_pos >= stream->buffer_size) {
+        stream->eof = 1;
+        return NULL;
+    }
+
+    const char *start = stream->buffer + stream->buffer_pos;
+    const char *end = stream->buffer + stream->buffer_size;
+    const char *c = start;
+
+    while (c < end && *c != '\n') c++;
+    if (c < end) c++;
+
+    stream->buffer_pos += c - start;
+    __fchecksum_add(stream, start, c - start);
+
+    *len = c - start;
+    return start;
+}
+
+/**
+ * Read from the stream.
+ * 
+ * The function is used to read the data
+ * from the stream.
+ * 
+ * Small reads are served from the buffer, reads
+ * bigger than the buffer go straight to the
+ * destination.
+ * 
+ * @param ptr pointer to the data
+ * @param size size of the data
+ * @param nmemb number of members
+ * @param stream stream to read
+ * 
+ * @return number of members read
+*/
+_size_t _fread(char *str, _size_t size, _size_t nmemb, _FILE *stream) {
+    _size_t total = size * nmemb;
+    _size_t got = 0;
+
+    if (total == 0) return 0;
+
+    if (stream->flags & _F_MAPPED) {
+        const char *src = _freadptr(stream, total, &got);
+
+        for (_size_t i = 0; i < got; i++) str[i] = src[i];
+    }
+    else {
+        while (got < total) {
+            _size_t avail = stream->buffer_len - stream->buffer_pos;
+
+            // copy what is left in the buffer
+            if (avail > 0) {
+                if (avail > total - got) avail = total - got;
+
+                const char *src = stream->buffer + stream->buffer_pos;
+                for (_size_t i = 0; i < avail; i++) str[got + i] = src[i];
+                __fchecksum_add(stream, str + got, avail);
+
+                stream->buffer_pos += avail;
+                got += avail;
+                continue;
+            }
+
+            long long n;
+
+            if (total - got >= BUFSIZ) {
+                n = __fread_fd(stream, str + got, total - got);
+
+                if (n > 0) {
+                    if (stream->offset >= 0) stream->offset += n;
+                    stream->buffer_len = 0;
+                    stream->buffer_pos = 0;
+                    __fchecksum_add(stream, str + got, n);
+                    got += n;
+                }
+            }
+            else n = __frefill(stream);
+
+            if (n < 0) {
+                stream->error = 1;
+                break;
+            }
+            if (n == 0) {
+                stream->eof = 1;
+                break;
+            }
+        }
+    }
+
+    return got / size;
+}
+
+/**
+ * Read a line from the stream.
+ * 
+ * At most n - 1 characters are read, the line keeps
+ * its newline character and is null terminated.
+ * 
+ * @param str buffer for the line
+ * @param n size of the buffer
+ * @param stream stream to read
+ * @return str, or NULL if nothing was read
+*/
+char* _fgets(char *str, int n, _FILE *stream) {
+    int i = 0;
+
+    if (n <= 0) return NULL;
+
+    if (stream->flags & _F_MAPPED) {
+        if (stream->buffer_pos < stream->buffer_size) {
+            const char *c = stream->buffer + stream->buffer_pos;
+            const char *end = stream->buffer + stream->buffer_size;
+
+            while (i < n - 1 && c < end) {
+                str[i++] = *c;
+                if (*c++ == '\n') break;
+            }
+
+            stream->buffer_pos = c - stream->buffer;
+        }
+    }
+    else {
+        while (i < n - 1) {
+            if (stream->buffer_pos == stream->buffer_len) {
+                long long got = __frefill(stream);
+                if (got <= 0) {
+                    if (got < 0) stream->error = 1;
+                    break;
+                }
+            }
+
+            char c = stream->buffer[stream->buffer_pos++];
+
+            str[i++] = c;
+            if (c == '\n') break;
+        }
+    }
+
+    if (i == 0) {
+        stream->eof = 1;
+        return NULL;
+    }
+
+    __fchecksum_add(stream, str, i);
+
+    str[i] = '\0';
+    return str;
+}
+
+/**
+ * Get the position of the stream.
+ * 
+ * @param stream stream to get the position of
+ * @return the position, or an error code
+*/
+long long _ftell(_FILE *stream) {
+    if (stream->flags & _F_MAPPED) return stream->buffer_pos;
+
+    long long off = __foffset(stream);
+    if (off < 0) return off;
+
+    return off - (long long)(stream->buffer_len - stream->buffer_pos);
+}
+
+/**
+ * Set the position of the stream.
+ * 
+ * If the new position is inside the buffered window
+ * of the file, only the position in the buffer is
+ * moved and the buffered data is kept, so jumping
+ * around a small area of the file does not read it
+ * again. Otherwise the buffer is dropped and the
+ * descriptor is moved.
+ * 
+ * Example usage:
+ *  _fseek(file, 128, _SEEK_SET);
+ *  _fread(record, 1, 32, file);
+ * 
+ * @param stream stream to seek
+ * @param offset offset relative to whence
+ * @param whence _SEEK_SET, _SEEK_CUR or _SEEK_END
+ * @return 0 on success, or an error code
+*/
+int _fseek(_FILE *stream, long long offset, int whence) {
+    long long target;
+
+    switch (whence)
+    {
+    case _SEEK_SET : target = offset; break;
+    case _SEEK_CUR : {
+        long long pos = _ftell(stream);
+        if (pos < 0) return (int)pos;
+
+        target = pos + offset;
+        break;
+    }
+    case _SEEK_END : {
+        if (stream->flags & _F_MAPPED) {
+            target = stream->buffer_size + offset;
+            break;
+        }
+
+        _stat_t st;
+
+        int ret = sys_fstat(stream->fd, &st);
+        if (ret != 0) return ret;
+
+        target = st.st_size + offset;
+        break;
+    }
+    default : return -22;                               // EINVAL
+    }
+
+    if (target < 0) return -22;
+
+    stream->eof = 0;
+
+    // the window is [offset - buffer_len, offset], a mapped
+    // stream has the whole file in the window
+    long long start = stream->offset - (long long)stream->buffer_len;
+
+    if (stream->offset >= 0 && target >= start && target <= stream->offset) {
+        stream->buffer_pos = target - start;
+        return 0;
+    }
+
+    if (stream->flags & _F_MAPPED) {
+        stream->buffer_pos = target;
+        return 0;
+    }
+
+    long long off = sys_lseek(stream->fd, target, _SEEK_SET);
+    if (off < 0) return (int)off;
+
+    stream->offset = off;
+    stream->buffer_len = 0;
+    stream->buffer_pos = 0;
+    return 0;
+}
+
+/**
+ * Set the position of the stream to the start
+ * and clear its error indicator.
+ * 
+ * @param stream stream to rewind
+*/
+void _rewind(_FILE *stream) {
+    _fseek(stream, 0, _SEEK_SET);
+    stream->error = 0;
+}
+
+/**
+ * Read from the given offset of the stream.
+ * 
+ * The position of the stream is not changed, so
+ * the function can be used for random reads next
+ * to sequential ones. Data inside the buffered
+ * window is copied without a syscall.
+ * 
+ * @param stream stream to read
+ * @param buf buffer to store read data
+ * @param size number of bytes to read
+ * @param offset offset in the file
+ * @return number of bytes read, or an error code
+*/
+long long _fpread(_FILE *stream, void *buf, _size_t size, long long offset) {
+    char *dst = (char *)buf;
+    long long start = stream->offset - (long long)stream->buffer_len;
+
+    if (offset < 0) return -22;
+
+    if (stream->flags & _F_MAPPED) {
+        if ((unsigned long long)offset >= stream->buffer_size) return 0;
+        if (size > stream->buffer_size - offset) size = stream->buffer_size - offset;
+    }
+    else if (stream->offset < 0 || offset < start || offset + (long long)size > stream->offset) {
+        _size_t got = 0;
+
+        while (got < size) {
+            long long n = sys_pread64(stream->fd, dst + got, size - got, offset + got);
+
+            if (n < 0) return got ? (long long)got : n;
+            if (n == 0) break;
+            got += n;
+        }
+
+        return got;
+    }
+
+    const char *src = stream->buffer + (offset - start);
+    for (_size_t i = 0; i < size; i++) dst[i] = src[i];
+
+    return size;
+}
+
+/**
+ * Write to the given offset of the stream.
+ * 
+ * The position of the stream is not changed. If the
+ * written range overlaps the buffered window, the
+ * buffer is updated as well, so later reads see the
+ * new data.
+ * 
+ * @param stream stream to write
+ * @param buf buffer containing data to write
+ * @param size number of bytes to write
+ * @param offset offset in the file
+ * @return number of bytes written, or an error code
+*/
+long long _fpwrite(_FILE *stream, const void *buf, _size_t size, long long offset) {
+    const char *src = (const char *)buf;
+    _size_t done = 0;
+
+    if (offset < 0) return -22;
+
+    // mapped streams are read-only
+    if (stream->flags & _F_MAPPED) return -9;           // EBADF
+
+    while (done < size) {
+        long long n = sys_pwrite64(stream->fd, src + done, size - done, offset + done);
+
+        if (n < 0) {
+            if (done == 0) return n;
+            break;
+        }
+        done += n;
+    }
+
+    if (stream->offset >= 0 && stream->buffer_len > 0) {
+        long long start = stream->offset - (long long)stream->buffer_len;
+        long long lo = offset > start ? offset : start;
+        long long hi = offset + (long long)done;
+
+        if (hi > stream->offset) hi = stream->offset;
+
+        for (long long i = lo; i < hi; i++) stream->buffer[i - start] = src[i - offset];
+    }
+
+    return done;
+}
+
+/**
+ * Announce the access pattern of the stream.
+ * 
+ * The kernel adjusts its read ahead to the advice,
+ * e.g. _POSIX_FADV_RANDOM stops it from reading
+ * pages which a random reader would never use.
+ * For mapped streams the advice is given to the
+ * mapping.
+ * 
+ * @param stream stream to advise about
+ * @param offset start of the range
+ * @param len length of the range, 0 means until the end of the file
+ * @param advice the advice (_POSIX_FADV_*)
+ * @return 0 on success, or an error code
+*/
+int _fadvise(_FILE *stream, long long offset, long long len, int advice) {
+    if (stream->flags & _F_MAPPED) {
+        if (offset < 0 || len < 0) return -22;
+        if ((unsigned long long)offset >= stream->buffer_size) return 0;
+
+        _size_t end = stream->buffer_size;
+        if (len > 0 && (unsigned long long)(offset + len) < end) end = offset + len;
+
+        // madvise wants a page aligned address
+        _size_t begin = offset & ~4095LL;
+
+        // the advice values are the same as for madvise
+        return sys_madvise(stream->buffer + begin, end - begin, advice);
+    }
+
+    return sys_fadvise64(stream->fd, offset, len, advice);
+}
+
+/**
+ * Read a range of the stream into the page cache.
+ * 
+ * The call starts the reading and returns, later
+ * reads of the range do not wait for the disk.
+ * 
+ * @param stream stream to read ahead
+ * @param offset start of the range
+ * @param len length of the range
+ * @return 0 on success, or an error code
+*/
+int _freadahead(_FILE *stream, long long offset, _size_t len) {
+    return sys_readahead(stream->fd, offset, len);
+}
+
+/**
+ * Ways of copying the data used by _fcopy, from the
+ * fastest to the slowest. When one of them fails
+ * (e.g. the files are on different file systems),
+ * the copy continues with the next one.
+ * 
+ * - FCOPY_RANGE    - copy_file_range, can share the data blocks
+ * - FCOPY_SENDFILE - sendfile, copies inside the kernel
+ * - FCOPY_SPLICE   - splice through a pipe, moves the pages
+ * - FCOPY_BUFFER   - read and write through the stream buffer
+*/
+#define __FCOPY_RANGE     0
+#define __FCOPY_SENDFILE  1
+#define __FCOPY_SPLICE    2
+#define __FCOPY_BUFFER    3
+
+/**
+ * Move the data from the source to a pipe and from
+ * the pipe to the destination.
+ * 
+ * @param dst descriptor to write to
+ * @param src descriptor to read from
+ * @param off where to read from (NULL for the file position)
+ * @param len number of bytes to move
+ * @param pipe the pipe
+ * @return number of bytes moved, or an error code
+*/
+long long __fcopy_splice(int dst, int src, long long *off, _size_t len, int *pipe) {
+    long long n = sys_splice(src, off, pipe[1], NULL, len, _SPLICE_F_MOVE | _SPLICE_F_MORE);
+    if (n <= 0) return n;
+
+    long long moved = 0;
+
+    while (moved < n) {
+        long long m = sys_splice(pipe[0], NULL, dst, NULL, n - moved, _SPLICE_F_MOVE | _SPLICE_F_MORE);
+
+        if (m == -4) continue;                          // EINTR
+        if (m <= 0) {
+            // the data already left the source, pass the
+            // rest through user space rather than lose it
+            char buf[512];
+
+            while (moved < n) {
+                long long r = sys_read(pipe[0], buf, sizeof(buf));
+                if (r <= 0) return r < 0 ? r : -5;      // EIO
+
+                for (long long w = 0; w < r;) {
+                    long long k = sys_write(dst, buf + w, r - w);
+                    if (k < 0) return k;
+                    w += k;
+                }
+                moved += r;
+            }
+            break;
+        }
+        moved += m;
+    }
+
+    return moved;
+}
+
+/**
+ * Copy from one stream to another.
+ * 
+ * The data is copied from the position of the source
+ * to the position of the destination, both positions
+ * move past the copied data. The copy stays in the
+ * kernel whenever possible:
+ * 
+ * - whole files are cloned with FICLONE, which shares
+ *   the data blocks on file systems supporting reflinks
+ * - copy_file_range copies (or reflinks) ranges
+ * - sendfile copies to any descriptor
+ * - splice moves the pages through a pipe
+ * 
+ * Only when none of them works, the data is read and
+ * written through the stream buffer.
+ * 
+ * Example usage:
+ *  _FILE *src = _fopen("artifact.bin", "r");
+ *  _FILE *dst = _fopen("artifact.copy", "w");
+ *  _fcopy(dst, src, 0);
+ * 
+ * @param dst stream to write to
+ * @param src stream to read from
+ * @param len number of bytes to copy, 0 copies
+ *            until the end of the source
+ * @return number of bytes copied, or an error code
+ *         if nothing could be copied
+*/
+long long _fcopy(_FILE *dst, _FILE *src, _size_t len) {
+    _size_t done = 0;
+    int pipe[2] = { -1, -1 };
+    int method = __FCOPY_RANGE;
+    int stop = 0;
+    long long ret = 0;
+
+    if (__fdiscard(dst) != 0) return -5;                // EIO
+
+    int mapped = src->flags & _F_MAPPED;
+    long long in = src->buffer_pos;
+
+    // data already in the buffer of the source is
+    // written out first, the kernel continues after it
+    if (!mapped && src->buffer_pos < src->buffer_len) {
+        _size_t n = src->buffer_len - src->buffer_pos;
+        if (len && n > len) n = len;
+
+        _fwrite(src->buffer + src->buffer_pos, 1, n, dst);
+        if (dst->error) return -5;
+
+        src->buffer_pos += n;
+        done += n;
+    }
+
+    if (len && done == len) return done;
+
+    // clone the whole file when both streams are at the start
+    if (len == 0 && _ftell(src) == 0 && _ftell(dst) == 0 && !(dst->flags & _F_APPEND)) {
+        _stat_t st;
+
+        if (sys_ioctl(dst->fd, _FICLONE, src->fd) == 0 && sys_fstat(src->fd, &st) == 0) {
+            _fseek(src, st.st_size, _SEEK_SET);
+
+            long long off = sys_lseek(dst->fd, st.st_size, _SEEK_SET);
+            if (off >= 0) dst->offset = off;
+
+            return st.st_size;
+        }
+    }
+
+    // the kernel reads from the descriptor position, so the
+    // window of the source is dropped, a mapped source keeps
+    // its position in the buffer and passes it explicitly
+    if (!mapped) {
+        src->buffer_len = 0;
+        src->buffer_pos = 0;
+    }
+
+    while (len == 0 || done < len) {
+        _size_t chunk = len ? len - done : 0x40000000;
+        if (chunk > 0x40000000) chunk = 0x40000000;
+
+        long long *off = mapped ? &in : NULL;
+        long long n;
+
+        switch (method)
+        {
+        case __FCOPY_RANGE :
+            n = sys_copy_file_range(src->fd, off, dst->fd, NULL, chunk, 0);
+            break;
+        case __FCOPY_SENDFILE :
+            n = sys_sendfile(dst->fd, src->fd, off, chunk);
+            break;
+        case __FCOPY_SPLICE :
+            if (pipe[0] < 0 && (n = sys_pipe2(pipe, _O_CLOEXEC)) < 0) break;
+
+            n = __fcopy_splice(dst->fd, src->fd, off, chunk, pipe);
+            break;
+        default :
+            if (mapped) {
+                _size_t left = in < (long long)src->buffer_size ? src->buffer_size - in : 0;
+
+                n = sys_write(dst->fd, src->buffer + in, chunk < left ? chunk : left);
+                if (n > 0) in += n;
+            }
+            else {
+                if (__fbuffer(src) == NULL) {
+                    n = -12;                            // ENOMEM
+                    break;
+                }
+
+                n = sys_read(src->fd, src->buffer, chunk < src->buffer_size ? chunk : src->buffer_size);
+
+                if (n > 0) {
+                    if (src->offset >= 0) src->offset += n;
+
+                    for (long long w = 0; w < n;) {
+                        long long k = sys_write(dst->fd, src->buffer + w, n - w);
+
+                        if (k == -4) continue;          // EINTR
+                        if (k < 0) {
+                            // keep the unwritten data buffered in the source
+                            src->buffer_len = n;
+                            src->buffer_pos = w;
+                            ret = k;
+                            stop = 1;
+                            n = w ? w : k;
+                            break;
+                        }
+                        w += k;
+                    }
+                }
+            }
+            break;
+        }
+
+        if (n == -4) continue;                          // EINTR
+
+        if (n < 0) {
+            // try the next way, the buffered one is the last
+            if (method < __FCOPY_BUFFER) {
+                method++;
+                continue;
+            }
+
+            ret = n;
+            break;
+        }
+
+        if (n == 0) {
+            src->eof = 1;
+            break;
+        }
+
+        done += n;
+        if (!mapped && method != __FCOPY_BUFFER && src->offset >= 0) src->offset += n;
+        if (dst->offset >= 0) dst->offset += n;
+        if (stop) break;
+    }
+
+    if (pipe[0] >= 0) {
+        sys_close(pipe[0]);
+        sys_close(pipe[1]);
+    }
+
+    if (mapped) src->buffer_pos = in;
+    if (dst->flags & _F_APPEND) dst->offset = -1;
+
+    if (done == 0 && ret < 0) {
+        dst->error = 1;
+        return ret;
+    }
+
+    return done;
 }
 
 #endif // __STDIO_H__
@@ -0,0 +1,1876 @@
+/**
+ * _stdlib.h - Standard general utilities library remake.
+ *
+ * The library provides the memory allocator, and
+ * includes the sorts of _sort.h, the searches of
+ * _search.h and the random numbers of _random.h.
+ *
+ * The memory is taken from the kernel with mmap in
+ * segments of 4 MB, aligned to their size. The start
+ * of every segment holds a header with one entry per
+ * page, so the metadata of any pointer is found by
+ * masking its address, without a header in front of
+ * every allocation.
+ *
+ * Allocations are served in three ways, by size:
+ *
+ * - small (up to 8 KB)  - objects of segregated size classes,
+ *                         carved from runs of pages, every class
+ *                         keeps a list of runs with free objects
+ * - medium (up to 1 MB) - whole runs of pages, free runs are kept
+ *                         in bins by length and merged with their
+ *                         free neighbours
+ * - large               - mapped directly, in a segment of their own
+ *
+ * Every thread keeps a cache of free small objects, so
+ * most allocations and frees do not take the lock of the
+ * shared heap (see __tcache).
+ *
+ * Programs with big heaps can back the memory with
+ * transparent huge pages and prefault large blocks,
+ * pages of free runs are given back to the kernel
+ * from time to time (see _mallopt).
+ *
+ * Defining RAWC_MALLOC_STATS before including the
+ * library turns on counters of the allocator and a
+ * sampling heap profiler (see _malloc_stats). Without
+ * it, the counting code is not compiled at all.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __STDLIB_H__
+#define __STDLIB_H__
+
+#include <_stdio.h>
+
+/**
+ * Library functions:
+ *  > memory management:
+ *   @fn _malloc Allocate a memory block.
+ *   @fn _calloc Allocate a zeroed memory block for an array.
+ *   @fn _aligned_alloc Allocate a memory block with the given alignment.
+ *   @fn _realloc Change the size of a memory block.
+ *   @fn _free Free a memory block.
+ *   @fn _malloc_flush Give the objects cached by the thread back.
+ *  > tuning:
+ *   @fn _mallopt Set an option of the allocator.
+ *   @fn _malloc_trim Give the free pages back to the kernel.
+ *  > instrumentation (RAWC_MALLOC_STATS):
+ *   @fn _malloc_stats Write the counters of the allocator.
+ *   @fn _malloc_profile Write the heap profile.
+ *   @fn _malloc_leaks Write the sampled blocks which are still in use.
+*/
+
+/**
+ * Options of the allocator, set with _mallopt.
+ *
+ * - M_HUGEPAGE - back segments and large blocks with transparent
+ *                huge pages, large blocks are rounded up to whole
+ *                huge pages (0 or 1, off by default)
+ * - M_PREFAULT - fault the pages of large blocks in when they are
+ *                allocated, not on the first access (0 or 1, off
+ *                by default)
+ * - M_PURGE    - how the pages of free runs are given back to the
+ *                kernel: _MADV_FREE (default), _MADV_DONTNEED, or
+ *                0 to keep them
+ * - M_SAMPLE   - average number of bytes allocated between two
+ *                samples of the heap profiler, 0 turns it off
+ *                (off by default, only with RAWC_MALLOC_STATS)
+*/
+#define _M_HUGEPAGE   1
+#define _M_PREFAULT   2
+#define _M_PURGE      3
+#define _M_SAMPLE     4
+
+/**
+ * Allocator geometry.
+ *
+ * - PAGE_SIZE    - size of a page, the unit of the runs
+ * - SEG_SIZE     - size and alignment of a segment
+ * - SEG_PAGES    - number of pages in a segment
+ * - SMALL_MAX    - the biggest small allocation
+ * - MEDIUM_MAX   - the biggest medium allocation
+ * - CLASSES      - number of small size classes
+ * - BINS         - number of free run bins, the last one
+ *                  holds the runs of BINS - 1 pages or more
+ * - HUGE_SIZE    - size of a transparent huge page
+ * - DIRTY_MAX    - number of dirty free pages kept, the
+ *                  oldest dirty runs over it are purged
+*/
+#define __PAGE_SIZE   4096UL
+#define __SEG_SIZE    (4UL << 20)
+#define __SEG_PAGES   (__SEG_SIZE / __PAGE_SIZE)
+#define __SMALL_MAX   8192UL
+#define __MEDIUM_MAX  (1UL << 20)
+#define __CLASSES     32
+#define __BINS        257
+#define __HUGE_SIZE   (2UL << 20)
+#define __DIRTY_MAX   (8 * __SEG_PAGES)
+
+/**
+ * Kinds of runs and segments.
+*/
+#define __RUN_FREE    1
+#define __RUN_SMALL   2
+#define __RUN_MEDIUM  3
+
+#define __SEG_RUNS    1
+#define __SEG_LARGE   2
+
+/**
+ * __run - a run of pages inside a segment.
+ *
+ * Every page of a segment has an entry, the entry of
+ * the first page describes the whole run. The entry of
+ * the last page of a run keeps its kind too, so a run
+ * being freed can tell if its left neighbour is free.
+ *
+ * @param free free objects of a small run (singly linked)
+ * @param bump first object of a small run never handed out
+ * @param next next run in a class list or a bin
+ * @param prev previous run in a class list or a bin
+ * @param older next older run in the dirty list
+ * @param newer next newer run in the dirty list
+ * @param pages number of pages in the run
+ * @param dirty number of pages of a free run which
+ *              may be resident, 0 if it is purged
+ * @param offset distance from the first page of the run
+ * @param used number of objects handed out (small runs)
+ * @param cap number of objects in the run (small runs)
+ * @param kind kind of the run (__RUN_*)
+ * @param cls size class of a small run
+*/
+typedef struct __run {
+    void *free;
+    char *bump;
+    struct __run *next;
+    struct __run *prev;
+    struct __run *older;
+    struct __run *newer;
+    unsigned int pages;
+    unsigned int offset;
+    unsigned int dirty;
+    unsigned short used;
+    unsigned short cap;
+    unsigned char kind;
+    unsigned char cls;
+} __run;
+
+/**
+ * __segment - header at the start of every segment.
+ *
+ * @param kind kind of the segment (__SEG_*)
+ * @param size size of the mapping
+ * @param free number of free pages (__SEG_RUNS)
+ * @param runs page entries (__SEG_RUNS)
+*/
+typedef struct {
+    unsigned long kind;
+    unsigned long size;
+    unsigned long free;
+    __run runs[__SEG_PAGES];
+} __segment;
+
+/**
+ * Pages taken by the segment header, the runs
+ * start right after them.
+*/
+#define __SEG_HEADER  ((sizeof(__segment) + __PAGE_SIZE - 1) / __PAGE_SIZE)
+#define __SEG_USABLE  (__SEG_PAGES - __SEG_HEADER)
+
+/**
+ * __heap - state of the allocator.
+ *
+ * @param classes runs with free objects, by size class
+ * @param bins free runs, by number of pages
+ * @param bitmap non-empty bins, one bit per bin
+ * @param oldest oldest dirty free run
+ * @param newest newest dirty free run
+ * @param empty number of completely free segments kept
+ * @param dirty number of dirty pages in the free runs
+*/
+typedef struct {
+    __run *classes[__CLASSES];
+    __run *bins[__BINS];
+    unsigned long long bitmap[(__BINS + 63) / 64];
+    __run *oldest;
+    __run *newest;
+    unsigned long empty;
+    unsigned long dirty;
+} __heap_t;
+
+__heap_t __heap;
+
+/**
+ * __options_t - options of the allocator (see _mallopt).
+ *
+ * @param hugepage use transparent huge pages
+ * @param prefault prefault large blocks
+ * @param purge advice used to purge free pages (0 to keep them)
+*/
+typedef struct {
+    int hugepage;
+    int prefault;
+    int purge;
+} __options_t;
+
+__options_t __options = { 0, 0, _MADV_FREE };
+
+#ifdef RAWC_MALLOC_STATS
+
+/**
+ * __stats - counters of the allocator.
+ *
+ * The counters of small objects are kept by every
+ * thread and added here in bulk (see __stats_publish),
+ * the other ones are updated with atomic operations
+ * on the slow paths.
+ *
+ * @param allocs small allocations by size class
+ * @param frees small frees by size class
+ * @param misses small allocations which refilled a thread cache
+ * @param medium_allocs medium allocations
+ * @param medium_frees medium frees
+ * @param medium_bytes bytes in medium blocks in use
+ * @param large_allocs large allocations
+ * @param large_frees large frees
+ * @param large_bytes bytes in large blocks in use
+ * @param mapped bytes mapped by the allocator
+*/
+typedef struct {
+    unsigned long long allocs[__CLASSES];
+    unsigned long long frees[__CLASSES];
+    unsigned long long misses;
+    unsigned long long medium_allocs;
+    unsigned long long medium_frees;
+    unsigned long long medium_bytes;
+    unsigned long long large_allocs;
+    unsigned long long large_frees;
+    unsigned long long large_bytes;
+    unsigned long long mapped;
+} __stats_t;
+
+__stats_t __stats;
+
+    #define __STAT_ADD(field, n) __atomic_fetch_add(&__stats.field, (unsigned long long)(n), __ATOMIC_RELAXED)
+    #define __STAT_SUB(field, n) __atomic_fetch_sub(&__stats.field, (unsigned long long)(n), __ATOMIC_RELAXED)
+    #define __MALLOC_API __attribute__((noinline))
+#else
+    #define __STAT_ADD(field, n) ((void)0)
+    #define __STAT_SUB(field, n) ((void)0)
+    #define __MALLOC_API
+#endif
+
+/**
+ * Get the segment of the given pointer.
+*/
+#define __SEGMENT_OF(ptr) ((__segment *)((unsigned long)(ptr) & ~(__SEG_SIZE - 1)))
+
+/**
+ * Get the address of the first page of a run.
+ *
+ * @param seg segment of the run
+ * @param run entry of the first page
+ * @return address of the run
+*/
+char* __run_addr(__segment *seg, __run *run) {
+    return (char *)seg + (run - seg->runs) * __PAGE_SIZE;
+}
+
+/**
+ * Get the size class of a small allocation.
+ *
+ * Classes of 16 bytes cover sizes up to 128 bytes,
+ * above that every power of two is split into four
+ * classes, so at most a quarter of a block is wasted.
+ *
+ * @param size size of the allocation (1 to __SMALL_MAX)
+ * @return the size class
+*/
+unsigned __size_class(_size_t size) {
+    if (size <= 128) return size ? (unsigned)((size + 15) >> 4) - 1 : 0;
+
+    // size - 1 lies in [2^k, 2^(k+1)), the four classes
+    // of this range are 2^(k-2) bytes apart
+    unsigned k = 63 - __builtin_clzll(size - 1);
+
+    return 8 + (k - 7) * 4 + (unsigned)((size - 1 - (1ULL << k)) >> (k - 2));
+}
+
+/**
+ * Get the size of the objects of a size class.
+ *
+ * @param cls size class
+ * @return size of the objects
+*/
+_size_t __class_size(unsigned cls) {
+    if (cls < 8) return (cls + 1) << 4;
+
+    unsigned k = 7 + (cls - 8) / 4;
+    return (1ULL << k) + (((cls - 8) % 4) + 1) * (1ULL << (k - 2));
+}
+
+/**
+ * Get the number of pages of the runs of a size class.
+ *
+ * Runs have room for at least 16 objects, but are
+ * not longer than 16 pages.
+ *
+ * @param cls size class
+ * @return number of pages
+*/
+unsigned __class_pages(unsigned cls) {
+    _size_t pages = (__class_size(cls) * 16 + __PAGE_SIZE - 1) / __PAGE_SIZE;
+
+    return pages > 16 ? 16 : (unsigned)pages;
+}
+
+/**
+ * Map memory aligned to the segment size.
+ *
+ * More memory than needed is mapped and the parts
+ * before and after the aligned area are unmapped.
+ *
+ * @param size size of the area (a multiple of the page size)
+ * @return address of the area, or NULL on failure
+*/
+void* __seg_map(_size_t size) {
+    _size_t span = size + __SEG_SIZE;
+
+    // the area wraps the address space
+    if (span < size) return NULL;
+
+    long long addr = sys_mmap(NULL, span, _PROT_READ | _PROT_WRITE,
+                              _MAP_PRIVATE | _MAP_ANONYMOUS, -1, 0);
+    if (addr < 0) return NULL;
+
+    unsigned long start = (unsigned long)addr;
+    unsigned long aligned = (start + __SEG_SIZE - 1) & ~(__SEG_SIZE - 1);
+
+    if (aligned > start) sys_munmap((void *)start, aligned - start);
+    if (start + span > aligned + size) sys_munmap((void *)(aligned + size), start + span - aligned - size);
+
+    return (void *)aligned;
+}
+
+/**
+ * Apply the options of the allocator to a new mapping.
+ *
+ * Huge pages are asked for before the pages are
+ * touched, so the prefault already maps huge pages.
+ *
+ * @param area the mapping (aligned to a segment)
+ * @param size size of the mapping
+ * @param prefault fault the pages in
+*/
+void __seg_advise(void *area, _size_t size, int prefault) {
+    if (__options.hugepage) sys_madvise(area, size, _MADV_HUGEPAGE);
+    if (!prefault) return;
+
+    // kernels before 5.14 do not know MADV_POPULATE_WRITE
+    if (sys_madvise(area, size, _MADV_POPULATE_WRITE) == 0) return;
+
+    for (_size_t i = 0; i < size; i += __PAGE_SIZE) ((volatile char *)area)[i] = 0;
+}
+
+/**
+ * Give the pages of a free area back to the kernel.
+ *
+ * The area stays mapped, its pages read as zeros
+ * once the kernel has taken them.
+ *
+ * @param area the area (aligned to a page)
+ * @param size size of the area
+*/
+void __pages_purge(void *area, _size_t size) {
+    if (__options.purge == 0) return;
+
+    // kernels before 4.5 do not know MADV_FREE
+    if (sys_madvise(area, size, __options.purge) != 0 && __options.purge == _MADV_FREE) {
+        __options.purge = _MADV_DONTNEED;
+        sys_madvise(area, size, _MADV_DONTNEED);
+    }
+}
+
+/**
+ * Link a run to the front of a list.
+ *
+ * @param list head of the list
+ * @param run run to link
+*/
+void __run_push(__run **list, __run *run) {
+    run->prev = NULL;
+    run->next = *list;
+
+    if (*list) (*list)->prev = run;
+    *list = run;
+}
+
+/**
+ * Unlink a run from a list.
+ *
+ * @param list head of the list
+ * @param run run to unlink
+*/
+void __run_unlink(__run **list, __run *run) {
+    if (run->prev) run->prev->next = run->next;
+    else *list = run->next;
+
+    if (run->next) run->next->prev = run->prev;
+
+    run->next = NULL;
+    run->prev = NULL;
+}
+
+/**
+ * Get the bin of a free run.
+ *
+ * @param pages number of pages in the run
+ * @return the bin
+*/
+unsigned __bin_of(unsigned pages) {
+    return pages < __BINS - 1 ? pages : __BINS - 1;
+}
+
+/**
+ * Put a free run into its bin.
+ *
+ * The entries of the first and the last page are
+ * marked, so the neighbours can find the run.
+ *
+ * @param seg segment of the run
+ * @param first index of the first page
+ * @param pages number of pages
+*/
+void __bin_insert(__segment *seg, unsigned first, unsigned pages) {
+    __run *run = &seg->runs[first];
+    __run *last = &seg->runs[first + pages - 1];
+    unsigned bin = __bin_of(pages);
+
+    run->kind = __RUN_FREE;
+    run->pages = pages;
+    run->offset = 0;
+
+    last->kind = __RUN_FREE;
+    last->offset = pages - 1;
+
+    __run_push(&__heap.bins[bin], run);
+    __heap.bitmap[bin / 64] |= 1ULL << (bin % 64);
+}
+
+/**
+ * Take a free run out of its bin.
+ *
+ * @param run entry of the first page of the run
+*/
+void __bin_remove(__run *run) {
+    unsigned bin = __bin_of(run->pages);
+
+    __run_unlink(&__heap.bins[bin], run);
+    if (__heap.bins[bin] == NULL) __heap.bitmap[bin / 64] &= ~(1ULL << (bin % 64));
+}
+
+/**
+ * Add dirty pages to a free run.
+ *
+ * A clean run goes to the newest end of the dirty
+ * list, a dirty one keeps its place.
+ *
+ * @param run entry of the first page of the run
+ * @param pages number of dirty pages
+*/
+void __dirty_add(__run *run, unsigned pages) {
+    if (pages == 0) return;
+
+    if (run->dirty == 0) {
+        run->older = __heap.newest;
+        run->newer = NULL;
+
+        if (__heap.newest) __heap.newest->newer = run;
+        else __heap.oldest = run;
+        __heap.newest = run;
+    }
+
+    run->dirty += pages;
+    __heap.dirty += pages;
+}
+
+/**
+ * Take a free run out of the dirty list.
+ *
+ * @param run entry of the first page of the run
+ * @return number of dirty pages the run had
+*/
+unsigned __dirty_remove(__run *run) {
+    unsigned pages = run->dirty;
+    if (pages == 0) return 0;
+
+    if (run->older) run->older->newer = run->newer;
+    else __heap.oldest = run->newer;
+
+    if (run->newer) run->newer->older = run->older;
+    else __heap.newest = run->older;
+
+    run->older = NULL;
+    run->newer = NULL;
+    run->dirty = 0;
+    __heap.dirty -= pages;
+
+    return pages;
+}
+
+/**
+ * Find a free run of at least the given length.
+ *
+ * The bitmap gives the smallest non-empty bin which
+ * fits, the last bin is searched for the first run
+ * which is long enough.
+ *
+ * @param pages number of pages wanted
+ * @return the run, or NULL if there is none
+*/
+__run* __bin_find(unsigned pages) {
+    unsigned bin = __bin_of(pages);
+
+    for (unsigned word = bin / 64; word < (__BINS + 63) / 64; word++) {
+        unsigned long long bits = __heap.bitmap[word];
+
+        // ignore the bins below the wanted one
+        if (word == bin / 64) bits &= ~0ULL << (bin % 64);
+        if (bits == 0) continue;
+
+        unsigned found = word * 64 + __builtin_ctzll(bits);
+
+        if (found < __BINS - 1) return __heap.bins[found];
+
+        for (__run *run = __heap.bins[found]; run != NULL; run = run->next) {
+            if (run->pages >= pages) return run;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Map a new segment, all of its pages form one free run.
+ *
+ * @return 0 on success, -1 if the memory can not be mapped
+*/
+int __seg_grow(void) {
+    __segment *seg = (__segment *)__seg_map(__SEG_SIZE);
+    if (seg == NULL) return -1;
+
+    __seg_advise(seg, __SEG_SIZE, 0);
+    __STAT_ADD(mapped, __SEG_SIZE);
+
+    seg->kind = __SEG_RUNS;
+    seg->size = __SEG_SIZE;
+    seg->free = __SEG_USABLE;
+
+    __bin_insert(seg, __SEG_HEADER, __SEG_USABLE);
+    __heap.empty++;
+
+    return 0;
+}
+
+/**
+ * Allocate a run of pages.
+ *
+ * The best fitting free run is split, the rest of
+ * it goes back to the bins.
+ *
+ * @param pages number of pages
+ * @param kind kind of the new run
+ * @return entry of the first page, or NULL on failure
+*/
+__run* __pages_alloc(unsigned pages, unsigned char kind) {
+    __run *run = __bin_find(pages);
+
+    if (run == NULL) {
+        if (__seg_grow() != 0) return NULL;
+        run = __bin_find(pages);
+    }
+
+    __segment *seg = __SEGMENT_OF(run);
+    unsigned first = run - seg->runs;
+    unsigned total = run->pages;
+    unsigned dirty = __dirty_remove(run);
+
+    __bin_remove(run);
+
+    if (seg->free == __SEG_USABLE) __heap.empty--;
+    seg->free -= pages;
+
+    // the rest keeps at most its own pages dirty
+    if (total > pages) {
+        __bin_insert(seg, first + pages, total - pages);
+        __dirty_add(&seg->runs[first + pages], dirty < total - pages ? dirty : total - pages);
+    }
+
+    run->kind = kind;
+    run->pages = pages;
+    run->offset = 0;
+    run->next = NULL;
+    run->prev = NULL;
+
+    seg->runs[first + pages - 1].kind = kind;
+
+    return run;
+}
+
+/**
+ * Purge the oldest dirty free runs, until no more
+ * than the given number of dirty pages is left.
+ *
+ * Runs purged before are clean and not touched again,
+ * so every freed page is purged once at most.
+ *
+ * @param keep number of dirty pages to keep
+ * @return number of bytes purged
+*/
+_size_t __heap_purge(unsigned long keep) {
+    _size_t purged = 0;
+
+    while (__heap.dirty > keep) {
+        __run *run = __heap.oldest;
+
+        __dirty_remove(run);
+        if (__options.purge == 0) continue;
+
+        _size_t size = (_size_t)run->pages * __PAGE_SIZE;
+
+        __pages_purge(__run_addr(__SEGMENT_OF(run), run), size);
+        purged += size;
+    }
+
+    return purged;
+}
+
+/**
+ * Free a run of pages.
+ *
+ * The run is merged with the free runs next to it.
+ * If the whole segment becomes free, it is given back
+ * to the kernel, unless it is the only free one.
+ *
+ * The freed pages stay dirty until more than DIRTY_MAX
+ * of them are, then the oldest dirty runs are purged,
+ * so a run which is freed and allocated again in a
+ * loop does not fault its pages in every time.
+ *
+ * @param run entry of the first page
+*/
+void __pages_free(__run *run) {
+    __segment *seg = __SEGMENT_OF(run);
+    unsigned first = run - seg->runs;
+    unsigned pages = run->pages;
+    unsigned dirty = pages;
+
+    seg->free += pages;
+
+    // merge with the run on the left
+    if (first > __SEG_HEADER && seg->runs[first - 1].kind == __RUN_FREE) {
+        __run *left = &seg->runs[first - 1 - seg->runs[first - 1].offset];
+
+        dirty += __dirty_remove(left);
+        __bin_remove(left);
+        first = left - seg->runs;
+        pages += left->pages;
+    }
+
+    // merge with the run on the right
+    if (first + pages < __SEG_PAGES && seg->runs[first + pages].kind == __RUN_FREE) {
+        __run *right = &seg->runs[first + pages];
+
+        dirty += __dirty_remove(right);
+        __bin_remove(right);
+        pages += right->pages;
+    }
+
+    if (seg->free == __SEG_USABLE && __heap.empty > 0) {
+        __STAT_SUB(mapped, seg->size);
+        sys_munmap(seg, seg->size);
+        return;
+    }
+
+    if (seg->free == __SEG_USABLE) __heap.empty++;
+    __bin_insert(seg, first, pages);
+    __dirty_add(&seg->runs[first], dirty);
+
+    if (__heap.dirty > __DIRTY_MAX) __heap_purge(__DIRTY_MAX);
+}
+
+/**
+ * Allocate a small object.
+ *
+ * The object is taken from the free list of the first
+ * run of its class, or carved from the part of the run
+ * which was never used. Full runs leave the class list.
+ *
+ * @param cls size class
+ * @return the object, or NULL on failure
+*/
+void* __small_alloc(unsigned cls) {
+    __run *run = __heap.classes[cls];
+
+    if (run == NULL) {
+        unsigned pages = __class_pages(cls);
+
+        run = __pages_alloc(pages, __RUN_SMALL);
+        if (run == NULL) return NULL;
+
+        __segment *seg = __SEGMENT_OF(run);
+        unsigned first = run - seg->runs;
+
+        // every page points to the first one of the run and
+        // knows the class, so a free needs a single lookup
+        for (unsigned i = 1; i < pages; i++) {
+            seg->runs[first + i].offset = i;
+            seg->runs[first + i].kind = __RUN_SMALL;
+            seg->runs[first + i].cls = cls;
+        }
+
+        run->cls = cls;
+        run->free = NULL;
+        run->bump = __run_addr(seg, run);
+        run->used = 0;
+        run->cap = (pages * __PAGE_SIZE) / __class_size(cls);
+
+        __run_push(&__heap.classes[cls], run);
+    }
+
+    void *obj = run->free;
+
+    if (obj != NULL) run->free = *(void **)obj;
+    else {
+        obj = run->bump;
+        run->bump += __class_size(cls);
+    }
+
+    // a run with no free and no fresh objects is full
+    if (++run->used == run->cap) __run_unlink(&__heap.classes[cls], run);
+
+    return obj;
+}
+
+/**
+ * Free a small object.
+ *
+ * A full run gets back into its class list, an empty
+ * run gives its pages back, unless it is the last run
+ * of its class.
+ *
+ * @param run run of the object
+ * @param ptr the object
+*/
+void __small_free(__run *run, void *ptr) {
+    unsigned cls = run->cls;
+
+    *(void **)ptr = run->free;
+    run->free = ptr;
+
+    if (run->used-- == run->cap) __run_push(&__heap.classes[cls], run);
+
+    if (run->used == 0 && (run->prev != NULL || run->next != NULL)) {
+        __run_unlink(&__heap.classes[cls], run);
+        __pages_free(run);
+    }
+}
+
+/**
+ * Get the size of the segment of a large block.
+ *
+ * @param size size of the block
+ * @return size of the segment, or 0 if it does not fit
+*/
+_size_t __large_span(_size_t size) {
+    _size_t span = (size + __PAGE_SIZE + __PAGE_SIZE - 1) & ~(__PAGE_SIZE - 1);
+
+    if (span < size) return 0;
+
+    // the end of the block would be left on small pages
+    if (__options.hugepage && span >= __HUGE_SIZE) {
+        _size_t huge = (span + __HUGE_SIZE - 1) & ~(__HUGE_SIZE - 1);
+
+        span = huge < span ? 0 : huge;
+    }
+
+    return span;
+}
+
+/**
+ * Allocate a large block in a segment of its own.
+ *
+ * The first page holds the segment header, the block
+ * starts at the second page.
+ *
+ * @param size size of the block
+ * @return the block, or NULL on failure
+*/
+void* __large_alloc(_size_t size) {
+    _size_t span = __large_span(size);
+
+    if (span == 0) return NULL;
+
+    __segment *seg = (__segment *)__seg_map(span);
+    if (seg == NULL) return NULL;
+
+    __seg_advise(seg, span, __options.prefault);
+    __STAT_ADD(mapped, span);
+    __STAT_ADD(large_allocs, 1);
+    __STAT_ADD(large_bytes, span - __PAGE_SIZE);
+
+    seg->kind = __SEG_LARGE;
+    seg->size = span;
+
+    return (char *)seg + __PAGE_SIZE;
+}
+
+/**
+ * Lock of the shared heap.
+ *
+ * Only refills and flushes of the thread caches and
+ * medium allocations take it, the critical sections
+ * are short, so spinning is cheaper than sleeping.
+*/
+int __heap_lock = 0;
+
+/**
+ * Tell the CPU the thread is spinning.
+*/
+#if defined(__x86_64__) || defined(__i386__)
+    #define __CPU_RELAX() asm volatile("pause" ::: "memory")
+#else
+    #define __CPU_RELAX() asm volatile("yield" ::: "memory")
+#endif
+
+/**
+ * Take a spin lock.
+ *
+ * @param lock the lock
+*/
+void __spin_acquire(int *lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        // wait for the lock to look free before trying
+        // again, so the cache line is not bounced around
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) __CPU_RELAX();
+    }
+}
+
+/**
+ * Release a spin lock.
+ *
+ * @param lock the lock
+*/
+void __spin_release(int *lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * Take the lock of the shared heap.
+*/
+void __heap_acquire(void) {
+    __spin_acquire(&__heap_lock);
+}
+
+/**
+ * Release the lock of the shared heap.
+*/
+void __heap_release(void) {
+    __spin_release(&__heap_lock);
+}
+
+/**
+ * __tcache - cache of free small objects of a thread.
+ *
+ * Allocations and frees of small objects only touch
+ * the cache of the calling thread, without locks or
+ * atomic operations. Objects move between the cache
+ * and the shared heap in batches.
+ *
+ * @param bins free objects by size class (singly linked)
+ * @param counts number of objects in every bin
+ * @param allocs small allocations not added to __stats yet
+ * @param frees small frees not added to __stats yet
+ * @param misses allocations which refilled the cache
+ * @param ops operations counted since the last publish
+ * @param sample_left bytes to allocate before the next sample
+ * @param seed state of the sampling interval generator,
+ *             0 until the thread allocates with profiling on
+*/
+typedef struct {
+    void *bins[__CLASSES];
+    unsigned counts[__CLASSES];
+#ifdef RAWC_MALLOC_STATS
+    unsigned long long allocs[__CLASSES];
+    unsigned long long frees[__CLASSES];
+    unsigned long long misses;
+    unsigned ops;
+    long long sample_left;
+    unsigned long long seed;
+#endif
+} __tcache_t;
+
+__thread __tcache_t __tcache;
+
+#ifdef RAWC_MALLOC_STATS
+
+/**
+ * Add the counters of the calling thread to __stats.
+*/
+void __stats_publish(void) {
+    for (unsigned cls = 0; cls < __CLASSES; cls++) {
+        if (__tcache.allocs[cls] != 0) __STAT_ADD(allocs[cls], __tcache.allocs[cls]);
+        if (__tcache.frees[cls] != 0) __STAT_ADD(frees[cls], __tcache.frees[cls]);
+
+        __tcache.allocs[cls] = 0;
+        __tcache.frees[cls] = 0;
+    }
+
+    __STAT_ADD(misses, __tcache.misses);
+    __tcache.misses = 0;
+    __tcache.ops = 0;
+}
+
+/**
+ * Count a small allocation or free in the calling thread,
+ * the counters are published every 256 operations.
+ *
+ * @param counter counter of the size class
+*/
+void __stats_count(unsigned long long *counter) {
+    (*counter)++;
+    if (++__tcache.ops >= 256) __stats_publish();
+}
+
+    #define __STAT_ALLOC(cls) __stats_count(&__tcache.allocs[cls])
+    #define __STAT_FREE(cls)  __stats_count(&__tcache.frees[cls])
+    #define __STAT_MISS()     (__tcache.misses++)
+#else
+    #define __STAT_ALLOC(cls) ((void)0)
+    #define __STAT_FREE(cls)  ((void)0)
+    #define __STAT_MISS()     ((void)0)
+#endif
+
+/**
+ * __remote - objects given back to the shared heap.
+ *
+ * A thread with too many objects of a class in its
+ * cache pushes a batch of them here with a single
+ * compare-and-swap, most of the time without taking
+ * the lock. Objects freed by another thread than the
+ * one which allocated them come back this way. Threads
+ * refilling their cache take the whole queue at once.
+ *
+ * @param head objects of the queue (singly linked)
+ * @param count number of objects in the queue
+*/
+typedef struct {
+    void *head;
+    long count;
+} __remote_t;
+
+__remote_t __remote[__CLASSES];
+
+/**
+ * Get the number of objects moved between a thread
+ * cache and the shared heap at once.
+ *
+ * About 8 KB of objects are moved, but at least 2
+ * and at most 32 of them.
+ *
+ * @param cls size class
+ * @return the batch size
+*/
+unsigned __batch_size(unsigned cls) {
+    _size_t n = 8192 / __class_size(cls);
+
+    return n < 2 ? 2 : n > 32 ? 32 : (unsigned)n;
+}
+
+/**
+ * Give a chain of objects back to their runs.
+ *
+ * @param head first object of the chain (linked through
+ *             the first word of the objects)
+*/
+void __chain_free(void *head) {
+    __heap_acquire();
+
+    while (head != NULL) {
+        void *next = *(void **)head;
+        __segment *seg = __SEGMENT_OF(head);
+        __run *run = &seg->runs[((char *)head - (char *)seg) / __PAGE_SIZE];
+
+        __small_free(run - run->offset, head);
+        head = next;
+    }
+
+    __heap_release();
+}
+
+/**
+ * Refill the cache of the calling thread.
+ *
+ * Objects waiting in the remote queue are taken
+ * first, only when it is empty new objects are
+ * carved from the runs under the lock.
+ *
+ * @param cls size class
+ * @return 0 on success, -1 if the memory can not be mapped
+*/
+int __tcache_refill(unsigned cls) {
+    void *head = __atomic_exchange_n(&__remote[cls].head, NULL, __ATOMIC_ACQUIRE);
+
+    if (head != NULL) {
+        unsigned n = 1;
+        void *tail = head;
+
+        while (*(void **)tail != NULL) {
+            tail = *(void **)tail;
+            n++;
+        }
+
+        __atomic_fetch_sub(&__remote[cls].count, n, __ATOMIC_RELAXED);
+
+        *(void **)tail = __tcache.bins[cls];
+        __tcache.bins[cls] = head;
+        __tcache.counts[cls] += n;
+        return 0;
+    }
+
+    unsigned batch = __batch_size(cls);
+
+    __heap_acquire();
+
+    for (unsigned i = 0; i < batch; i++) {
+        void *obj = __small_alloc(cls);
+        if (obj == NULL) break;
+
+        *(void **)obj = __tcache.bins[cls];
+        __tcache.bins[cls] = obj;
+        __tcache.counts[cls]++;
+    }
+
+    __heap_release();
+
+    return __tcache.bins[cls] != NULL ? 0 : -1;
+}
+
+/**
+ * Move a batch of objects from the cache of the calling
+ * thread to the remote queue.
+ *
+ * When the queue grows too long, it is emptied back
+ * into the runs, so the memory can be given back.
+ *
+ * @param cls size class
+*/
+void __tcache_flush(unsigned cls) {
+    unsigned batch = __batch_size(cls);
+    void *head = __tcache.bins[cls];
+    void *tail = head;
+
+    for (unsigned i = 1; i < batch; i++) tail = *(void **)tail;
+
+    __tcache.bins[cls] = *(void **)tail;
+    __tcache.counts[cls] -= batch;
+
+    // push the whole batch with one compare-and-swap
+    void *old = __atomic_load_n(&__remote[cls].head, __ATOMIC_RELAXED);
+    do *(void **)tail = old;
+    while (!__atomic_compare_exchange_n(&__remote[cls].head, &old, head, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    long count = __atomic_add_fetch(&__remote[cls].count, batch, __ATOMIC_RELAXED);
+
+    if (count > 8 * (long)batch) {
+        long n = 0;
+
+        head = __atomic_exchange_n(&__remote[cls].head, NULL, __ATOMIC_ACQUIRE);
+
+        for (void *obj = head; obj != NULL; obj = *(void **)obj) n++;
+        __atomic_fetch_sub(&__remote[cls].count, n, __ATOMIC_RELAXED);
+
+        __chain_free(head);
+    }
+}
+
+/**
+ * Allocate a small object from the cache of the calling thread.
+ *
+ * @param cls size class
+ * @return the object, or NULL on failure
+*/
+void* __tcache_alloc(unsigned cls) {
+    void *obj = __tcache.bins[cls];
+
+    if (obj == NULL) {
+        if (__tcache_refill(cls) != 0) return NULL;
+        obj = __tcache.bins[cls];
+        __STAT_MISS();
+    }
+
+    __tcache.bins[cls] = *(void **)obj;
+    __tcache.counts[cls]--;
+    __STAT_ALLOC(cls);
+    return obj;
+}
+
+/**
+ * Give the objects cached by the calling thread
+ * back to the shared heap.
+ *
+ * A thread should call it before it exits, otherwise
+ * the objects in its cache can not be used again.
+*/
+void _malloc_flush(void) {
+    for (unsigned cls = 0; cls < __CLASSES; cls++) {
+        if (__tcache.bins[cls] == NULL) continue;
+
+        __chain_free(__tcache.bins[cls]);
+
+        __tcache.bins[cls] = NULL;
+        __tcache.counts[cls] = 0;
+    }
+
+#ifdef RAWC_MALLOC_STATS
+    __stats_publish();
+#endif
+}
+
+/**
+ * Give back what other libraries keep per thread.
+ *
+ * _thread_exit calls the functions before _malloc_flush.
+ * _coro.h adds one which unmaps the coroutine stacks
+ * pooled by the thread (_coro_pool_release), _log.h one
+ * which frees the ring of the thread for the next one.
+*/
+#define __THREAD_RELEASE 4
+
+void (*__thread_release[__THREAD_RELEASE])(void);
+
+/**
+ * Add a function to __thread_release, once.
+ *
+ * @param fn the function
+*/
+void __thread_release_add(void (*fn)(void)) {
+    for (int i = 0; i < __THREAD_RELEASE; i++) {
+        void (*slot)(void) = __atomic_load_n(&__thread_release[i], __ATOMIC_ACQUIRE);
+
+        if (slot == NULL && __atomic_compare_exchange_n(&__thread_release[i], &slot, fn, 0,
+                                                        __ATOMIC_RELEASE, __ATOMIC_ACQUIRE)) return;
+        if (slot == fn) return;
+    }
+}
+
+#ifdef RAWC_MALLOC_STATS
+
+/**
+ * Sizes of the tables of the heap profiler.
+ *
+ * - PROFILE_SITES  - call sites (a power of two)
+ * - PROFILE_LIVE   - sampled blocks in use (a power of two),
+ *                    at most half of them are tracked
+ * - PROFILE_FILTER - counters of the filter of sampled blocks
+*/
+#define __PROFILE_SITES   1024
+#define __PROFILE_LIVE    4096
+#define __PROFILE_FILTER  65536
+
+/**
+ * __profile_site - samples taken at one call site.
+ *
+ * @param site return address of the allocation call
+ * @param samples number of samples
+ * @param bytes estimated number of bytes allocated
+*/
+typedef struct {
+    void *site;
+    unsigned long long samples;
+    unsigned long long bytes;
+} __profile_site;
+
+/**
+ * __profile_block - a sampled block which is in use.
+ *
+ * @param ptr the block (NULL if the slot is empty)
+ * @param bytes estimated number of bytes it stands for
+ * @param site index of its call site
+*/
+typedef struct {
+    void *ptr;
+    unsigned long long bytes;
+    unsigned site;
+} __profile_block;
+
+/**
+ * __profile - state of the heap profiler.
+ *
+ * A block is sampled about every `interval` bytes,
+ * every sample keeps an estimate of the bytes it
+ * stands for (see __profile_weight).
+ *
+ * Frees look at the filter first, a counter per hash
+ * of the sampled blocks, so only frees of blocks which
+ * may have been sampled take the lock.
+ *
+ * @param interval average number of bytes between samples
+ * @param lock lock of the tables
+ * @param live number of tracked blocks
+ * @param dropped samples which did not fit in the tables
+ * @param sites call sites (open addressing)
+ * @param blocks sampled blocks in use (open addressing)
+ * @param filter number of tracked blocks per hash
+*/
+typedef struct {
+    long long interval;
+    int lock;
+    unsigned live;
+    unsigned long long dropped;
+    __profile_site sites[__PROFILE_SITES];
+    __profile_block blocks[__PROFILE_LIVE];
+    unsigned char filter[__PROFILE_FILTER];
+} __profile_t;
+
+__profile_t __profile;
+
+/**
+ * Hash a pointer.
+ *
+ * @param ptr the pointer
+ * @param bits number of bits of the hash
+ * @return the hash
+*/
+unsigned __profile_hash(void *ptr, unsigned bits) {
+    return (unsigned)(((unsigned long long)(unsigned long)ptr * 0x9E3779B97F4A7C15ULL) >> (64 - bits));
+}
+
+/**
+ * Estimate the number of bytes a sample stands for.
+ *
+ * A block of `size` bytes is sampled with the chance
+ * 1 - e^(-size / interval), so its sample stands for
+ * its size divided by that chance.
+ *
+ * @param size size of the sampled block
+ * @param interval the sampling interval
+ * @return the estimate
+*/
+unsigned long long __profile_weight(_size_t size, long long interval) {
+    double x = (double)size / (double)interval;
+
+    if (size == 0) return 0;
+    if (x > 32) return size;
+
+    // e^-x = 2^-k * e^-r, with r below ln 2
+    int k = (int)(x / 0.6931471805599453);
+    double r = x - k * 0.6931471805599453;
+    double e = 1 - r * (1 - r / 2 * (1 - r / 3 * (1 - r / 4 * (1 - r / 5 * (1 - r / 6)))));
+
+    e /= (double)(1ULL << k);
+    return (unsigned long long)((double)size / (1 - e));
+}
+
+/**
+ * Record a sample.
+ *
+ * @param ptr the sampled block
+ * @param size its size
+ * @param site return address of the allocation call
+*/
+void __profile_sample(void *ptr, _size_t size, void *site) {
+    unsigned long long bytes = __profile_weight(size, __profile.interval);
+    unsigned mask = __PROFILE_SITES - 1;
+    unsigned i = __profile_hash(site, 10);
+    unsigned probes = 0;
+
+    __spin_acquire(&__profile.lock);
+
+    while (__profile.sites[i].site != site && __profile.sites[i].site != NULL && probes++ < mask) i = (i + 1) & mask;
+
+    if (__profile.sites[i].site != site && __profile.sites[i].site != NULL) {
+        __profile.dropped++;
+        __spin_release(&__profile.lock);
+        return;
+    }
+
+    __profile.sites[i].site = site;
+    __profile.sites[i].samples++;
+    __profile.sites[i].bytes += bytes;
+
+    unsigned char *filter = &__profile.filter[__profile_hash(ptr, 16)];
+
+    if (__profile.live >= __PROFILE_LIVE / 2 || *filter == 255) __profile.dropped++;
+    else {
+        unsigned j = __profile_hash(ptr, 12);
+
+        while (__profile.blocks[j].ptr != NULL) j = (j + 1) & (__PROFILE_LIVE - 1);
+
+        __profile.blocks[j].ptr = ptr;
+        __profile.blocks[j].bytes = bytes;
+        __profile.blocks[j].site = i;
+        __profile.live++;
+        __atomic_store_n(filter, *filter + 1, __ATOMIC_RELAXED);
+    }
+
+    __spin_release(&__profile.lock);
+}
+
+/**
+ * Seed the sampling of the calling thread.
+ *
+ * The seed comes from the kernel (getrandom), mixed
+ * with the address of the cache of the thread, so
+ * threads sample at different points even without
+ * getrandom.
+ *
+ * @return the seed, never 0
+*/
+unsigned long long __profile_seed(void) {
+    unsigned long long seed = 0;
+
+    sys_getrandom(&seed, sizeof(seed), _GRND_NONBLOCK);
+    seed ^= (unsigned long long)(unsigned long)&__tcache * 0x9E3779B97F4A7C15ULL;
+
+    return seed | 1;
+}
+
+/**
+ * Draw the number of bytes to the next sample.
+ *
+ * The distance comes from an exponential distribution
+ * with the mean `interval`, so every allocated byte has
+ * the same chance to be sampled, small blocks next to
+ * big ones too, and allocations repeating with a period
+ * are not sampled in step.
+ *
+ * @param interval mean distance between samples
+ * @return the distance
+*/
+long long __profile_distance(long long interval) {
+    __tcache.seed = __tcache.seed * 6364136223846793005ULL + 1442695040888963407ULL;
+
+    // -ln(u) for u = r / 2^32, in 16.16 fixed point, log2 of the
+    // mantissa is approximated by t + 0.3466 * t * (1 - t)
+    unsigned long long r = (__tcache.seed >> 32) + 1;
+    unsigned e = 63 - __builtin_clzll(r);
+    unsigned long long t = ((r << (63 - e)) >> 47) & 0xFFFF;
+    unsigned long long log2r = ((unsigned long long)e << 16) + t + ((t * (65536 - t) * 22714) >> 32);
+    unsigned long long ln = (((32ULL << 16) - log2r) * 45426) >> 16;
+
+    return (long long)(((unsigned long long)interval * ln) >> 16);
+}
+
+/**
+ * Count an allocation for the heap profiler.
+ *
+ * A block is sampled when the bytes allocated by the
+ * thread pass the distance drawn by __profile_distance.
+ *
+ * @param ptr the block
+ * @param size its size
+ * @param site return address of the allocation call
+*/
+void __profile_alloc(void *ptr, _size_t size, void *site) {
+    long long interval = __profile.interval;
+
+    if (interval <= 0 || ptr == NULL) return;
+
+    // the first distance is drawn too, the first block of
+    // a thread is not sampled more often than the others
+    if (__tcache.seed == 0) {
+        __tcache.seed = __profile_seed();
+        __tcache.sample_left = __profile_distance(interval);
+    }
+
+    __tcache.sample_left -= (long long)size;
+    if (__tcache.sample_left >= 0) return;
+
+    __tcache.sample_left = __profile_distance(interval);
+
+    __profile_sample(ptr, size, site);
+}
+
+/**
+ * Forget a sampled block which is freed.
+ *
+ * The slot is emptied by moving the following blocks
+ * of its probe sequence back, so no tombstones are left.
+ *
+ * @param ptr the block
+*/
+void __profile_free(void *ptr) {
+    unsigned char *filter = &__profile.filter[__profile_hash(ptr, 16)];
+
+    if (__atomic_load_n(filter, __ATOMIC_RELAXED) == 0) return;
+
+    __spin_acquire(&__profile.lock);
+
+    unsigned mask = __PROFILE_LIVE - 1;
+    unsigned i = __profile_hash(ptr, 12);
+
+    while (__profile.blocks[i].ptr != NULL && __profile.blocks[i].ptr != ptr) i = (i + 1) & mask;
+
+    if (__profile.blocks[i].ptr == ptr) {
+        __atomic_store_n(filter, *filter - 1, __ATOMIC_RELAXED);
+        __profile.live--;
+
+        for (unsigned j = (i + 1) & mask; __profile.blocks[j].ptr != NULL; j = (j + 1) & mask) {
+            unsigned home = __profile_hash(__profile.blocks[j].ptr, 12);
+
+            // the block can not move before its home slot
+            if (((j - home) & mask) < ((j - i) & mask)) continue;
+
+            __profile.blocks[i] = __profile.blocks[j];
+            i = j;
+        }
+
+        __profile.blocks[i].ptr = NULL;
+    }
+
+    __spin_release(&__profile.lock);
+}
+
+    #define __PROFILE_ALLOC(ptr, size) __profile_alloc(ptr, size, __builtin_return_address(0))
+    #define __PROFILE_FREE(ptr)        __profile_free(ptr)
+#else
+    #define __PROFILE_ALLOC(ptr, size) ((void)0)
+    #define __PROFILE_FREE(ptr)        ((void)0)
+#endif
+
+/**
+ * Get the usable size of a block.
+ *
+ * @param ptr the block
+ * @return number of bytes which can be used
+*/
+_size_t __block_size(void *ptr) {
+    __segment *seg = __SEGMENT_OF(ptr);
+
+    if (seg->kind == __SEG_LARGE) return seg->size - __PAGE_SIZE;
+
+    __run *run = &seg->runs[((char *)ptr - (char *)seg) / __PAGE_SIZE];
+    run -= run->offset;
+
+    if (run->kind == __RUN_SMALL) return __class_size(run->cls);
+    return (_size_t)run->pages * __PAGE_SIZE;
+}
+
+/**
+ * Allocate a memory block, without profiling it.
+ *
+ * @param size size of the block
+ * @return the block, or NULL on failure
+*/
+void* __malloc(_size_t size) {
+    if (size <= __SMALL_MAX) return __tcache_alloc(__size_class(size));
+
+    if (size <= __MEDIUM_MAX) {
+        __heap_acquire();
+        __run *run = __pages_alloc((size + __PAGE_SIZE - 1) / __PAGE_SIZE, __RUN_MEDIUM);
+        __heap_release();
+
+        if (run == NULL) return NULL;
+
+        __STAT_ADD(medium_allocs, 1);
+        __STAT_ADD(medium_bytes, (_size_t)run->pages * __PAGE_SIZE);
+
+        return __run_addr(__SEGMENT_OF(run), run);
+    }
+
+    return __large_alloc(size);
+}
+
+/**
+ * Allocate a memory block.
+ *
+ * Example usage:
+ *  int *numbers = _malloc(100 * sizeof(int));
+ *  ...
+ *  _free(numbers);
+ *
+ * @param size size of the block
+ * @return the block (aligned to 16 bytes), or NULL on failure
+*/
+__MALLOC_API void* _malloc(_size_t size) {
+    void *ptr = __malloc(size);
+
+    __PROFILE_ALLOC(ptr, size);
+    return ptr;
+}
+
+/**
+ * Allocate a memory block with the given alignment.
+ *
+ * Small objects start at multiples of their class size
+ * from the start of a page, so the smallest class which
+ * is a multiple of the alignment is used. Bigger blocks
+ * always start at a page boundary.
+ *
+ * @param align alignment, a power of two up to the page size
+ * @param size size of the block
+ * @return the block, or NULL on failure (also if the
+ *         alignment is not supported)
+*/
+__MALLOC_API void* _aligned_alloc(_size_t align, _size_t size) {
+    void *ptr;
+
+    if (align <= 16) ptr = __malloc(size);
+    else if (align > __PAGE_SIZE || (align & (align - 1)) != 0) return NULL;
+    else if (size <= __SMALL_MAX) {
+        unsigned cls = __size_class(size);
+
+        // the last class is a multiple of any supported alignment
+        while (__class_size(cls) % align != 0) cls++;
+        ptr = __tcache_alloc(cls);
+    }
+    // page runs and large blocks are page aligned
+    else ptr = __malloc(size);
+
+    __PROFILE_ALLOC(ptr, size);
+    return ptr;
+}
+
+/**
+ * Free a memory block.
+ *
+ * The block has to be returned by _malloc, _calloc or
+ * _realloc. Freeing NULL does nothing.
+ *
+ * @param ptr pointer to the memory block
+*/
+__MALLOC_API void _free(void *ptr) {
+    if (ptr == NULL) return;
+
+    __PROFILE_FREE(ptr);
+
+    __segment *seg = __SEGMENT_OF(ptr);
+
+    if (seg->kind == __SEG_LARGE) {
+        __STAT_ADD(large_frees, 1);
+        __STAT_SUB(large_bytes, seg->size - __PAGE_SIZE);
+        __STAT_SUB(mapped, seg->size);
+
+        sys_munmap(seg, seg->size);
+        return;
+    }
+
+    __run *run = &seg->runs[((char *)ptr - (char *)seg) / __PAGE_SIZE];
+
+    if (run->kind == __RUN_SMALL) {
+        unsigned cls = run->cls;
+
+        *(void **)ptr = __tcache.bins[cls];
+        __tcache.bins[cls] = ptr;
+        __STAT_FREE(cls);
+
+        if (++__tcache.counts[cls] > 2 * __batch_size(cls)) __tcache_flush(cls);
+        return;
+    }
+
+    __STAT_ADD(medium_frees, 1);
+    __STAT_SUB(medium_bytes, (_size_t)run->pages * __PAGE_SIZE);
+
+    __heap_acquire();
+    __pages_free(run);
+    __heap_release();
+}
+
+/**
+ * Allocate a zeroed memory block for an array.
+ *
+ * @param nmemb number of members
+ * @param size size of a member
+ * @return the block, or NULL on failure (also if the
+ *         size of the array does not fit in _size_t)
+*/
+__MALLOC_API void* _calloc(_size_t nmemb, _size_t size) {
+    _size_t total;
+
+    if (__builtin_mul_overflow(nmemb, size, &total)) return NULL;
+
+    char *ptr = (char *)__malloc(total);
+    if (ptr == NULL) return NULL;
+
+    __PROFILE_ALLOC(ptr, total);
+
+    // large blocks come straight from the kernel, already zeroed
+    if (total > __MEDIUM_MAX) return ptr;
+
+    for (_size_t i = 0; i < total; i++) ptr[i] = 0;
+
+    return ptr;
+}
+
+/**
+ * Change the size of a memory block.
+ *
+ * The block stays in place if it is already big enough.
+ * Large blocks are moved by remapping their pages, so
+ * they are never copied.
+ *
+ * @param ptr the block (NULL allocates a new one)
+ * @param size new size of the block (0 frees the block)
+ * @return the block, or NULL on failure (the old block
+ *         is left untouched)
+*/
+__MALLOC_API void* _realloc(void *ptr, _size_t size) {
+    if (ptr == NULL) {
+        ptr = __malloc(size);
+
+        __PROFILE_ALLOC(ptr, size);
+        return ptr;
+    }
+
+    if (size == 0) {
+        _free(ptr);
+        return NULL;
+    }
+
+    _size_t old = __block_size(ptr);
+    __segment *seg = __SEGMENT_OF(ptr);
+
+    // shrink in place, unless a much smaller block
+    // would release memory
+    if (size <= old && (size > old / 2 || old <= 16)) return ptr;
+
+    _size_t span = __large_span(size);
+
+    if (seg->kind == __SEG_LARGE && size > __MEDIUM_MAX && span != 0) {
+        // try to grow or shrink the mapping where it is
+        if (sys_mremap(seg, seg->size, span, 0, NULL) >= 0) {
+            __STAT_ADD(large_bytes, span - seg->size);
+            __STAT_ADD(mapped, span - seg->size);
+
+            seg->size = span;
+            return ptr;
+        }
+
+        // move the pages to a new aligned area
+        void *area = __seg_map(span);
+
+        if (area != NULL) {
+            if (sys_mremap(seg, seg->size, span, _MREMAP_MAYMOVE | _MREMAP_FIXED, area) >= 0) {
+                // the old mapping is gone, its header moved too
+                seg = (__segment *)area;
+
+                __STAT_ADD(large_bytes, span - seg->size);
+                __STAT_ADD(mapped, span - seg->size);
+
+                seg->size = span;
+
+                __PROFILE_FREE(ptr);
+                __PROFILE_ALLOC((char *)area + __PAGE_SIZE, size);
+                return (char *)area + __PAGE_SIZE;
+            }
+            sys_munmap(area, span);
+        }
+    }
+
+    char *block = (char *)__malloc(size);
+    if (block == NULL) return NULL;
+
+    __PROFILE_ALLOC(block, size);
+
+    _size_t n = size < old ? size : old;
+    for (_size_t i = 0; i < n; i++) block[i] = ((char *)ptr)[i];
+
+    _free(ptr);
+    return block;
+}
+
+/**
+ * Set an option of the allocator.
+ *
+ * Options apply to the memory mapped after the call.
+ *
+ * Example usage:
+ *  _mallopt(_M_HUGEPAGE, 1);
+ *  _mallopt(_M_PREFAULT, 1);
+ *  char *table = _malloc(1UL << 30);
+ *
+ * @param param the option (_M_*)
+ * @param value new value of the option
+ * @return 1 on success, 0 if the option or the value is not known
+*/
+int _mallopt(int param, int value) {
+    switch (param) {
+        case _M_HUGEPAGE:
+            __options.hugepage = value != 0;
+            return 1;
+        case _M_PREFAULT:
+            __options.prefault = value != 0;
+            return 1;
+        case _M_PURGE:
+            if (value != 0 && value != _MADV_FREE && value != _MADV_DONTNEED) return 0;
+
+            __heap_acquire();
+            __options.purge = value;
+            __heap_release();
+            return 1;
+#ifdef RAWC_MALLOC_STATS
+        case _M_SAMPLE:
+            if (value < 0) return 0;
+
+            __profile.interval = value;
+            return 1;
+#endif
+    }
+
+    return 0;
+}
+
+/**
+ * Give the free pages back to the kernel.
+ *
+ * The objects cached by the calling thread are given
+ * back first, then the pages of all dirty free runs
+ * are purged, without waiting for DIRTY_MAX of them.
+ *
+ * @return number of bytes purged
+*/
+_size_t _malloc_trim(void) {
+    _malloc_flush();
+
+    __heap_acquire();
+    _size_t purged = __heap_purge(0);
+    __heap_release();
+
+    return purged;
+}
+
+/**
+ * Write the counters of the allocator.
+ *
+ * The counters of the calling thread are published
+ * first, other threads publish theirs every 256 small
+ * allocations and frees, and when they call _malloc_flush.
+ *
+ * Example usage:
+ *  _malloc_stats(2);
+ *
+ * @param fd file descriptor to write to
+*/
+void _malloc_stats(int fd) {
+#ifdef RAWC_MALLOC_STATS
+    unsigned long long allocs = 0, small = 0;
+
+    __stats_publish();
+
+    _dprintf(fd, "class\tsize\tallocs\tfrees\tin use\n");
+
+    for (unsigned cls = 0; cls < __CLASSES; cls++) {
+        unsigned long long a = __atomic_load_n(&__stats.allocs[cls], __ATOMIC_RELAXED);
+        unsigned long long f = __atomic_load_n(&__stats.frees[cls], __ATOMIC_RELAXED);
+        unsigned long long live = a > f ? (a - f) * __class_size(cls) : 0;
+
+        allocs += a;
+        small += live;
+
+        if (a != 0) _dprintf(fd, "%u\t%llu\t%llu\t%llu\t%llu\n", cls, (unsigned long long)__class_size(cls), a, f, live);
+    }
+
+    unsigned long long misses = __atomic_load_n(&__stats.misses, __ATOMIC_RELAXED);
+    unsigned long long medium = __atomic_load_n(&__stats.medium_bytes, __ATOMIC_RELAXED);
+    unsigned long long large = __atomic_load_n(&__stats.large_bytes, __ATOMIC_RELAXED);
+    unsigned long long mapped = __atomic_load_n(&__stats.mapped, __ATOMIC_RELAXED);
+    unsigned long long used = small + medium + large;
+
+    _dprintf(fd, "medium: %llu allocs, %llu frees, %llu bytes in use\n",
+             __atomic_load_n(&__stats.medium_allocs, __ATOMIC_RELAXED),
+             __atomic_load_n(&__stats.medium_frees, __ATOMIC_RELAXED), medium);
+    _dprintf(fd, "large: %llu allocs, %llu frees, %llu bytes in use\n",
+             __atomic_load_n(&__stats.large_allocs, __ATOMIC_RELAXED),
+             __atomic_load_n(&__stats.large_frees, __ATOMIC_RELAXED), large);
+    _dprintf(fd, "in use: %llu bytes, mapped: %llu bytes\n", used, mapped);
+
+    // memory mapped but not handed out: free pages, free objects
+    // in runs and thread caches, and the rounding of sizes
+    if (mapped != 0 && used <= mapped) _dprintf(fd, "fragmentation: %llu%%\n", (mapped - used) * 100 / mapped);
+
+    if (allocs != 0) _dprintf(fd, "thread cache: %llu hits, %llu misses, %llu%% hit rate\n", allocs - misses, misses, (allocs - misses) * 100 / allocs);
+#else
+    _dprintf(fd, "malloc stats are off, define RAWC_MALLOC_STATS\n");
+#endif
+}
+
+/**
+ * Write the heap profile.
+ *
+ * Every call site which allocated a sampled block is
+ * written with the number of samples and an estimate
+ * of the bytes it allocated (see _M_SAMPLE).
+ *
+ * @param fd file descriptor to write to
+*/
+void _malloc_profile(int fd) {
+#ifdef RAWC_MALLOC_STATS
+    __spin_acquire(&__profile.lock);
+
+    _dprintf(fd, "heap profile, one sample every %lld bytes\n", __profile.interval);
+
+    for (unsigned i = 0; i < __PROFILE_SITES; i++) {
+        __profile_site *site = &__profile.sites[i];
+
+        if (site->site != NULL) _dprintf(fd, "%p\t%llu samples\t%llu bytes\n", site->site, site->samples, site->bytes);
+    }
+
+    if (__profile.dropped != 0) _dprintf(fd, "%llu samples dropped\n", __profile.dropped);
+
+    __spin_release(&__profile.lock);
+#else
+    _dprintf(fd, "malloc stats are off, define RAWC_MALLOC_STATS\n");
+#endif
+}
+
+/**
+ * Write the sampled blocks which are still in use.
+ *
+ * The blocks are summed up by call site, with an
+ * estimate of the bytes still in use. Called at the
+ * end of a program, it points to the call sites of
+ * the leaked memory.
+ *
+ * @param fd file descriptor to write to
+*/
+void _malloc_leaks(int fd) {
+#ifdef RAWC_MALLOC_STATS
+    unsigned blocks[__PROFILE_SITES] = { 0 };
+    unsigned long long bytes[__PROFILE_SITES] = { 0 };
+    unsigned long long total = 0;
+
+    __spin_acquire(&__profile.lock);
+
+    for (unsigned i = 0; i < __PROFILE_LIVE; i++) {
+        __profile_block *block = &__profile.blocks[i];
+
+        if (block->ptr == NULL) continue;
+
+        blocks[block->site]++;
+        bytes[block->site] += block->bytes;
+        total += block->bytes;
+    }
+
+    _dprintf(fd, "%u sampled blocks in use, about %llu bytes\n", __profile.live, total);
+
+    for (unsigned i = 0; i < __PROFILE_SITES; i++) {
+        if (blocks[i] != 0) _dprintf(fd, "%p\t%u blocks\t%llu bytes\n", __profile.sites[i].site, blocks[i], bytes[i]);
+    }
+
+    __spin_release(&__profile.lock);
+#else
+    _dprintf(fd, "malloc stats are off, define RAWC_MALLOC_STATS\n");
+#endif
+}
+
+#include <_sort.h>
+#include <_search.h>
+#include <_random.h>
+
+#endif // __STDLIB_H__
@@ -6,6 +6,9 @@
  * Date: 20.05.2024
 */
 
+#ifndef __STRING_H__
+#define __STRING_H__
+
 /**
  * _size_t - type representing the size of
  *           the memory block or the length of string.
@@ -105,7 +108,7 @@ int _strcmp(const char* str1, const char* str2) {
  *         NULL if the character is not found.
 */
 char* _strchr(const char* str, int ch) {
-    size_t i = 0; // Use size_t for indexing
+    _size_t i = 0; // Use _size_t for indexing
 
     while (str[i] != '\0') {
         if (str[i] == (char)ch) {
@@ -127,8 +130,8 @@ char* _strchr(const char* str, int ch) {
  *         NULL if the character is not found.
 */
 char * _strrchr(const char* str, int ch) {
-    size_t i = 0;
-    size_t last = -1; // Initialize last to -1
+    _size_t i = 0;
+    _size_t last = -1; // Initialize last to -1
 
     while (str[i] != '\0') {
         if (str[i] == (char)ch) {
@@ -145,39 +148,6 @@ char * _strrchr(const char* str, int ch) {
     return (char*)&str[last];
 }
 
-/**
- * Find the first occurrence of a substring in the string.
- * 
- * @param str - the string to be searched.
- * @param substr - the substring to be found.
- * @return a pointer to the first occurrence of the 
- *         substring in the string.
- *         NULL if the substring is not found.
-*/
-char* _strstr(const char* str, const char* substr) {
-    size_t i = 0;
-    size_t j = 0;
-    size_t k = 0;
-
-    while (str[i]
- != '\0') {
-        if (str[i] == substr[j]) {
-            k = i;
-            while (str[k] == substr[j] && substr[j] != '\0') {
-                k++;
-                j++;
-            }
-            if (substr[j] == '\0') {
-                return (char*)&str[i];
-            }
-            j = 0;
-        }
-        i++;
-    }
-
-    return (char*)_NULL;
-}
-
 /**
  * Find the index of the first occurrence of a character in the string.
  * 
@@ -479,4 +449,6 @@ char* _strtok(char* str, const char* delim) {
     }
 
     return next;
-}
\ No newline at end of file
+}
+
+#endif // __STRING_H__
@@ -0,0 +1,39 @@
+/**
+ * _syscalls.h - Architecture dispatch for the raw syscalls.
+ *
+ * Every RawC library which has to talk to the kernel
+ * includes this file instead of picking the syscalls
+ * header on its own.
+ *
+ * Author: ruxixa
+ *
+ * Date: 17.05.2024
+*/
+
+#ifndef __SYSCALLS_H__
+#define __SYSCALLS_H__
+
+/**
+ * Determine the architecture and include the
+ * proper syscalls header file.
+ *
+ * Available architectures:
+ * - x86_64
+ * - i386
+ * - arm
+ * ! more architectures will be added in the future
+ *
+ * If the architecture is not supported, the error
+ * "Architecture not supported" will be thrown.
+*/
+#ifdef __x86_64__
+    #include <x86_64/syscalls.h>
+#elif defined(__i386__) || defined(__i686__)
+    #include <x86/syscalls.h>
+#elif defined(__arm__)
+    #include <arm/syscalls.h>
+#else
+    #error "Architecture not supported"
+#endif
+
+#endif // __SYSCALLS_H__
@@ -0,0 +1,429 @@
+/**
+ * _thread.h - Threads without libpthread.
+ *
+ * A thread is started with the clone syscall, in one
+ * mapping holding everything it needs:
+ *
+ *  | guard page | stack ...... | TLS block | _thread_t |
+ *
+ * - the guard page is never mapped, a stack overflow
+ *   stops the program instead of corrupting the memory
+ *   below the stack
+ * - the TLS block holds the __thread variables of the
+ *   program, copied from the PT_TLS segment (tbss is
+ *   left zeroed)
+ * - _thread_t is the thread control block, the thread
+ *   pointer (FS on x86_64, GS on i386) points to it
+ *
+ * The kernel clears the thread ID in _thread_t when the
+ * thread exits and wakes up the futex on it
+ * (CLONE_CHILD_CLEARTID), so _thread_join sleeps until
+ * the thread is gone and can unmap its stack.
+ *
+ * The TLS of the program is set up, not the one of the
+ * C library: threads made here run RawC code and must
+ * not call into libc. The objects cached by the malloc
+ * of a thread (_stdlib.h), its pooled coroutine stacks
+ * (_coro.h) and its log ring (_log.h) are given back
+ * when it exits.
+ *
+ * Supported architectures: x86_64 and i386.
+ *
+ * Example usage:
+ *  void *work(void *arg) { ... return result; }
+ *
+ *  _thread_t *thread = _thread_create(work, &job, 0);
+ *  ...
+ *  void *result = _thread_join(thread);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __THREAD_H__
+#define __THREAD_H__
+
+#include <_stdlib.h>
+#include <_vdso.h>
+
+#if !defined(__x86_64__) && !defined(__i386__)
+    #error "Threads are not supported on this architecture"
+#endif
+
+/**
+ * THREAD_STACK - Default stack size of a thread.
+ *
+ * The pages are mapped when they are first touched,
+ * so a thread uses only as much as it needs.
+*/
+#define THREAD_STACK (2 * 1024 * 1024)
+
+/**
+ * __THREAD_TCB - Words at the start of the thread control
+ *                block, copied from the creating thread.
+ *
+ * The x86 TLS ABI keeps a pointer to the block itself in
+ * the first word, and the stack protector reads its canary
+ * from the sixth (%fs:0x28 on x86_64, %gs:0x14 on i386).
+*/
+#define __THREAD_TCB   8
+#define __THREAD_MAGIC 0x52617754U
+
+/**
+ * Flags of the clone syscall starting a thread.
+*/
+#define __THREAD_CLONE (_CLONE_VM | _CLONE_FS | _CLONE_FILES | _CLONE_SIGHAND | _CLONE_THREAD \
+                        | _CLONE_SYSVSEM | _CLONE_SETTLS | _CLONE_PARENT_SETTID | _CLONE_CHILD_CLEARTID)
+
+/**
+ * _thread_t - a thread, and its thread control block.
+ *
+ * @param tcb the start of the thread control block,
+ *            tcb[0] and tcb[2] point to the thread
+ * @param magic __THREAD_MAGIC, tells threads made by
+ *              _thread_create from the others
+ * @param tid thread ID, cleared by the kernel when the
+ *            thread exits
+ * @param fn function run by the thread
+ * @param arg argument of the function
+ * @param result value returned by the function
+ * @param map the mapping of the thread
+ * @param map_size size of the mapping
+*/
+typedef struct {
+    void *tcb[__THREAD_TCB];
+    unsigned int magic;
+    int tid;
+    void *(*fn)(void *);
+    void *arg;
+    void *result;
+    void *map;
+    _size_t map_size;
+} _thread_t;
+
+/**
+ * __thread_tls - the PT_TLS segment of the program.
+ *
+ * @param image initial values of the __thread variables
+ * @param filesz size of the initial values (tdata)
+ * @param size size of the TLS block, with the zeroed part
+ *             (tbss), as laid out below the thread pointer
+ * @param align alignment of the block
+*/
+struct {
+    const void *image;
+    _size_t filesz;
+    _size_t size;
+    _size_t align;
+} __thread_tls;
+
+_once_t __thread_tls_once = ONCE_INIT;
+
+#ifdef __i386__
+/* GDT entry of the thread pointer segment. */
+int __thread_gdt_entry = -1;
+#endif
+
+/**
+ * Library functions:
+ *  @fn _thread_create Start a thread.
+ *  @fn _thread_join Wait for a thread to finish.
+ *  @fn _thread_exit End the calling thread.
+ *  @fn _thread_self Get the calling thread.
+*/
+
+/**
+ * Find the PT_TLS segment of the program.
+ *
+ * The program headers come from the auxiliary vector,
+ * the PT_PHDR entry gives the load address of a
+ * position-independent program.
+*/
+void __thread_tls_init(void) {
+    const _Elf_Phdr *phdr = (const _Elf_Phdr *)_getauxval(_AT_PHDR);
+    unsigned long phnum = _getauxval(_AT_PHNUM);
+    unsigned long bias = 0;
+
+    __thread_tls.align = 1;
+    if (phdr == NULL) return;
+
+    for (unsigned long i = 0; i < phnum; i++) {
+        if (phdr[i].p_type == _PT_PHDR) bias = (unsigned long)phdr - phdr[i].p_vaddr;
+    }
+
+    for (unsigned long i = 0; i < phnum; i++) {
+        if (phdr[i].p_type != _PT_TLS) continue;
+
+        _size_t align = phdr[i].p_align ? phdr[i].p_align : 1;
+
+        // the block ends at the thread pointer, its first byte keeps
+        // the offset of p_vaddr inside the alignment (as ld.so does)
+        _size_t first = (0 - phdr[i].p_vaddr) & (align - 1);
+
+        __thread_tls.image = (const void *)(bias + phdr[i].p_vaddr);
+        __thread_tls.filesz = phdr[i].p_filesz;
+        __thread_tls.size = ((phdr[i].p_memsz - first + align - 1) & ~(align - 1)) + first;
+        __thread_tls.align = align;
+    }
+}
+
+/**
+ * Get the thread pointer of the calling thread.
+ *
+ * @return the thread pointer, or NULL if it is not set
+*/
+void *__thread_pointer(void) {
+#ifdef __x86_64__
+    unsigned long long base = 0;
+
+    sys_arch_prctl(_ARCH_GET_FS, (unsigned long long)&base);
+    return (void *)base;
+#else
+    unsigned int gs;
+    void *base;
+
+    asm volatile ("mov %%gs, %0" : "=r" (gs));
+    if (gs == 0) return NULL;
+
+    asm volatile ("mov %%gs:0, %0" : "=r" (base));
+    return base;
+#endif
+}
+
+/**
+ * Get the calling thread.
+ *
+ * @return the thread, or NULL if it was not made
+ *         by _thread_create (e.g. the main thread)
+*/
+_thread_t *_thread_self(void) {
+    _thread_t *thread = (_thread_t *)__thread_pointer();
+
+    if (thread == NULL || thread->magic != __THREAD_MAGIC) return NULL;
+    return thread;
+}
+
+/**
+ * End the calling thread.
+ *
+ * What the other libraries keep for the thread
+ * (__thread_release) and the objects cached by its
+ * malloc are given back first.
+ *
+ * @param result value returned by _thread_join
+*/
+void _thread_exit(void *result) {
+    _thread_t *thread = _thread_self();
+
+    for (int i = 0; i < __THREAD_RELEASE; i++) {
+        void (*release)(void) = __atomic_load_n(&__thread_release[i], __ATOMIC_ACQUIRE);
+
+        if (release != NULL) release();
+    }
+    _malloc_flush();
+
+    if (thread != NULL) thread->result = result;
+
+    // exits the thread only, not the whole process (exit_group)
+    for (;;) sys_exit(0);
+}
+
+/**
+ * Run the function of a thread and end the thread.
+ *
+ * The first code the thread runs, on its own stack.
+ *
+ * @param thread the thread
+*/
+void __thread_start(_thread_t *thread) {
+    _thread_exit(thread->fn(thread->arg));
+}
+
+/**
+ * Clone the calling thread into a new one starting in
+ * __thread_start.
+ *
+ * The child wakes up on the new stack with the registers
+ * of the parent, so the function it runs and its argument
+ * are put on the stack, and the child pops them and calls
+ * the function without returning into this frame.
+ *
+ * @param thread the thread, with its thread pointer
+ * @param stack top of the stack, 16-byte aligned
+ * @return thread ID, or an error code
+*/
+long long __thread_clone(_thread_t *thread, void **stack) {
+#ifdef __x86_64__
+    long long ret;
+
+    *--stack = (void *)__thread_start;
+    *--stack = thread;
+
+    register long long r10 asm("r10") = (long long)&thread->tid;
+    register long long r8 asm("r8") = (long long)thread;
+
+    asm volatile
+    (
+        "syscall\n\t"
+        "test %%rax, %%rax\n\t"
+        "jnz 1f\n\t"
+        // the child, the stack is 16-byte aligned again after the pops
+        "xor %%ebp, %%ebp\n\t"
+        "pop %%rdi\n\t"
+        "pop %%rax\n\t"
+        "call *%%rax\n\t"
+        "hlt\n\t"
+        "1:"
+        : "=a" (ret)
+        //                 EDI                         RSI          RDX                  R10        R8
+        : "0"(__SYS_CLONE__), "D"((long long)__THREAD_CLONE), "S"(stack), "d"(&thread->tid), "r"(r10), "r"(r8)
+        : "rcx", "r11", "memory"
+    );
+#else
+    long ret;
+    _user_desc_t desc;
+
+    desc.entry_number = __thread_gdt_entry;
+    desc.base_addr = (unsigned int)thread;
+    desc.limit = 0xFFFFF;
+    desc.flags = _USER_DESC_TLS;
+
+    // the argument sits 16-byte aligned on top of the stack when the function is called
+    *--stack = NULL;
+    *--stack = NULL;
+    *--stack = NULL;
+    *--stack = thread;
+    *--stack = (void *)__thread_start;
+    *--stack = (void *)(unsigned long)(__thread_gdt_entry * 8 + 3);
+
+    asm volatile
+    (
+        "int $0x80\n\t"
+        "test %%eax, %%eax\n\t"
+        "jnz 1f\n\t"
+        // the child loads the segment of its thread pointer
+        "xor %%ebp, %%ebp\n\t"
+        "pop %%eax\n\t"
+        "mov %%ax, %%gs\n\t"
+        "pop %%eax\n\t"
+        "call *%%eax\n\t"
+        "hlt\n\t"
+        "1:"
+        : "=a" (ret)
+        //                 EBX                     ECX          EDX                  ESI         EDI
+        : "0"(__SYS_CLONE__), "b"(__THREAD_CLONE), "c"(stack), "d"(&thread->tid), "S"(&desc), "D"(&thread->tid)
+        : "memory"
+    );
+#endif
+
+    return ret;
+}
+
+/**
+ * Start a thread.
+ *
+ * Example usage:
+ *  _thread_t *thread = _thread_create(sum_part, &parts[i], 0);
+ *
+ * @param fn function run by the thread, its return value
+ *           is returned by _thread_join
+ * @param arg argument of the function
+ * @param stack_size size of the stack, 0 for THREAD_STACK
+ * @return the thread, or NULL if it can not be started
+*/
+_thread_t *_thread_create(void *(*fn)(void *), void *arg, _size_t stack_size) {
+    _once(&__thread_tls_once, __thread_tls_init);
+
+    _size_t page = _getauxval(_AT_PAGESZ);
+    if (page == 0) page = 4096;
+
+    if (stack_size == 0) stack_size = THREAD_STACK;
+    stack_size = (stack_size + 15) & ~(_size_t)15;
+
+    // the thread pointer is aligned for the TLS block and a cache line
+    _size_t align = __thread_tls.align > 64 ? __thread_tls.align : 64;
+    _size_t size = page + stack_size + __thread_tls.size + sizeof(_thread_t) + align;
+    size = (size + page - 1) & ~(page - 1);
+
+#ifdef __i386__
+    // a process without a thread pointer gets a GDT entry for it
+    if (__atomic_load_n(&__thread_gdt_entry, __ATOMIC_ACQUIRE) < 0) {
+        unsigned int gs;
+
+        asm volatile ("mov %%gs, %0" : "=r" (gs));
+
+        if (gs != 0) __atomic_store_n(&__thread_gdt_entry, (int)(gs >> 3), __ATOMIC_RELEASE);
+        else {
+            _user_desc_t desc = { (unsigned int)-1, 0, 0xFFFFF, _USER_DESC_TLS };
+
+            if (sys_set_thread_area(&desc) != 0) return NULL;
+            __atomic_store_n(&__thread_gdt_entry, (int)desc.entry_number, __ATOMIC_RELEASE);
+        }
+    }
+#endif
+
+    long long addr = sys_mmap(NULL, size, _PROT_READ | _PROT_WRITE,
+                              _MAP_PRIVATE | _MAP_ANONYMOUS | _MAP_NORESERVE, -1, 0);
+    if (addr < 0) return NULL;
+
+    char *map = (char *)(unsigned long)addr;
+
+    if (sys_mprotect(map, page, _PROT_NONE) != 0) {
+        sys_munmap(map, size);
+        return NULL;
+    }
+
+    _thread_t *thread = (_thread_t *)(((unsigned long)(map + size - sizeof(_thread_t))) & ~(align - 1));
+    char *tls = (char *)thread - __thread_tls.size;
+
+    if (__thread_tls.filesz > 0) _memcpy(tls, __thread_tls.image, __thread_tls.filesz);
+
+    // the stack protector canary and the rest of the header of the creating thread
+    void **current = (void **)__thread_pointer();
+    if (current != NULL) _memcpy(thread->tcb, current, sizeof(thread->tcb));
+
+    thread->tcb[0] = thread;
+    thread->tcb[1] = NULL;
+    thread->tcb[2] = thread;
+    thread->magic = __THREAD_MAGIC;
+    thread->fn = fn;
+    thread->arg = arg;
+    thread->result = NULL;
+    thread->map = map;
+    thread->map_size = size;
+
+    void **stack = (void **)((unsigned long)tls & ~15UL);
+
+    if (__thread_clone(thread, stack) < 0) {
+        sys_munmap(map, size);
+        return NULL;
+    }
+
+    return thread;
+}
+
+/**
+ * Wait for a thread to finish.
+ *
+ * The thread is freed, it can be joined only once.
+ *
+ * @param thread the thread
+ * @return the value returned by the function of the
+ *         thread, or passed to _thread_exit
+*/
+void *_thread_join(_thread_t *thread) {
+    int tid;
+
+    // the kernel wakes the thread ID as a shared futex
+    while ((tid = __atomic_load_n(&thread->tid, __ATOMIC_ACQUIRE)) != 0) {
+        sys_futex((unsigned int *)&thread->tid, _FUTEX_WAIT, tid, NULL, NULL, 0);
+    }
+
+    void *result = thread->result;
+    sys_munmap(thread->map, thread->map_size);
+
+    return result;
+}
+
+#endif // __THREAD_H__
@@ -0,0 +1,538 @@
+/**
+ * _thread_sync.h - Synchronization of threads.
+ *
+ * The primitives are built on atomic instructions and
+ * the futex syscall, without libpthread. A lock which
+ * is free (the usual case) is taken and released with
+ * one atomic instruction each, the kernel is called
+ * only to put a thread to sleep or to wake one up:
+ *
+ * - _mutex_t    - a mutex, spins a little before sleeping
+ * - _cond_t     - a condition variable, used with a mutex
+ * - _once_t     - runs an initialization exactly once
+ * - _rwlock_t   - a lock for many readers or one writer
+ * - _spinlock_t - a lock which never sleeps, for very
+ *                 short critical sections
+ *
+ * All of them are ready when zeroed (static variables
+ * need no initialization), and none of them can be
+ * shared between processes.
+ *
+ * Example usage:
+ *  _mutex_t lock = MUTEX_INIT;
+ *  _mutex_lock(&lock);
+ *  counter++;
+ *  _mutex_unlock(&lock);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __THREAD_SYNC_H__
+#define __THREAD_SYNC_H__
+
+#include <_syscalls.h>
+
+/**
+ * Initial values of the primitives.
+*/
+#define MUTEX_INIT    { 0 }
+#define COND_INIT     { 0 }
+#define ONCE_INIT     { 0 }
+#define RWLOCK_INIT   { 0, 0 }
+#define SPINLOCK_INIT { 0 }
+
+/**
+ * __SYNC_SPIN - Times a lock is tried again before
+ *               the thread goes to sleep.
+ *
+ * __SYNC_BACKOFF - Most pauses between two tries of
+ *                  a spinlock.
+*/
+#define __SYNC_SPIN    100
+#define __SYNC_BACKOFF 1024
+
+/**
+ * __ETIMEDOUT - Error code of a timed wait which
+ *               ran out of time.
+*/
+#define __ETIMEDOUT 110
+
+/**
+ * _mutex_t - a mutex.
+ *
+ * @param state 0 - unlocked, 1 - locked, 2 - locked
+ *              and other threads may be sleeping
+*/
+typedef struct {
+    unsigned int state;
+} _mutex_t;
+
+/**
+ * _cond_t - a condition variable.
+ *
+ * @param seq changes on every signal, sleeping threads
+ *            wait for it to change
+*/
+typedef struct {
+    unsigned int seq;
+} _cond_t;
+
+/**
+ * _once_t - state of a one-time initialization.
+ *
+ * @param state 0 - not run yet, 1 - running, 2 - running
+ *              and other threads are sleeping, 3 - done
+*/
+typedef struct {
+    unsigned int state;
+} _once_t;
+
+/**
+ * _rwlock_t - a readers-writer lock.
+ *
+ * @param lock number of readers holding the lock, or
+ *             __RWLOCK_WRITER, with __RWLOCK_WAITING set
+ *             while threads may be sleeping
+ * @param waiters number of sleeping threads
+*/
+typedef struct {
+    unsigned int lock;
+    unsigned int waiters;
+} _rwlock_t;
+
+#define __RWLOCK_WRITER  0x7FFFFFFFU
+#define __RWLOCK_WAITING 0x80000000U
+
+/**
+ * _spinlock_t - a spinlock.
+ *
+ * @param locked 1 while the lock is held
+*/
+typedef struct {
+    unsigned int locked;
+} _spinlock_t;
+
+/**
+ * Library functions:
+ *  > mutex:
+ *   @fn _mutex_init Initialize a mutex.
+ *   @fn _mutex_lock Lock a mutex.
+ *   @fn _mutex_trylock Lock a mutex if it is free.
+ *   @fn _mutex_unlock Unlock a mutex.
+ *
+ *  > condition variable:
+ *   @fn _cond_init Initialize a condition variable.
+ *   @fn _cond_wait Wait for a condition variable.
+ *   @fn _cond_timedwait Wait for a condition variable, with a timeout.
+ *   @fn _cond_signal Wake up one waiting thread.
+ *   @fn _cond_broadcast Wake up all waiting threads.
+ *
+ *  > once:
+ *   @fn _once Run an initialization exactly once.
+ *
+ *  > readers-writer lock:
+ *   @fn _rwlock_init Initialize a readers-writer lock.
+ *   @fn _rwlock_rdlock Lock for reading.
+ *   @fn _rwlock_wrlock Lock for writing.
+ *   @fn _rwlock_tryrdlock Lock for reading if no writer holds the lock.
+ *   @fn _rwlock_trywrlock Lock for writing if the lock is free.
+ *   @fn _rwlock_unlock Unlock a readers-writer lock.
+ *
+ *  > spinlock:
+ *   @fn _spin_init Initialize a spinlock.
+ *   @fn _spin_lock Lock a spinlock.
+ *   @fn _spin_trylock Lock a spinlock if it is free.
+ *   @fn _spin_unlock Unlock a spinlock.
+*/
+
+/**
+ * Tell the CPU the thread is spinning.
+ *
+ * Frees the core for the other hardware thread and
+ * saves the pipeline flush when the spin ends.
+*/
+void __cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    asm volatile ("pause" ::: "memory");
+#elif defined(__arm__) && defined(__ARM_ARCH) && __ARM_ARCH >= 7
+    asm volatile ("yield" ::: "memory");
+#else
+    asm volatile ("" ::: "memory");
+#endif
+}
+
+/**
+ * Sleep while a futex holds a value.
+ *
+ * @param addr the futex
+ * @param val the value
+ * @param timeout_ns most nanoseconds to sleep, or -1
+ * @return 0 when woken up (or the value changed),
+ *         -ETIMEDOUT when the time ran out
+*/
+int __futex_wait(unsigned int *addr, unsigned int val, long long timeout_ns) {
+    // the layout of the timespec of the kernel
+    struct { long tv_sec; long tv_nsec; } ts;
+
+    if (timeout_ns >= 0) {
+        ts.tv_sec = (long)(timeout_ns / 1000000000);
+        ts.tv_nsec = (long)(timeout_ns % 1000000000);
+    }
+
+    long long ret = sys_futex(addr, _FUTEX_WAIT | _FUTEX_PRIVATE_FLAG, val,
+                              timeout_ns >= 0 ? &ts : (void *)0, (void *)0, 0);
+
+    return ret == -__ETIMEDOUT ? -__ETIMEDOUT : 0;
+}
+
+/**
+ * Wake up threads sleeping on a futex.
+ *
+ * @param addr the futex
+ * @param count most threads to wake up
+*/
+void __futex_wake(unsigned int *addr, int count) {
+    sys_futex(addr, _FUTEX_WAKE | _FUTEX_PRIVATE_FLAG, count, (void *)0, (void *)0, 0);
+}
+
+/**
+ * Initialize a mutex.
+ *
+ * @param mutex the mutex
+*/
+void _mutex_init(_mutex_t *mutex) {
+    mutex->state = 0;
+}
+
+/**
+ * Lock a mutex if it is free.
+ *
+ * @param mutex the mutex
+ * @return 1 if the mutex was locked, 0 if it is held
+*/
+int _mutex_trylock(_mutex_t *mutex) {
+    unsigned int expected = 0;
+
+    return __atomic_compare_exchange_n(&mutex->state, &expected, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Lock a mutex held by another thread.
+ *
+ * The lock is tried for a while, as it is usually
+ * held for a short time, then the thread marks the
+ * mutex as having sleepers and goes to sleep.
+ *
+ * @param mutex the mutex
+*/
+void __mutex_lock_slow(_mutex_t *mutex) {
+    for (int i = 0; i < __SYNC_SPIN; i++) {
+        __cpu_relax();
+
+        if (__atomic_load_n(&mutex->state, __ATOMIC_RELAXED) == 0 && _mutex_trylock(mutex)) return;
+    }
+
+    // taken as 2, the unlocking thread can not know if others sleep
+    while (__atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE) != 0) {
+        __futex_wait(&mutex->state, 2, -1);
+    }
+}
+
+/**
+ * Lock a mutex.
+ *
+ * @param mutex the mutex
+*/
+void _mutex_lock(_mutex_t *mutex) {
+    if (!_mutex_trylock(mutex)) __mutex_lock_slow(mutex);
+}
+
+/**
+ * Unlock a mutex.
+ *
+ * The kernel is called only when other threads
+ * may be sleeping on the mutex.
+ *
+ * @param mutex the mutex, locked by this thread
+*/
+void _mutex_unlock(_mutex_t *mutex) {
+    if (__atomic_exchange_n(&mutex->state, 0, __ATOMIC_RELEASE) == 2) __futex_wake(&mutex->state, 1);
+}
+
+/**
+ * Initialize a condition variable.
+ *
+ * @param cond the condition variable
+*/
+void _cond_init(_cond_t *cond) {
+    cond->seq = 0;
+}
+
+/**
+ * Wait for a condition variable, with a timeout.
+ *
+ * The mutex is unlocked while the thread sleeps and
+ * locked again before the function returns. The thread
+ * can wake up without a signal, so the condition has
+ * to be checked in a loop.
+ *
+ * @param cond the condition variable
+ * @param mutex the mutex, locked by this thread
+ * @param timeout_ns most nanoseconds to wait, or -1
+ * @return 0 when woken up, -ETIMEDOUT when the
+ *         time ran out
+*/
+int _cond_timedwait(_cond_t *cond, _mutex_t *mutex, long long timeout_ns) {
+    unsigned int seq = __atomic_load_n(&cond->seq, __ATOMIC_RELAXED);
+
+    _mutex_unlock(mutex);
+    int ret = __futex_wait(&cond->seq, seq, timeout_ns);
+
+    // other waiters may have been woken with this thread
+    while (__atomic_exchange_n(&mutex->state, 2, __ATOMIC_ACQUIRE) != 0) {
+        __futex_wait(&mutex->state, 2, -1);
+    }
+
+    return ret;
+}
+
+/**
+ * Wait for a condition variable.
+ *
+ * Example usage:
+ *  _mutex_lock(&lock);
+ *  while (queue_empty(&queue)) _cond_wait(&ready, &lock);
+ *  item = queue_pop(&queue);
+ *  _mutex_unlock(&lock);
+ *
+ * @param cond the condition variable
+ * @param mutex the mutex, locked by this thread
+*/
+void _cond_wait(_cond_t *cond, _mutex_t *mutex) {
+    _cond_timedwait(cond, mutex, -1);
+}
+
+/**
+ * Wake up one thread waiting for a condition variable.
+ *
+ * @param cond the condition variable
+*/
+void _cond_signal(_cond_t *cond) {
+    __atomic_fetch_add(&cond->seq, 1, __ATOMIC_RELEASE);
+    __futex_wake(&cond->seq, 1);
+}
+
+/**
+ * Wake up all threads waiting for a condition variable.
+ *
+ * @param cond the condition variable
+*/
+void _cond_broadcast(_cond_t *cond) {
+    __atomic_fetch_add(&cond->seq, 1, __ATOMIC_RELEASE);
+    __futex_wake(&cond->seq, 0x7FFFFFFF);
+}
+
+/**
+ * Run an initialization exactly once.
+ *
+ * The first thread runs the function, threads coming
+ * while it runs sleep until it is done. Once it is
+ * done, the call is a single load.
+ *
+ * Example usage:
+ *  _once_t tables_once = ONCE_INIT;
+ *  _once(&tables_once, make_tables);
+ *
+ * @param once state of the initialization
+ * @param init the initialization
+*/
+void _once(_once_t *once, void (*init)(void)) {
+    if (__atomic_load_n(&once->state, __ATOMIC_ACQUIRE) == 3) return;
+
+    unsigned int state = 0;
+
+    if (__atomic_compare_exchange_n(&once->state, &state, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+        init();
+
+        if (__atomic_exchange_n(&once->state, 3, __ATOMIC_RELEASE) == 2) __futex_wake(&once->state, 0x7FFFFFFF);
+        return;
+    }
+
+    while (state != 3) {
+        if (state == 1) __atomic_compare_exchange_n(&once->state, &state, 2, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        if (state != 3) __futex_wait(&once->state, 2, -1);
+
+        state = __atomic_load_n(&once->state, __ATOMIC_ACQUIRE);
+    }
+}
+
+/**
+ * Initialize a readers-writer lock.
+ *
+ * @param rwlock the lock
+*/
+void _rwlock_init(_rwlock_t *rwlock) {
+    rwlock->lock = 0;
+    rwlock->waiters = 0;
+}
+
+/**
+ * Lock for reading if no writer holds the lock.
+ *
+ * @param rwlock the lock
+ * @return 1 if the lock was taken, 0 if not
+*/
+int _rwlock_tryrdlock(_rwlock_t *rwlock) {
+    unsigned int val = __atomic_load_n(&rwlock->lock, __ATOMIC_RELAXED);
+
+    while ((val & __RWLOCK_WRITER) < __RWLOCK_WRITER - 1) {
+        if (__atomic_compare_exchange_n(&rwlock->lock, &val, val + 1, 1, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * Lock for writing if the lock is free.
+ *
+ * @param rwlock the lock
+ * @return 1 if the lock was taken, 0 if not
+*/
+int _rwlock_trywrlock(_rwlock_t *rwlock) {
+    unsigned int expected = 0;
+
+    return __atomic_compare_exchange_n(&rwlock->lock, &expected, __RWLOCK_WRITER, 0,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+/**
+ * Sleep until the holder of a readers-writer lock
+ * releases it.
+ *
+ * @param rwlock the lock
+*/
+void __rwlock_sleep(_rwlock_t *rwlock) {
+    unsigned int val = __atomic_load_n(&rwlock->lock, __ATOMIC_RELAXED);
+
+    if (val == 0) return;
+
+    __atomic_fetch_add(&rwlock->waiters, 1, __ATOMIC_RELAXED);
+
+    // the unlocking thread wakes up sleepers only with the flag set
+    if (val & __RWLOCK_WAITING || __atomic_compare_exchange_n(&rwlock->lock, &val, val | __RWLOCK_WAITING, 0,
+                                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        __futex_wait(&rwlock->lock, val | __RWLOCK_WAITING, -1);
+
+    __atomic_fetch_sub(&rwlock->waiters, 1, __ATOMIC_RELAXED);
+}
+
+/**
+ * Lock for reading.
+ *
+ * Many threads can hold the lock for reading at once.
+ * Readers do not wait for writers waiting for the lock,
+ * so a steady stream of readers can hold writers off.
+ *
+ * @param rwlock the lock
+*/
+void _rwlock_rdlock(_rwlock_t *rwlock) {
+    for (;;) {
+        for (int i = 0; i < __SYNC_SPIN; i++) {
+            if (_rwlock_tryrdlock(rwlock)) return;
+            __cpu_relax();
+        }
+
+        __rwlock_sleep(rwlock);
+    }
+}
+
+/**
+ * Lock for writing.
+ *
+ * @param rwlock the lock
+*/
+void _rwlock_wrlock(_rwlock_t *rwlock) {
+    for (;;) {
+        for (int i = 0; i < __SYNC_SPIN; i++) {
+            if (_rwlock_trywrlock(rwlock)) return;
+            __cpu_relax();
+        }
+
+        __rwlock_sleep(rwlock);
+    }
+}
+
+/**
+ * Unlock a readers-writer lock.
+ *
+ * The last reader leaving wakes up one sleeping
+ * thread (a writer), a writer leaving wakes up all.
+ *
+ * @param rwlock the lock, held by this thread
+*/
+void _rwlock_unlock(_rwlock_t *rwlock) {
+    unsigned int val = __atomic_load_n(&rwlock->lock, __ATOMIC_RELAXED);
+    unsigned int count, next;
+
+    do {
+        count = val & __RWLOCK_WRITER;
+        next = (count == __RWLOCK_WRITER || count == 1) ? 0 : val - 1;
+    } while (!__atomic_compare_exchange_n(&rwlock->lock, &val, next, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    if (next == 0 && ((val & __RWLOCK_WAITING) || __atomic_load_n(&rwlock->waiters, __ATOMIC_RELAXED)))
+        __futex_wake(&rwlock->lock, count == __RWLOCK_WRITER ? 0x7FFFFFFF : 1);
+}
+
+/**
+ * Initialize a spinlock.
+ *
+ * @param lock the spinlock
+*/
+void _spin_init(_spinlock_t *lock) {
+    lock->locked = 0;
+}
+
+/**
+ * Lock a spinlock if it is free.
+ *
+ * @param lock the spinlock
+ * @return 1 if the lock was taken, 0 if not
+*/
+int _spin_trylock(_spinlock_t *lock) {
+    return __atomic_exchange_n(&lock->locked, 1, __ATOMIC_ACQUIRE) == 0;
+}
+
+/**
+ * Lock a spinlock.
+ *
+ * The lock is only read while it is held, so the cache
+ * line stays shared between the waiting cores, and the
+ * pause between tries doubles up to __SYNC_BACKOFF, so
+ * the waiting cores do not all try at once.
+ *
+ * @param lock the spinlock
+*/
+void _spin_lock(_spinlock_t *lock) {
+    unsigned int backoff = 1;
+
+    while (!_spin_trylock(lock)) {
+        do {
+            for (unsigned int i = 0; i < backoff; i++) __cpu_relax();
+            if (backoff < __SYNC_BACKOFF) backoff <<= 1;
+        } while (__atomic_load_n(&lock->locked, __ATOMIC_RELAXED));
+    }
+}
+
+/**
+ * Unlock a spinlock.
+ *
+ * @param lock the spinlock, held by this thread
+*/
+void _spin_unlock(_spinlock_t *lock) {
+    __atomic_store_n(&lock->locked, 0, __ATOMIC_RELEASE);
+}
+
+#endif // __THREAD_SYNC_H__
@@ -0,0 +1,198 @@
+/**
+ * _time.h - Time library remake.
+ *
+ * The clocks are read through the vDSO, so getting
+ * a timestamp does not enter the kernel. When the
+ * vDSO (or one of its functions) is not available,
+ * the real syscall is used instead.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __TIME_H__
+#define __TIME_H__
+
+#include <_syscalls.h>
+#include <_vdso.h>
+
+/**
+ * _time_t - type representing the time in seconds
+ *           since the Epoch (1970-01-01 00:00:00 UTC).
+*/
+typedef long _time_t;
+
+/**
+ * _timespec - time with nanoseconds precision.
+ *
+ * @param tv_sec seconds
+ * @param tv_nsec nanoseconds
+*/
+typedef struct {
+    _time_t tv_sec;
+    long tv_nsec;
+} _timespec;
+
+/**
+ * _timeval - time with microseconds precision.
+ *
+ * @param tv_sec seconds
+ * @param tv_usec microseconds
+*/
+typedef struct {
+    _time_t tv_sec;
+    long tv_usec;
+} _timeval;
+
+/**
+ * Clock identifiers.
+ *
+ * - CLOCK_REALTIME           - wall clock time
+ * - CLOCK_MONOTONIC          - time since an unspecified point, never jumps
+ * - CLOCK_PROCESS_CPUTIME_ID - CPU time used by the process
+ * - CLOCK_THREAD_CPUTIME_ID  - CPU time used by the thread
+ * - CLOCK_MONOTONIC_RAW      - monotonic time not adjusted by NTP
+ * - CLOCK_REALTIME_COARSE    - fast, low resolution wall clock time
+ * - CLOCK_MONOTONIC_COARSE   - fast, low resolution monotonic time
+ * - CLOCK_BOOTTIME           - monotonic time including suspend
+*/
+#define _CLOCK_REALTIME           0
+#define _CLOCK_MONOTONIC          1
+#define _CLOCK_PROCESS_CPUTIME_ID 2
+#define _CLOCK_THREAD_CPUTIME_ID  3
+#define _CLOCK_MONOTONIC_RAW      4
+#define _CLOCK_REALTIME_COARSE    5
+#define _CLOCK_MONOTONIC_COARSE   6
+#define _CLOCK_BOOTTIME           7
+
+/**
+ * Library functions:
+ *  @fn _clock_gettime Get the time of the given clock.
+ *  @fn _gettimeofday Get the wall clock time in microseconds precision.
+ *  @fn _time Get the time in seconds since the Epoch.
+ *  @fn _getcpu Get the CPU the calling thread is running on.
+ *  @fn _monotonic_ns Get the monotonic time in nanoseconds.
+*/
+
+/**
+ * vDSO function pointers.
+ *
+ * They are resolved once, on the first call to any
+ * of the library functions. A NULL pointer means the
+ * vDSO does not export the function and the syscall
+ * has to be used.
+*/
+long (*__vdso_clock_gettime)(int, _timespec *) = 0;
+long (*__vdso_gettimeofday)(_timeval *, void *) = 0;
+_time_t (*__vdso_time)(_time_t *) = 0;
+long (*__vdso_getcpu)(unsigned *, unsigned *, void *) = 0;
+int __time_ready = 0;
+
+/**
+ * Resolve the vDSO functions.
+ *
+ * Racing threads resolve the same addresses,
+ * so the worst case is doing the lookup twice.
+*/
+void __time_init(void) {
+    if (__time_ready) return;
+
+    __vdso_clock_gettime = (long (*)(int, _timespec *))
+        _vdso_sym("LINUX_2.6", "__vdso_clock_gettime");
+    __vdso_gettimeofday = (long (*)(_timeval *, void *))
+        _vdso_sym("LINUX_2.6", "__vdso_gettimeofday");
+    __vdso_time = (_time_t (*)(_time_t *))
+        _vdso_sym("LINUX_2.6", "__vdso_time");
+    __vdso_getcpu = (long (*)(unsigned *, unsigned *, void *))
+        _vdso_sym("LINUX_2.6", "__vdso_getcpu");
+
+    __atomic_store_n(&__time_ready, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Get the time of the given clock.
+ *
+ * Example usage:
+ *  _timespec ts;
+ *  _clock_gettime(_CLOCK_MONOTONIC, &ts);
+ *
+ * @param clock clock identifier (_CLOCK_*)
+ * @param ts where to store the time
+ * @return 0 on success, or an error code
+*/
+int _clock_gettime(int clock, _timespec *ts) {
+    if (!__atomic_load_n(&__time_ready, __ATOMIC_ACQUIRE)) __time_init();
+
+    if (__vdso_clock_gettime) return (int)__vdso_clock_gettime(clock, ts);
+
+    return (int)sys_clock_gettime(clock, ts);
+}
+
+/**
+ * Get the wall clock time in microseconds precision.
+ *
+ * @param tv where to store the time
+ * @return 0 on success, or an error code
+*/
+int _gettimeofday(_timeval *tv) {
+    if (!__atomic_load_n(&__time_ready, __ATOMIC_ACQUIRE)) __time_init();
+
+    if (__vdso_gettimeofday) return (int)__vdso_gettimeofday(tv, 0);
+
+    return (int)sys_gettimeofday(tv, 0);
+}
+
+/**
+ * Get the time in seconds since the Epoch.
+ *
+ * @param t where to store the time too (can be NULL)
+ * @return time in seconds since the Epoch
+*/
+_time_t _time(_time_t *t) {
+    if (!__atomic_load_n(&__time_ready, __ATOMIC_ACQUIRE)) __time_init();
+
+    if (__vdso_time) return __vdso_time(t);
+
+    // not every architecture has the time syscall
+    // (ARM EABI does not), the realtime clock is
+    // as good as it and always exists
+    _timespec ts;
+    _clock_gettime(_CLOCK_REALTIME_COARSE, &ts);
+
+    if (t) *t = ts.tv_sec;
+    return ts.tv_sec;
+}
+
+/**
+ * Get the CPU the calling thread is running on.
+ *
+ * @param cpu where to store the CPU number (can be NULL)
+ * @param node where to store the NUMA node number (can be NULL)
+ * @return 0 on success, or an error code
+*/
+int _getcpu(unsigned *cpu, unsigned *node) {
+    if (!__atomic_load_n(&__time_ready, __ATOMIC_ACQUIRE)) __time_init();
+
+    if (__vdso_getcpu) return (int)__vdso_getcpu(cpu, node, 0);
+
+    return (int)sys_getcpu(cpu, node, 0);
+}
+
+/**
+ * Get the monotonic time in nanoseconds.
+ *
+ * Useful for timestamps and measuring intervals,
+ * the value never goes back and is not affected
+ * by changes of the wall clock.
+ *
+ * @return nanoseconds since an unspecified point
+*/
+unsigned long long _monotonic_ns(void) {
+    _timespec ts;
+
+    _clock_gettime(_CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+#endif // __TIME_H__
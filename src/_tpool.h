@@ -0,0 +1,722 @@
+/**
+ * _tpool.h - Work-stealing thread pool.
+ *
+ * Tasks run on a set of worker threads (_thread.h),
+ * one per CPU the process may run on. Each worker has
+ * its own Chase-Lev deque:
+ *
+ * - the worker pushes and pops the tasks it makes at
+ *   the bottom, without atomic read-modify-write
+ * - idle workers steal the oldest task at the top of
+ *   the deque of a random victim
+ * - tasks submitted by other threads go through a
+ *   shared queue, workers take from it when their own
+ *   deque is empty
+ *
+ * Workers with nothing to steal sleep on a futex and
+ * are woken up one by one as tasks are pushed.
+ *
+ * A thread waiting for tasks (_tgroup_wait, _tpool_wait,
+ * _parallel_for) runs queued tasks itself instead of
+ * sleeping, so tasks may wait for the tasks they start.
+ *
+ * The workers are RawC threads: tasks must not call
+ * into the C library.
+ *
+ * Example usage:
+ *  _tgroup_t group = TGROUP_INIT;
+ *
+ *  for (int i = 0; i < 16; i++) _tgroup_submit(&group, compress_block, &blocks[i]);
+ *  _tgroup_wait(&group);
+ *
+ *  _parallel_for(0, count, 4096, scale_range, &factor);
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __TPOOL_H__
+#define __TPOOL_H__
+
+#include <_thread.h>
+#include <_random.h>
+
+/**
+ * TPOOL_MAX - Maximum number of workers.
+*/
+#define TPOOL_MAX 256
+
+/**
+ * __TPOOL_DEQUE - Capacity of the deque of a worker.
+ *
+ * A worker with a full deque runs the task it would
+ * push right away.
+*/
+#define __TPOOL_DEQUE 4096
+
+/**
+ * __TPOOL_SPIN - Rounds of stealing before a worker
+ *                goes to sleep.
+*/
+#define __TPOOL_SPIN 64
+
+#define TGROUP_INIT { 0, 0, 0 }
+
+/**
+ * _tgroup_t - a group of tasks waited for together.
+ *
+ * A group often lives on the stack of its waiter, so
+ * _tgroup_wait returns only when no finishing task
+ * touches the group any more (busy is 0).
+ *
+ * @param pending number of tasks not finished yet,
+ *                the futex word of _tgroup_wait
+ * @param waiting 1 if a thread sleeps in _tgroup_wait
+ * @param busy number of tasks in __tgroup_done
+*/
+typedef struct {
+    unsigned int pending;
+    unsigned int waiting;
+    unsigned int busy;
+} _tgroup_t;
+
+/**
+ * __tpool_task - a queued task.
+ *
+ * A task without a function is a range of _parallel_for,
+ * it splits itself until it is not longer than the grain.
+ *
+ * @param fn function of the task
+ * @param arg argument of the function
+ * @param group group of the task
+ * @param next next task in the shared queue
+ * @param range function of a _parallel_for range
+ * @param begin start of the range
+ * @param end end of the range (exclusive)
+ * @param grain longest range run without splitting
+*/
+typedef struct __tpool_task {
+    void (*fn)(void *);
+    void *arg;
+    _tgroup_t *group;
+    struct __tpool_task *next;
+    void (*range)(_size_t, _size_t, void *);
+    _size_t begin;
+    _size_t end;
+    _size_t grain;
+} __tpool_task;
+
+/**
+ * __tpool_deque - Chase-Lev deque of a worker.
+ *
+ * The owner and the thieves touch different cache
+ * lines, the top is changed by thieves only with a
+ * compare-and-swap.
+ *
+ * @param top index of the oldest task
+ * @param bottom index after the newest task
+ * @param rng generator picking the victims of the worker
+ * @param slots ring of the tasks
+*/
+typedef struct {
+    long long top __attribute__((aligned(64)));
+    long long bottom __attribute__((aligned(64)));
+    _xoshiro256_t rng;
+    __tpool_task *slots[__TPOOL_DEQUE] __attribute__((aligned(64)));
+} __tpool_deque;
+
+/**
+ * __tpool - the pool.
+ *
+ * @param deques deques of the workers
+ * @param threads the workers
+ * @param count number of workers
+ * @param state 0 - stopped, 1 - starting, 2 - running
+ * @param stop set to stop the workers
+ * @param epoch futex word of the sleeping workers,
+ *              changed every time they are woken up
+ * @param sleepers number of sleeping workers
+ * @param lock lock of the shared queue
+ * @param head first task of the shared queue
+ * @param tail last task of the shared queue
+ * @param all group of the tasks from _tpool_submit
+*/
+struct {
+    __tpool_deque *deques;
+    _thread_t *threads[TPOOL_MAX];
+    int count;
+    int state;
+    int stop;
+    unsigned int epoch __attribute__((aligned(64)));
+    unsigned int sleepers;
+    _mutex_t lock __attribute__((aligned(64)));
+    __tpool_task *head;
+    __tpool_task *tail;
+    _tgroup_t all;
+} __tpool;
+
+/* Deque of the calling worker, NULL in other threads. */
+__thread __tpool_deque *__tpool_self = NULL;
+
+/**
+ * Library functions:
+ *  @fn _tpool_start Start the workers.
+ *  @fn _tpool_stop Wait for the tasks and stop the workers.
+ *  @fn _tpool_threads Get the number of workers.
+ *  @fn _tpool_submit Run a function on a worker.
+ *  @fn _tpool_wait Wait for the tasks from _tpool_submit.
+ *  @fn _tgroup_submit Run a function of a group on a worker.
+ *  @fn _tgroup_wait Wait for the tasks of a group.
+ *  @fn _parallel_for Run a function over a range on the workers.
+*/
+
+/**
+ * Count the CPUs the process may run on.
+ *
+ * @return number of CPUs, at least 1
+*/
+int __tpool_cpus(void) {
+    unsigned long long mask[16];
+
+    long long size = sys_sched_getaffinity(0, sizeof(mask), mask);
+    if (size <= 0) return 1;
+
+    int cpus = 0;
+    for (long long i = 0; i < size / 8; i++) cpus += __builtin_popcountll(mask[i]);
+
+    return cpus > 0 ? cpus : 1;
+}
+
+/**
+ * Push a task to the bottom of the deque of the calling worker.
+ *
+ * @param deque the deque
+ * @param task the task
+ * @return 0 on success, -1 if the deque is full
+*/
+int __tpool_push(__tpool_deque *deque, __tpool_task *task) {
+    long long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    long long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+    if (bottom - top >= __TPOOL_DEQUE) return -1;
+
+    __atomic_store_n(&deque->slots[bottom & (__TPOOL_DEQUE - 1)], task, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+/**
+ * Pop the newest task of the deque of the calling worker.
+ *
+ * Only the last task can be raced for by a thief,
+ * the compare-and-swap on the top decides who gets it.
+ *
+ * @param deque the deque
+ * @return the task, or NULL if the deque is empty
+*/
+__tpool_task *__tpool_pop(__tpool_deque *deque) {
+    long long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    long long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    if (top > bottom) {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    __tpool_task *task = __atomic_load_n(&deque->slots[bottom & (__TPOOL_DEQUE - 1)], __ATOMIC_RELAXED);
+
+    if (top == bottom) {
+        if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            task = NULL;
+        }
+
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+
+    return task;
+}
+
+/**
+ * Steal the oldest task of a deque.
+ *
+ * @param deque the deque
+ * @return the task, or NULL if the deque is empty or
+ *         another thread took the task first
+*/
+__tpool_task *__tpool_steal(__tpool_deque *deque) {
+    long long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+    if (top >= bottom) return NULL;
+
+    __tpool_task *task = __atomic_load_n(&deque->slots[top & (__TPOOL_DEQUE - 1)], __ATOMIC_RELAXED);
+
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+
+    return task;
+}
+
+/**
+ * Take the first task of the shared queue.
+ *
+ * @return the task, or NULL if the queue is empty
+*/
+__tpool_task *__tpool_dequeue(void) {
+    if (__atomic_load_n(&__tpool.head, __ATOMIC_RELAXED) == NULL) return NULL;
+
+    _mutex_lock(&__tpool.lock);
+
+    __tpool_task *task = __tpool.head;
+    if (task != NULL) {
+        __tpool.head = task->next;
+        if (__tpool.head == NULL) __tpool.tail = NULL;
+    }
+
+    _mutex_unlock(&__tpool.lock);
+
+    return task;
+}
+
+/**
+ * Find a task to run: from the deque of the calling
+ * worker, the shared queue, or another worker.
+ *
+ * @return the task, or NULL if none was found
+*/
+__tpool_task *__tpool_find(void) {
+    __tpool_deque *self = __tpool_self;
+    __tpool_task *task;
+
+    if (self != NULL && (task = __tpool_pop(self)) != NULL) return task;
+    if ((task = __tpool_dequeue()) != NULL) return task;
+
+    int count = __atomic_load_n(&__tpool.count, __ATOMIC_ACQUIRE);
+    if (count == 0) return NULL;
+
+    // start at a random victim, then try the others in order
+    _size_t start = self != NULL ? _xoshiro256_below(&self->rng, count) : (_size_t)_rand_below(count);
+
+    for (int i = 0; i < count; i++) {
+        __tpool_deque *victim = &__tpool.deques[(start + i) % count];
+
+        if (victim != self && (task = __tpool_steal(victim)) != NULL) return task;
+    }
+
+    return NULL;
+}
+
+/**
+ * Check whether a task is queued anywhere.
+ *
+ * @return 1 if a task is queued, 0 otherwise
+*/
+int __tpool_queued(void) {
+    if (__atomic_load_n(&__tpool.head, __ATOMIC_RELAXED) != NULL) return 1;
+
+    for (int i = 0; i < __tpool.count; i++) {
+        __tpool_deque *deque = &__tpool.deques[i];
+
+        if (__atomic_load_n(&deque->top, __ATOMIC_RELAXED) < __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Wake up a sleeping worker, if there is one.
+ *
+ * The fence orders the task just pushed before the
+ * check of the sleepers, against the worker counting
+ * itself as a sleeper before its last look for tasks.
+*/
+void __tpool_notify(void) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&__tpool.sleepers, __ATOMIC_RELAXED) == 0) return;
+
+    __atomic_add_fetch(&__tpool.epoch, 1, __ATOMIC_SEQ_CST);
+    __futex_wake(&__tpool.epoch, 1);
+}
+
+/**
+ * Mark a task of a group as finished.
+ *
+ * Leaving busy is the last access to the group,
+ * the waiter may free it right after.
+ *
+ * @param group the group
+*/
+void __tgroup_done(_tgroup_t *group) {
+    __atomic_add_fetch(&group->busy, 1, __ATOMIC_SEQ_CST);
+
+    if (__atomic_sub_fetch(&group->pending, 1, __ATOMIC_SEQ_CST) == 0
+        && __atomic_load_n(&group->waiting, __ATOMIC_SEQ_CST)) {
+        __futex_wake(&group->pending, 0x7FFFFFFF);
+    }
+
+    __atomic_sub_fetch(&group->busy, 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Wait until the tasks which finished the group
+ * left __tgroup_done.
+ *
+ * @param group a group with no pending tasks
+*/
+void __tgroup_quiet(_tgroup_t *group) {
+    while (__atomic_load_n(&group->busy, __ATOMIC_ACQUIRE) != 0) __cpu_relax();
+}
+
+void __tpool_run(__tpool_task *task);
+
+/**
+ * Queue a task.
+ *
+ * A worker pushes to its own deque, other threads to
+ * the shared queue. A task which can not be queued
+ * runs right away.
+ *
+ * @param task the task, counted in its group already
+*/
+void __tpool_spawn(__tpool_task *task) {
+    __tpool_deque *self = __tpool_self;
+
+    if (self != NULL) {
+        if (__tpool_push(self, task) != 0) {
+            __tpool_run(task);
+            return;
+        }
+    }
+    else {
+        task->next = NULL;
+
+        _mutex_lock(&__tpool.lock);
+        if (__tpool.tail != NULL) __tpool.tail->next = task;
+        else __atomic_store_n(&__tpool.head, task, __ATOMIC_RELAXED);
+        __tpool.tail = task;
+        _mutex_unlock(&__tpool.lock);
+    }
+
+    __tpool_notify();
+}
+
+/**
+ * Run a task and free it.
+ *
+ * A range longer than the grain gives its upper half
+ * away as a new task until it is short enough, so the
+ * halves spread over the workers by stealing.
+ *
+ * @param task the task
+*/
+void __tpool_run(__tpool_task *task) {
+    _tgroup_t *group = task->group;
+
+    if (task->fn != NULL) task->fn(task->arg);
+    else {
+        while (task->end - task->begin > task->grain) {
+            _size_t middle = task->begin + (task->end - task->begin) / 2;
+            __tpool_task *half = _malloc(sizeof(__tpool_task));
+
+            if (half == NULL) break;
+
+            *half = *task;
+            half->begin = middle;
+            task->end = middle;
+
+            __atomic_add_fetch(&group->pending, 1, __ATOMIC_RELAXED);
+            __tpool_spawn(half);
+        }
+
+        task->range(task->begin, task->end, task->arg);
+    }
+
+    _free(task);
+    __tgroup_done(group);
+}
+
+/**
+ * Main loop of a worker.
+ *
+ * @param arg the deque of the worker
+ * @return NULL
+*/
+void *__tpool_worker(void *arg) {
+    __tpool_self = arg;
+
+    for (;;) {
+        __tpool_task *task = NULL;
+
+        for (int spin = 0; spin < __TPOOL_SPIN && task == NULL; spin++) {
+            task = __tpool_find();
+            if (task == NULL) __cpu_relax();
+        }
+
+        if (task != NULL) {
+            __tpool_run(task);
+            continue;
+        }
+
+        if (__atomic_load_n(&__tpool.stop, __ATOMIC_ACQUIRE)) break;
+
+        // count as a sleeper, then look once more before sleeping
+        unsigned int epoch = __atomic_load_n(&__tpool.epoch, __ATOMIC_ACQUIRE);
+        __atomic_add_fetch(&__tpool.sleepers, 1, __ATOMIC_SEQ_CST);
+
+        if (!__tpool_queued() && !__atomic_load_n(&__tpool.stop, __ATOMIC_ACQUIRE)) {
+            __futex_wait(&__tpool.epoch, epoch, -1);
+        }
+
+        __atomic_sub_fetch(&__tpool.sleepers, 1, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+/**
+ * Start the workers.
+ *
+ * The pool starts by itself with one worker per CPU
+ * when the first task is submitted, call this to choose
+ * the number of workers. It does nothing if the pool
+ * is running already.
+ *
+ * @param threads number of workers, 0 for one per CPU
+ * @return number of workers, 0 if none could be started
+*/
+int _tpool_start(int threads) {
+    int state = 0;
+
+    if (!__atomic_compare_exchange_n(&__tpool.state, &state, 1, 0, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&__tpool.state, __ATOMIC_ACQUIRE) == 1) __cpu_relax();
+        return __atomic_load_n(&__tpool.count, __ATOMIC_ACQUIRE);
+    }
+
+    if (threads <= 0) threads = __tpool_cpus();
+    if (threads > TPOOL_MAX) threads = TPOOL_MAX;
+
+    __tpool.deques = _aligned_alloc(64, threads * sizeof(__tpool_deque));
+    __tpool.stop = 0;
+
+    int count = 0;
+
+    if (__tpool.deques != NULL) {
+        for (; count < threads; count++) {
+            __tpool_deque *deque = &__tpool.deques[count];
+
+            deque->top = 0;
+            deque->bottom = 0;
+            _xoshiro256_seed(&deque->rng, count + 1);
+        }
+
+        // the workers steal only from deques of started workers
+        __atomic_store_n(&__tpool.count, count, __ATOMIC_RELEASE);
+
+        for (int i = 0; i < count; i++) {
+            __tpool.threads[i] = _thread_create(__tpool_worker, &__tpool.deques[i], 0);
+
+            if (__tpool.threads[i] == NULL) {
+                count = i;
+                break;
+            }
+        }
+
+        __atomic_store_n(&__tpool.count, count, __ATOMIC_RELEASE);
+    }
+
+    if (count == 0) {
+        _free(__tpool.deques);
+        __tpool.deques = NULL;
+        __atomic_store_n(&__tpool.state, 0, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    __atomic_store_n(&__tpool.state, 2, __ATOMIC_RELEASE);
+
+    return count;
+}
+
+/**
+ * Get the number of workers.
+ *
+ * @return number of workers, 0 if the pool is stopped
+*/
+int _tpool_threads(void) {
+    return __atomic_load_n(&__tpool.state, __ATOMIC_ACQUIRE) == 2 ? __tpool.count : 0;
+}
+
+/**
+ * Queue a task of a group, starting the pool if needed.
+ *
+ * @param group the group
+ * @param task the task
+*/
+void __tgroup_spawn(_tgroup_t *group, __tpool_task *task) {
+    task->group = group;
+    __atomic_add_fetch(&group->pending, 1, __ATOMIC_RELAXED);
+
+    if (__atomic_load_n(&__tpool.state, __ATOMIC_ACQUIRE) != 2 && _tpool_start(0) == 0) {
+        __tpool_run(task);
+        return;
+    }
+
+    __tpool_spawn(task);
+}
+
+/**
+ * Run a function of a group on a worker.
+ *
+ * If the pool can not be started or the task can not
+ * be allocated, the function runs in the calling thread.
+ *
+ * Example usage:
+ *  _tgroup_submit(&group, compress_block, &blocks[i]);
+ *
+ * @param group the group
+ * @param fn the function
+ * @param arg argument of the function
+*/
+void _tgroup_submit(_tgroup_t *group, void (*fn)(void *), void *arg) {
+    __tpool_task *task = _malloc(sizeof(__tpool_task));
+
+    if (task == NULL) {
+        fn(arg);
+        return;
+    }
+
+    task->fn = fn;
+    task->arg = arg;
+    __tgroup_spawn(group, task);
+}
+
+/**
+ * Wait for the tasks of a group.
+ *
+ * The calling thread runs queued tasks while the
+ * group is not finished, of any group.
+ *
+ * @param group the group
+*/
+void _tgroup_wait(_tgroup_t *group) {
+    for (;;) {
+        unsigned int pending = __atomic_load_n(&group->pending, __ATOMIC_ACQUIRE);
+        if (pending == 0) break;
+
+        __tpool_task *task = __tpool_find();
+
+        if (task != NULL) {
+            __tpool_run(task);
+            continue;
+        }
+
+        // the last task of the group wakes up the waiters
+        __atomic_store_n(&group->waiting, 1, __ATOMIC_SEQ_CST);
+
+        pending = __atomic_load_n(&group->pending, __ATOMIC_SEQ_CST);
+        if (pending == 0) break;
+
+        // wake up now and then to help with tasks queued meanwhile
+        __futex_wait(&group->pending, pending, 1000000);
+    }
+
+    __tgroup_quiet(group);
+}
+
+/**
+ * Run a function on a worker.
+ *
+ * Example usage:
+ *  _tpool_submit(flush_log, log);
+ *
+ * @param fn the function
+ * @param arg argument of the function
+*/
+void _tpool_submit(void (*fn)(void *), void *arg) {
+    _tgroup_submit(&__tpool.all, fn, arg);
+}
+
+/**
+ * Wait for the tasks from _tpool_submit.
+*/
+void _tpool_wait(void) {
+    _tgroup_wait(&__tpool.all);
+}
+
+/**
+ * Run a function over a range on the workers.
+ *
+ * The range is split in halves until the parts are
+ * not longer than the grain, every part is passed to
+ * the function once. Returns when all parts are done.
+ *
+ * Example usage:
+ *  void scale_range(_size_t begin, _size_t end, void *arg) { ... }
+ *
+ *  _parallel_for(0, count, 4096, scale_range, &factor);
+ *
+ * @param begin start of the range
+ * @param end end of the range (exclusive)
+ * @param grain longest part run without splitting, 0 for 1
+ * @param fn the function, called with a part of the range
+ * @param arg argument of the function
+*/
+void _parallel_for(_size_t begin, _size_t end, _size_t grain, void (*fn)(_size_t, _size_t, void *), void *arg) {
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+
+    __tpool_task *task = _malloc(sizeof(__tpool_task));
+
+    if (end - begin <= grain || task == NULL) {
+        _free(task);
+        fn(begin, end, arg);
+        return;
+    }
+
+    _tgroup_t group = TGROUP_INIT;
+
+    task->fn = NULL;
+    task->arg = arg;
+    task->range = fn;
+    task->begin = begin;
+    task->end = end;
+    task->grain = grain;
+
+    __tgroup_spawn(&group, task);
+    _tgroup_wait(&group);
+}
+
+/**
+ * Wait for the tasks from _tpool_submit and stop the workers.
+ *
+ * The pool starts again with the next task.
+*/
+void _tpool_stop(void) {
+    if (__atomic_load_n(&__tpool.state, __ATOMIC_ACQUIRE) != 2) return;
+
+    _tpool_wait();
+
+    __atomic_store_n(&__tpool.stop, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&__tpool.epoch, 1, __ATOMIC_SEQ_CST);
+    __futex_wake(&__tpool.epoch, 0x7FFFFFFF);
+
+    for (int i = 0; i < __tpool.count; i++) _thread_join(__tpool.threads[i]);
+
+    _free(__tpool.deques);
+    __tpool.deques = NULL;
+    __atomic_store_n(&__tpool.count, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&__tpool.state, 0, __ATOMIC_RELEASE);
+}
+
+#endif // __TPOOL_H__
@@ -0,0 +1,460 @@
+/**
+ * _vdso.h - Auxiliary vector and vDSO symbol lookup.
+ *
+ * The kernel maps a small shared object (the vDSO) into
+ * every process. It exports functions such as clock_gettime
+ * which can be called like any other function, without
+ * entering the kernel. The address of the vDSO is passed
+ * to the process in the auxiliary vector (AT_SYSINFO_EHDR).
+ *
+ * This file reads the auxiliary vector and implements a
+ * minimal ELF dynamic symbol lookup, just enough to find
+ * the vDSO functions used by the other RawC libraries.
+ *
+ * Author: ruxixa
+ *
+ * Date: 19.10.2026
+*/
+
+#ifndef __VDSO_H__
+#define __VDSO_H__
+
+#include <_syscalls.h>
+
+/**
+ * Auxiliary vector entry types used by RawC.
+ *
+ * - AT_NULL         - end of the vector
+ * - AT_PHDR         - program headers of the executable
+ * - AT_PHNUM        - number of program headers
+ * - AT_PAGESZ       - system page size
+ * - AT_HWCAP        - hardware capabilities of the CPU
+ * - AT_HWCAP2       - more hardware capabilities of the CPU
+ * - AT_SYSINFO_EHDR - address of the vDSO ELF header
+*/
+#define _AT_NULL          0
+#define _AT_PHDR          3
+#define _AT_PHNUM         5
+#define _AT_PAGESZ        6
+#define _AT_HWCAP         16
+#define _AT_HWCAP2        26
+#define _AT_SYSINFO_EHDR  33
+
+/**
+ * _AUXV_MAX - Maximum number of auxiliary vector
+ *             entries kept in memory. Linux passes
+ *             around 20-30 entries.
+*/
+#define _AUXV_MAX 64
+
+/**
+ * ELF structures used by the symbol lookup.
+ *
+ * The vDSO has the word size of the process, so
+ * the 64-bit layouts are used on x86_64 and the
+ * 32-bit ones on i386 and ARM.
+*/
+#ifdef __x86_64__
+typedef unsigned long long _Elf_Addr;
+typedef long long          _Elf_Sword;
+
+typedef struct {
+    unsigned char  e_ident[16];
+    unsigned short e_type;
+    unsigned short e_machine;
+    unsigned int   e_version;
+    _Elf_Addr      e_entry;
+    _Elf_Addr      e_phoff;
+    _Elf_Addr      e_shoff;
+    unsigned int   e_flags;
+    unsigned short e_ehsize;
+    unsigned short e_phentsize;
+    unsigned short e_phnum;
+    unsigned short e_shentsize;
+    unsigned short e_shnum;
+    unsigned short e_shstrndx;
+} _Elf_Ehdr;
+
+typedef struct {
+    unsigned int p_type;
+    unsigned int p_flags;
+    _Elf_Addr    p_offset;
+    _Elf_Addr    p_vaddr;
+    _Elf_Addr    p_paddr;
+    _Elf_Addr    p_filesz;
+    _Elf_Addr    p_memsz;
+    _Elf_Addr    p_align;
+} _Elf_Phdr;
+
+typedef struct {
+    unsigned int   st_name;
+    unsigned char  st_info;
+    unsigned char  st_other;
+    unsigned short st_shndx;
+    _Elf_Addr      st_value;
+    _Elf_Addr      st_size;
+} _Elf_Sym;
+#else
+typedef unsigned int _Elf_Addr;
+typedef int          _Elf_Sword;
+
+typedef struct {
+    unsigned char  e_ident[16];
+    unsigned short e_type;
+    unsigned short e_machine;
+    unsigned int   e_version;
+    _Elf_Addr      e_entry;
+    _Elf_Addr      e_phoff;
+    _Elf_Addr      e_shoff;
+    unsigned int   e_flags;
+    unsigned short e_ehsize;
+    unsigned short e_phentsize;
+    unsigned short e_phnum;
+    unsigned short e_shentsize;
+    unsigned short e_shnum;
+    unsigned short e_shstrndx;
+} _Elf_Ehdr;
+
+typedef struct {
+    unsigned int p_type;
+    _Elf_Addr    p_offset;
+    _Elf_Addr    p_vaddr;
+    _Elf_Addr    p_paddr;
+    _Elf_Addr    p_filesz;
+    _Elf_Addr    p_memsz;
+    unsigned int p_flags;
+    _Elf_Addr    p_align;
+} _Elf_Phdr;
+
+typedef struct {
+    unsigned int   st_name;
+    _Elf_Addr      st_value;
+    _Elf_Addr      st_size;
+    unsigned char  st_info;
+    unsigned char  st_other;
+    unsigned short st_shndx;
+} _Elf_Sym;
+#endif
+
+typedef struct {
+    _Elf_Sword d_tag;
+    _Elf_Addr  d_val;
+} _Elf_Dyn;
+
+typedef struct {
+    unsigned short vd_version;
+    unsigned short vd_flags;
+    unsigned short vd_ndx;
+    unsigned short vd_cnt;
+    unsigned int   vd_hash;
+    unsigned int   vd_aux;
+    unsigned int   vd_next;
+} _Elf_Verdef;
+
+typedef struct {
+    unsigned int vda_name;
+    unsigned int vda_next;
+} _Elf_Verdaux;
+
+#define _PT_LOAD      1
+#define _PT_DYNAMIC   2
+#define _PT_PHDR      6
+#define _PT_TLS       7
+
+#define _DT_NULL      0
+#define _DT_HASH      4
+#define _DT_STRTAB    5
+#define _DT_SYMTAB    6
+#define _DT_GNU_HASH  0x6ffffef5
+#define _DT_VERSYM    0x6ffffff0
+#define _DT_VERDEF    0x6ffffffc
+
+#define _STT_FUNC     2
+#define _STB_GLOBAL   1
+#define _STB_WEAK     2
+#define _SHN_UNDEF    0
+#define _VER_FLG_BASE 0x1
+
+/**
+ * Library functions:
+ *  @fn _getauxval Get an entry of the auxiliary vector.
+ *  @fn _vdso_sym Find a function exported by the vDSO.
+*/
+
+/**
+ * Auxiliary vector cache.
+ *
+ * The vector is read once from /proc/self/auxv,
+ * which works even when RawC does not control
+ * the process entry point.
+*/
+unsigned long __auxv[2 * _AUXV_MAX];
+int __auxv_state = 0;   // 0 - not read, 1 - read, -1 - unavailable
+
+/**
+ * Get an entry of the auxiliary vector.
+ *
+ * @param type entry type (_AT_*)
+ * @return value of the entry, or 0 if it is not present
+*/
+unsigned long _getauxval(unsigned long type) {
+    if (__auxv_state == 0) {
+        long long fd = sys_open("/proc/self/auxv", _O_RDONLY, 0);
+
+        if (fd < 0) {
+            __auxv_state = -1;
+            return 0;
+        }
+
+        // leave the last pair zeroed, so the vector
+        // is always terminated with AT_NULL
+        unsigned long long got = 0;
+        while (got < sizeof(__auxv) - 2 * sizeof(unsigned long)) {
+            long long n = sys_read((int)fd, (char *)__auxv + got,
+                                   sizeof(__auxv) - 2 * sizeof(unsigned long) - got);
+            if (n <= 0) break;
+            got += n;
+        }
+        sys_close((int)fd);
+
+        __auxv_state = got ? 1 : -1;
+    }
+
+    if (__auxv_state < 0) return 0;
+
+    for (int i = 0; i < _AUXV_MAX && __auxv[2 * i] != _AT_NULL; i++) {
+        if (__auxv[2 * i] == type) return __auxv[2 * i + 1];
+    }
+
+    return 0;
+}
+
+/**
+ * Parsed vDSO image.
+ *
+ * @param load_offset difference between the mapped and linked addresses
+ * @param symtab dynamic symbol table
+ * @param strtab dynamic string table
+ * @param bucket SysV hash buckets (DT_HASH)
+ * @param chain SysV hash chains (DT_HASH)
+ * @param gnu_hash GNU hash table (DT_GNU_HASH)
+ * @param versym symbol version indices
+ * @param verdef version definitions
+*/
+typedef struct {
+    _Elf_Addr            load_offset;
+    const _Elf_Sym      *symtab;
+    const char          *strtab;
+    const unsigned int  *bucket;
+    const unsigned int  *chain;
+    unsigned int         nbucket;
+    const unsigned int  *gnu_hash;
+    const unsigned short *versym;
+    const _Elf_Verdef   *verdef;
+} _vdso_info;
+
+_vdso_info __vdso;
+int __vdso_state = 0;   // 0 - not parsed, 1 - parsed, -1 - unavailable
+
+/**
+ * SysV ELF hash of a symbol name.
+*/
+unsigned int __elf_hash(const char *name) {
+    unsigned int h = 0, g;
+
+    while (*name) {
+        h = (h << 4) + (unsigned char)*name++;
+        if ((g = h & 0xf0000000)) h ^= g >> 24;
+        h &= ~g;
+    }
+
+    return h;
+}
+
+/**
+ * GNU ELF hash of a symbol name.
+*/
+unsigned int __gnu_hash(const char *name) {
+    unsigned int h = 5381;
+
+    while (*name) h = h * 33 + (unsigned char)*name++;
+    return h;
+}
+
+/**
+ * Compare two symbol names.
+*/
+int __vdso_streq(const char *a, const char *b) {
+    while (*a && *a == *b) {
+        a++;
+        b++;
+    }
+
+    return *a == *b;
+}
+
+/**
+ * Parse the vDSO image pointed by AT_SYSINFO_EHDR.
+ *
+ * @return 1 if the vDSO can be used, 0 otherwise
+*/
+int __vdso_init(void) {
+    if (__vdso_state) return __vdso_state > 0;
+
+    __vdso_state = -1;
+
+    unsigned long base = _getauxval(_AT_SYSINFO_EHDR);
+    if (!base) return 0;
+
+    const _Elf_Ehdr *ehdr = (const _Elf_Ehdr *)base;
+    const _Elf_Phdr *phdr = (const _Elf_Phdr *)(base + ehdr->e_phoff);
+    const _Elf_Dyn *dyn = 0;
+    int found_load = 0;
+
+    // the vDSO is a single PT_LOAD image, its link address
+    // (usually 0) tells how to relocate the dynamic entries
+    for (int i = 0; i < ehdr->e_phnum; i++) {
+        if (phdr[i].p_type == _PT_LOAD && !found_load) {
+            found_load = 1;
+            __vdso.load_offset = base + phdr[i].p_offset - phdr[i].p_vaddr;
+        }
+        else if (phdr[i].p_type == _PT_DYNAMIC) {
+            dyn = (const _Elf_Dyn *)(base + phdr[i].p_offset);
+        }
+    }
+
+    if (!found_load || !dyn) return 0;
+
+    const unsigned int *hash = 0;
+
+    for (; dyn->d_tag != _DT_NULL; dyn++) {
+        _Elf_Addr addr = dyn->d_val + __vdso.load_offset;
+
+        switch (dyn->d_tag) {
+            case _DT_STRTAB:   __vdso.strtab   = (const char *)addr; break;
+            case _DT_SYMTAB:   __vdso.symtab   = (const _Elf_Sym *)addr; break;
+            case _DT_HASH:     hash            = (const unsigned int *)addr; break;
+            case _DT_GNU_HASH: __vdso.gnu_hash = (const unsigned int *)addr; break;
+            case _DT_VERSYM:   __vdso.versym   = (const unsigned short *)addr; break;
+            case _DT_VERDEF:   __vdso.verdef   = (const _Elf_Verdef *)addr; break;
+        }
+    }
+
+    if (!__vdso.strtab || !__vdso.symtab || (!hash && !__vdso.gnu_hash)) return 0;
+
+    if (hash) {
+        __vdso.nbucket = hash[0];
+        __vdso.bucket  = &hash[2];
+        __vdso.chain   = &hash[2 + hash[0]];
+    }
+
+    // versioning is optional, without the definitions
+    // there is nothing to check the symbols against
+    if (!__vdso.verdef) __vdso.versym = 0;
+
+    __vdso_state = 1;
+    return 1;
+}
+
+/**
+ * Check if the symbol has the wanted version.
+ *
+ * @param index index of the symbol
+ * @param version name of the version, e.g. "LINUX_2.6"
+ * @return 1 if the version matches, 0 otherwise
+*/
+int __vdso_match_version(unsigned int index, const char *version) {
+    if (!__vdso.versym) return 1;
+
+    unsigned short ver = __vdso.versym[index] & 0x7fff;
+    const _Elf_Verdef *def = __vdso.verdef;
+
+    // walk the version definitions until the one
+    // with the index of the symbol is found
+    while (1) {
+        if (!(def->vd_flags & _VER_FLG_BASE) && (def->vd_ndx & 0x7fff) == ver) break;
+        if (def->vd_next == 0) return 0;
+
+        def = (const _Elf_Verdef *)((const char *)def + def->vd_next);
+    }
+
+    const _Elf_Verdaux *aux = (const _Elf_Verdaux *)((const char *)def + def->vd_aux);
+    return __vdso_streq(version, __vdso.strtab + aux->vda_name);
+}
+
+/**
+ * Check if the symbol at the given index is the one we look for.
+*/
+int __vdso_sym_matches(unsigned int index, const char *name, const char *version) {
+    const _Elf_Sym *sym = &__vdso.symtab[index];
+    unsigned int type = sym->st_info & 0xf;
+    unsigned int bind = sym->st_info >> 4;
+
+    if (type != _STT_FUNC) return 0;
+    if (bind != _STB_GLOBAL && bind != _STB_WEAK) return 0;
+    if (sym->st_shndx == _SHN_UNDEF) return 0;
+    if (!__vdso_streq(name, __vdso.strtab + sym->st_name)) return 0;
+
+    return __vdso_match_version(index, version);
+}
+
+/**
+ * Find a function exported by the vDSO.
+ *
+ * The SysV hash table is preferred, when the vDSO
+ * was linked only with the GNU hash style the GNU
+ * table is used instead.
+ *
+ * Example usage:
+ *  void *fn = _vdso_sym("LINUX_2.6", "__vdso_clock_gettime");
+ *
+ * @param version name of the symbol version
+ * @param name name of the symbol
+ * @return address of the function, or NULL if it is not exported
+*/
+void *_vdso_sym(const char *version, const char *name) {
+    if (!__vdso_init()) return (void *)0;
+
+    if (__vdso.bucket) {
+        unsigned int i = __vdso.bucket[__elf_hash(name) % __vdso.nbucket];
+
+        for (; i != 0; i = __vdso.chain[i]) {
+            if (__vdso_sym_matches(i, name, version))
+                return (void *)(__vdso.symtab[i].st_value + __vdso.load_offset);
+        }
+
+        return (void *)0;
+    }
+
+    /**
+     * GNU hash table layout:
+     *  nbuckets, symoffset, bloom_size, bloom_shift,
+     *  bloom[bloom_size], buckets[nbuckets], chain[]
+    */
+    const unsigned int *gh = __vdso.gnu_hash;
+    unsigned int nbuckets = gh[0];
+    unsigned int symoffset = gh[1];
+    unsigned int bloom_size = gh[2];
+    const unsigned int *buckets = gh + 4 + bloom_size * (sizeof(_Elf_Addr) / 4);
+    const unsigned int *chain = buckets + nbuckets;
+
+    unsigned int h = __gnu_hash(name);
+    unsigned int i = buckets[h % nbuckets];
+
+    if (i < symoffset) return (void *)0;
+
+    while (1) {
+        unsigned int ch = chain[i - symoffset];
+
+        if ((ch | 1) == (h | 1) && __vdso_sym_matches(i, name, version))
+            return (void *)(__vdso.symtab[i].st_value + __vdso.load_offset);
+
+        // the lowest bit marks the end of the chain
+        if (ch & 1) break;
+        i++;
+    }
+
+    return (void *)0;
+}
+
+#endif // __VDSO_H__
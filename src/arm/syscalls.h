@@ -26,6 +26,8 @@
  * - O_CREAT  - create file if it does not exist
  * - O_APPEND - append to the end of the file
  * - O_TRUNC  - truncate the file
+ * - O_NONBLOCK - do not block on reads and writes
+ * - O_CLOEXEC  - close the file descriptor on exec
  *  
  * Permissions:
  * - S_IRUSR  - read permission owner
@@ -37,15 +39,261 @@
 #define _O_RDONLY  0x0000     // O_RDONLY - read only
 #define _O_WRONLY  0x0001     // O_WRONLY - write only
 #define _O_RDWR    0x0002     // O_RDWR   - read and write
-#define _O_CREAT   0x0100     // O_CREAT  - create file if it does not exist
-#define _O_APPEND  0x0200     // O_APPEND - append to the end of the file
-#define _O_TRUNC   0x0400     // O_TRUNC  - truncate the file
+#define _O_CREAT   0x0040     // O_CREAT  - create file if it does not exist
+#define _O_APPEND  0x0400     // O_APPEND - append to the end of the file
+#define _O_TRUNC   0x0200     // O_TRUNC  - truncate the file
+#define _O_NONBLOCK 0x0800    // O_NONBLOCK - do not block on reads and writes
+#define _O_CLOEXEC 0x80000    // O_CLOEXEC  - close the file descriptor on exec
 
 #define _S_IRUSR  00400       // S_IRUSR  - read permission owner
 #define _S_IWUSR  00200       // S_IWUSR  - write permission owner
 #define _S_IRGRP  00040       // S_IRGRP  - read permission group
 #define _S_IROTH  00004       // S_IROTH  - read permission others
 
+/**
+ * Macros for file positioning and file access advice.
+ * 
+ * Whence:
+ * - SEEK_SET - offset is relative to the start of the file
+ * - SEEK_CUR - offset is relative to the current position
+ * - SEEK_END - offset is relative to the end of the file
+ * 
+ * Advice:
+ * - POSIX_FADV_NORMAL     - no special treatment
+ * - POSIX_FADV_RANDOM     - expect random access, disable read ahead
+ * - POSIX_FADV_SEQUENTIAL - expect sequential access, read ahead more
+ * - POSIX_FADV_WILLNEED   - the range will be accessed soon
+ * - POSIX_FADV_DONTNEED   - the range will not be accessed soon
+*/
+
+#define _SEEK_SET  0              // SEEK_SET - relative to the start of the file
+#define _SEEK_CUR  1              // SEEK_CUR - relative to the current position
+#define _SEEK_END  2              // SEEK_END - relative to the end of the file
+
+#define _POSIX_FADV_NORMAL      0 // POSIX_FADV_NORMAL     - no special treatment
+#define _POSIX_FADV_RANDOM      1 // POSIX_FADV_RANDOM     - expect random access
+#define _POSIX_FADV_SEQUENTIAL  2 // POSIX_FADV_SEQUENTIAL - expect sequential access
+#define _POSIX_FADV_WILLNEED    3 // POSIX_FADV_WILLNEED   - the range will be accessed soon
+#define _POSIX_FADV_DONTNEED    4 // POSIX_FADV_DONTNEED   - the range will not be accessed soon
+
+/**
+ * Macros for moving data between file descriptors.
+ * 
+ * Splice flags:
+ * - SPLICE_F_MOVE     - move pages instead of copying them
+ * - SPLICE_F_NONBLOCK - do not block on the pipe
+ * - SPLICE_F_MORE     - more data will follow
+ * 
+ * Ioctl requests:
+ * - FICLONE - share the data blocks of a whole file (reflink)
+*/
+
+#define _SPLICE_F_MOVE      0x01       // SPLICE_F_MOVE     - move pages instead of copying them
+#define _SPLICE_F_NONBLOCK  0x02       // SPLICE_F_NONBLOCK - do not block on the pipe
+#define _SPLICE_F_MORE      0x04       // SPLICE_F_MORE     - more data will follow
+
+#define _FICLONE            0x40049409 // FICLONE           - share the data blocks of a whole file
+
+/**
+ * Macros for memory mappings.
+ * 
+ * Protection:
+ * - PROT_NONE      - pages can not be accessed
+ * - PROT_READ      - pages can be read
+ * - PROT_WRITE     - pages can be written
+ * - PROT_EXEC      - pages can be executed
+ * 
+ * Flags:
+ * - MAP_SHARED     - changes are visible to other mappings of the file
+ * - MAP_PRIVATE    - copy-on-write mapping
+ * - MAP_FIXED      - place the mapping exactly at the given address
+ * - MAP_ANONYMOUS  - mapping is not backed by any file
+ * - MAP_NORESERVE  - do not reserve swap space
+ * - MAP_POPULATE   - prefault the pages
+*/
+
+#define _PROT_NONE      0x0       // PROT_NONE      - pages can not be accessed
+#define _PROT_READ      0x1       // PROT_READ      - pages can be read
+#define _PROT_WRITE     0x2       // PROT_WRITE     - pages can be written
+#define _PROT_EXEC      0x4       // PROT_EXEC      - pages can be executed
+
+#define _MAP_SHARED     0x0001    // MAP_SHARED     - changes are visible to other mappings
+#define _MAP_PRIVATE    0x0002    // MAP_PRIVATE    - copy-on-write mapping
+#define _MAP_FIXED      0x0010    // MAP_FIXED      - place the mapping at the given address
+#define _MAP_ANONYMOUS  0x0020    // MAP_ANONYMOUS  - mapping is not backed by any file
+#define _MAP_NORESERVE  0x4000    // MAP_NORESERVE  - do not reserve swap space
+#define _MAP_POPULATE   0x8000    // MAP_POPULATE   - prefault the pages
+
+/**
+ * Macros for memory advice and remapping.
+ * 
+ * Advice:
+ * - MADV_NORMAL     - no special treatment
+ * - MADV_RANDOM     - expect random page references
+ * - MADV_SEQUENTIAL - expect sequential page references
+ * - MADV_WILLNEED   - expect access in the near future (read ahead)
+ * - MADV_DONTNEED   - do not expect access, pages can be freed
+ * - MADV_FREE       - pages can be freed lazily, when memory is short
+ * - MADV_HUGEPAGE   - back the range with transparent huge pages
+ * - MADV_NOHUGEPAGE - do not back the range with huge pages
+ * - MADV_POPULATE_WRITE - prefault the pages writable
+ * 
+ * Remap flags:
+ * - MREMAP_MAYMOVE  - the mapping can be moved to a new address
+ * - MREMAP_FIXED    - the mapping is moved to new_addr
+*/
+
+#define _MADV_NORMAL      0       // MADV_NORMAL     - no special treatment
+#define _MADV_RANDOM      1       // MADV_RANDOM     - expect random page references
+#define _MADV_SEQUENTIAL  2       // MADV_SEQUENTIAL - expect sequential page references
+#define _MADV_WILLNEED    3       // MADV_WILLNEED   - expect access in the near future
+#define _MADV_DONTNEED    4       // MADV_DONTNEED   - do not expect access
+#define _MADV_FREE        8       // MADV_FREE       - pages can be freed lazily
+#define _MADV_HUGEPAGE    14      // MADV_HUGEPAGE   - use transparent huge pages
+#define _MADV_NOHUGEPAGE  15      // MADV_NOHUGEPAGE - do not use huge pages
+#define _MADV_POPULATE_WRITE 23   // MADV_POPULATE_WRITE - prefault the pages writable
+
+#define _MREMAP_MAYMOVE   1       // MREMAP_MAYMOVE  - the mapping can be moved
+#define _MREMAP_FIXED     2       // MREMAP_FIXED    - the mapping is moved to new_addr
+
+/**
+ * Macros for the getrandom flags.
+ * 
+ * - GRND_NONBLOCK - fail with EAGAIN instead of blocking
+ *                   before the entropy pool is ready
+ * - GRND_RANDOM   - take the bytes from the blocking pool
+ * - GRND_INSECURE - do not wait for the pool (Linux 5.6)
+*/
+
+#define _GRND_NONBLOCK    1       // GRND_NONBLOCK - do not block
+#define _GRND_RANDOM      2       // GRND_RANDOM   - use the blocking pool
+#define _GRND_INSECURE    4       // GRND_INSECURE - do not wait for the pool
+
+/**
+ * Macros for the futex operations.
+ * 
+ * - FUTEX_WAIT         - sleep while the futex holds the value
+ * - FUTEX_WAKE         - wake up sleeping threads
+ * - FUTEX_REQUEUE      - wake up threads, move the rest to another futex
+ * - FUTEX_CMP_REQUEUE  - FUTEX_REQUEUE if the futex holds the value
+ * - FUTEX_WAIT_BITSET  - FUTEX_WAIT with an absolute timeout
+ * - FUTEX_PRIVATE_FLAG - the futex is not shared between processes
+ * - FUTEX_CLOCK_REALTIME - the timeout is on the realtime clock
+*/
+
+#define _FUTEX_WAIT           0       // FUTEX_WAIT        - wait for a wake up
+#define _FUTEX_WAKE           1       // FUTEX_WAKE        - wake up waiters
+#define _FUTEX_REQUEUE        3       // FUTEX_REQUEUE     - move waiters
+#define _FUTEX_CMP_REQUEUE    4       // FUTEX_CMP_REQUEUE - move waiters if the value matches
+#define _FUTEX_WAIT_BITSET    9       // FUTEX_WAIT_BITSET - wait with an absolute timeout
+#define _FUTEX_PRIVATE_FLAG   128     // FUTEX_PRIVATE_FLAG   - process-private futex
+#define _FUTEX_CLOCK_REALTIME 256     // FUTEX_CLOCK_REALTIME - realtime clock timeout
+
+/**
+ * Macros for the fcntl commands.
+ * 
+ * - F_GETFL - get the status flags (_O_NONBLOCK, _O_APPEND)
+ * - F_SETFL - set the status flags
+*/
+
+#define _F_GETFL              3           // F_GETFL - get the status flags
+#define _F_SETFL              4           // F_SETFL - set the status flags
+
+/**
+ * Macros for epoll.
+ * 
+ * - EPOLL_CLOEXEC - close the instance on exec
+ * - EPOLL_CTL_ADD - add a file descriptor
+ * - EPOLL_CTL_DEL - remove a file descriptor
+ * - EPOLL_CTL_MOD - change the events of a file descriptor
+ * - EPOLLIN       - ready for reading
+ * - EPOLLOUT      - ready for writing
+ * - EPOLLERR      - an error happened (always reported)
+ * - EPOLLHUP      - the other end hung up (always reported)
+ * - EPOLLRDHUP    - the peer closed its writing end
+ * - EPOLLET       - report the changes of the state only
+*/
+
+#define _EPOLL_CLOEXEC        0x80000     // EPOLL_CLOEXEC - close on exec
+#define _EPOLL_CTL_ADD        1           // EPOLL_CTL_ADD - add a file descriptor
+#define _EPOLL_CTL_DEL        2           // EPOLL_CTL_DEL - remove a file descriptor
+#define _EPOLL_CTL_MOD        3           // EPOLL_CTL_MOD - change the events
+#define _EPOLLIN              0x001       // EPOLLIN       - ready for reading
+#define _EPOLLOUT             0x004       // EPOLLOUT      - ready for writing
+#define _EPOLLERR             0x008       // EPOLLERR      - error
+#define _EPOLLHUP             0x010       // EPOLLHUP      - hang up
+#define _EPOLLRDHUP           0x2000      // EPOLLRDHUP    - peer closed its writing end
+#define _EPOLLET              0x80000000U // EPOLLET       - edge triggered
+
+/**
+ * Macros for the timerfd and eventfd flags.
+ * 
+ * - TFD_NONBLOCK      - reads of the timer do not block
+ * - TFD_CLOEXEC       - close the timer on exec
+ * - TFD_TIMER_ABSTIME - the expiration is an absolute time
+ * - EFD_NONBLOCK      - reads of the counter do not block
+ * - EFD_CLOEXEC       - close the counter on exec
+*/
+
+#define _TFD_NONBLOCK         0x0800      // TFD_NONBLOCK      - do not block
+#define _TFD_CLOEXEC          0x80000     // TFD_CLOEXEC       - close on exec
+#define _TFD_TIMER_ABSTIME    1           // TFD_TIMER_ABSTIME - absolute expiration
+#define _EFD_NONBLOCK         0x0800      // EFD_NONBLOCK      - do not block
+#define _EFD_CLOEXEC          0x80000     // EFD_CLOEXEC       - close on exec
+
+/**
+ * _stat_t - file status, as filled by the fstat64 syscall.
+ * 
+ * RawC uses mainly the size and the mode of the file,
+ * the layout has to match the kernel structure.
+*/
+typedef struct {
+    unsigned long long st_dev;
+    unsigned char      __pad0[4];
+    unsigned long      __st_ino;
+    unsigned int       st_mode;
+    unsigned int       st_nlink;
+    unsigned long      st_uid;
+    unsigned long      st_gid;
+    unsigned long long st_rdev;
+    unsigned char      __pad3[4];
+    long long          st_size;
+    unsigned long      st_blksize;
+    unsigned long long st_blocks;
+    unsigned long      st_atime_sec;
+    unsigned long      st_atime_nsec;
+    unsigned long      st_mtime_sec;
+    unsigned long      st_mtime_nsec;
+    unsigned long      st_ctime_sec;
+    unsigned long      st_ctime_nsec;
+    unsigned long long st_ino;
+} _stat_t;
+
+/**
+ * _iovec - a buffer of a vectored read or write
+ *          (writev, io_uring buffers).
+ * 
+ * @param base address of the buffer
+ * @param len length of the buffer
+*/
+typedef struct {
+    void *base;
+    unsigned long len;
+} _iovec;
+
+/**
+ * _epoll_event_t - an event of an epoll instance.
+ * 
+ * It is 16 bytes, the data is aligned to 8 bytes on ARM EABI.
+ * 
+ * @param events - the events (_EPOLL*)
+ * @param data - returned with the events of the file descriptor
+*/
+typedef struct {
+    unsigned int events;
+    unsigned long long data;
+} _epoll_event_t;
+
 /**
  * Syscall definitions
  * 
@@ -53,25 +301,93 @@
  * 
  * Syscalls we are going to use:
  * 
- * | Syscall    | Numer | Arguments |
- * | ---------  | ----- | --------- |
- * | SYS_READ   | 63    | 3         |
- * | SYS_WRITE  | 64    | 3         |
- * | SYS_OPEN   | 5     | 3         |
- * | SYS_CLOSE  | 6     | 1         |
- * | SYS_EXIT   | 93    | 1         |
- * | SYS_RENAME | 128   | 2         |
+ * | Syscall               | Numer | Arguments |
+ * | --------------------- | ----- | --------- |
+ * | SYS_READ              | 63    | 3         |
+ * | SYS_WRITE             | 64    | 3         |
+ * | SYS_OPEN              | 5     | 3         |
+ * | SYS_CLOSE             | 6     | 1         |
+ * | SYS_EXIT              | 93    | 1         |
+ * | SYS_RENAME            | 128   | 2         |
+ * | SYS_CLOCK_GETTIME     | 263   | 2         |
+ * | SYS_GETTIMEOFDAY      | 78    | 2         |
+ * | SYS_GETCPU            | 345   | 3         |
+ * | SYS_MMAP2             | 192   | 6         |
+ * | SYS_MUNMAP            | 91    | 2         |
+ * | SYS_IO_URING_SETUP    | 425   | 2         |
+ * | SYS_IO_URING_ENTER    | 426   | 6         |
+ * | SYS_IO_URING_REGISTER | 427   | 4         |
+ * | SYS_FSTAT64           | 197   | 2         |
+ * | SYS_MREMAP            | 163   | 5         |
+ * | SYS_MADVISE           | 220   | 3         |
+ * | SYS_LLSEEK            | 140   | 5         |
+ * | SYS_PREAD64           | 180   | 6         |
+ * | SYS_PWRITE64          | 181   | 6         |
+ * | SYS_READAHEAD         | 225   | 5         |
+ * | SYS_ARM_FADVISE64_64  | 270   | 6         |
+ * | SYS_IOCTL             | 54    | 3         |
+ * | SYS_SENDFILE64        | 239   | 4         |
+ * | SYS_SPLICE            | 340   | 6         |
+ * | SYS_TEE               | 342   | 4         |
+ * | SYS_PIPE2             | 359   | 2         |
+ * | SYS_COPY_FILE_RANGE   | 391   | 6         |
+ * | SYS_GETRANDOM         | 384   | 3         |
+ * | SYS_FUTEX             | 240   | 6         |
+ * | SYS_SCHED_GETAFFINITY | 242   | 3         |
+ * | SYS_WRITEV            | 146   | 3         |
+ * | SYS_FCNTL             | 55    | 3         |
+ * | SYS_EPOLL_CREATE1     | 357   | 1         |
+ * | SYS_EPOLL_CTL         | 251   | 4         |
+ * | SYS_EPOLL_WAIT        | 252   | 4         |
+ * | SYS_TIMERFD_CREATE    | 350   | 2         |
+ * | SYS_TIMERFD_SETTIME   | 353   | 4         |
+ * | SYS_TIMERFD_GETTIME   | 354   | 2         |
+ * | SYS_EVENTFD2          | 356   | 2         |
  * 
  * You can find the list of all syscalls here:
  *  https://chromium.googlesource.com/chromiumos/docs/+/master/constants/syscalls.md
 */
 
-#define __SYS_READ__   63
-#define __SYS_WRITE__  64
-#define __SYS_OPEN__   5
-#define __SYS_CLOSE__  6
-#define __SYS_EXIT__   93
-#define __SYS_RENAME__ 128
+#define __SYS_READ__              63
+#define __SYS_WRITE__             64
+#define __SYS_OPEN__              5
+#define __SYS_CLOSE__             6
+#define __SYS_EXIT__              93
+#define __SYS_RENAME__            128
+#define __SYS_CLOCK_GETTIME__     263
+#define __SYS_GETTIMEOFDAY__      78
+#define __SYS_GETCPU__            345
+#define __SYS_MMAP2__             192
+#define __SYS_MUNMAP__            91
+#define __SYS_IO_URING_SETUP__    425
+#define __SYS_IO_URING_ENTER__    426
+#define __SYS_IO_URING_REGISTER__ 427
+#define __SYS_FSTAT64__           197
+#define __SYS_MREMAP__            163
+#define __SYS_MADVISE__           220
+#define __SYS_LLSEEK__            140
+#define __SYS_PREAD64__           180
+#define __SYS_PWRITE64__          181
+#define __SYS_READAHEAD__         225
+#define __SYS_ARM_FADVISE64_64__  270
+#define __SYS_IOCTL__             54
+#define __SYS_SENDFILE64__        239
+#define __SYS_SPLICE__            340
+#define __SYS_TEE__               342
+#define __SYS_PIPE2__             359
+#define __SYS_COPY_FILE_RANGE__   391
+#define __SYS_GETRANDOM__         384
+#define __SYS_FUTEX__             240
+#define __SYS_SCHED_GETAFFINITY__ 242
+#define __SYS_WRITEV__            146
+#define __SYS_FCNTL__             55
+#define __SYS_EPOLL_CREATE1__     357
+#define __SYS_EPOLL_CTL__         251
+#define __SYS_EPOLL_WAIT__        252
+#define __SYS_TIMERFD_CREATE__    350
+#define __SYS_TIMERFD_SETTIME__   353
+#define __SYS_TIMERFD_GETTIME__   354
+#define __SYS_EVENTFD2__          356
 
 /**
  * Read from a file descriptor.
@@ -248,4 +564,1380 @@ int sys_close(int fd) {
     return (int)ret;
 }
 
+/**
+ * Get the time of the given clock.
+ * 
+ * @param clock - clock identifier
+ * @param ts - timespec structure to fill
+ * 
+ * @return - 0 on success, or an error code
+*/
+long long sys_clock_gettime(int clock, void *ts) {
+    /**
+     * Call the syscall for reading a clock with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - clock identifier
+     * @param r1  - timespec address
+    */
+    register long r7 asm("r7") = __SYS_CLOCK_GETTIME__;
+    register long r0 asm("r0") = clock;
+    register long r1 asm("r1") = (long)ts;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Get the wall clock time in microseconds precision.
+ * 
+ * @param tv - timeval structure to fill
+ * @param tz - timezone structure to fill (can be NULL)
+ * 
+ * @return - 0 on success, or an error code
+*/
+long long sys_gettimeofday(void *tv, void *tz) {
+    /**
+     * Call the syscall for reading the wall clock with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - timeval address
+     * @param r1  - timezone address
+    */
+    register long r7 asm("r7") = __SYS_GETTIMEOFDAY__;
+    register long r0 asm("r0") = (long)tv;
+    register long r1 asm("r1") = (long)tz;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Determine the CPU and NUMA node the calling thread is running on.
+ * 
+ * @param cpu - where to store the CPU number (can be NULL)
+ * @param node - where to store the NUMA node number (can be NULL)
+ * @param cache - unused since Linux 2.6.24, pass NULL
+ * 
+ * @return - 0 on success, or an error code
+*/
+long long sys_getcpu(unsigned *cpu, unsigned *node, void *cache) {
+    /**
+     * Call the syscall for reading the current CPU with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - cpu address
+     * @param r1  - node address
+     * @param r2  - cache address
+    */
+    register long r7 asm("r7") = __SYS_GETCPU__;
+    register long r0 asm("r0") = (long)cpu;
+    register long r1 asm("r1") = (long)node;
+    register long r2 asm("r2") = (long)cache;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2
+        : "r"(r7), "r"(r1), "r"(r2)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Map files or anonymous memory into the address space.
+ * 
+ * ARM has no 64-bit offset mmap, the mmap2 syscall
+ * takes the offset in pages of 4096 bytes instead.
+ * 
+ * @param addr - hint for the address of the mapping (can be NULL)
+ * @param length - length of the mapping
+ * @param prot - memory protection (_PROT_*)
+ * @param flags - mapping flags (_MAP_*)
+ * @param fd - file descriptor to map, or -1
+ * @param offset - offset in the file, multiple of the page size
+ * 
+ * @return - address of the mapping, or an error code
+*/
+long long sys_mmap(void *addr, unsigned long long length, int prot, int flags, int fd, long long offset) {
+    /**
+     * Call the mmap2 syscall with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - address hint
+     * @param r1  - length
+     * @param r2  - protection
+     * @param r3  - flags
+     * @param r4  - file descriptor
+     * @param r5  - offset in pages
+    */
+    register long r7 asm("r7") = __SYS_MMAP2__;
+    register long r0 asm("r0") = (long)addr;
+    register long r1 asm("r1") = (long)length;
+    register long r2 asm("r2") = prot;
+    register long r3 asm("r3") = flags;
+    register long r4 asm("r4") = fd;
+    register long r5 asm("r5") = (long)(offset >> 12);
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    // addresses in the upper half are valid mappings,
+    // only the last page of values are error codes
+    if ((unsigned long)r0 > -4096UL) return r0;
+    return (unsigned long)r0;
+}
+
+/**
+ * Unmap a memory mapping.
+ * 
+ * @param addr - address of the mapping
+ * @param length - length of the mapping
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_munmap(void *addr, unsigned long long length) {
+    /**
+     * Call the syscall for unmapping memory with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - address of the mapping
+     * @param r1  - length
+    */
+    register long r7 asm("r7") = __SYS_MUNMAP__;
+    register long r0 asm("r0") = (long)addr;
+    register long r1 asm("r1") = (long)length;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Create an io_uring instance.
+ * 
+ * @param entries - requested number of submission queue entries
+ * @param params - setup parameters, filled with the ring offsets
+ * 
+ * @return - file descriptor of the ring, or an error code
+*/
+int sys_io_uring_setup(unsigned entries, void *params) {
+    /**
+     * Call the syscall for creating an io_uring with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - number of entries
+     * @param r1  - parameters address
+    */
+    register long r7 asm("r7") = __SYS_IO_URING_SETUP__;
+    register long r0 asm("r0") = entries;
+    register long r1 asm("r1") = (long)params;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Submit queued requests and/or wait for completions of an io_uring.
+ * 
+ * @param fd - file descriptor of the ring
+ * @param to_submit - number of requests to submit
+ * @param min_complete - number of completions to wait for
+ * @param flags - enter flags (_IORING_ENTER_*)
+ * @param sig - signal mask to use while waiting (can be NULL)
+ * @param sigsz - size of the signal mask
+ * 
+ * @return - number of submitted requests, or an error code
+*/
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void *sig, unsigned long long sigsz) {
+    /**
+     * Call the syscall for entering an io_uring with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - ring file descriptor
+     * @param r1  - number of requests to submit
+     * @param r2  - number of completions to wait for
+     * @param r3  - flags
+     * @param r4  - signal mask address
+     * @param r5  - signal mask size
+    */
+    register long r7 asm("r7") = __SYS_IO_URING_ENTER__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = to_submit;
+    register long r2 asm("r2") = min_complete;
+    register long r3 asm("r3") = flags;
+    register long r4 asm("r4") = (long)sig;
+    register long r5 asm("r5") = (long)sigsz;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Register resources (buffers, files) with an io_uring.
+ * 
+ * @param fd - file descriptor of the ring
+ * @param opcode - what to register (_IORING_REGISTER_*)
+ * @param arg - resources to register
+ * @param nr_args - number of resources
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    /**
+     * Call the syscall for registering resources with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - ring file descriptor
+     * @param r1  - opcode
+     * @param r2  - resources address
+     * @param r3  - number of resources
+    */
+    register long r7 asm("r7") = __SYS_IO_URING_REGISTER__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = opcode;
+    register long r2 asm("r2") = (long)arg;
+    register long r3 asm("r3") = nr_args;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Get the information about an open file.
+ * 
+ * The fstat64 syscall is used, so the size of
+ * files over 2 GB is reported correctly.
+ * 
+ * @param fd - file descriptor
+ * @param st - stat structure to fill
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_fstat(int fd, _stat_t *st) {
+    /**
+     * Call the syscall for reading the file status with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - stat structure address
+    */
+    register long r7 asm("r7") = __SYS_FSTAT64__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = (long)st;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Grow, shrink or move a memory mapping.
+ * 
+ * @param addr - address of the mapping
+ * @param old_size - current length of the mapping
+ * @param new_size - wanted length of the mapping
+ * @param flags - remap flags (_MREMAP_*)
+ * @param new_addr - new address, only with _MREMAP_FIXED
+ * 
+ * @return - address of the mapping, or an error code
+*/
+long long sys_mremap(void *addr, unsigned long long old_size, unsigned long long new_size, int flags, void *new_addr) {
+    /**
+     * Call the syscall for remapping memory with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - address of the mapping
+     * @param r1  - current length
+     * @param r2  - wanted length
+     * @param r3  - flags
+     * @param r4  - new address
+    */
+    register long r7 asm("r7") = __SYS_MREMAP__;
+    register long r0 asm("r0") = (long)addr;
+    register long r1 asm("r1") = (long)old_size;
+    register long r2 asm("r2") = (long)new_size;
+    register long r3 asm("r3") = flags;
+    register long r4 asm("r4") = (long)new_addr;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4)
+        : "memory"
+    );
+
+    if ((unsigned long)r0 > -4096UL) return r0;
+    return (unsigned long)r0;
+}
+
+/**
+ * Give the kernel advice about the use of memory.
+ * 
+ * @param addr - start of the range, page aligned
+ * @param length - length of the range
+ * @param advice - the advice (_MADV_*)
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_madvise(void *addr, unsigned long long length, int advice) {
+    /**
+     * Call the syscall for advising about memory with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - start of the range
+     * @param r1  - length
+     * @param r2  - advice
+    */
+    register long r7 asm("r7") = __SYS_MADVISE__;
+    register long r0 asm("r0") = (long)addr;
+    register long r1 asm("r1") = (long)length;
+    register long r2 asm("r2") = advice;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2
+        : "r"(r7), "r"(r1), "r"(r2)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Move the file position of a file descriptor.
+ * 
+ * The _llseek syscall is used, it takes the 64-bit
+ * offset in two registers and stores the result in
+ * memory, so files over 2 GB can be used.
+ * 
+ * @param fd - file descriptor
+ * @param offset - offset relative to whence
+ * @param whence - _SEEK_SET, _SEEK_CUR or _SEEK_END
+ * 
+ * @return - the new file position, or an error code
+*/
+long long sys_lseek(int fd, long long offset, int whence) {
+    long long result;
+
+    /**
+     * Call the syscall for seeking with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - high 32 bits of the offset
+     * @param r2  - low 32 bits of the offset
+     * @param r3  - result address
+     * @param r4  - whence
+    */
+    register long r7 asm("r7") = __SYS_LLSEEK__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = (long)(offset >> 32);
+    register long r2 asm("r2") = (long)offset;
+    register long r3 asm("r3") = (long)&result;
+    register long r4 asm("r4") = whence;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4)
+        : "memory"
+    );
+
+    return r0 < 0 ? r0 : result;
+}
+
+/**
+ * Read from a file descriptor at the given offset,
+ * without changing the file position.
+ * 
+ * The 64-bit offset has to start in an even register,
+ * so R3 is left unused.
+ * 
+ * @param fd - file descriptor
+ * @param buf - buffer to store read data
+ * @param size - number of bytes to read
+ * @param offset - offset in the file
+ * 
+ * @return - number of bytes read, or an error code
+*/
+long long sys_pread64(int fd, void *buf, unsigned long long size, long long offset) {
+    /**
+     * Call the syscall for positional reading with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - buffer address
+     * @param r2  - size
+     * @param r4  - low 32 bits of the offset
+     * @param r5  - high 32 bits of the offset
+    */
+    register long r7 asm("r7") = __SYS_PREAD64__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = (long)buf;
+    register long r2 asm("r2") = (long)size;
+    register long r4 asm("r4") = (long)offset;
+    register long r5 asm("r5") = (long)(offset >> 32);
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Write to a file descriptor at the given offset,
+ * without changing the file position.
+ * 
+ * @param fd - file descriptor
+ * @param buf - buffer containing data to write
+ * @param size - number of bytes to write
+ * @param offset - offset in the file
+ * 
+ * @return - number of bytes written, or an error code
+*/
+long long sys_pwrite64(int fd, const void *buf, unsigned long long size, long long offset) {
+    /**
+     * Call the syscall for positional writing with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - buffer address
+     * @param r2  - size
+     * @param r4  - low 32 bits of the offset
+     * @param r5  - high 32 bits of the offset
+    */
+    register long r7 asm("r7") = __SYS_PWRITE64__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = (long)buf;
+    register long r2 asm("r2") = (long)size;
+    register long r4 asm("r4") = (long)offset;
+    register long r5 asm("r5") = (long)(offset >> 32);
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Read the given range of a file into the page cache.
+ * 
+ * @param fd - file descriptor
+ * @param offset - start of the range
+ * @param count - length of the range
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_readahead(int fd, long long offset, unsigned long long count) {
+    /**
+     * Call the syscall for reading ahead with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r2  - low 32 bits of the offset
+     * @param r3  - high 32 bits of the offset
+     * @param r4  - count
+    */
+    register long r7 asm("r7") = __SYS_READAHEAD__;
+    register long r0 asm("r0") = fd;
+    register long r2 asm("r2") = (long)offset;
+    register long r3 asm("r3") = (long)(offset >> 32);
+    register long r4 asm("r4") = (long)count;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R2        R3        R4
+        : "r"(r7), "r"(r2), "r"(r3), "r"(r4)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Announce the access pattern for a range of a file.
+ * 
+ * ARM has its own version of the syscall, with the
+ * advice moved before the 64-bit arguments.
+ * 
+ * @param fd - file descriptor
+ * @param offset - start of the range
+ * @param len - length of the range, 0 means until the end of the file
+ * @param advice - the advice (_POSIX_FADV_*)
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_fadvise64(int fd, long long offset, long long len, int advice) {
+    /**
+     * Call the arm_fadvise64_64 syscall with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - advice
+     * @param r2  - low 32 bits of the offset
+     * @param r3  - high 32 bits of the offset
+     * @param r4  - low 32 bits of the length
+     * @param r5  - high 32 bits of the length
+    */
+    register long r7 asm("r7") = __SYS_ARM_FADVISE64_64__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = advice;
+    register long r2 asm("r2") = (long)offset;
+    register long r3 asm("r3") = (long)(offset >> 32);
+    register long r4 asm("r4") = (long)len;
+    register long r5 asm("r5") = (long)(len >> 32);
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Control a device or a file.
+ * 
+ * @param fd - file descriptor
+ * @param cmd - request code
+ * @param arg - argument of the request
+ * 
+ * @return - result of the request, or an error code
+*/
+int sys_ioctl(int fd, unsigned long cmd, unsigned long arg) {
+    /**
+     * Call the syscall for device control with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - request code
+     * @param r2  - argument
+    */
+    register long r7 asm("r7") = __SYS_IOCTL__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = (long)cmd;
+    register long r2 asm("r2") = (long)arg;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2
+        : "r"(r7), "r"(r1), "r"(r2)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Copy data between file descriptors inside the kernel.
+ * 
+ * The sendfile64 syscall is used, it takes a 64-bit offset.
+ * 
+ * @param out_fd - file descriptor to write to
+ * @param in_fd - file descriptor to read from (must support mmap)
+ * @param offset - where to read from, updated after the call
+ *                 (NULL reads from the file position)
+ * @param count - number of bytes to copy
+ * 
+ * @return - number of bytes copied, or an error code
+*/
+long long sys_sendfile(int out_fd, int in_fd, long long *offset, unsigned long long count) {
+    /**
+     * Call the syscall for sending a file with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - output file descriptor
+     * @param r1  - input file descriptor
+     * @param r2  - offset address
+     * @param r3  - count
+    */
+    register long r7 asm("r7") = __SYS_SENDFILE64__;
+    register long r0 asm("r0") = out_fd;
+    register long r1 asm("r1") = in_fd;
+    register long r2 asm("r2") = (long)offset;
+    register long r3 asm("r3") = (long)count;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Move data between a file descriptor and a pipe
+ * without copying it through user space.
+ * 
+ * @param fd_in - file descriptor to read from
+ * @param off_in - where to read from (NULL for pipes and the file position)
+ * @param fd_out - file descriptor to write to
+ * @param off_out - where to write to (NULL for pipes and the file position)
+ * @param len - number of bytes to move
+ * @param flags - _SPLICE_F_* flags
+ * 
+ * @return - number of bytes moved, or an error code
+*/
+long long sys_splice(int fd_in, long long *off_in, int fd_out, long long *off_out, unsigned long long len, unsigned flags) {
+    /**
+     * Call the syscall for splicing with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - input file descriptor
+     * @param r1  - input offset address
+     * @param r2  - output file descriptor
+     * @param r3  - output offset address
+     * @param r4  - length
+     * @param r5  - flags
+    */
+    register long r7 asm("r7") = __SYS_SPLICE__;
+    register long r0 asm("r0") = fd_in;
+    register long r1 asm("r1") = (long)off_in;
+    register long r2 asm("r2") = fd_out;
+    register long r3 asm("r3") = (long)off_out;
+    register long r4 asm("r4") = (long)len;
+    register long r5 asm("r5") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Duplicate the data of a pipe into another pipe
+ * without consuming it.
+ * 
+ * @param fd_in - pipe to read from
+ * @param fd_out - pipe to write to
+ * @param len - number of bytes to duplicate
+ * @param flags - _SPLICE_F_* flags
+ * 
+ * @return - number of bytes duplicated, or an error code
+*/
+long long sys_tee(int fd_in, int fd_out, unsigned long long len, unsigned flags) {
+    /**
+     * Call the syscall for duplicating pipe data with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - input pipe
+     * @param r1  - output pipe
+     * @param r2  - length
+     * @param r3  - flags
+    */
+    register long r7 asm("r7") = __SYS_TEE__;
+    register long r0 asm("r0") = fd_in;
+    register long r1 asm("r1") = fd_out;
+    register long r2 asm("r2") = (long)len;
+    register long r3 asm("r3") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Create a pipe.
+ * 
+ * @param fds - where to store the read end and the write end
+ * @param flags - _O_CLOEXEC, _O_NONBLOCK
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_pipe2(int *fds, int flags) {
+    /**
+     * Call the syscall for creating a pipe with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptors address
+     * @param r1  - flags
+    */
+    register long r7 asm("r7") = __SYS_PIPE2__;
+    register long r0 asm("r0") = (long)fds;
+    register long r1 asm("r1") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Copy a range of a file to another file inside the kernel.
+ * 
+ * File systems which support it share the data
+ * blocks (reflink) instead of copying them.
+ * 
+ * @param fd_in - file descriptor to read from
+ * @param off_in - where to read from (NULL for the file position)
+ * @param fd_out - file descriptor to write to
+ * @param off_out - where to write to (NULL for the file position)
+ * @param len - number of bytes to copy
+ * @param flags - must be 0
+ * 
+ * @return - number of bytes copied, or an error code
+*/
+long long sys_copy_file_range(int fd_in, long long *off_in, int fd_out, long long *off_out, unsigned long long len, unsigned flags) {
+    /**
+     * Call the syscall for copying a file range with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - input file descriptor
+     * @param r1  - input offset address
+     * @param r2  - output file descriptor
+     * @param r3  - output offset address
+     * @param r4  - length
+     * @param r5  - flags
+    */
+    register long r7 asm("r7") = __SYS_COPY_FILE_RANGE__;
+    register long r0 asm("r0") = fd_in;
+    register long r1 asm("r1") = (long)off_in;
+    register long r2 asm("r2") = fd_out;
+    register long r3 asm("r3") = (long)off_out;
+    register long r4 asm("r4") = (long)len;
+    register long r5 asm("r5") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Fill a buffer with random bytes from the kernel.
+ * 
+ * @param buf - buffer to fill
+ * @param size - number of bytes
+ * @param flags - _GRND_* flags, or 0
+ * 
+ * @return - number of bytes written, or an error code
+*/
+long long sys_getrandom(void *buf, unsigned long long size, unsigned int flags) {
+    /**
+     * Call the syscall for getting random bytes with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - buffer address
+     * @param r1  - size
+     * @param r2  - flags
+    */
+    register long r7 asm("r7") = __SYS_GETRANDOM__;
+    register long r0 asm("r0") = (long)buf;
+    register long r1 asm("r1") = (long)size;
+    register long r2 asm("r2") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2
+        : "r"(r7), "r"(r1), "r"(r2)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Wait on or wake up a futex (fast userspace mutex).
+ * 
+ * @param uaddr - address of the futex word
+ * @param op - operation (_FUTEX_*), with _FUTEX_PRIVATE_FLAG
+ *             for futexes not shared between processes
+ * @param val - expected value (wait) or number of threads (wake)
+ * @param timeout - relative timeout of a wait (_timespec), or NULL
+ * @param uaddr2 - second futex of the requeue operations
+ * @param val3 - value compared by _FUTEX_CMP_REQUEUE, or the bitset
+ * 
+ * @return - number of woken threads (wake), 0 (wait), or an error code
+*/
+long long sys_futex(unsigned int *uaddr, int op, unsigned int val, const void *timeout, unsigned int *uaddr2, unsigned int val3) {
+    /**
+     * Call the syscall for a futex operation with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - futex address
+     * @param r1  - operation
+     * @param r2  - value
+     * @param r3  - timeout address
+     * @param r4  - second futex address
+     * @param r5  - third value
+    */
+    register long r7 asm("r7") = __SYS_FUTEX__;
+    register long r0 asm("r0") = (long)uaddr;
+    register long r1 asm("r1") = op;
+    register long r2 asm("r2") = val;
+    register long r3 asm("r3") = (long)timeout;
+    register long r4 asm("r4") = (long)uaddr2;
+    register long r5 asm("r5") = val3;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3        R4        R5
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3), "r"(r4), "r"(r5)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Get the CPU affinity mask of a thread.
+ * 
+ * @param pid - thread ID, 0 for the calling thread
+ * @param size - size of the mask buffer in bytes
+ * @param mask - buffer receiving the mask, one bit per CPU
+ * 
+ * @return - size of the mask written by the kernel, or an error code
+*/
+long long sys_sched_getaffinity(int pid, unsigned long long size, void *mask) {
+    /**
+     * Call the syscall for getting the CPU affinity with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - thread ID
+     * @param r1  - size of the mask
+     * @param r2  - mask address
+    */
+    register long r7 asm("r7") = __SYS_SCHED_GETAFFINITY__;
+    register long r0 asm("r0") = pid;
+    register long r1 asm("r1") = (long)size;
+    register long r2 asm("r2") = (long)mask;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2
+        : "r"(r7), "r"(r1), "r"(r2)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Write several buffers to a file descriptor.
+ * 
+ * @param fd - file descriptor
+ * @param iov - the buffers (_iovec), written in order
+ * @param iovcnt - number of buffers
+ * 
+ * @return - number of bytes written, or an error code
+*/
+long long sys_writev(int fd, const _iovec *iov, int iovcnt) {
+    /**
+     * Call the syscall for writing several buffers with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - buffers
+     * @param r2  - number of buffers
+    */
+    register long r7 asm("r7") = __SYS_WRITEV__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = (long)iov;
+    register long r2 asm("r2") = iovcnt;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2
+        : "r"(r7), "r"(r1), "r"(r2)
+        : "memory"
+    );
+
+    return r0;
+}
+
+/**
+ * Control a file descriptor.
+ * 
+ * @param fd - file descriptor
+ * @param cmd - command (_F_GETFL, _F_SETFL)
+ * @param arg - argument of the command
+ * 
+ * @return - result of the command, or an error code
+*/
+int sys_fcntl(int fd, int cmd, long arg) {
+    /**
+     * Call the syscall for controlling a file descriptor with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor
+     * @param r1  - command (_F_GETFL, _F_SETFL)
+     * @param r2  - argument of the command
+    */
+    register long r7 asm("r7") = __SYS_FCNTL__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = cmd;
+    register long r2 asm("r2") = arg;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2
+        : "r"(r7), "r"(r1), "r"(r2)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Create an epoll instance.
+ * 
+ * @param flags - _EPOLL_CLOEXEC or 0
+ * 
+ * @return - file descriptor of the instance, or an error code
+*/
+int sys_epoll_create1(int flags) {
+    /**
+     * Call the syscall for creating an epoll instance with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - _EPOLL_CLOEXEC or 0
+    */
+    register long r7 asm("r7") = __SYS_EPOLL_CREATE1__;
+    register long r0 asm("r0") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7
+        : "r"(r7)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Add, modify or remove a file descriptor of an epoll instance.
+ * 
+ * @param epfd - epoll instance
+ * @param op - _EPOLL_CTL_ADD, _EPOLL_CTL_MOD or _EPOLL_CTL_DEL
+ * @param fd - file descriptor
+ * @param event - events to wait for and the data reported with them
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_epoll_ctl(int epfd, int op, int fd, _epoll_event_t *event) {
+    /**
+     * Call the syscall for controlling an epoll instance with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - epoll instance
+     * @param r1  - _EPOLL_CTL_ADD, _EPOLL_CTL_MOD or _EPOLL_CTL_DEL
+     * @param r2  - file descriptor
+     * @param r3  - events to wait for and the data reported with them
+    */
+    register long r7 asm("r7") = __SYS_EPOLL_CTL__;
+    register long r0 asm("r0") = epfd;
+    register long r1 asm("r1") = op;
+    register long r2 asm("r2") = fd;
+    register long r3 asm("r3") = (long)event;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Wait for events on an epoll instance.
+ * 
+ * @param epfd - epoll instance
+ * @param events - where to store the events
+ * @param maxevents - size of events
+ * @param timeout - timeout in milliseconds, -1 to wait forever
+ * 
+ * @return - number of events stored, or an error code
+*/
+int sys_epoll_wait(int epfd, _epoll_event_t *events, int maxevents, int timeout) {
+    /**
+     * Call the syscall for waiting for epoll events with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - epoll instance
+     * @param r1  - where to store the events
+     * @param r2  - size of events
+     * @param r3  - timeout in milliseconds, -1 to wait forever
+    */
+    register long r7 asm("r7") = __SYS_EPOLL_WAIT__;
+    register long r0 asm("r0") = epfd;
+    register long r1 asm("r1") = (long)events;
+    register long r2 asm("r2") = maxevents;
+    register long r3 asm("r3") = timeout;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Create a timer which notifies through a file descriptor.
+ * 
+ * @param clockid - clock of the timer (_CLOCK_MONOTONIC)
+ * @param flags - _TFD_NONBLOCK, _TFD_CLOEXEC
+ * 
+ * @return - file descriptor of the timer, or an error code
+*/
+int sys_timerfd_create(int clockid, int flags) {
+    /**
+     * Call the syscall for creating a timer with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - clock of the timer (_CLOCK_MONOTONIC)
+     * @param r1  - _TFD_NONBLOCK, _TFD_CLOEXEC
+    */
+    register long r7 asm("r7") = __SYS_TIMERFD_CREATE__;
+    register long r0 asm("r0") = clockid;
+    register long r1 asm("r1") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Arm or disarm a timer.
+ * 
+ * The times are an interval and the first expiration,
+ * two _timespec (struct itimerspec), zero disarms.
+ * 
+ * @param fd - file descriptor of the timer
+ * @param flags - _TFD_TIMER_ABSTIME or 0
+ * @param new_value - the new times
+ * @param old_value - where to store the old times, or NULL
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_timerfd_settime(int fd, int flags, const void *new_value, void *old_value) {
+    /**
+     * Call the syscall for arming a timer with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor of the timer
+     * @param r1  - _TFD_TIMER_ABSTIME or 0
+     * @param r2  - the new times
+     * @param r3  - where to store the old times, or NULL
+    */
+    register long r7 asm("r7") = __SYS_TIMERFD_SETTIME__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = flags;
+    register long r2 asm("r2") = (long)new_value;
+    register long r3 asm("r3") = (long)old_value;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1        R2        R3
+        : "r"(r7), "r"(r1), "r"(r2), "r"(r3)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Get the times of a timer.
+ * 
+ * @param fd - file descriptor of the timer
+ * @param curr_value - where to store the interval and the time left
+ * 
+ * @return - 0 on success, or an error code
+*/
+int sys_timerfd_gettime(int fd, void *curr_value) {
+    /**
+     * Call the syscall for getting the times of a timer with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - file descriptor of the timer
+     * @param r1  - where to store the interval and the time left
+    */
+    register long r7 asm("r7") = __SYS_TIMERFD_GETTIME__;
+    register long r0 asm("r0") = fd;
+    register long r1 asm("r1") = (long)curr_value;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Create a file descriptor for event notification.
+ * 
+ * Writes add to a 64-bit counter, a read returns
+ * the counter and resets it.
+ * 
+ * @param initval - initial value of the counter
+ * @param flags - _EFD_NONBLOCK, _EFD_CLOEXEC
+ * 
+ * @return - file descriptor of the counter, or an error code
+*/
+int sys_eventfd2(unsigned int initval, int flags) {
+    /**
+     * Call the syscall for creating an event counter with the following parameters:
+     * 
+     * @param r7  - syscall number
+     * @param r0  - initial value of the counter
+     * @param r1  - _EFD_NONBLOCK, _EFD_CLOEXEC
+    */
+    register long r7 asm("r7") = __SYS_EVENTFD2__;
+    register long r0 asm("r0") = initval;
+    register long r1 asm("r1") = flags;
+
+    asm volatile
+    (
+        "svc #0"
+        : "+r" (r0)
+        //         R7        R1
+        : "r"(r7), "r"(r1)
+        : "memory"
+    );
+
+    return (int)r0;
+}
+
+/**
+ * Context switch of the coroutines (_coro.h).
+ * 
+ * A suspended coroutine is its stack pointer: the
+ * callee-saved registers (r4-r11, and d8-d15 with the
+ * hard-float calling convention) and the return address
+ * are pushed on its stack. The other registers are saved
+ * by the caller of the switch (the C calling convention),
+ * so they are not touched.
+*/
+
+#ifdef __ARM_PCS_VFP
+#define __CORO_VFP 8    // d8-d15, two words each
+#else
+#define __CORO_VFP 0
+#endif
+
+/**
+ * Switch to another stack.
+ * 
+ * Written in assembly at file scope, so the compiler
+ * adds nothing to it (no frame, no stack protector).
+ * It is ARM code, Thumb callers reach it with blx.
+ * 
+ * @param from - where to store the stack pointer of the current context (r0)
+ * @param to - stack pointer of the context to continue (r1)
+*/
+void __coro_switch(void **from, void *to);
+
+/**
+ * First code of a new context, the switch returns here.
+ * 
+ * Calls the entry function (r5) with its argument (r4).
+ * The entry function never returns.
+*/
+void __coro_boot(void);
+
+asm
+(
+    ".pushsection .text\n"
+    ".arm\n"
+    ".align 2\n"
+    ".globl __coro_switch\n"
+    ".type __coro_switch, %function\n"
+    "__coro_switch:\n"
+    "    push {r4-r11, lr}\n"
+#ifdef __ARM_PCS_VFP
+    "    vpush {d8-d15}\n"
+#endif
+    "    str sp, [r0]\n"
+    "    mov sp, r1\n"
+#ifdef __ARM_PCS_VFP
+    "    vpop {d8-d15}\n"
+#endif
+    "    pop {r4-r11, pc}\n"
+    ".size __coro_switch, .-__coro_switch\n"
+
+    ".globl __coro_boot\n"
+    ".type __coro_boot, %function\n"
+    "__coro_boot:\n"
+    "    mov r0, r4\n"
+    "    blx r5\n"
+    "    b .\n"
+    ".size __coro_boot, .-__coro_boot\n"
+    ".popsection\n"
+);
+
+/**
+ * Prepare the stack of a new context.
+ * 
+ * @param top - end of the stack
+ * @param entry - function called first in the context, never returns
+ * @param arg - argument of entry
+ * 
+ * @return - stack pointer to switch to
+*/
+void *__coro_frame(void *top, void (*entry)(void *), void *arg) {
+    unsigned long *sp = (unsigned long *)((unsigned long)top & ~7UL);
+
+    *--sp = (unsigned long)__coro_boot;     // pc
+    for (int i = 11; i >= 6; i--) *--sp = 0;    // r11-r6
+    *--sp = (unsigned long)entry;           // r5
+    *--sp = (unsigned long)arg;             // r4
+    for (int i = 0; i < __CORO_VFP * 2; i++) *--sp = 0;  // d8-d15
+
+    return sp;
+}
+
 #endif // include guard
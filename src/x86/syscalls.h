@@ -26,6 +26,8 @@
  * - O_CREAT  - create file if it does not exist
  * - O_APPEND - append to the end of the file
  * - O_TRUNC  - truncate the file
+ * - O_NONBLOCK - do not block on reads and writes
+ * - O_CLOEXEC  - close the file descriptor on exec
  *  
  * Permissions:
  * - S_IRUSR  - read permission owner
@@ -37,15 +39,304 @@
 #define _O_RDONLY  0x0000     // O_RDONLY - read only
 #define _O_WRONLY  0x0001     // O_WRONLY - write only
 #define _O_RDWR    0x0002     // O_RDWR   - read and write
-#define _O_CREAT   0x0100     // O_CREAT  - create file if it does not exist
-#define _O_APPEND  0x0200     // O_APPEND - append to the end of the file
-#define _O_TRUNC   0x0400     // O_TRUNC  - truncate the file
+#define _O_CREAT   0x0040     // O_CREAT  - create file if it does not exist
+#define _O_APPEND  0x0400     // O_APPEND - append to the end of the file
+#define _O_TRUNC   0x0200     // O_TRUNC  - truncate the file
+#define _O_NONBLOCK 0x0800    // O_NONBLOCK - do not block on reads and writes
+#define _O_CLOEXEC 0x80000    // O_CLOEXEC  - close the file descriptor on exec
 
 #define _S_IRUSR  00400       // S_IRUSR  - read permission owner
 #define _S_IWUSR  00200       // S_IWUSR  - write permission owner
 #define _S_IRGRP  00040       // S_IRGRP  - read permission group
 #define _S_IROTH  00004       // S_IROTH  - read permission others
 
+/**
+ * Macros for file positioning and file access advice.
+ * 
+ * Whence:
+ * - SEEK_SET - offset is relative to the start of the file
+ * - SEEK_CUR - offset is relative to the current position
+ * - SEEK_END - offset is relative to the end of the file
+ * 
+ * Advice:
+ * - POSIX_FADV_NORMAL     - no special treatment
+ * - POSIX_FADV_RANDOM     - expect random access, disable read ahead
+ * - POSIX_FADV_SEQUENTIAL - expect sequential access, read ahead more
+ * - POSIX_FADV_WILLNEED   - the range will be accessed soon
+ * - POSIX_FADV_DONTNEED   - the range will not be accessed soon
+*/
+
+#define _SEEK_SET  0              // SEEK_SET - relative to the start of the file
+#define _SEEK_CUR  1              // SEEK_CUR - relative to the current position
+#define _SEEK_END  2              // SEEK_END - relative to the end of the file
+
+#define _POSIX_FADV_NORMAL      0 // POSIX_FADV_NORMAL     - no special treatment
+#define _POSIX_FADV_RANDOM      1 // POSIX_FADV_RANDOM     - expect random access
+#define _POSIX_FADV_SEQUENTIAL  2 // POSIX_FADV_SEQUENTIAL - expect sequential access
+#define _POSIX_FADV_WILLNEED    3 // POSIX_FADV_WILLNEED   - the range will be accessed soon
+#define _POSIX_FADV_DONTNEED    4 // POSIX_FADV_DONTNEED   - the range will not be accessed soon
+
+/**
+ * Macros for moving data between file descriptors.
+ * 
+ * Splice flags:
+ * - SPLICE_F_MOVE     - move pages instead of copying them
+ * - SPLICE_F_NONBLOCK - do not block on the pipe
+ * - SPLICE_F_MORE     - more data will follow
+ * 
+ * Ioctl requests:
+ * - FICLONE - share the data blocks of a whole file (reflink)
+*/
+
+#define _SPLICE_F_MOVE      0x01       // SPLICE_F_MOVE     - move pages instead of copying them
+#define _SPLICE_F_NONBLOCK  0x02       // SPLICE_F_NONBLOCK - do not block on the pipe
+#define _SPLICE_F_MORE      0x04       // SPLICE_F_MORE     - more data will follow
+
+#define _FICLONE            0x40049409 // FICLONE           - share the data blocks of a whole file
+
+/**
+ * Macros for memory mappings.
+ * 
+ * Protection:
+ * - PROT_NONE      - pages can not be accessed
+ * - PROT_READ      - pages can be read
+ * - PROT_WRITE     - pages can be written
+ * - PROT_EXEC      - pages can be executed
+ * 
+ * Flags:
+ * - MAP_SHARED     - changes are visible to other mappings of the file
+ * - MAP_PRIVATE    - copy-on-write mapping
+ * - MAP_FIXED      - place the mapping exactly at the given address
+ * - MAP_ANONYMOUS  - mapping is not backed by any file
+ * - MAP_NORESERVE  - do not reserve swap space
+ * - MAP_POPULATE   - prefault the pages
+*/
+
+#define _PROT_NONE      0x0       // PROT_NONE      - pages can not be accessed
+#define _PROT_READ      0x1       // PROT_READ      - pages can be read
+#define _PROT_WRITE     0x2       // PROT_WRITE     - pages can be written
+#define _PROT_EXEC      0x4       // PROT_EXEC      - pages can be executed
+
+#define _MAP_SHARED     0x0001    // MAP_SHARED     - changes are visible to other mappings
+#define _MAP_PRIVATE    0x0002    // MAP_PRIVATE    - copy-on-write mapping
+#define _MAP_FIXED      0x0010    // MAP_FIXED      - place the mapping at the given address
+#define _MAP_ANONYMOUS  0x0020    // MAP_ANONYMOUS  - mapping is not backed by any file
+#define _MAP_NORESERVE  0x4000    // MAP_NORESERVE  - do not reserve swap space
+#define _MAP_POPULATE   0x8000    // MAP_POPULATE   - prefault the pages
+
+/**
+ * Macros for memory advice and remapping.
+ * 
+ * Advice:
+ * - MADV_NORMAL     - no special treatment
+ * - MADV_RANDOM     - expect random page references
+ * - MADV_SEQUENTIAL - expect sequential page references
+ * - MADV_WILLNEED   - expect access in the near future (read ahead)
+ * - MADV_DONTNEED   - do not expect access, pages can be freed
+ * - MADV_FREE       - pages can be freed lazily, when memory is short
+ * - MADV_HUGEPAGE   - back the range with transparent huge pages
+ * - MADV_NOHUGEPAGE - do not back the range with huge pages
+ * - MADV_POPULATE_WRITE - prefault the pages writable
+ * 
+ * Remap flags:
+ * - MREMAP_MAYMOVE  - the mapping can be moved to a new address
+ * - MREMAP_FIXED    - the mapping is moved to new_addr
+*/
+
+#define _MADV_NORMAL      0       // MADV_NORMAL     - no special treatment
+#define _MADV_RANDOM      1       // MADV_RANDOM     - expect random page references
+#define _MADV_SEQUENTIAL  2       // MADV_SEQUENTIAL - expect sequential page references
+#define _MADV_WILLNEED    3       // MADV_WILLNEED   - expect access in the near future
+#define _MADV_DONTNEED    4       // MADV_DONTNEED   - do not expect access
+#define _MADV_FREE        8       // MADV_FREE       - pages can be freed lazily
+#define _MADV_HUGEPAGE    14      // MADV_HUGEPAGE   - use transparent huge pages
+#define _MADV_NOHUGEPAGE  15      // MADV_NOHUGEPAGE - do not use huge pages
+#define _MADV_POPULATE_WRITE 23   // MADV_POPULATE_WRITE - prefault the pages writable
+
+#define _MREMAP_MAYMOVE   1       // MREMAP_MAYMOVE  - the mapping can be moved
+#define _MREMAP_FIXED     2       // MREMAP_FIXED    - the mapping is moved to new_addr
+
+/**
+ * Macros for the getrandom flags.
+ * 
+ * - GRND_NONBLOCK - fail with EAGAIN instead of blocking
+ *                   before the entropy pool is ready
+ * - GRND_RANDOM   - take the bytes from the blocking pool
+ * - GRND_INSECURE - do not wait for the pool (Linux 5.6)
+*/
+
+#define _GRND_NONBLOCK    1       // GRND_NONBLOCK - do not block
+#define _GRND_RANDOM      2       // GRND_RANDOM   - use the blocking pool
+#define _GRND_INSECURE    4       // GRND_INSECURE - do not wait for the pool
+
+/**
+ * Macros for the futex operations.
+ * 
+ * - FUTEX_WAIT         - sleep while the futex holds the value
+ * - FUTEX_WAKE         - wake up sleeping threads
+ * - FUTEX_REQUEUE      - wake up threads, move the rest to another futex
+ * - FUTEX_CMP_REQUEUE  - FUTEX_REQUEUE if the futex holds the value
+ * - FUTEX_WAIT_BITSET  - FUTEX_WAIT with an absolute timeout
+ * - FUTEX_PRIVATE_FLAG - the futex is not shared between processes
+ * - FUTEX_CLOCK_REALTIME - the timeout is on the realtime clock
+*/
+
+#define _FUTEX_WAIT           0       // FUTEX_WAIT        - wait for a wake up
+#define _FUTEX_WAKE           1       // FUTEX_WAKE        - wake up waiters
+#define _FUTEX_REQUEUE        3       // FUTEX_REQUEUE     - move waiters
+#define _FUTEX_CMP_REQUEUE    4       // FUTEX_CMP_REQUEUE - move waiters if the value matches
+#define _FUTEX_WAIT_BITSET    9       // FUTEX_WAIT_BITSET - wait with an absolute timeout
+#define _FUTEX_PRIVATE_FLAG   128     // FUTEX_PRIVATE_FLAG   - process-private futex
+#define _FUTEX_CLOCK_REALTIME 256     // FUTEX_CLOCK_REALTIME - realtime clock timeout
+
+/**
+ * Macros for the clone flags.
+ * 
+ * - CLONE_VM             - share the memory
+ * - CLONE_FS             - share the working directory and umask
+ * - CLONE_FILES          - share the file descriptors
+ * - CLONE_SIGHAND        - share the signal handlers
+ * - CLONE_THREAD         - a thread of the same process
+ * - CLONE_SYSVSEM        - share the System V semaphore undo values
+ * - CLONE_SETTLS         - set the thread pointer of the child
+ * - CLONE_PARENT_SETTID  - store the thread ID at ptid
+ * - CLONE_CHILD_CLEARTID - clear ctid and wake it as a futex at exit
+*/
+
+#define _CLONE_VM             0x00000100  // CLONE_VM             - share the memory
+#define _CLONE_FS             0x00000200  // CLONE_FS             - share the filesystem info
+#define _CLONE_FILES          0x00000400  // CLONE_FILES          - share the descriptors
+#define _CLONE_SIGHAND        0x00000800  // CLONE_SIGHAND        - share the signal handlers
+#define _CLONE_THREAD         0x00010000  // CLONE_THREAD         - same thread group
+#define _CLONE_SYSVSEM        0x00040000  // CLONE_SYSVSEM        - share semaphore undo
+#define _CLONE_SETTLS         0x00080000  // CLONE_SETTLS         - set the thread pointer
+#define _CLONE_PARENT_SETTID  0x00100000  // CLONE_PARENT_SETTID  - store the thread ID
+#define _CLONE_CHILD_CLEARTID 0x00200000  // CLONE_CHILD_CLEARTID - clear the thread ID at exit
+
+/**
+ * _user_desc_t - segment descriptor, as taken by
+ *                set_thread_area and clone.
+ * 
+ * flags holds the bit fields of the kernel structure:
+ * seg_32bit (bit 0), contents (bits 1-2), read_exec_only
+ * (bit 3), limit_in_pages (bit 4), seg_not_present (bit 5)
+ * and useable (bit 6). _USER_DESC_TLS are the flags of
+ * a thread pointer segment covering all memory.
+*/
+typedef struct {
+    unsigned int entry_number;
+    unsigned int base_addr;
+    unsigned int limit;
+    unsigned int flags;
+} _user_desc_t;
+
+#define _USER_DESC_TLS        0x51
+
+/**
+ * Macros for the fcntl commands.
+ * 
+ * - F_GETFL - get the status flags (_O_NONBLOCK, _O_APPEND)
+ * - F_SETFL - set the status flags
+*/
+
+#define _F_GETFL              3           // F_GETFL - get the status flags
+#define _F_SETFL              4           // F_SETFL - set the status flags
+
+/**
+ * Macros for epoll.
+ * 
+ * - EPOLL_CLOEXEC - close the instance on exec
+ * - EPOLL_CTL_ADD - add a file descriptor
+ * - EPOLL_CTL_DEL - remove a file descriptor
+ * - EPOLL_CTL_MOD - change the events of a file descriptor
+ * - EPOLLIN       - ready for reading
+ * - EPOLLOUT      - ready for writing
+ * - EPOLLERR      - an error happened (always reported)
+ * - EPOLLHUP      - the other end hung up (always reported)
+ * - EPOLLRDHUP    - the peer closed its writing end
+ * - EPOLLET       - report the changes of the state only
+*/
+
+#define _EPOLL_CLOEXEC        0x80000     // EPOLL_CLOEXEC - close on exec
+#define _EPOLL_CTL_ADD        1           // EPOLL_CTL_ADD - add a file descriptor
+#define _EPOLL_CTL_DEL        2           // EPOLL_CTL_DEL - remove a file descriptor
+#define _EPOLL_CTL_MOD        3           // EPOLL_CTL_MOD - change the events
+#define _EPOLLIN              0x001       // EPOLLIN       - ready for reading
+#define _EPOLLOUT             0x004       // EPOLLOUT      - ready for writing
+#define _EPOLLERR             0x008       // EPOLLERR      - error
+#define _EPOLLHUP             0x010       // EPOLLHUP      - hang up
+#define _EPOLLRDHUP           0x2000      // EPOLLRDHUP    - peer closed its writing end
+#define _EPOLLET              0x80000000U // EPOLLET       - edge triggered
+
+/**
+ * Macros for the timerfd and eventfd flags.
+ * 
+ * - TFD_NONBLOCK      - reads of the timer do not block
+ * - TFD_CLOEXEC       - close the timer on exec
+ * - TFD_TIMER_ABSTIME - the expiration is an absolute time
+ * - EFD_NONBLOCK      - reads of the counter do not block
+ * - EFD_CLOEXEC       - close the counter on exec
+*/
+
+#define _TFD_NONBLOCK         0x0800      // TFD_NONBLOCK      - do not block
+#define _TFD_CLOEXEC          0x80000     // TFD_CLOEXEC       - close on exec
+#define _TFD_TIMER_ABSTIME    1           // TFD_TIMER_ABSTIME - absolute expiration
+#define _EFD_NONBLOCK         0x0800      // EFD_NONBLOCK      - do not block
+#define _EFD_CLOEXEC          0x80000     // EFD_CLOEXEC       - close on exec
+
+/**
+ * _stat_t - file status, as filled by the fstat64 syscall.
+ * 
+ * RawC uses mainly the size and the mode of the file,
+ * the layout has to match the kernel structure.
+*/
+typedef struct {
+    unsigned long long st_dev;
+    unsigned char      __pad0[4];
+    unsigned long      __st_ino;
+    unsigned int       st_mode;
+    unsigned int       st_nlink;
+    unsigned long      st_uid;
+    unsigned long      st_gid;
+    unsigned long long st_rdev;
+    unsigned char      __pad3[4];
+    long long          st_size;
+    unsigned long      st_blksize;
+    unsigned long long st_blocks;
+    unsigned long      st_atime_sec;
+    unsigned long      st_atime_nsec;
+    unsigned long      st_mtime_sec;
+    unsigned long      st_mtime_nsec;
+    unsigned long      st_ctime_sec;
+    unsigned long      st_ctime_nsec;
+    unsigned long long st_ino;
+} _stat_t;
+
+/**
+ * _iovec - a buffer of a vectored read or write
+ *          (writev, io_uring buffers).
+ * 
+ * @param base address of the buffer
+ * @param len length of the buffer
+*/
+typedef struct {
+    void *base;
+    unsigned long len;
+} _iovec;
+
+/**
+ * _epoll_event_t - an event of an epoll instance.
+ * 
+ * It is 12 bytes, the data is aligned to 4 bytes on i386.
+ * 
+ * @param events the events (_EPOLL*)
+ * @param data returned with the events of the file descriptor
+*/
+typedef struct __attribute__((packed)) {
+    unsigned int events;
+    unsigned long long data;
+} _epoll_event_t;
+
 /**
  * Syscall definitions
  * 
@@ -54,25 +345,103 @@
  * 
  * Syscalls we are going to use:
  * 
- * | Syscall    | Numer | Arguments |
- * | ---------  | ----- | --------- |
- * | SYS_READ   | 3     | 3         |
- * | SYS_WRITE  | 4     | 3         |
- * | SYS_OPEN   | 5     | 3         |
- * | SYS_CLOSE  | 6     | 1         |
- * | SYS_EXIT   | 1     | 1         |
- * | SYS_RENAME | 82    | 2         |
+ * | Syscall               | Numer | Arguments |
+ * | --------------------- | ----- | --------- |
+ * | SYS_READ              | 3     | 3         |
+ * | SYS_WRITE             | 4     | 3         |
+ * | SYS_OPEN              | 5     | 3         |
+ * | SYS_CLOSE             | 6     | 1         |
+ * | SYS_EXIT              | 1     | 1         |
+ * | SYS_RENAME            | 82    | 2         |
+ * | SYS_CLOCK_GETTIME     | 265   | 2         |
+ * | SYS_GETTIMEOFDAY      | 78    | 2         |
+ * | SYS_TIME              | 13    | 1         |
+ * | SYS_GETCPU            | 318   | 3         |
+ * | SYS_MMAP2             | 192   | 6         |
+ * | SYS_MUNMAP            | 91    | 2         |
+ * | SYS_IO_URING_SETUP    | 425   | 2         |
+ * | SYS_IO_URING_ENTER    | 426   | 6         |
+ * | SYS_IO_URING_REGISTER | 427   | 4         |
+ * | SYS_FSTAT64           | 197   | 2         |
+ * | SYS_MREMAP            | 163   | 5         |
+ * | SYS_MADVISE           | 219   | 3         |
+ * | SYS_LLSEEK            | 140   | 5         |
+ * | SYS_PREAD64           | 180   | 5         |
+ * | SYS_PWRITE64          | 181   | 5         |
+ * | SYS_READAHEAD         | 225   | 4         |
+ * | SYS_FADVISE64_64      | 272   | 6         |
+ * | SYS_IOCTL             | 54    | 3         |
+ * | SYS_SENDFILE64        | 239   | 4         |
+ * | SYS_SPLICE            | 313   | 6         |
+ * | SYS_TEE               | 315   | 4         |
+ * | SYS_PIPE2             | 331   | 2         |
+ * | SYS_COPY_FILE_RANGE   | 377   | 6         |
+ * | SYS_GETRANDOM         | 355   | 3         |
+ * | SYS_FUTEX             | 240   | 6         |
+ * | SYS_MPROTECT          | 125   | 3         |
+ * | SYS_CLONE             | 120   | 5         |
+ * | SYS_SET_THREAD_AREA   | 243   | 1         |
+ * | SYS_SET_TID_ADDRESS   | 258   | 1         |
+ * | SYS_SCHED_GETAFFINITY | 242   | 3         |
+ * | SYS_WRITEV            | 146   | 3         |
+ * | SYS_FCNTL             | 55    | 3         |
+ * | SYS_EPOLL_CREATE1     | 329   | 1         |
+ * | SYS_EPOLL_CTL         | 255   | 4         |
+ * | SYS_EPOLL_WAIT        | 256   | 4         |
+ * | SYS_TIMERFD_CREATE    | 322   | 2         |
+ * | SYS_TIMERFD_SETTIME   | 325   | 4         |
+ * | SYS_TIMERFD_GETTIME   | 326   | 2         |
+ * | SYS_EVENTFD2          | 328   | 2         |
  * 
  * You can find the list of all syscalls here:
  *  https://chromium.googlesource.com/chromiumos/docs/+/master/constants/syscalls.md
 */
 
-#define __SYS_READ__   3
-#define __SYS_WRITE__  4
-#define __SYS_OPEN__   5
-#define __SYS_CLOSE__  6
-#define __SYS_EXIT__   1
-#define __SYS_RENAME__ 82
+#define __SYS_READ__              3
+#define __SYS_WRITE__             4
+#define __SYS_OPEN__              5
+#define __SYS_CLOSE__             6
+#define __SYS_EXIT__              1
+#define __SYS_RENAME__            82
+#define __SYS_CLOCK_GETTIME__     265
+#define __SYS_GETTIMEOFDAY__      78
+#define __SYS_TIME__              13
+#define __SYS_GETCPU__            318
+#define __SYS_MMAP2__             192
+#define __SYS_MUNMAP__            91
+#define __SYS_IO_URING_SETUP__    425
+#define __SYS_IO_URING_ENTER__    426
+#define __SYS_IO_URING_REGISTER__ 427
+#define __SYS_FSTAT64__           197
+#define __SYS_MREMAP__            163
+#define __SYS_MADVISE__           219
+#define __SYS_LLSEEK__            140
+#define __SYS_PREAD64__           180
+#define __SYS_PWRITE64__          181
+#define __SYS_READAHEAD__         225
+#define __SYS_FADVISE64_64__      272
+#define __SYS_IOCTL__             54
+#define __SYS_SENDFILE64__        239
+#define __SYS_SPLICE__            313
+#define __SYS_TEE__               315
+#define __SYS_PIPE2__             331
+#define __SYS_COPY_FILE_RANGE__   377
+#define __SYS_GETRANDOM__         355
+#define __SYS_FUTEX__             240
+#define __SYS_MPROTECT__          125
+#define __SYS_CLONE__             120
+#define __SYS_SET_THREAD_AREA__   243
+#define __SYS_SET_TID_ADDRESS__   258
+#define __SYS_SCHED_GETAFFINITY__ 242
+#define __SYS_WRITEV__            146
+#define __SYS_FCNTL__             55
+#define __SYS_EPOLL_CREATE1__     329
+#define __SYS_EPOLL_CTL__         255
+#define __SYS_EPOLL_WAIT__        256
+#define __SYS_TIMERFD_CREATE__    322
+#define __SYS_TIMERFD_SETTIME__   325
+#define __SYS_TIMERFD_GETTIME__   326
+#define __SYS_EVENTFD2__          328
 
 /**
  * Read from a file descriptor.
@@ -84,7 +453,7 @@
  * @return - number of bytes read, or an error code
  */
 long long sys_read(int fd, void *buf, unsigned long long size) {
-    long long ret;
+    long ret;
 
     /**
      * Call the syscall for reading with the following parameters:
@@ -99,7 +468,7 @@ long long sys_read(int fd, void *buf, unsigned long long size) {
         "int $0x80"
         : "=a" (ret)
         //                EBX         ECX       EDX
-        : "0"(__SYS_READ__), "b"(fd), "c"(buf), "d"(size)
+        : "0"(__SYS_READ__), "b"(fd), "c"(buf), "d"((unsigned long)size)
         : "memory"
     );
 
@@ -116,7 +485,7 @@ long long sys_read(int fd, void *buf, unsigned long long size) {
  * @return number of bytes written, or an error code
 */
 long long sys_write(int fd, const void *buf, unsigned long long size) {
-    long long ret;
+    long ret;
 
     /**
      * Call the syscall for writing with the following parameters:
@@ -131,7 +500,7 @@ long long sys_write(int fd, const void *buf, unsigned long long size) {
         "int $0x80"
         : "=a" (ret)
         //                EBX         ECX       EDX
-        : "0"(__SYS_WRITE__), "b"(fd), "c"(buf), "d"(size)
+        : "0"(__SYS_WRITE__), "b"(fd), "c"(buf), "d"((unsigned long)size)
         : "memory"
     );
 
@@ -170,7 +539,7 @@ void sys_exit(int status) {
  * @return 0 on success, or an error code on failure
 */
 int sys_rename(const char* old_name, const char* new_name) {
-    long long ret;
+    long ret;
     /**
      * Call the 0x52 syscall with the following parameters:
      * 
@@ -199,7 +568,7 @@ int sys_rename(const char* old_name, const char* new_name) {
  * @param mode file permissions
 */
 long long sys_open(const char *filename, int flags, int mode) {
-    long long ret;
+    long ret;
     /**
      * Call the 0x05 syscall with the following parameters:
      * 
@@ -228,7 +597,7 @@ long long sys_open(const char *filename, int flags, int mode) {
  * @return 0 on success, or an error code on failure
 */
 int sys_close(int fd) {
-    long long ret;
+    long ret;
     /**
      * Call the syscall for closing a file descriptor with the following parameters:
      * 
@@ -247,5 +616,1444 @@ int sys_close(int fd) {
     return (int)ret;
 }
 
+/**
+ * Get the time of the given clock.
+ * 
+ * @param clock clock identifier
+ * @param ts timespec structure to fill
+ * 
+ * @return 0 on success, or an error code
+*/
+long long sys_clock_gettime(int clock, void *ts) {
+    long ret;
+
+    /**
+     * Call the syscall for reading a clock with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx clock identifier
+     * @param ecx timespec address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                         EBX            ECX
+        : "0"(__SYS_CLOCK_GETTIME__), "b"(clock), "c"(ts)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Get the wall clock time in microseconds precision.
+ * 
+ * @param tv timeval structure to fill
+ * @param tz timezone structure to fill (can be NULL)
+ * 
+ * @return 0 on success, or an error code
+*/
+long long sys_gettimeofday(void *tv, void *tz) {
+    long ret;
+
+    /**
+     * Call the syscall for reading the wall clock with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx timeval address
+     * @param ecx timezone address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                        EBX         ECX
+        : "0"(__SYS_GETTIMEOFDAY__), "b"(tv), "c"(tz)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Get the time in seconds since the Epoch.
+ * 
+ * @param t where to store the time (can be NULL)
+ * 
+ * @return time in seconds, or an error code
+*/
+long long sys_time(long *t) {
+    long ret;
+
+    /**
+     * Call the syscall for reading the time with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx time address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                EBX
+        : "0"(__SYS_TIME__), "b"(t)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Determine the CPU and NUMA node the calling thread is running on.
+ * 
+ * @param cpu where to store the CPU number (can be NULL)
+ * @param node where to store the NUMA node number (can be NULL)
+ * @param cache unused since Linux 2.6.24, pass NULL
+ * 
+ * @return 0 on success, or an error code
+*/
+long long sys_getcpu(unsigned *cpu, unsigned *node, void *cache) {
+    long ret;
+
+    /**
+     * Call the syscall for reading the current CPU with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx cpu address
+     * @param ecx node address
+     * @param edx cache address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                  EBX        ECX         EDX
+        : "0"(__SYS_GETCPU__), "b"(cpu), "c"(node), "d"(cache)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Map files or anonymous memory into the address space.
+ * 
+ * i386 has no 64-bit offset mmap, the mmap2 syscall
+ * takes the offset in pages of 4096 bytes instead.
+ * 
+ * @param addr hint for the address of the mapping (can be NULL)
+ * @param length length of the mapping
+ * @param prot memory protection (_PROT_*)
+ * @param flags mapping flags (_MAP_*)
+ * @param fd file descriptor to map, or -1
+ * @param offset offset in the file, multiple of the page size
+ * 
+ * @return address of the mapping, or an error code
+*/
+long long sys_mmap(void *addr, unsigned long long length, int prot, int flags, int fd, long long offset) {
+    long ret;
+    long pgoff = (long)(offset >> 12);
+
+    /**
+     * Call the mmap2 syscall with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx address hint
+     * @param ecx length
+     * @param edx protection
+     * @param esi flags
+     * @param edi file descriptor
+     * @param ebp offset in pages
+     * 
+     * EBP can not be named in the constraints, the sixth
+     * argument is pushed and loaded into it around the call.
+    */
+    asm volatile
+    (
+        "push %[a6]\n\t"
+        "push %%ebp\n\t"
+        "mov 4(%%esp), %%ebp\n\t"
+        "int $0x80\n\t"
+        "pop %%ebp\n\t"
+        "add $4, %%esp"
+        : "=a" (ret)
+        //                 EBX         ECX                         EDX         ESI          EDI       EBP
+        : "0"(__SYS_MMAP2__), "b"(addr), "c"((unsigned long)length), "d"(prot), "S"(flags), "D"(fd), [a6] "g"(pgoff)
+        : "memory"
+    );
+
+    // addresses in the upper half are valid mappings,
+    // only the last page of values are error codes
+    if ((unsigned long)ret > -4096UL) return ret;
+    return (unsigned long)ret;
+}
+
+/**
+ * Unmap a memory mapping.
+ * 
+ * @param addr address of the mapping
+ * @param length length of the mapping
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_munmap(void *addr, unsigned long long length) {
+    long ret;
+
+    /**
+     * Call the syscall for unmapping memory with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx address of the mapping
+     * @param ecx length
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                  EBX         ECX
+        : "0"(__SYS_MUNMAP__), "b"(addr), "c"((unsigned long)length)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Create an io_uring instance.
+ * 
+ * @param entries requested number of submission queue entries
+ * @param params setup parameters, filled with the ring offsets
+ * 
+ * @return file descriptor of the ring, or an error code
+*/
+int sys_io_uring_setup(unsigned entries, void *params) {
+    long ret;
+
+    /**
+     * Call the syscall for creating an io_uring with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx number of entries
+     * @param ecx parameters address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                          EBX            ECX
+        : "0"(__SYS_IO_URING_SETUP__), "b"(entries), "c"(params)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Submit queued requests and/or wait for completions of an io_uring.
+ * 
+ * @param fd file descriptor of the ring
+ * @param to_submit number of requests to submit
+ * @param min_complete number of completions to wait for
+ * @param flags enter flags (_IORING_ENTER_*)
+ * @param sig signal mask to use while waiting (can be NULL)
+ * @param sigsz size of the signal mask
+ * 
+ * @return number of submitted requests, or an error code
+*/
+int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, void *sig, unsigned long long sigsz) {
+    long ret;
+    unsigned long size = (unsigned long)sigsz;
+
+    /**
+     * Call the syscall for entering an io_uring with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx ring file descriptor
+     * @param ecx number of requests to submit
+     * @param edx number of completions to wait for
+     * @param esi flags
+     * @param edi signal mask address
+     * @param ebp signal mask size
+    */
+    asm volatile
+    (
+        "push %[a6]\n\t"
+        "push %%ebp\n\t"
+        "mov 4(%%esp), %%ebp\n\t"
+        "int $0x80\n\t"
+        "pop %%ebp\n\t"
+        "add $4, %%esp"
+        : "=a" (ret)
+        //                          EBX       ECX               EDX                 ESI          EDI        EBP
+        : "0"(__SYS_IO_URING_ENTER__), "b"(fd), "c"(to_submit), "d"(min_complete), "S"(flags), "D"(sig), [a6] "g"(size)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Register resources (buffers, files) with an io_uring.
+ * 
+ * @param fd file descriptor of the ring
+ * @param opcode what to register (_IORING_REGISTER_*)
+ * @param arg resources to register
+ * @param nr_args number of resources
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_io_uring_register(int fd, unsigned opcode, void *arg, unsigned nr_args) {
+    long ret;
+
+    /**
+     * Call the syscall for registering resources with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx ring file descriptor
+     * @param ecx opcode
+     * @param edx resources address
+     * @param esi number of resources
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                             EBX       ECX           EDX        ESI
+        : "0"(__SYS_IO_URING_REGISTER__), "b"(fd), "c"(opcode), "d"(arg), "S"(nr_args)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Get the information about an open file.
+ * 
+ * The fstat64 syscall is used, so the size of
+ * files over 2 GB is reported correctly.
+ * 
+ * @param fd file descriptor
+ * @param st stat structure to fill
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_fstat(int fd, _stat_t *st) {
+    long ret;
+
+    /**
+     * Call the syscall for reading the file status with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx stat structure address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                   EBX       ECX
+        : "0"(__SYS_FSTAT64__), "b"(fd), "c"(st)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Grow, shrink or move a memory mapping.
+ * 
+ * @param addr address of the mapping
+ * @param old_size current length of the mapping
+ * @param new_size wanted length of the mapping
+ * @param flags remap flags (_MREMAP_*)
+ * @param new_addr new address, only with _MREMAP_FIXED
+ * 
+ * @return address of the mapping, or an error code
+*/
+long long sys_mremap(void *addr, unsigned long long old_size, unsigned long long new_size, int flags, void *new_addr) {
+    long ret;
+
+    /**
+     * Call the syscall for remapping memory with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx address of the mapping
+     * @param ecx current length
+     * @param edx wanted length
+     * @param esi flags
+     * @param edi new address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                  EBX         ECX                           EDX                           ESI          EDI
+        : "0"(__SYS_MREMAP__), "b"(addr), "c"((unsigned long)old_size), "d"((unsigned long)new_size), "S"(flags), "D"(new_addr)
+        : "memory"
+    );
+
+    if ((unsigned long)ret > -4096UL) return ret;
+    return (unsigned long)ret;
+}
+
+/**
+ * Give the kernel advice about the use of memory.
+ * 
+ * @param addr start of the range, page aligned
+ * @param length length of the range
+ * @param advice the advice (_MADV_*)
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_madvise(void *addr, unsigned long long length, int advice) {
+    long ret;
+
+    /**
+     * Call the syscall for advising about memory with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx start of the range
+     * @param ecx length
+     * @param edx advice
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                   EBX         ECX                         EDX
+        : "0"(__SYS_MADVISE__), "b"(addr), "c"((unsigned long)length), "d"(advice)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Move the file position of a file descriptor.
+ * 
+ * The _llseek syscall is used, it takes the 64-bit
+ * offset in two registers and stores the result in
+ * memory, so files over 2 GB can be used.
+ * 
+ * @param fd file descriptor
+ * @param offset offset relative to whence
+ * @param whence _SEEK_SET, _SEEK_CUR or _SEEK_END
+ * 
+ * @return the new file position, or an error code
+*/
+long long sys_lseek(int fd, long long offset, int whence) {
+    long ret;
+    long long result;
+
+    /**
+     * Call the syscall for seeking with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx high 32 bits of the offset
+     * @param edx low 32 bits of the offset
+     * @param esi result address
+     * @param edi whence
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                  EBX       ECX                                EDX                           ESI             EDI
+        : "0"(__SYS_LLSEEK__), "b"(fd), "c"((unsigned long)(offset >> 32)), "d"((unsigned long)offset), "S"(&result), "D"(whence)
+        : "memory"
+    );
+
+    return ret < 0 ? ret : result;
+}
+
+/**
+ * Read from a file descriptor at the given offset,
+ * without changing the file position.
+ * 
+ * @param fd file descriptor
+ * @param buf buffer to store read data
+ * @param size number of bytes to read
+ * @param offset offset in the file
+ * 
+ * @return number of bytes read, or an error code
+*/
+long long sys_pread64(int fd, void *buf, unsigned long long size, long long offset) {
+    long ret;
+
+    /**
+     * Call the syscall for positional reading with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx buffer address
+     * @param edx size
+     * @param esi low 32 bits of the offset
+     * @param edi high 32 bits of the offset
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                   EBX       ECX       EDX                       ESI                           EDI
+        : "0"(__SYS_PREAD64__), "b"(fd), "c"(buf), "d"((unsigned long)size), "S"((unsigned long)offset), "D"((unsigned long)(offset >> 32))
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Write to a file descriptor at the given offset,
+ * without changing the file position.
+ * 
+ * @param fd file descriptor
+ * @param buf buffer containing data to write
+ * @param size number of bytes to write
+ * @param offset offset in the file
+ * 
+ * @return number of bytes written, or an error code
+*/
+long long sys_pwrite64(int fd, const void *buf, unsigned long long size, long long offset) {
+    long ret;
+
+    /**
+     * Call the syscall for positional writing with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx buffer address
+     * @param edx size
+     * @param esi low 32 bits of the offset
+     * @param edi high 32 bits of the offset
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                    EBX       ECX       EDX                       ESI                           EDI
+        : "0"(__SYS_PWRITE64__), "b"(fd), "c"(buf), "d"((unsigned long)size), "S"((unsigned long)offset), "D"((unsigned long)(offset >> 32))
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Read the given range of a file into the page cache.
+ * 
+ * @param fd file descriptor
+ * @param offset start of the range
+ * @param count length of the range
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_readahead(int fd, long long offset, unsigned long long count) {
+    long ret;
+
+    /**
+     * Call the syscall for reading ahead with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx low 32 bits of the offset
+     * @param edx high 32 bits of the offset
+     * @param esi count
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                     EBX       ECX                           EDX                                ESI
+        : "0"(__SYS_READAHEAD__), "b"(fd), "c"((unsigned long)offset), "d"((unsigned long)(offset >> 32)), "S"((unsigned long)count)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Announce the access pattern for a range of a file.
+ * 
+ * @param fd file descriptor
+ * @param offset start of the range
+ * @param len length of the range, 0 means until the end of the file
+ * @param advice the advice (_POSIX_FADV_*)
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_fadvise64(int fd, long long offset, long long len, int advice) {
+    long ret;
+
+    /**
+     * Call the fadvise64_64 syscall with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx low 32 bits of the offset
+     * @param edx high 32 bits of the offset
+     * @param esi low 32 bits of the length
+     * @param edi high 32 bits of the length
+     * @param ebp advice
+    */
+    asm volatile
+    (
+        "push %[a6]\n\t"
+        "push %%ebp\n\t"
+        "mov 4(%%esp), %%ebp\n\t"
+        "int $0x80\n\t"
+        "pop %%ebp\n\t"
+        "add $4, %%esp"
+        : "=a" (ret)
+        //                        EBX       ECX                           EDX                                ESI                        EDI                             EBP
+        : "0"(__SYS_FADVISE64_64__), "b"(fd), "c"((unsigned long)offset), "d"((unsigned long)(offset >> 32)), "S"((unsigned long)len), "D"((unsigned long)(len >> 32)), [a6] "g"(advice)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Control a device or a file.
+ * 
+ * @param fd file descriptor
+ * @param cmd request code
+ * @param arg argument of the request
+ * 
+ * @return result of the request, or an error code
+*/
+int sys_ioctl(int fd, unsigned long cmd, unsigned long arg) {
+    long ret;
+
+    /**
+     * Call the syscall for device control with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx request code
+     * @param edx argument
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                 EBX       ECX       EDX
+        : "0"(__SYS_IOCTL__), "b"(fd), "c"(cmd), "d"(arg)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Copy data between file descriptors inside the kernel.
+ * 
+ * The sendfile64 syscall is used, it takes a 64-bit offset.
+ * 
+ * @param out_fd file descriptor to write to
+ * @param in_fd file descriptor to read from (must support mmap)
+ * @param offset where to read from, updated after the call
+ *               (NULL reads from the file position)
+ * @param count number of bytes to copy
+ * 
+ * @return number of bytes copied, or an error code
+*/
+long long sys_sendfile(int out_fd, int in_fd, long long *offset, unsigned long long count) {
+    long ret;
+
+    /**
+     * Call the syscall for sending a file with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx output file descriptor
+     * @param ecx input file descriptor
+     * @param edx offset address
+     * @param esi count
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                      EBX           ECX          EDX          ESI
+        : "0"(__SYS_SENDFILE64__), "b"(out_fd), "c"(in_fd), "d"(offset), "S"((unsigned long)count)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Move data between a file descriptor and a pipe
+ * without copying it through user space.
+ * 
+ * @param fd_in file descriptor to read from
+ * @param off_in where to read from (NULL for pipes and the file position)
+ * @param fd_out file descriptor to write to
+ * @param off_out where to write to (NULL for pipes and the file position)
+ * @param len number of bytes to move
+ * @param flags _SPLICE_F_* flags
+ * 
+ * @return number of bytes moved, or an error code
+*/
+long long sys_splice(int fd_in, long long *off_in, int fd_out, long long *off_out, unsigned long long len, unsigned flags) {
+    long ret;
+
+    /**
+     * Call the syscall for splicing with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx input file descriptor
+     * @param ecx input offset address
+     * @param edx output file descriptor
+     * @param esi output offset address
+     * @param edi length
+     * @param ebp flags
+    */
+    asm volatile
+    (
+        "push %[a6]\n\t"
+        "push %%ebp\n\t"
+        "mov 4(%%esp), %%ebp\n\t"
+        "int $0x80\n\t"
+        "pop %%ebp\n\t"
+        "add $4, %%esp"
+        : "=a" (ret)
+        //                  EBX          ECX           EDX           ESI            EDI                      EBP
+        : "0"(__SYS_SPLICE__), "b"(fd_in), "c"(off_in), "d"(fd_out), "S"(off_out), "D"((unsigned long)len), [a6] "g"(flags)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Duplicate the data of a pipe into another pipe
+ * without consuming it.
+ * 
+ * @param fd_in pipe to read from
+ * @param fd_out pipe to write to
+ * @param len number of bytes to duplicate
+ * @param flags _SPLICE_F_* flags
+ * 
+ * @return number of bytes duplicated, or an error code
+*/
+long long sys_tee(int fd_in, int fd_out, unsigned long long len, unsigned flags) {
+    long ret;
+
+    /**
+     * Call the syscall for duplicating pipe data with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx input pipe
+     * @param ecx output pipe
+     * @param edx length
+     * @param esi flags
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //               EBX          ECX           EDX                      ESI
+        : "0"(__SYS_TEE__), "b"(fd_in), "c"(fd_out), "d"((unsigned long)len), "S"(flags)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Create a pipe.
+ * 
+ * @param fds where to store the read end and the write end
+ * @param flags _O_CLOEXEC, _O_NONBLOCK
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_pipe2(int *fds, int flags) {
+    long ret;
+
+    /**
+     * Call the syscall for creating a pipe with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptors address
+     * @param ecx flags
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                 EBX        ECX
+        : "0"(__SYS_PIPE2__), "b"(fds), "c"(flags)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Copy a range of a file to another file inside the kernel.
+ * 
+ * File systems which support it share the data
+ * blocks (reflink) instead of copying them.
+ * 
+ * @param fd_in file descriptor to read from
+ * @param off_in where to read from (NULL for the file position)
+ * @param fd_out file descriptor to write to
+ * @param off_out where to write to (NULL for the file position)
+ * @param len number of bytes to copy
+ * @param flags must be 0
+ * 
+ * @return number of bytes copied, or an error code
+*/
+long long sys_copy_file_range(int fd_in, long long *off_in, int fd_out, long long *off_out, unsigned long long len, unsigned flags) {
+    long ret;
+
+    /**
+     * Call the syscall for copying a file range with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx input file descriptor
+     * @param ecx input offset address
+     * @param edx output file descriptor
+     * @param esi output offset address
+     * @param edi length
+     * @param ebp flags
+    */
+    asm volatile
+    (
+        "push %[a6]\n\t"
+        "push %%ebp\n\t"
+        "mov 4(%%esp), %%ebp\n\t"
+        "int $0x80\n\t"
+        "pop %%ebp\n\t"
+        "add $4, %%esp"
+        : "=a" (ret)
+        //                           EBX          ECX           EDX           ESI            EDI                      EBP
+        : "0"(__SYS_COPY_FILE_RANGE__), "b"(fd_in), "c"(off_in), "d"(fd_out), "S"(off_out), "D"((unsigned long)len), [a6] "g"(flags)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Fill a buffer with random bytes from the kernel.
+ * 
+ * @param buf buffer to fill
+ * @param size number of bytes
+ * @param flags _GRND_* flags, or 0
+ * 
+ * @return number of bytes written, or an error code
+*/
+long long sys_getrandom(void *buf, unsigned long long size, unsigned int flags) {
+    long ret;
+
+    /**
+     * Call the syscall for getting random bytes with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx buffer address
+     * @param ecx size
+     * @param edx flags
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                        EBX       ECX                       EDX
+        : "0"(__SYS_GETRANDOM__), "b"(buf), "c"((unsigned long)size), "d"(flags)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Wait on or wake up a futex (fast userspace mutex).
+ * 
+ * @param uaddr address of the futex word
+ * @param op operation (_FUTEX_*), with _FUTEX_PRIVATE_FLAG
+ *           for futexes not shared between processes
+ * @param val expected value (wait) or number of threads (wake)
+ * @param timeout relative timeout of a wait (_timespec), or NULL
+ * @param uaddr2 second futex of the requeue operations
+ * @param val3 value compared by _FUTEX_CMP_REQUEUE, or the bitset
+ * 
+ * @return number of woken threads (wake), 0 (wait), or an error code
+*/
+long long sys_futex(unsigned int *uaddr, int op, unsigned int val, const void *timeout, unsigned int *uaddr2, unsigned int val3) {
+    long ret;
+
+    /**
+     * Call the syscall for a futex operation with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx futex address
+     * @param ecx operation
+     * @param edx value
+     * @param esi timeout address
+     * @param edi second futex address
+     * @param ebp third value
+    */
+    asm volatile
+    (
+        "push %[a6]\n\t"
+        "push %%ebp\n\t"
+        "mov 4(%%esp), %%ebp\n\t"
+        "int $0x80\n\t"
+        "pop %%ebp\n\t"
+        "add $4, %%esp"
+        : "=a" (ret)
+        //                 EBX          ECX       EDX        ESI            EDI           EBP
+        : "0"(__SYS_FUTEX__), "b"(uaddr), "c"(op), "d"(val), "S"(timeout), "D"(uaddr2), [a6] "g"(val3)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Change the protection of a memory range.
+ * 
+ * @param addr start of the range, page aligned
+ * @param length length of the range
+ * @param prot new protection (_PROT_*)
+ * 
+ * @return 0 on success, or an error code
+*/
+long long sys_mprotect(void *addr, unsigned long long length, int prot) {
+    long ret;
+
+    /**
+     * Call the syscall for changing the memory protection with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx start of the range
+     * @param ecx length
+     * @param edx protection
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                    EBX        ECX                         EDX
+        : "0"(__SYS_MPROTECT__), "b"(addr), "c"((unsigned long)length), "d"(prot)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Create a child process or thread.
+ * 
+ * The child continues from the syscall with the same
+ * registers. With a new stack it can not return from
+ * this function (the frame is on the old stack), so
+ * threads are started with _thread_create instead.
+ * 
+ * @param flags _CLONE_* flags, with the exit signal in the low byte
+ * @param stack top of the stack of the child, or NULL for a copy
+ * @param ptid where to store the thread ID (_CLONE_PARENT_SETTID)
+ * @param ctid thread ID cleared when the child exits (_CLONE_CHILD_CLEARTID)
+ * @param tls segment descriptor of the thread pointer (_user_desc_t, _CLONE_SETTLS)
+ * 
+ * @return thread ID of the child in the parent, 0 in the child, or an error code
+*/
+long long sys_clone(unsigned long long flags, void *stack, int *ptid, int *ctid, unsigned long long tls) {
+    long ret;
+
+    /**
+     * Call the syscall for creating a child with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx flags
+     * @param ecx stack
+     * @param edx parent thread ID address
+     * @param esi segment descriptor address
+     * @param edi child thread ID address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                 EBX                        ECX          EDX         ESI                      EDI
+        : "0"(__SYS_CLONE__), "b"((unsigned long)flags), "c"(stack), "d"(ptid), "S"((unsigned long)tls), "D"(ctid)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Set a segment descriptor of the thread pointer.
+ * 
+ * An entry_number of -1 takes a free entry and
+ * stores its number in the descriptor.
+ * 
+ * @param desc the descriptor
+ * 
+ * @return 0 on success, or an error code
+*/
+long long sys_set_thread_area(_user_desc_t *desc) {
+    long ret;
+
+    /**
+     * Call the syscall for setting a TLS descriptor with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx descriptor address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                           EBX
+        : "0"(__SYS_SET_THREAD_AREA__), "b"(desc)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Set the thread ID cleared when the thread exits.
+ * 
+ * The kernel writes 0 to the address and wakes up
+ * a thread waiting on it as a futex.
+ * 
+ * @param tidptr address of the thread ID
+ * 
+ * @return thread ID of the calling thread
+*/
+long long sys_set_tid_address(int *tidptr) {
+    long ret;
+
+    /**
+     * Call the syscall for setting the thread ID address with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx thread ID address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                           EBX
+        : "0"(__SYS_SET_TID_ADDRESS__), "b"(tidptr)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Get the CPU affinity mask of a thread.
+ * 
+ * @param pid thread ID, 0 for the calling thread
+ * @param size size of the mask buffer in bytes
+ * @param mask buffer receiving the mask, one bit per CPU
+ * 
+ * @return size of the mask written by the kernel, or an error code
+*/
+long long sys_sched_getaffinity(int pid, unsigned long long size, void *mask) {
+    long ret;
+
+    /**
+     * Call the syscall for getting the CPU affinity with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx thread ID
+     * @param ecx size of the mask
+     * @param edx mask address
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                             EBX        ECX                       EDX
+        : "0"(__SYS_SCHED_GETAFFINITY__), "b"(pid), "c"((unsigned long)size), "d"(mask)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Write several buffers to a file descriptor.
+ * 
+ * @param fd file descriptor
+ * @param iov the buffers (_iovec), written in order
+ * @param iovcnt number of buffers
+ * 
+ * @return number of bytes written, or an error code
+*/
+long long sys_writev(int fd, const _iovec *iov, int iovcnt) {
+    long ret;
+
+    /**
+     * Call the syscall for writing several buffers with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx buffers
+     * @param edx number of buffers
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                  EBX       ECX        EDX
+        : "0"(__SYS_WRITEV__), "b"(fd), "c"(iov), "d"(iovcnt)
+        : "memory"
+    );
+
+    return ret;
+}
+
+/**
+ * Control a file descriptor.
+ * 
+ * @param fd file descriptor
+ * @param cmd command (_F_GETFL, _F_SETFL)
+ * @param arg argument of the command
+ * 
+ * @return result of the command, or an error code
+*/
+int sys_fcntl(int fd, int cmd, long arg) {
+    long ret;
+
+    /**
+     * Call the syscall for controlling a file descriptor with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor
+     * @param ecx command (_F_GETFL, _F_SETFL)
+     * @param edx argument of the command
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                    EBX      ECX       EDX
+        : "0"(__SYS_FCNTL__), "b"(fd), "c"(cmd), "d"(arg)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Create an epoll instance.
+ * 
+ * @param flags _EPOLL_CLOEXEC or 0
+ * 
+ * @return file descriptor of the instance, or an error code
+*/
+int sys_epoll_create1(int flags) {
+    long ret;
+
+    /**
+     * Call the syscall for creating an epoll instance with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx _EPOLL_CLOEXEC or 0
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                            EBX
+        : "0"(__SYS_EPOLL_CREATE1__), "b"(flags)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Add, modify or remove a file descriptor of an epoll instance.
+ * 
+ * @param epfd epoll instance
+ * @param op _EPOLL_CTL_ADD, _EPOLL_CTL_MOD or _EPOLL_CTL_DEL
+ * @param fd file descriptor
+ * @param event events to wait for and the data reported with them
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_epoll_ctl(int epfd, int op, int fd, _epoll_event_t *event) {
+    long ret;
+
+    /**
+     * Call the syscall for controlling an epoll instance with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx epoll instance
+     * @param ecx _EPOLL_CTL_ADD, _EPOLL_CTL_MOD or _EPOLL_CTL_DEL
+     * @param edx file descriptor
+     * @param esi events to wait for and the data reported with them
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                        EBX        ECX      EDX      ESI
+        : "0"(__SYS_EPOLL_CTL__), "b"(epfd), "c"(op), "d"(fd), "S"(event)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Wait for events on an epoll instance.
+ * 
+ * @param epfd epoll instance
+ * @param events where to store the events
+ * @param maxevents size of events
+ * @param timeout timeout in milliseconds, -1 to wait forever
+ * 
+ * @return number of events stored, or an error code
+*/
+int sys_epoll_wait(int epfd, _epoll_event_t *events, int maxevents, int timeout) {
+    long ret;
+
+    /**
+     * Call the syscall for waiting for epoll events with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx epoll instance
+     * @param ecx where to store the events
+     * @param edx size of events
+     * @param esi timeout in milliseconds, -1 to wait forever
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                         EBX        ECX          EDX             ESI
+        : "0"(__SYS_EPOLL_WAIT__), "b"(epfd), "c"(events), "d"(maxevents), "S"(timeout)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Create a timer which notifies through a file descriptor.
+ * 
+ * @param clockid clock of the timer (_CLOCK_MONOTONIC)
+ * @param flags _TFD_NONBLOCK, _TFD_CLOEXEC
+ * 
+ * @return file descriptor of the timer, or an error code
+*/
+int sys_timerfd_create(int clockid, int flags) {
+    long ret;
+
+    /**
+     * Call the syscall for creating a timer with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx clock of the timer (_CLOCK_MONOTONIC)
+     * @param ecx _TFD_NONBLOCK, _TFD_CLOEXEC
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                             EBX           ECX
+        : "0"(__SYS_TIMERFD_CREATE__), "b"(clockid), "c"(flags)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Arm or disarm a timer.
+ * 
+ * The times are an interval and the first expiration,
+ * two _timespec (struct itimerspec), zero disarms.
+ * 
+ * @param fd file descriptor of the timer
+ * @param flags _TFD_TIMER_ABSTIME or 0
+ * @param new_value the new times
+ * @param old_value where to store the old times, or NULL
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_timerfd_settime(int fd, int flags, const void *new_value, void *old_value) {
+    long ret;
+
+    /**
+     * Call the syscall for arming a timer with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor of the timer
+     * @param ecx _TFD_TIMER_ABSTIME or 0
+     * @param edx the new times
+     * @param esi where to store the old times, or NULL
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                              EBX      ECX         EDX             ESI
+        : "0"(__SYS_TIMERFD_SETTIME__), "b"(fd), "c"(flags), "d"(new_value), "S"(old_value)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Get the times of a timer.
+ * 
+ * @param fd file descriptor of the timer
+ * @param curr_value where to store the interval and the time left
+ * 
+ * @return 0 on success, or an error code
+*/
+int sys_timerfd_gettime(int fd, void *curr_value) {
+    long ret;
+
+    /**
+     * Call the syscall for getting the times of a timer with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx file descriptor of the timer
+     * @param ecx where to store the interval and the time left
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                              EBX      ECX
+        : "0"(__SYS_TIMERFD_GETTIME__), "b"(fd), "c"(curr_value)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Create a file descriptor for event notification.
+ * 
+ * Writes add to a 64-bit counter, a read returns
+ * the counter and resets it.
+ * 
+ * @param initval initial value of the counter
+ * @param flags _EFD_NONBLOCK, _EFD_CLOEXEC
+ * 
+ * @return file descriptor of the counter, or an error code
+*/
+int sys_eventfd2(unsigned int initval, int flags) {
+    long ret;
+
+    /**
+     * Call the syscall for creating an event counter with the following parameters:
+     * 
+     * @param eax syscall number
+     * @param ebx initial value of the counter
+     * @param ecx _EFD_NONBLOCK, _EFD_CLOEXEC
+    */
+    asm volatile
+    (
+        "int $0x80"
+        : "=a" (ret)
+        //                       EBX           ECX
+        : "0"(__SYS_EVENTFD2__), "b"(initval), "c"(flags)
+        : "memory"
+    );
+
+    return (int)ret;
+}
+
+/**
+ * Context switch of the coroutines (_coro.h).
+ * 
+ * A suspended coroutine is its stack pointer: the
+ * callee-saved registers (ebp, ebx, esi, edi) are pushed
+ * on its stack, under the address to return to. The
+ * other registers are saved by the caller of the switch
+ * (the C calling convention), so they are not touched.
+*/
+
+/**
+ * Switch to another stack.
+ * 
+ * Written in assembly at file scope, so the compiler
+ * adds nothing to it (no frame, no stack protector).
+ * The arguments are on the stack, above the four saved
+ * registers and the return address.
+ * 
+ * @param from where to store the stack pointer of the current context
+ * @param to stack pointer of the context to continue
+*/
+void __coro_switch(void **from, void *to);
+
+/**
+ * First code of a new context, the switch returns here.
+ * 
+ * Calls the entry function (esi) with its argument (ebx)
+ * on an aligned stack. The entry function never returns.
+*/
+void __coro_boot(void);
+
+asm
+(
+    ".pushsection .text\n"
+    ".globl __coro_switch\n"
+    ".type __coro_switch, @function\n"
+    "__coro_switch:\n"
+    "    push %ebp\n"
+    "    push %ebx\n"
+    "    push %esi\n"
+    "    push %edi\n"
+    "    mov 20(%esp), %eax\n"
+    "    mov 24(%esp), %ecx\n"
+    "    mov %esp, (%eax)\n"
+    "    mov %ecx, %esp\n"
+    "    pop %edi\n"
+    "    pop %esi\n"
+    "    pop %ebx\n"
+    "    pop %ebp\n"
+    "    ret\n"
+    ".size __coro_switch, .-__coro_switch\n"
+
+    ".globl __coro_boot\n"
+    ".type __coro_boot, @function\n"
+    "__coro_boot:\n"
+    "    and $-16, %esp\n"
+    "    sub $12, %esp\n"
+    "    push %ebx\n"
+    "    call *%esi\n"
+    "    ud2\n"
+    ".size __coro_boot, .-__coro_boot\n"
+    ".popsection\n"
+);
+
+/**
+ * Prepare the stack of a new context.
+ * 
+ * @param top end of the stack
+ * @param entry function called first in the context, never returns
+ * @param arg argument of entry
+ * 
+ * @return stack pointer to switch to
+*/
+void *__coro_frame(void *top, void (*entry)(void *), void *arg) {
+    unsigned long *sp = (unsigned long *)((unsigned long)top & ~15UL);
+
+    *--sp = (unsigned long)__coro_boot;     // return address
+    *--sp = 0;                              // ebp
+    *--sp = (unsigned long)arg;             // ebx
+    *--sp = (unsigned long)entry;           // esi
+    *--sp = 0;                              // edi
+
+    return sp;
+}
 
 #endif // include guard